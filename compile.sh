@@ -4,7 +4,17 @@
 
 echo "Compiling 6DOF Flight Simulator with Audio Support..."
 
-g++ -std=c++17 \
+# Bitwise-reproducible dynamics (see include/fp_determinism.hpp). The flags
+# apply to every file: the inline vector math is shared between them.
+if [ "$FLIGHT_DETERMINISTIC" = "1" ]; then
+    echo "Deterministic floating point (no FMA contraction or reassociation)"
+    # The SLP vectorizer emits fused add/sub (vfmaddsub) with FMA targets
+    # even under -ffp-contract=off
+    CXXFLAGS="$CXXFLAGS -DFLIGHT_DETERMINISTIC -ffp-contract=off -fno-fast-math -fno-tree-slp-vectorize"
+fi
+
+# Extra flags from the environment, e.g. CXXFLAGS=-DFLIGHT_FAST_MATH
+g++ -std=c++17 -O2 $CXXFLAGS \
     -I./include \
     -I./external/imgui \
     -I./external/imgui/backends \
@@ -0,0 +1,103 @@
+#pragma once
+#include "aircraft.hpp"
+#include "flight_log.hpp"
+#include <cstddef>
+#include <string>
+
+// One identified aerodynamic derivative, named as in aircraft_types.hpp
+struct IdentifiedCoefficient {
+    const char* name;         // e.g. "LIFT_ALPHA"
+    double prior;             // Value the Aircraft flies with now
+    double value;
+    double standardError;     // 0 when held at the prior
+    double lower;             // 95% confidence bounds
+    double upper;
+    bool excited;             // False: the regressor never varied in the log, so it was held at the prior
+};
+
+// Least-squares fit of one coefficient equation, e.g.
+// CL = LIFT0 + LIFT_ALPHA alpha + LIFT_ELEVATOR elevator
+struct CoefficientFit {
+    static constexpr int MAX_TERMS = 4;
+
+    const char* name;         // "CL", "CD", ...
+    int termCount;
+    IdentifiedCoefficient terms[MAX_TERMS];
+    size_t samples;
+    double residualRms;       // Coefficient units
+    double rSquared;
+    double condition;         // Of the normal equations scaled to unit diagonal (0 if not reached)
+    bool solved;              // False if the regressors were collinear, ill-conditioned or too few samples
+};
+
+// Equation-error identification of the Aircraft coefficient model from a
+// recorded flight. Each log interval gives measured force and moment
+// coefficients: the accelerations are the interval's velocity and rate
+// differences, the state is the interval midpoint and the controls are
+// those recorded at its start (inputs are held over a control period),
+// and the known mass, inertia, geometry, thrust and gravity are removed.
+// Those are regressed on the terms of getCL/getCD/getCY/getCl/getCm/getCn
+// (alpha, beta, controls, CL^2 for induced drag, pHat/qHat/rHat damping).
+//
+// Intervals are reduced to per-block normal equations across a thread
+// pool and summed in block order, so a million-sample log is one pass and
+// the result does not depend on the thread count. Regressors the log never
+// varies (including a control held at a constant offset) are held at their
+// prior, and an equation whose normal equations are rank-deficient or
+// ill-conditioned is not solved: its terms keep their priors and are
+// reported as not identified rather than with a zero standard error. Confidence bounds assume independent
+// residuals; equation-error residuals on real data are correlated in time,
+// so treat them as optimistic there.
+class AeroIdentification {
+public:
+    enum Equation {
+        EQUATION_LIFT,
+        EQUATION_DRAG,
+        EQUATION_SIDE_FORCE,
+        EQUATION_ROLL,
+        EQUATION_PITCH,
+        EQUATION_YAW,
+        EQUATION_COUNT
+    };
+
+    // Fit every equation to a flight flown by `aircraft` (its physical
+    // properties are taken as known). False if no interval was usable.
+    // threadCount 0 = one per hardware thread.
+    bool identify(const FlightLog& log, const Aircraft& aircraft, unsigned int threadCount = 0);
+
+    const CoefficientFit& getFit(Equation equation) const { return fits[equation]; }
+
+    // Log intervals used and skipped (gaps, time reversals, on the ground,
+    // below MIN_AIRSPEED) by the last identify()
+    size_t getUsedCount() const { return usedCount; }
+    size_t getSkippedCount() const { return skippedCount; }
+
+    // Wall-clock time and threads used by the last identify()
+    double getSolveSeconds() const { return solveSeconds; }
+    unsigned int getThreadCount() const { return threadsUsed; }
+
+    static constexpr double MIN_AIRSPEED = 10.0;   // m/s
+    static constexpr double MAX_INTERVAL = 0.1;    // s; longer gaps are skipped
+
+    // One row per coefficient with prior, estimate, standard error and bounds
+    bool saveCSV(const std::string& path) const;
+
+    // The identified set as an aircraft_types.hpp struct, with the physical
+    // properties of the aircraft it was identified on
+    bool saveTypeHeader(const std::string& path, const std::string& typeName) const;
+
+private:
+    CoefficientFit fits[EQUATION_COUNT] = {};
+    size_t usedCount = 0;
+    size_t skippedCount = 0;
+    double solveSeconds = 0.0;
+    unsigned int threadsUsed = 0;
+
+    // Physical properties of the identified aircraft
+    double mass = 0.0;
+    double wingArea = 0.0;
+    double wingSpan = 0.0;
+    double chord = 0.0;
+    Vector3 inertia;
+    double maxThrust = 0.0;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include "aircraft.hpp"
+#include "atmosphere.hpp"
+
+// Air data for one physics step. FlightDynamics computes it once after
+// each step; instruments, audio, alerts and the renderer all read the
+// same record, so every consumer sees consistent values within a frame.
+struct AirData {
+    double altitude;            // m above sea level
+    double verticalSpeed;       // m/s, positive up (earth frame)
+    double trueAirspeed;        // m/s
+    double indicatedAirspeed;   // m/s (equivalent airspeed; no instrument error)
+    double mach;
+    double alpha;               // rad
+    double beta;                // rad
+    double dynamicPressure;     // Pa
+    double density;             // kg/m^3
+    double staticPressure;      // Pa
+    double densityAltitude;     // m
+    double loadFactor;          // g, along the body -z axis
+    Vector3 specificForce;      // m/s^2, body frame (what an accelerometer measures)
+    double turnRate;            // rad/s, rate of change of heading
+};
+
+// Everything but the specific force and load factor, which the force
+// model fills in with setSpecificForce()
+AirData computeAirData(const Aircraft& aircraft, Atmosphere& atmosphere);
+
+// Same at a given altitude (m) rather than -position.z, for the
+// round-earth model
+AirData computeAirData(const Aircraft& aircraft, Atmosphere& atmosphere, double altitude);
+
+// `specificForce` is the non-gravitational force per unit mass in the
+// body frame (m/s^2); also sets the load factor
+void setSpecificForce(AirData& data, const Vector3& specificForce);
@@ -40,8 +40,12 @@ public:
     
     // Physical properties
     double getMass() const { return mass; }
+    void setMass(double newMass) { mass = newMass; }
+    double getMaxThrust() const { return maxThrust; }
     double getWingArea() const { return wingArea; }
     double getWingSpan() const { return wingSpan; }
+    double getChord() const { return chord; }
+    Vector3 getInertia() const { return Vector3(Ixx, Iyy, Izz); }   // Principal moments, kg m^2
     
     // Aerodynamic coefficients (functions of alpha, beta, controls)
     double getCL(double alpha, double elevator) const;
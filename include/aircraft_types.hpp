@@ -0,0 +1,145 @@
+#pragma once
+#include "aircraft.hpp"
+#include "atmosphere.hpp"
+#include "flight_dynamics.hpp"
+#include <cstddef>
+#include <string>
+
+// Aircraft types as compile-time policies: mass properties and aerodynamic
+// derivatives (per radian, body axes) as constexpr members. Each type gets
+// its own instantiation of the dynamics kernel, so the constants fold into
+// the code and nothing goes through an Aircraft pointer.
+
+// Cessna 172, the values the runtime Aircraft is built from
+struct Cessna172 {
+    static constexpr const char* NAME = "c172";
+    static constexpr const char* DESCRIPTION = "Cessna 172 (the default Aircraft)";
+
+    static constexpr double MASS = 1043.0;          // kg
+    static constexpr double WING_AREA = 16.2;       // m^2
+    static constexpr double WING_SPAN = 11.0;       // m
+    static constexpr double CHORD = 1.47;           // m
+    static constexpr double IXX = 1285.3;           // kg m^2
+    static constexpr double IYY = 1824.9;
+    static constexpr double IZZ = 2666.9;
+    static constexpr double MAX_THRUST = 2000.0;    // N
+
+    // Lift, drag and side force
+    static constexpr double LIFT0 = 0.28;
+    static constexpr double LIFT_ALPHA = 4.58;
+    static constexpr double LIFT_ELEVATOR = 0.36;
+    static constexpr double DRAG0 = 0.027;
+    static constexpr double DRAG_INDUCED = 0.045;
+    static constexpr double SIDE_BETA = -0.393;
+    static constexpr double SIDE_RUDDER = 0.187;
+
+    // Rolling, pitching and yawing moments; damping per normalized rate
+    static constexpr double ROLL_BETA = -0.074;
+    static constexpr double ROLL_AILERON = 0.178;
+    static constexpr double ROLL_RUDDER = 0.0147;
+    static constexpr double ROLL_DAMPING = -0.484;
+    static constexpr double PITCH0 = 0.04;
+    static constexpr double PITCH_ALPHA = -0.613;
+    static constexpr double PITCH_ELEVATOR = -1.122;
+    static constexpr double PITCH_DAMPING = -12.4;
+    static constexpr double YAW_BETA = 0.071;
+    static constexpr double YAW_AILERON = -0.0504;
+    static constexpr double YAW_RUDDER = -0.0805;
+    static constexpr double YAW_DAMPING = -0.125;
+};
+
+// Piper PA-28-161 Warrior, approximate
+struct PiperWarrior {
+    static constexpr const char* NAME = "pa28";
+    static constexpr const char* DESCRIPTION = "Piper PA-28-161 Warrior (approximate)";
+
+    static constexpr double MASS = 1055.0;
+    static constexpr double WING_AREA = 15.8;
+    static constexpr double WING_SPAN = 10.67;
+    static constexpr double CHORD = 1.6;
+    static constexpr double IXX = 1160.0;
+    static constexpr double IYY = 1720.0;
+    static constexpr double IZZ = 2480.0;
+    static constexpr double MAX_THRUST = 1900.0;
+
+    static constexpr double LIFT0 = 0.30;
+    static constexpr double LIFT_ALPHA = 4.80;
+    static constexpr double LIFT_ELEVATOR = 0.38;
+    static constexpr double DRAG0 = 0.028;
+    static constexpr double DRAG_INDUCED = 0.047;
+    static constexpr double SIDE_BETA = -0.38;
+    static constexpr double SIDE_RUDDER = 0.17;
+
+    static constexpr double ROLL_BETA = -0.080;
+    static constexpr double ROLL_AILERON = 0.150;
+    static constexpr double ROLL_RUDDER = 0.012;
+    static constexpr double ROLL_DAMPING = -0.47;
+    static constexpr double PITCH0 = 0.05;
+    static constexpr double PITCH_ALPHA = -0.62;
+    static constexpr double PITCH_ELEVATOR = -1.2;
+    static constexpr double PITCH_DAMPING = -13.0;
+    static constexpr double YAW_BETA = 0.070;
+    static constexpr double YAW_AILERON = -0.040;
+    static constexpr double YAW_RUDDER = -0.070;
+    static constexpr double YAW_DAMPING = -0.11;
+};
+
+// Extra 330, approximate: light, powerful, low static margin
+struct Extra330 {
+    static constexpr const char* NAME = "extra330";
+    static constexpr const char* DESCRIPTION = "Extra 330 aerobatic (approximate)";
+
+    static constexpr double MASS = 750.0;
+    static constexpr double WING_AREA = 10.7;
+    static constexpr double WING_SPAN = 7.5;
+    static constexpr double CHORD = 1.43;
+    static constexpr double IXX = 680.0;
+    static constexpr double IYY = 1130.0;
+    static constexpr double IZZ = 1700.0;
+    static constexpr double MAX_THRUST = 3300.0;
+
+    static constexpr double LIFT0 = 0.0;            // Symmetric airfoil
+    static constexpr double LIFT_ALPHA = 4.40;
+    static constexpr double LIFT_ELEVATOR = 0.45;
+    static constexpr double DRAG0 = 0.030;
+    static constexpr double DRAG_INDUCED = 0.060;
+    static constexpr double SIDE_BETA = -0.45;
+    static constexpr double SIDE_RUDDER = 0.22;
+
+    static constexpr double ROLL_BETA = -0.020;
+    static constexpr double ROLL_AILERON = 0.300;
+    static constexpr double ROLL_RUDDER = 0.010;
+    static constexpr double ROLL_DAMPING = -0.42;
+    static constexpr double PITCH0 = 0.0;
+    static constexpr double PITCH_ALPHA = -0.35;
+    static constexpr double PITCH_ELEVATOR = -1.4;
+    static constexpr double PITCH_DAMPING = -11.0;
+    static constexpr double YAW_BETA = 0.090;
+    static constexpr double YAW_AILERON = -0.020;
+    static constexpr double YAW_RUDDER = -0.110;
+    static constexpr double YAW_DAMPING = -0.14;
+};
+
+// Runtime registry entry: one type's kernel instantiation behind function
+// pointers, looked up by name
+struct AircraftType {
+    const char* name;
+    const char* description;
+    double mass;
+    double wingArea;
+    double wingSpan;
+    double maxThrust;
+
+    // Time derivative at a state, as FlightDynamics::computeDerivative
+    FlightDynamics::StateDerivative (*derivative)(const AircraftState& state, Atmosphere& atmosphere);
+
+    // One RK4 step of `count` independent aircraft of this type. For the
+    // Cessna 172 the states match FlightDynamics::update bit for bit.
+    void (*step)(AircraftState* states, size_t count, Atmosphere& atmosphere, double dt);
+};
+
+// nullptr if no type has this name
+const AircraftType* findAircraftType(const std::string& name);
+
+// All registered types
+const AircraftType* getAircraftTypes(size_t& count);
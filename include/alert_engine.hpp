@@ -0,0 +1,111 @@
+#pragma once
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+enum class AlertType {
+    ALTITUDE_CALLOUT,   // Descended through a height in the callout table
+    SINK_RATE,          // GPWS mode 1: excessive descent rate for the height
+    TERRAIN_CLOSURE,    // GPWS mode 2: terrain closing too fast ("PULL UP")
+    TERRAIN_AHEAD,      // Predicted flight path meets the terrain soon
+    STALL               // Airspeed in the stall warning band
+};
+
+enum class AlertPhase {
+    ONSET,
+    REPEAT,     // Still active; repeated at the mode's interval
+    CLEARED
+};
+
+struct AlertEvent {
+    AlertType type;
+    AlertPhase phase;
+    int aircraft;
+    int calloutFeet;     // ALTITUDE_CALLOUT only
+    double value;        // Sink/closure rate (ft/min), airspeed (m/s) or time to impact (s)
+    double simTime;      // Sim tick the condition was detected on
+    std::chrono::steady_clock::time_point detectTime;
+};
+
+// One aircraft's sample for a sim tick
+struct AlertInputs {
+    double altitude;           // m above sea level
+    double terrainElevation;   // m, terrain under the aircraft
+    double verticalSpeed;      // m/s, positive up
+    double airspeed;           // m/s indicated (the engine holds the stall warning band)
+    double timeToImpact;       // s to terrain along the predicted path, INFINITY if none predicted
+};
+
+// Alerting evaluated once per sim tick per aircraft. Height callouts come
+// from a sorted threshold table: a tick's crossings are found by binary
+// search between the previous and current height, so a fast descent
+// cannot step over a callout between samples. Sink rate and terrain
+// closure limits are piecewise-linear envelopes, also looked up by binary
+// search, so evaluation is O(log n) per aircraft per tick. The lookahead
+// mode uses the time to impact from a flight-path prediction. Events go to
+// the consumer (the audio layer) through a lock-free queue.
+class AlertEngine {
+public:
+    explicit AlertEngine(int aircraftCount = 1);
+
+    // Per-aircraft state is preallocated; resizing forgets previous samples
+    void setAircraftCount(int count);
+    int getAircraftCount() const { return (int)tracks.size(); }
+
+    // Callout heights in feet above terrain (sorted on set)
+    void setCallouts(const std::vector<double>& feet);
+    const std::vector<double>& getCallouts() const { return callouts; }
+
+    // Forget the previous sample and clear active modes (e.g. after a sim reset)
+    void reset(int aircraft);
+    void resetAll();
+
+    // Producer: evaluate one aircraft for the tick ending at `simTime`
+    void evaluate(int aircraft, const AlertInputs& inputs, double simTime);
+
+    // Consumer: next pending event, false when the queue is empty
+    bool poll(AlertEvent& event) { return events.pop(event); }
+
+    uint64_t getDroppedEvents() const { return droppedEvents.load(std::memory_order_relaxed); }
+
+    struct EnvelopePoint {
+        double heightFeet;
+        double rateFpm;     // Alert when the rate exceeds this at the height
+    };
+
+    // Limit at `heightFeet`, interpolated; the envelope must be sorted by height
+    static double envelopeLimit(const std::vector<EnvelopePoint>& envelope, double heightFeet);
+
+private:
+    struct Track {
+        bool hasPrevious;
+        double previousFeet;      // Height above terrain at the previous tick
+        double previousTime;
+        int armedCount;           // Callouts [0, armedCount) may still fire
+        double closureFpm;        // Filtered rate of height-above-terrain loss
+        bool stallActive;
+        bool sinkActive;
+        bool closureActive;
+        bool aheadActive;
+        double lastStallEvent;
+        double lastSinkEvent;
+        double lastClosureEvent;
+        double lastAheadEvent;
+    };
+
+    void emit(AlertType type, AlertPhase phase, int aircraft, int calloutFeet, double value,
+              double simTime);
+    void evaluateCallouts(Track& track, int aircraft, double heightFeet, double simTime);
+    void evaluateMode(bool trigger, bool& active, double& lastEvent, double repeatInterval,
+                      AlertType type, int aircraft, double value, double simTime);
+
+    std::vector<Track> tracks;
+    std::vector<double> callouts;                  // Ascending, feet
+    std::vector<EnvelopePoint> sinkRateEnvelope;   // Mode 1
+    std::vector<EnvelopePoint> closureEnvelope;    // Mode 2
+
+    SpscQueue<AlertEvent, 256> events;
+    std::atomic<uint64_t> droppedEvents;
+};
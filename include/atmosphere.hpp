@@ -1,4 +1,5 @@
 #pragma once
+#include "math_policy.hpp"
 
 class Atmosphere {
 public:
@@ -6,7 +7,20 @@ public:
     
     // Get atmospheric properties at altitude (meters)
     void getProperties(double altitude, double& density, double& pressure, 
-                      double& temperature, double& speedOfSound);
+                      double& temperature, double& speedOfSound) {
+        getPropertiesWith<SimMath>(altitude, density, pressure, temperature, speedOfSound);
+    }
+    
+    // Same with an explicit math policy (instantiated for StdMath and FastMath)
+    template <typename Math>
+    void getPropertiesWith(double altitude, double& density, double& pressure,
+                           double& temperature, double& speedOfSound);
+    
+    // Altitude (meters) at which the standard atmosphere has this density
+    double getDensityAltitude(double density) const;
+    
+    // Altitude (meters) at which the standard atmosphere has this pressure
+    double getPressureAltitude(double pressure) const;
     
 private:
     // ISA (International Standard Atmosphere) constants
@@ -0,0 +1,17 @@
+#pragma once
+#include "audio_system.hpp"
+#include <string>
+
+// ImGui window showing audio pipeline instrumentation: callback duration
+// histogram, underruns/overruns, voice pool usage, synthesizer CPU and
+// alert latency, with export to CSV.
+class AudioDebugPanel {
+public:
+    AudioDebugPanel();
+
+    void render(AudioSystem& audio, bool* open = nullptr);
+
+private:
+    std::string exportPath;
+    std::string exportStatus;
+};
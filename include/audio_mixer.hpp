@@ -0,0 +1,143 @@
+#pragma once
+#include "spsc_queue.hpp"
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Higher priorities may steal voices from lower ones when the pool is full
+enum class AudioPriority {
+    AMBIENT = 0,    // Wind, engine rumble
+    CALLOUT = 1,    // Altitude callouts
+    WARNING = 2     // Stall horn, gear warning
+};
+
+enum class Waveform {
+    SINE,
+    SQUARE
+};
+
+// Identifies a voice started with AudioMixer::play (0 = none)
+using VoiceHandle = uint32_t;
+
+// Fixed-capacity tone mixer. The game thread posts commands through a
+// lock-free SPSC queue; the audio thread applies them and mixes all active
+// voices in render(). Nothing is allocated after construction, so render()
+// is safe to call from a real-time audio callback.
+class AudioMixer {
+public:
+    static constexpr int MAX_VOICES = 32;
+    using Clock = std::chrono::steady_clock;
+
+    AudioMixer();
+
+    // Set the output format; call before the audio thread starts rendering
+    void configure(uint32_t sampleRate, uint32_t channels);
+    uint32_t getSampleRate() const { return sampleRate; }
+    uint32_t getChannels() const { return channels; }
+
+    // --- Game thread ---
+
+    // Start a tone. `group` tags the voice so it can be stopped or adjusted
+    // as a group (the SoundType it was played for). duration <= 0 loops
+    // until stopped. If `detectTime` is set (when the sim detected the
+    // condition), the time until the voice's first sample is mixed is
+    // recorded per priority. Returns 0 if the command queue is full.
+    VoiceHandle play(int group, AudioPriority priority, Waveform waveform, float frequency,
+                     float duration, float volume, Clock::time_point detectTime = Clock::time_point());
+    void stop(VoiceHandle handle);
+    void stopGroup(int group);
+    void stopAll();
+
+    // Volume and pitch multipliers applied to every voice in the group
+    void setGroupVolume(int group, float volume);
+    void setGroupPitch(int group, float pitch);
+
+    // --- Audio thread ---
+
+    // Mix `frameCount` interleaved float frames into `output` (overwrites it)
+    void render(float* output, uint32_t frameCount);
+
+    // --- Either thread ---
+
+    struct Stats {
+        uint32_t activeVoices;
+        uint32_t peakVoices;
+        uint64_t voicesStarted;
+        uint64_t voicesStolen;
+        uint64_t voicesRejected;     // Pool full of higher-priority voices
+        uint64_t commandsDropped;    // Queue full
+    };
+    Stats getStats() const;
+    
+    // Detection-to-first-mixed-sample latency for voices started with a detect time
+    const LatencyHistogram& getAlertLatency(AudioPriority priority) const {
+        return alertLatency[(int)priority];
+    }
+    void resetStats();
+
+    static constexpr int MAX_GROUPS = 32;
+
+private:
+    enum class CommandType { PLAY, STOP, STOP_GROUP, STOP_ALL, GROUP_VOLUME, GROUP_PITCH };
+
+    struct Command {
+        CommandType type;
+        VoiceHandle handle;
+        int group;
+        AudioPriority priority;
+        Waveform waveform;
+        float frequency;
+        float duration;
+        float value;   // Volume, or the group volume/pitch
+        Clock::time_point detectTime;
+    };
+
+    struct Voice {
+        bool active;
+        bool releasing;
+        VoiceHandle handle;
+        int group;
+        AudioPriority priority;
+        Waveform waveform;
+        float frequency;
+        float volume;
+        double phase;          // Cycles, [0, 1)
+        int64_t remaining;     // Frames until release, -1 = loop
+        float envelope;        // Attack/release ramp, avoids clicks
+        uint64_t startOrder;   // For stealing the oldest of equal priority
+        Clock::time_point detectTime;   // Cleared once the first sample is mixed
+    };
+
+    bool post(const Command& command);
+    void applyCommand(const Command& command);
+    void startVoice(const Command& command);
+    Voice* findVoiceToSteal(AudioPriority priority);
+    void mixVoice(Voice& voice, float* output, uint32_t frameCount);
+
+    uint32_t sampleRate;
+    uint32_t channels;
+
+    // Game thread only
+    VoiceHandle nextHandle;
+
+    // Audio thread only
+    Voice voices[MAX_VOICES];
+    float groupVolume[MAX_GROUPS];
+    float groupPitch[MAX_GROUPS];
+    uint64_t startCounter;
+    float envelopeStep;
+
+    SpscQueue<Command, 256> commands;
+
+    std::atomic<uint32_t> activeVoices;
+    std::atomic<uint32_t> peakVoices;
+    std::atomic<uint64_t> voicesStarted;
+    std::atomic<uint64_t> voicesStolen;
+    std::atomic<uint64_t> voicesRejected;
+    std::atomic<uint64_t> commandsDropped;
+    
+    LatencyHistogram alertLatency[3];
+
+    static constexpr float ENVELOPE_SECONDS = 0.005f;
+};
@@ -1,12 +1,18 @@
 #pragma once
+#include "alert_engine.hpp"
+#include "audio_mixer.hpp"
+#include "engine_synth.hpp"
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
-#include <map>
-#include <vector>
 
 // Forward declare miniaudio types
 struct ma_engine;
 struct ma_sound;
 struct ma_decoder;
+struct ma_device;
 
 enum class SoundType {
     ENGINE,
@@ -22,7 +28,11 @@ enum class SoundType {
     TERRAIN_20,
     TERRAIN_10,
     WIND_AMBIENT,
-    GEAR_WARNING
+    GEAR_WARNING,
+    SINK_RATE,
+    PULL_UP,
+    TERRAIN_AHEAD,
+    COUNT
 };
 
 class AudioSystem {
@@ -33,6 +43,17 @@ public:
     bool initialize();
     void shutdown();
     
+    // Offline mode: the same mixer and synthesizer graph with no audio
+    // device. Audio advances only as renderOffline() pulls frames, so a
+    // caller driving update() and processAlerts() per sim step gets
+    // deterministic output.
+    bool initializeOffline(uint32_t sampleRate = 48000, uint32_t channels = 2);
+    bool renderOffline(float* output, uint32_t frameCount);
+    bool isOffline() const { return offline; }
+    
+    uint32_t getSampleRate() const;
+    uint32_t getChannels() const;
+    
     // Load a sound file
     bool loadSound(SoundType type, const std::string& filepath);
     
@@ -53,8 +74,38 @@ public:
     // Check if sound is playing
     bool isPlaying(SoundType type);
     
-    // Update function (call each frame)
-    void update(double throttle, double airspeed, double altitude, bool isStalling);
+    // Engine and airflow sound (call each frame)
+    void update(double throttle, double airspeed);
+    
+    // Play the alerts the engine has queued since the last call
+    void processAlerts(AlertEngine& alerts);
+    
+    // Voice pool counters
+    AudioMixer::Stats getMixerStats() const { return mixer.getStats(); }
+    
+    // Engine/airflow synthesizer CPU cost per audio buffer
+    EngineSynth::Stats getSynthStats() const { return synth.getStats(); }
+    
+    // Audio pipeline instrumentation
+    struct PipelineStats {
+        uint64_t callbacks;
+        uint64_t underruns;       // Device callback arrived over two periods after the previous one
+        uint64_t overruns;        // Callback took longer than its buffer's playback time
+        double bufferMs;          // Playback time of the last buffer
+        double outputLatencyMs;   // Device buffering after the mix (estimate)
+    };
+    PipelineStats getPipelineStats() const;
+    
+    // Duration of each audio callback (engine graph read), microseconds
+    const LatencyHistogram& getCallbackHistogram() const { return callbackHistogram; }
+    
+    // Sim detection (alert event) to first mixed sample, per alert priority
+    const LatencyHistogram& getAlertLatency(AudioPriority priority) const {
+        return mixer.getAlertLatency(priority);
+    }
+    
+    void resetStats();
+    bool exportStats(const std::string& path) const;
     
 private:
     struct Sound {
@@ -68,15 +119,39 @@ private:
     
     void* enginePtr;  // Will be ma_engine*
     void* devicePtr;  // Will be ma_device* 
+    void* mixerSourcePtr;  // Data source feeding the mixer into the engine
+    void* mixerSoundPtr;   // Will be ma_sound*
+    void* synthSourcePtr;  // Data source feeding the engine synthesizer
+    void* synthSoundPtr;
     bool initialized;
+    bool offline;
+    
+    Sound sounds[(int)SoundType::COUNT];
+    
+    // Synthetic tones; voices are preallocated and fed by a command queue
+    AudioMixer mixer;
+    
+    // Continuous engine, propeller and wind sound
+    EngineSynth synth;
+    
+    // Instrumentation (written by the audio thread)
+    LatencyHistogram callbackHistogram;
+    std::atomic<uint64_t> callbacks;
+    std::atomic<uint64_t> underruns;
+    std::atomic<uint64_t> overruns;
+    std::atomic<double> bufferMs;
+    std::atomic<double> outputLatencyMs;
+    std::chrono::steady_clock::time_point lastCallbackStart;
     
-    std::map<SoundType, Sound> sounds;
+    bool initializeEngine(const void* engineConfig);   // ma_engine_config*, null = default device
     
-    // State tracking for alerts
-    bool stallWarningActive;
-    double lastTerrainCallout;
-    double terrainCalloutCooldown;
+    // Device data callback: pulls the engine graph and times it
+    static void deviceCallback(ma_device* device, void* output, const void* input, uint32_t frameCount);
+    void readEngine(float* output, uint32_t frameCount, bool fromDevice);
     
-    // Play a beep tone
-    void playBeep(float frequency, float duration, float volume);
+    // Play a beep tone on a pooled voice; detectTime feeds the alert latency stats
+    void playBeep(SoundType type, float frequency, float duration, float volume,
+                  AudioMixer::Clock::time_point detectTime = AudioMixer::Clock::time_point());
+    void playAlert(const AlertEvent& event);
+    static AudioPriority priorityFor(SoundType type);
 };
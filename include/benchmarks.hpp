@@ -0,0 +1,6 @@
+#pragma once
+#include <string>
+
+// Headless micro-benchmarks, run with: flight_simulator --bench <name>
+// "list" prints the available names. Returns a process exit code.
+int runBenchmark(const std::string& name);
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Continuous procedural engine and airflow sound:
+//  - propeller harmonics (shaft orders 1-8, blade-pass orders emphasised)
+//  - engine firing pulses, modulated at cam rate, low-pass filtered
+//  - stereo wind noise band-passed with airspeed-dependent cutoff, plus rumble
+// Oscillators and pulse shaping run four samples at a time; the noise
+// filters run four independent channels per SIMD lane. Parameters are set
+// from the game thread through atomics and smoothed on the audio thread,
+// so render() never locks or allocates.
+class EngineSynth {
+public:
+    static constexpr int HARMONICS = 8;
+
+    // CPU budget per buffer, as a fraction of the buffer's playback time
+    static constexpr double CPU_BUDGET_FRACTION = 0.02;
+
+    EngineSynth();
+
+    // Set the output format; call before the audio thread starts rendering
+    void configure(uint32_t sampleRate, uint32_t channels);
+    uint32_t getSampleRate() const { return sampleRate; }
+    uint32_t getChannels() const { return channels; }
+
+    // --- Game thread ---
+    void setParameters(float rpm, float throttle, float airspeed);
+    void setVolume(float volume);
+
+    // --- Audio thread ---
+    // Write `frameCount` interleaved float frames (overwrites the buffer)
+    void render(float* output, uint32_t frameCount);
+
+    // --- Either thread ---
+    struct Stats {
+        double lastUs;         // CPU time of the last buffer
+        double meanUs;         // Smoothed
+        double maxUs;
+        double budgetUs;       // Budget for the last buffer
+        uint64_t buffers;
+        uint64_t overBudget;   // Buffers that exceeded the budget
+    };
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    static constexpr int CHUNK = 128;   // Frames per parameter update
+
+    void renderChunk(float* output, int frames);
+
+    uint32_t sampleRate;
+    uint32_t channels;
+
+    // Targets written by the game thread
+    std::atomic<float> targetRpm;
+    std::atomic<float> targetThrottle;
+    std::atomic<float> targetAirspeed;
+    std::atomic<float> targetVolume;
+
+    // Smoothed parameters (audio thread)
+    float rpm;
+    float throttle;
+    float airspeed;
+    float volume;
+    float smoothing;   // Per-chunk approach factor
+
+    // Oscillator and filter state (audio thread)
+    double harmonicPhase[HARMONICS];   // Radians
+    double camPhase;                   // Radians
+    double firingPhase;                // Cycles, [0, 1)
+    alignas(16) uint32_t noiseState[4];
+    alignas(16) float filterLow[4];
+    alignas(16) float filterBand[4];
+
+    std::atomic<double> lastUs;
+    std::atomic<double> meanUs;
+    std::atomic<double> maxUs;
+    std::atomic<double> budgetUs;
+    std::atomic<uint64_t> buffers;
+    std::atomic<uint64_t> overBudget;
+};
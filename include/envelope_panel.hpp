@@ -0,0 +1,33 @@
+#pragma once
+#include "flight_envelope.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+
+// ImGui heat map of a flight-envelope map: altitude against airspeed for
+// one weight, colored by the selected metric, with per-cell tooltips.
+// Generation runs on a background thread so the frame loop keeps going.
+class EnvelopePanel {
+public:
+    EnvelopePanel();
+    ~EnvelopePanel();
+
+    EnvelopePanel(const EnvelopePanel&) = delete;
+    EnvelopePanel& operator=(const EnvelopePanel&) = delete;
+
+    void render(bool* open = nullptr);
+
+private:
+    void startGeneration();
+    void drawHeatMap();
+
+    FlightEnvelope envelope;   // Shown
+    FlightEnvelope pending;    // Written by the worker until `ready`
+    std::thread worker;
+    std::atomic<bool> ready;
+    bool generating;
+
+    int metric;
+    int weightIndex;
+    std::string status;
+};
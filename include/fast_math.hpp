@@ -0,0 +1,247 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Polynomial approximations of the elementary functions on the dynamics
+// hot path: shorter dependency chains than libm, a few ulp less accurate.
+// Maximum error against libm, checked by `--bench fast-math`:
+//
+//   sin, cos   |x| <= 1e5       absolute 2e-14
+//   tan        |x| <= 1.5       relative 3e-14
+//   exp        [-708, 709]      relative 1.5e-14
+//   log        normal x > 0     absolute 5e-15 + 2.3e-16 |log x| (1 ulp), log(1) = 0
+//   pow        x > 0            relative 1e-14 + 4e-15 |y| + 2e-16 |y log x|
+//   atan2      finite x, y      absolute 1e-15
+//
+// Special values are not handled beyond what the simulation needs: exp
+// saturates at the ends of its range, log and pow expect positive finite
+// input, atan2(0, 0) is 0. The batched sincos, exp and atan2 use SSE2 where
+// available and give bitwise the same results as the scalar versions
+// (without FMA contraction).
+namespace fastmath {
+
+namespace detail {
+
+// Adding then subtracting 1.5 * 2^52 rounds to the nearest integer, which
+// also ends up in the low mantissa bits of the sum
+constexpr double ROUND_MAGIC = 6755399441055744.0;
+
+constexpr double TWO_OVER_PI = 0.63661977236758134308;
+constexpr double PI_OVER_4 = 0.78539816339744830962;
+constexpr double PI_OVER_2_HI = 1.57079632673412561417;     // First 33 bits
+constexpr double PI_OVER_2_LO = 6.07710050650619224932e-11;
+
+constexpr double LOG2E = 1.44269504088896338700;
+constexpr double LN2_HI = 6.93147180369123816490e-01;       // First 32 bits
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+
+constexpr double PI = 3.14159265358979311600;
+constexpr double PI_OVER_2 = 1.57079632679489655800;
+
+constexpr double EXP_MIN = -708.0;
+constexpr double EXP_MAX = 709.0;
+
+// Near-minimax fits (interpolation at Chebyshev nodes):
+//   sin r = r + r^3 S(r^2),  cos r = 1 + r^2 C(r^2)   for |r| <= pi/4
+//   e^r = 1 + r + r^2 E(r)                            for |r| <= ln2/128
+//   log(1 + r) = r + r^2 L(r)                         for |r| <= 1/128
+// and the Taylor series for atan r = r + r^3 A(r^2), |r| <= 1/32, whose
+// first omitted term is below 3e-18
+constexpr double SIN_COEFFICIENTS[] = {
+    -1.66666666666638846e-01, 8.33333333107922312e-03, -1.98412669169859658e-04,
+    2.75559909295653188e-06, -2.48056362418347625e-08
+};
+constexpr double COS_COEFFICIENTS[] = {
+    -4.99999999999999667e-01, 4.16666666666309291e-02, -1.38888888821279521e-03,
+    2.48015826233519498e-05, -2.75558555119295075e-07, 2.06655048701227406e-09
+};
+constexpr double EXP_COEFFICIENTS[] = {
+    5.00000000000000000e-01, 1.66666853628939821e-01, 4.16666978270413615e-02
+};
+constexpr double LOG_COEFFICIENTS[] = {
+    -4.99999999919234717e-01, 3.33333333264105858e-01, -2.50010377417831109e-01,
+    2.00008894943030702e-01
+};
+constexpr double ATAN_COEFFICIENTS[] = {
+    -1.0 / 3.0, 1.0 / 5.0, -1.0 / 7.0, 1.0 / 9.0
+};
+
+// exp steps in ln2/64: 2^(j/64) for j = 0..63 (fast_math.cpp)
+constexpr int EXP_TABLE_BITS = 6;
+extern const double EXP_TABLE[1 << EXP_TABLE_BITS];
+
+// atan steps in 1/16: atan(j/16) for j = 0..16 (fast_math.cpp)
+constexpr int ATAN_TABLE_BITS = 4;
+extern const double ATAN_TABLE[(1 << ATAN_TABLE_BITS) + 1];
+
+// log splits the mantissa into 64 subintervals centred on c = 1 + j/64:
+// 1/c rounded, and -log of that rounded value (fast_math.cpp)
+struct LogTableEntry {
+    double invc;
+    double logc;
+};
+constexpr int LOG_TABLE_BITS = 6;
+extern const LogTableEntry LOG_TABLE[1 << LOG_TABLE_BITS];
+
+// Short polynomials, Estrin form where it shortens the dependency chain.
+// Templated on the value type so the SSE2 lanes in fast_math.cpp run the
+// identical sequence.
+template <typename T>
+inline T sinPoly(T z) {
+    const double* c = SIN_COEFFICIENTS;
+    T z2 = z * z;
+    return (T(c[0]) + z * T(c[1])) + z2 * ((T(c[2]) + z * T(c[3])) + z2 * T(c[4]));
+}
+
+template <typename T>
+inline T cosPoly(T z) {
+    const double* c = COS_COEFFICIENTS;
+    T z2 = z * z;
+    T z4 = z2 * z2;
+    return ((T(c[0]) + z * T(c[1])) + z2 * (T(c[2]) + z * T(c[3]))) + z4 * (T(c[4]) + z * T(c[5]));
+}
+
+template <typename T>
+inline T expPoly(T r) {
+    const double* c = EXP_COEFFICIENTS;
+    return T(c[0]) + r * (T(c[1]) + r * T(c[2]));
+}
+
+template <typename T>
+inline T logPoly(T r) {
+    const double* c = LOG_COEFFICIENTS;
+    T r2 = r * r;
+    return (T(c[0]) + r * T(c[1])) + r2 * (T(c[2]) + r * T(c[3]));
+}
+
+template <typename T>
+inline T atanPoly(T z) {
+    const double* c = ATAN_COEFFICIENTS;
+    T z2 = z * z;
+    return (T(c[0]) + z * T(c[1])) + z2 * (T(c[2]) + z * T(c[3]));
+}
+
+inline uint64_t bitsOf(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double fromBits(uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+} // namespace detail
+
+inline void sincos(double x, double& s, double& c) {
+    using namespace detail;
+    // Most attitude and flow angles need no reduction
+    if (std::fabs(x) <= PI_OVER_4) {
+        double x2 = x * x;
+        s = x + x * x2 * sinPoly(x2);
+        c = 1.0 + x2 * cosPoly(x2);
+        return;
+    }
+
+    double t = x * TWO_OVER_PI + ROUND_MAGIC;
+    double k = t - ROUND_MAGIC;
+    double r = (x - k * PI_OVER_2_HI) - k * PI_OVER_2_LO;
+    double r2 = r * r;
+    uint64_t sr = bitsOf(r + r * r2 * sinPoly(r2));
+    uint64_t cr = bitsOf(1.0 + r2 * cosPoly(r2));
+
+    // Odd quadrants swap sin and cos; sin is negative in quadrants 2-3,
+    // cos in quadrants 1-2. Done on the bits to stay branch-free.
+    uint64_t quadrant = bitsOf(t);
+    uint64_t swap = 0 - (quadrant & 1);
+    s = fromBits(((cr & swap) | (sr & ~swap)) ^ ((quadrant & 2) << 62));
+    c = fromBits(((sr & swap) | (cr & ~swap)) ^ (((quadrant + 1) & 2) << 62));
+}
+
+inline double sin(double x) {
+    double s, c;
+    sincos(x, s, c);
+    return s;
+}
+
+inline double cos(double x) {
+    double s, c;
+    sincos(x, s, c);
+    return c;
+}
+
+inline double tan(double x) {
+    double s, c;
+    sincos(x, s, c);
+    return s / c;
+}
+
+inline double exp(double x) {
+    using namespace detail;
+    // x = (64 q + j) ln2/64 + r, e^x = 2^q * 2^(j/64) * e^r
+    x = x < EXP_MIN ? EXP_MIN : (x > EXP_MAX ? EXP_MAX : x);
+    double t = x * (LOG2E * (1 << EXP_TABLE_BITS)) + ROUND_MAGIC;
+    double k = t - ROUND_MAGIC;
+    double r = (x - k * (LN2_HI / (1 << EXP_TABLE_BITS))) - k * (LN2_LO / (1 << EXP_TABLE_BITS));
+    uint64_t n = bitsOf(t) - bitsOf(ROUND_MAGIC);
+    uint64_t mask = (1 << EXP_TABLE_BITS) - 1;
+    double scale = fromBits(bitsOf(EXP_TABLE[n & mask]) + ((n & ~mask) << (52 - EXP_TABLE_BITS)));
+    return scale * (1.0 + r + r * r * expPoly(r));
+}
+
+inline double log(double x) {
+    using namespace detail;
+    // x = 2^e * m with m in [1 - 1/128, 2 - 1/128), and m = c (1 + r) for
+    // the table centre c nearest m, so no division and only a short
+    // polynomial. Rounding the mantissa to the nearest centre may carry
+    // into the exponent. Around x = 1, c = 1 and log(1) is exactly 0.
+    uint64_t bits = bitsOf(x);
+    uint64_t rounded = bits + (1ull << (51 - LOG_TABLE_BITS));
+    int64_t exponent = (int64_t)(rounded >> 52) - 1023;
+    const LogTableEntry& entry = LOG_TABLE[(rounded >> (52 - LOG_TABLE_BITS)) & ((1 << LOG_TABLE_BITS) - 1)];
+    double m = fromBits(bits - ((uint64_t)exponent << 52));
+    double r = m * entry.invc - 1.0;
+
+    // e ln2 + log c rounds to hi; its error lo is exact (|e ln2| >= log c
+    // unless e = 0) and joins the small terms, so the result rounds once
+    double e = (double)exponent;
+    double a = e * LN2_HI;
+    double hi = a + entry.logc;
+    double lo = (a - hi) + entry.logc;
+    return hi + (r + r * r * logPoly(r) + (e * LN2_LO + lo));
+}
+
+inline double pow(double x, double y) {
+    return exp(y * log(x));
+}
+
+inline double atan2(double y, double x) {
+    using namespace detail;
+    // Reduced to atan(t), t = min/max of |y|, |x| in [0, 1], then to the
+    // table point c = j/16 nearest t: atan t = atan c + atan r with
+    // r = (t - c) / (1 + t c), formed from |y| and |x| directly
+    double ay = std::fabs(y), ax = std::fabs(x);
+    bool swap = ay > ax;
+    double num = swap ? ax : ay;
+    double den = swap ? ay : ax;
+    double t = den > 0.0 ? num / den : 0.0;
+    double k = t * (1 << ATAN_TABLE_BITS) + ROUND_MAGIC;
+    double c = (k - ROUND_MAGIC) * (1.0 / (1 << ATAN_TABLE_BITS));
+    double r = den > 0.0 ? (num - c * den) / (den + c * num) : 0.0;
+    double z = r * r;
+    double a = ATAN_TABLE[bitsOf(k) - bitsOf(ROUND_MAGIC)] + (r + r * z * atanPoly(z));
+    a = swap ? PI_OVER_2 - a : a;
+    a = x < 0.0 ? PI - a : a;
+    return fromBits(bitsOf(a) | (bitsOf(y) & 0x8000000000000000ull));
+}
+
+// Batched versions, two lanes per instruction with SSE2
+void sincos(const double* x, double* s, double* c, size_t count);
+void exp(const double* x, double* out, size_t count);
+void atan2(const double* y, const double* x, double* out, size_t count);
+
+} // namespace fastmath
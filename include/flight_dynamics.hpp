@@ -1,24 +1,65 @@
 #pragma once
+#include "air_data.hpp"
 #include "aircraft.hpp"
 #include "atmosphere.hpp"
+#include "geodesy.hpp"
+#include "math_policy.hpp"
+#include <cstdint>
 
 class FlightDynamics {
 public:
     FlightDynamics(Aircraft* aircraft, Atmosphere* atmosphere);
     
     // Update aircraft state (RK4 integration)
-    void update(double dt);
+    void update(double dt) { updateWith<SimMath>(dt); }
+    
+    // Same with an explicit math policy (instantiated for StdMath and FastMath)
+    template <typename Math>
+    void updateWith(double dt);
     
     // Reset to initial conditions
     void reset();
     
-private:
-    Aircraft* aircraft;
-    Atmosphere* atmosphere;
+    // Air data for the current state, refreshed by update() and reset()
+    const AirData& getAirData() const { return airData; }
     
-    // Calculate forces and moments
-    Vector3 calculateForces(const AircraftState& state);
-    Vector3 calculateMoments(const AircraftState& state);
+    // Recompute air data after the state was set from outside (e.g. replay)
+    void updateAirData();
+    
+    // Rolling hash of the state after every update() (see state_hash.hpp),
+    // for finding the first step where two runs diverge. On by default in
+    // FLIGHT_DETERMINISTIC builds. reset() restarts it; so does
+    // resetStateHash() after the state was set from outside.
+    void setStateHashing(bool enabled) { stateHashing = enabled; }
+    bool isStateHashing() const { return stateHashing; }
+    void resetStateHash();
+    uint64_t getStateHash() const { return stateHash; }
+    uint64_t getHashedSteps() const { return hashedSteps; }
+    
+    // Round-earth mode: with a frame set, position is in that frame's
+    // (fixed, origin-tangent) NED axes over the WGS-84 ellipsoid instead of
+    // flat-earth NED. Attitude is then relative to the local level at the
+    // aircraft, gravity varies with latitude and height, the atmosphere and
+    // air data use the height above the ellipsoid, and the ground is the
+    // ellipsoid surface; read altitude from getAirData(), since -position.z
+    // drops away from it with distance (about 80 m at 32 km). The earth is
+    // not rotating. Heading is relative to north, which is undefined at the
+    // poles, so this is not a polar model: a frame whose origin is within
+    // 1 deg of a pole is refused (false, the previous frame kept). A flight
+    // that still passes within a few metres of a pole keeps finite rates
+    // but picks up a heading error there. nullptr (the default) is the
+    // flat-earth model, bitwise unchanged. The frame must outlive its use
+    // here.
+    bool setEarthFrame(const NedFrame* frame);
+    const NedFrame* getEarthFrame() const { return earthFrame; }
+    
+    // Height of a state above the ground in this model: the ellipsoid in
+    // round-earth mode, -position.z on the flat earth (for the current
+    // state it is getAirData().altitude). isOnGround() is the test update()
+    // stops the aircraft at, allowing the frame's round-off (a micrometre)
+    // after it was put back on the ellipsoid.
+    double altitudeOf(const AircraftState& state) const;
+    bool isOnGround(const AircraftState& state) const;
     
     // State derivative for integration
     struct StateDerivative {
@@ -28,7 +69,54 @@ private:
         Vector3 eulerDot;
     };
     
-    StateDerivative computeDerivative(const AircraftState& state);
+    // Time derivative at an arbitrary state (also used for trim analysis)
+    StateDerivative computeDerivative(const AircraftState& state) {
+        return computeDerivativeWith<SimMath>(state);
+    }
+    
+    template <typename Math>
+    StateDerivative computeDerivativeWith(const AircraftState& state);
+    
+private:
+    Aircraft* aircraft;
+    Atmosphere* atmosphere;
+    AirData airData;
+    const NedFrame* earthFrame;
+    
+    // Where the state being evaluated is over the earth: refreshed for each
+    // derivative and by updateAirData()
+    struct LocalEarth {
+        double altitude;             // m, atmosphere and air data
+        double gravity;              // m/s^2
+        Matrix<3, 3> levelToFrame;   // Local NED to earthFrame axes (round earth only)
+        double sinLatitude, cosLatitude;
+    } local;
+    
+    bool stateHashing;
+    uint64_t stateHash;
+    uint64_t hashedSteps;
+    
+    void updateLocalEarth(const AircraftState& state);
+    
+    // What the force and moment models share within one derivative: the
+    // dynamic pressure (one atmosphere lookup), the aerodynamic angles, and
+    // the sines and cosines of the attitude and alpha taken together (one
+    // batched sincos under FastMath)
+    struct Stage {
+        enum { ROLL, PITCH, YAW, ALPHA };
+        double q;
+        double alpha, beta;
+        double sines[4], cosines[4];
+    };
+    
+    // Calculate forces and moments
+    template <typename Math> Vector3 calculateForces(const AircraftState& state, const Stage& stage);
+    // Aerodynamic and thrust force only (no gravity), for dynamic pressure q
+    template <typename Math>
+    Vector3 calculateAeroForces(const AircraftState& state, double q, double alpha, double beta,
+                                double sinAlpha, double cosAlpha);
+    template <typename Math> Vector3 calculateMoments(const AircraftState& state, const Stage& stage);
+    Vector3 calculateGravity(const Stage& stage);
     
     // RK4 integration helpers
     AircraftState addScaledDerivative(const AircraftState& state, 
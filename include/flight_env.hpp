@@ -0,0 +1,118 @@
+#pragma once
+#include "aircraft.hpp"
+#include "atmosphere.hpp"
+#include "flight_dynamics.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+struct FlightEnvConfig {
+    double dt = 0.02;                  // Agent step (s)
+    int substeps = 20;                 // Physics steps per agent step (1 kHz)
+    double maxEpisodeSeconds = 120.0;  // Episodes are truncated here
+    uint64_t seed = 1;                 // Initial-condition random streams
+
+    // Task: hold altitude, airspeed and heading, wings level
+    double targetAltitude = 1000.0;    // m
+    double targetAirspeed = 50.0;      // m/s true
+    double targetHeading = 0.0;        // rad
+    double crashPenalty = 100.0;       // Subtracted from the reward on ground impact
+    const NedFrame* earthFrame = nullptr;  // Round-earth mode for every instance (FlightDynamics::setEarthFrame)
+
+    unsigned int threads = 0;          // Including the calling thread; 0 = one per hardware thread
+};
+
+// N independent aircraft behind a gym-style vector-environment interface,
+// for training controllers on the flight model. All buffers belong to the
+// caller and are contiguous, instance-major (instance i's observation is
+// observations[i * OBSERVATION_SIZE ...]); nothing is allocated after
+// construction. Instances are stepped in blocks across a thread pool.
+//
+// An instance whose episode ends (ground impact, where FlightDynamics
+// stops the aircraft, or the time limit) is reset within the same
+// step: its done flag is set, its reward is the final one, and the
+// observation returned is the first of the next episode. Initial
+// conditions come from counter-based random streams keyed by (seed,
+// instance, episode), so results do not depend on the thread count.
+class FlightEnvBatch {
+public:
+    enum Observation {
+        OBS_ALTITUDE_ERROR,      // (altitude - target) / 100 m
+        OBS_VERTICAL_SPEED,      // / 10 m/s, positive up
+        OBS_AIRSPEED_ERROR,      // (TAS - target) / 10 m/s
+        OBS_ALPHA,               // rad
+        OBS_BETA,                // rad
+        OBS_ROLL,                // rad
+        OBS_PITCH,               // rad
+        OBS_HEADING_ERROR,       // rad, wrapped to [-pi, pi]
+        OBS_ROLL_RATE,           // rad/s
+        OBS_PITCH_RATE,
+        OBS_YAW_RATE,
+        OBS_THROTTLE,            // Current setting, 0..1
+        OBSERVATION_SIZE
+    };
+
+    // Elevator, aileron and rudder in [-1, 1], throttle in [0, 1]; values
+    // outside (or NaN) are clamped
+    enum Action {
+        ACTION_ELEVATOR,
+        ACTION_AILERON,
+        ACTION_RUDDER,
+        ACTION_THROTTLE,
+        ACTION_SIZE
+    };
+
+    enum Done : uint8_t {
+        DONE_NONE = 0,
+        DONE_CRASHED = 1,        // Ground impact (terminal)
+        DONE_TIME_LIMIT = 2      // maxEpisodeSeconds reached (truncated)
+    };
+
+    explicit FlightEnvBatch(size_t count, const FlightEnvConfig& config = FlightEnvConfig());
+
+    FlightEnvBatch(const FlightEnvBatch&) = delete;
+    FlightEnvBatch& operator=(const FlightEnvBatch&) = delete;
+
+    size_t size() const { return count; }
+    const FlightEnvConfig& getConfig() const { return config; }
+    unsigned int getThreadCount() const { return pool.getThreadCount(); }
+
+    // Start a new episode in every instance; observations: size() x OBSERVATION_SIZE
+    void reset(float* observations);
+
+    // actions: size() x ACTION_SIZE in; observations, rewards (size()) and
+    // dones (size(), Done values) out
+    void step(const float* actions, float* observations, float* rewards, uint8_t* dones);
+
+    const AircraftState& getState(size_t index) const { return instances[index].aircraft.getState(); }
+
+    // Totals over all instances since construction
+    uint64_t getStepCount() const;
+    uint64_t getEpisodeCount() const;
+    uint64_t getCrashCount() const;
+
+private:
+    struct Instance {
+        Aircraft aircraft;
+        Atmosphere atmosphere;
+        FlightDynamics dynamics;
+        uint64_t episode;        // Episodes started
+        uint64_t episodeSteps;   // Agent steps in the current episode
+        uint64_t steps;
+        uint64_t crashes;
+
+        Instance() : dynamics(&aircraft, &atmosphere), episode(0), episodeSteps(0), steps(0), crashes(0) {}
+    };
+
+    void resetInstance(size_t index);
+    void observe(size_t index, float* observation) const;
+    float computeReward(size_t index) const;
+    void stepInstance(size_t index, const float* action, float* observation, float* reward, uint8_t* done);
+
+    FlightEnvConfig config;
+    uint64_t maxEpisodeSteps;
+    size_t count;
+    std::unique_ptr<Instance[]> instances;   // Fixed addresses: FlightDynamics points into each
+    ThreadPool pool;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Evenly spaced grid axis
+struct EnvelopeAxis {
+    double min;
+    double max;
+    int count;
+
+    double value(int index) const {
+        return count > 1 ? min + (max - min) * index / (count - 1) : min;
+    }
+};
+
+struct EnvelopeGrid {
+    EnvelopeAxis weight;     // Aircraft mass, kg
+    EnvelopeAxis altitude;   // m
+    EnvelopeAxis airspeed;   // True airspeed, m/s
+
+    static EnvelopeGrid standard();
+    size_t cellCount() const { return (size_t)weight.count * altitude.count * airspeed.count; }
+};
+
+// Performance at one (weight, altitude, airspeed) point. Values that do not
+// exist at the point (e.g. turn performance where level flight cannot be
+// trimmed) are NaN.
+struct EnvelopeCell {
+    uint8_t trimmed;          // Level 1 g trim within control and stall limits
+    float trimAlpha;          // rad
+    float trimElevator;       // -1 to 1
+    float trimThrottle;       // 0 to 1
+    float stallMargin;        // Airspeed / 1 g stall speed
+    float maxRateOfClimb;     // m/s at full throttle (negative: cannot hold altitude)
+    float maxLoadFactor;      // Sustained level turn
+    float turnRate;           // rad/s at maxLoadFactor
+    float turnRadius;         // m at maxLoadFactor
+};
+
+// Flight-envelope map: trim feasibility, stall margin, climb and sustained
+// turn performance over a weight x altitude x airspeed grid. Every point is
+// trimmed with FlightDynamics::computeDerivative on the Aircraft coefficient
+// model; (weight, altitude) rows are spread over a thread pool.
+class FlightEnvelope {
+public:
+    enum Metric {
+        METRIC_TRIMMED,
+        METRIC_TRIM_ALPHA,
+        METRIC_TRIM_ELEVATOR,
+        METRIC_TRIM_THROTTLE,
+        METRIC_STALL_MARGIN,
+        METRIC_RATE_OF_CLIMB,
+        METRIC_LOAD_FACTOR,
+        METRIC_TURN_RATE,
+        METRIC_TURN_RADIUS,
+        METRIC_COUNT
+    };
+
+    // Stall angle of attack assumed by the map; the coefficient model itself
+    // is linear in alpha and has no stall
+    static constexpr double STALL_ALPHA = 16.0 * 3.14159265358979323846 / 180.0;
+    // Structural limit for the sustained turn search (normal category)
+    static constexpr double LOAD_FACTOR_LIMIT = 3.8;
+
+    // Evaluate every cell; threadCount 0 = one per hardware thread
+    void generate(const EnvelopeGrid& grid, unsigned int threadCount = 0);
+
+    bool empty() const { return cells.empty(); }
+    const EnvelopeGrid& getGrid() const { return grid; }
+    const EnvelopeCell& at(int weight, int altitude, int airspeed) const {
+        return cells[((size_t)weight * grid.altitude.count + altitude) * grid.airspeed.count + airspeed];
+    }
+
+    // Wall-clock time and threads used by the last generate()
+    double getGenerateSeconds() const { return generateSeconds; }
+    unsigned int getThreadCount() const { return threadsUsed; }
+
+    static const char* metricName(Metric metric);
+    static float metricValue(const EnvelopeCell& cell, Metric metric);   // Display units
+
+    // Compact native-endian binary table (header, then packed cells) and CSV
+    bool saveBinary(const std::string& path) const;
+    bool loadBinary(const std::string& path);
+    bool saveCSV(const std::string& path) const;
+
+private:
+    EnvelopeGrid grid = EnvelopeGrid::standard();
+    std::vector<EnvelopeCell> cells;
+    double generateSeconds = 0.0;
+    unsigned int threadsUsed = 0;
+};
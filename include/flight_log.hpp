@@ -0,0 +1,31 @@
+#pragma once
+#include "aircraft.hpp"
+#include <string>
+#include <vector>
+
+struct FlightLogSample {
+    double time;            // Sim time, s
+    AircraftState state;    // Full state including control inputs
+};
+
+// Recorded flight: one sample per physics step. Saved as CSV with full
+// double precision so a replay reproduces the recorded states exactly.
+class FlightLog {
+public:
+    void clear() { samples.clear(); }
+    void reserve(size_t count) { samples.reserve(count); }
+
+    void record(double time, const AircraftState& state);
+
+    size_t size() const { return samples.size(); }
+    bool empty() const { return samples.empty(); }
+    const FlightLogSample& operator[](size_t index) const { return samples[index]; }
+    const std::vector<FlightLogSample>& getSamples() const { return samples; }
+    double getDuration() const;
+
+    bool saveCSV(const std::string& path) const;
+    bool loadCSV(const std::string& path);
+
+private:
+    std::vector<FlightLogSample> samples;
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include "aircraft.hpp"
+#include "geodesy.hpp"
+#include "triple_buffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+struct PredictorConfig {
+    double horizon = 30.0;            // s ahead
+    double step = 0.02;               // s, midpoint (RK2) step
+    double rate = 10.0;               // Predictions per second at most
+    double terrainElevation = 0.0;    // m; the sim's terrain is flat
+    const NedFrame* earthFrame = nullptr;   // The sim's round-earth frame, if it flies one
+};
+
+// Trajectory from one aircraft state with its control inputs held
+struct PredictedPath {
+    static constexpr int MAX_POINTS = 256;
+
+    double simTime;               // Sim time of the state it starts from
+    uint64_t epoch;               // Discontinuity count when it was requested
+    int count;
+    double pointInterval;         // s between points
+    Vector3 points[MAX_POINTS];   // NED; points[0] is the start state
+    double timeToImpact;          // s after simTime to ground contact, INFINITY if none within the horizon
+    Vector3 impactPoint;
+    double computeMicroseconds;
+};
+
+// Predicts the flight path ahead on a worker thread, for lookahead
+// warnings and display. The main thread hands over the current state with
+// submit() and picks up the newest finished path with getLatest(); both go
+// through triple buffers, so the main thread never waits on the worker.
+// The worker wakes at most `rate` times a second, predicts from the newest
+// state submitted since its last run (nothing if there is none), and
+// integrates FlightDynamics::computeDerivative with a midpoint step far
+// longer than the 1 ms physics step, so its CPU cost is bounded by
+// rate x horizon / step derivative evaluations.
+class FlightPathPredictor {
+public:
+    FlightPathPredictor();
+    ~FlightPathPredictor();
+
+    FlightPathPredictor(const FlightPathPredictor&) = delete;
+    FlightPathPredictor& operator=(const FlightPathPredictor&) = delete;
+
+    bool start(const PredictorConfig& config = PredictorConfig());
+    void stop();
+    bool isRunning() const { return worker.joinable(); }
+    const PredictorConfig& getConfig() const { return config; }
+
+    // Main thread: the state to predict from (the latest submitted wins)
+    void submit(const AircraftState& state, double simTime);
+
+    // Main thread: paths requested before this are not returned any more
+    // (e.g. after a reset or rewind)
+    void markDiscontinuity() { epoch++; }
+
+    // Main thread: newest finished path, nullptr if there is none since the
+    // last discontinuity
+    const PredictedPath* getLatest();
+
+    struct Stats {
+        uint64_t predictions;
+        double meanMicroseconds;      // Per prediction
+        double maxMicroseconds;
+        double cpuShare;              // Worker busy time / wall time since start()
+    };
+    Stats getStats() const;
+
+private:
+    struct Request {
+        AircraftState state;
+        double simTime;
+        uint64_t epoch;
+    };
+
+    void run();
+    void predict(const Request& request, PredictedPath& path);
+
+    PredictorConfig config;
+    uint64_t epoch;
+
+    TripleBuffer<Request> requests;
+    TripleBuffer<PredictedPath> paths;
+    bool hasPath;
+
+    std::thread worker;
+    std::mutex stopMutex;                 // Only for waking the worker on stop()
+    std::condition_variable stopCondition;
+    bool stopping;
+
+    std::atomic<uint64_t> predictions;
+    std::atomic<double> totalMicroseconds;
+    std::atomic<double> maxMicroseconds;
+    std::chrono::steady_clock::time_point startTime;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <cfloat>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#else
+#include <cfenv>
+#endif
+
+// Bitwise-deterministic dynamics (build with FLIGHT_DETERMINISTIC=1
+// ./compile.sh). The result of a step then depends only on the state and
+// inputs, not on the optimisation level, the target's FMA support or what
+// other code did to the floating-point environment:
+//  - no FMA contraction and no reassociation: -ffp-contract=off
+//    -fno-fast-math -fno-tree-slp-vectorize for the whole program, since
+//    the header-inline vector math is compiled into (and shared between)
+//    every translation unit. GCC's SLP vectorizer forms fused add/sub
+//    instructions on FMA targets despite -ffp-contract=off;
+//  - plain double evaluation (SSE2 on x86, not the x87 stack);
+//  - round-to-nearest with denormals kept, pinned for each step.
+// The dynamics translation units include this header, so -ffast-math or
+// x87 evaluation fails to compile instead of drifting. Contraction cannot
+// be detected by the preprocessor; `--bench determinism` flies a scripted
+// flight against a pinned state hash.
+// libm (sin, atan2, pow, ...) is outside this: compare runs linked against
+// the same C library.
+#ifdef FLIGHT_DETERMINISTIC
+#if defined(__FAST_MATH__)
+#error "FLIGHT_DETERMINISTIC: the dynamics must not be built with -ffast-math"
+#endif
+#if FLT_EVAL_METHOD != 0
+#error "FLIGHT_DETERMINISTIC: doubles must be evaluated in double precision (e.g. -msse2 -mfpmath=sse)"
+#endif
+#endif
+
+// Round-to-nearest with denormals kept (no flush-to-zero) for its scope,
+// restoring the caller's mode. Only writes the control register when its
+// control bits differ (the low six bits are sticky exception flags, set by
+// any inexact operation), so the usual case is one register read on entry
+// and exit.
+class ScopedFpEnvironment {
+public:
+#if defined(__SSE2__) || defined(_M_X64)
+    ScopedFpEnvironment() : saved(_mm_getcsr()), changed((saved & ~FLAG_BITS) != DEFAULT_CSR) {
+        if (changed) _mm_setcsr(DEFAULT_CSR);
+    }
+    ~ScopedFpEnvironment() {
+        if (changed) _mm_setcsr(saved);
+    }
+
+private:
+    static constexpr unsigned int DEFAULT_CSR = 0x1F80;   // All exceptions masked, nearest, no FTZ/DAZ
+    static constexpr unsigned int FLAG_BITS = 0x3F;       // Exception flags, not control
+    unsigned int saved;
+    bool changed;
+#else
+    ScopedFpEnvironment() : saved(std::fegetround()) {
+        if (saved != FE_TONEAREST) std::fesetround(FE_TONEAREST);
+    }
+    ~ScopedFpEnvironment() {
+        if (saved != FE_TONEAREST) std::fesetround(saved);
+    }
+
+private:
+    int saved;
+#endif
+
+public:
+    ScopedFpEnvironment(const ScopedFpEnvironment&) = delete;
+    ScopedFpEnvironment& operator=(const ScopedFpEnvironment&) = delete;
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+enum class PacingMode {
+    VSYNC,       // Swap interval 1, the driver paces frames
+    UNCAPPED,    // Swap interval 0, run as fast as possible
+    FIXED_RATE   // Swap interval 0, sleep then spin to a fixed frame rate
+};
+
+// Paces the render loop and measures frame-to-frame jitter.
+// Call beginFrame() at the top of the loop, endWork() when the CPU work for
+// the frame is done (before presenting), and endFrame() after presenting.
+class FramePacer {
+public:
+    FramePacer();
+
+    void setMode(PacingMode mode);
+    void setTargetRate(double hz);
+
+    PacingMode getMode() const { return mode; }
+    double getTargetRate() const { return targetHz; }
+
+    // Swap interval the renderer should use for the current mode
+    int getSwapInterval() const { return mode == PacingMode::VSYNC ? 1 : 0; }
+
+    void beginFrame();
+    void endWork();
+    void endFrame();
+
+    struct Stats {
+        double meanIntervalMs;   // Frame-to-frame interval
+        double jitterMs;         // Standard deviation of the interval
+        double maxDeviationMs;   // Worst |interval - mean|
+        double meanWorkMs;       // CPU work per frame, excluding pacing waits
+        double lastWorkMs;
+        uint64_t lateFrames;     // FIXED_RATE frames that missed their deadline
+    };
+    const Stats& getStats() const { return stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void waitUntil(Clock::time_point deadline);
+    void updateStats();
+
+    PacingMode mode;
+    double targetHz;
+
+    Clock::time_point frameStart;
+    Clock::time_point lastFrameEnd;
+    Clock::time_point nextDeadline;
+    bool hasLastFrame;
+
+    static constexpr int HISTORY = 240;
+    double intervals[HISTORY];
+    double workTimes[HISTORY];
+    int historyCount;
+    int historyIndex;
+
+    Stats stats;
+
+    // Wake this long before the deadline and spin the rest (OS sleep granularity)
+    static constexpr double SPIN_MARGIN_MS = 1.5;
+};
+
+// Trades secondary detail for frame time when frames run over budget.
+// The primary flight display (airspeed, attitude, altimeter, heading, VSI)
+// is never degraded; only secondary panels, instrument detail and the
+// telemetry text are.
+class FrameBudgetGovernor {
+public:
+    static constexpr int MAX_LEVEL = 3;
+
+    FrameBudgetGovernor();
+
+    void setEnabled(bool enable);
+    bool isEnabled() const { return enabled; }
+
+    void setBudget(double milliseconds) { budgetMs = milliseconds; }
+    double getBudget() const { return budgetMs; }
+
+    // Feed the measured CPU work of the last frame
+    void update(double workMs);
+
+    // 0 = full detail, MAX_LEVEL = most reduced
+    int getLevel() const { return level; }
+    double getSmoothedWorkMs() const { return smoothedMs; }
+
+    // Derived settings for the current level
+    bool reduceInstrumentDetail() const { return level >= 2; }
+    int getTelemetryLines() const;          // Telemetry text lines to show
+    int getSecondaryUpdateDivisor() const;  // Secondary panels refresh every N frames
+
+private:
+    bool enabled;
+    double budgetMs;
+    double smoothedMs;
+    int level;
+    int overBudgetFrames;
+    int underBudgetFrames;
+
+    // Hysteresis: degrade quickly, recover slowly
+    static constexpr int DEGRADE_FRAMES = 10;
+    static constexpr int RECOVER_FRAMES = 120;
+    static constexpr double RECOVER_FRACTION = 0.6;
+};
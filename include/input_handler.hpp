@@ -1,34 +1,115 @@
 #pragma once
 #include <GLFW/glfw3.h>
 #include "aircraft.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
+// Key transition captured by the GLFW callback
+struct InputEvent {
+    int key;
+    int action;   // GLFW_PRESS or GLFW_RELEASE
+    std::chrono::steady_clock::time_point time;
+};
+
+// Keyboard input driven by GLFW key callbacks. Events are timestamped when
+// they arrive and queued; each physics step consumes the events that fall
+// inside its slot of wall-clock time and integrates the controls over the
+// time each key was actually held, so control rates do not depend on the
+// frame rate and taps shorter than a frame still move the controls.
 class InputHandler {
 public:
+    using Clock = std::chrono::steady_clock;
+
     InputHandler();
-    
-    void update(GLFWwindow* window, Aircraft& aircraft, double dt);
-    
+    ~InputHandler();
+
+    // Install the key callback (chains any callback already installed, e.g. ImGui's)
+    void attach(GLFWwindow* window);
+
+    // Queue an event (called from the key callback; usable for scripted input)
+    bool pushEvent(int key, int action, Clock::time_point time);
+
+    // Consume events stamped up to stepEnd and update the controls for the
+    // step covering [stepEnd - dt, stepEnd]
+    void applyStep(Aircraft& aircraft, Clock::time_point stepEnd, double dt);
+
+    // Consume events up to `time` without moving the controls (while paused)
+    void skipTo(Clock::time_point time);
+
     bool isPaused() const { return paused; }
     void togglePause() { paused = !paused; }
-    
+
+    // Continue from the aircraft's current controls (after a rewind restore)
+    void syncControls(const AircraftState& state);
+
     bool shouldReset() const { return resetRequested; }
     void clearReset() { resetRequested = false; }
-    
+
+    // Time from a key event to the aircraft controls reflecting it
+    struct LatencyStats {
+        double lastUs;
+        double meanUs;
+        double p99Us;
+        double maxUs;
+        uint64_t samples;
+        uint64_t droppedEvents;   // Queue was full
+    };
+    LatencyStats getLatencyStats() const;
+    void resetLatencyStats();
+
 private:
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static InputHandler* instance;
+    static GLFWkeyfun previousCallback;
+
+    void handleEvent(const InputEvent& event, Clock::time_point stepStart);
+    void recordLatency(Clock::time_point eventTime, Clock::time_point now);
+
     bool paused;
     bool resetRequested;
-    
+
     // Control state
     double elevatorInput;
     double aileronInput;
     double rudderInput;
     double throttleInput;
-    
-    // Keyboard state tracking
-    bool keyStates[GLFW_KEY_LAST];
-    
+
+    // Flight control keys; see keySlot()
+    enum KeySlot {
+        KEY_W, KEY_UP, KEY_S, KEY_DOWN,
+        KEY_A, KEY_LEFT, KEY_D, KEY_RIGHT,
+        KEY_Q, KEY_E,
+        KEY_Z, KEY_PAGE_UP, KEY_X, KEY_PAGE_DOWN,
+        KEY_SPACE,
+        KEY_SLOT_COUNT
+    };
+    static int keySlot(int key);
+
+    bool keyDown[KEY_SLOT_COUNT];
+    Clock::time_point keyDownSince[KEY_SLOT_COUNT];
+    double keyHeld[KEY_SLOT_COUNT];   // Seconds held during the current step
+
+    SpscQueue<InputEvent, 256> events;
+    std::atomic<uint64_t> droppedEvents;
+
+    // Events applied in the current step, for latency measurement
+    static constexpr int MAX_STEP_EVENTS = 32;
+    Clock::time_point stepEventTimes[MAX_STEP_EVENTS];
+    int stepEventCount;
+
+    // Latency samples in microseconds
+    static constexpr int LATENCY_HISTORY = 512;
+    double latencySamples[LATENCY_HISTORY];
+    int latencyIndex;
+    uint64_t latencyCount;
+    double latencySum;
+    double latencyMax;
+
     // Control sensitivity
     static constexpr double CONTROL_RATE = 2.0;      // units/sec
     static constexpr double THROTTLE_RATE = 0.5;     // units/sec
+    static constexpr double RETURN_RATE = 1.2;       // 1/sec, return to center (~2% per 60 Hz frame)
+    static constexpr double CENTER_KEY_RATE = 3.0;   // 1/sec, extra centering while Space is held
 };
-
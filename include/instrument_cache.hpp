@@ -0,0 +1,60 @@
+#pragma once
+#include "imgui.h"
+#include <memory>
+#include <vector>
+
+// Static parts of the gauges that can be baked once and replayed
+enum class DialLayer {
+    AIRSPEED,              // Face, ring, ticks and labels
+    ALTIMETER,
+    VERTICAL_SPEED,
+    HEADING_BEZEL,         // Face and ring (the compass card moves)
+    ATTITUDE_SKY,          // Sky disc behind the ground polygon
+    ATTITUDE_OVERLAY,      // Ring and fixed aircraft symbol
+    TURN_COORDINATOR,
+    COUNT
+};
+
+// Caches the static layers of the instrument panel as prebuilt vertex and
+// index ranges. A layer is built once into a private draw list around the
+// origin and re-baked only when its radius, the font size or the font
+// texture changes. Each frame the cached range is copied into the window
+// draw list with a translation, so tick marks and labels cost one memcpy-
+// like loop instead of hundreds of ImDrawList calls.
+class InstrumentGeometryCache {
+public:
+    // Draws the static part of a layer around `center` into `drawList`
+    using BuildFn = void (*)(ImDrawList* drawList, ImVec2 center, float radius);
+
+    InstrumentGeometryCache();
+    ~InstrumentGeometryCache();
+
+    void draw(ImDrawList* drawList, DialLayer layer, ImVec2 center, float radius, BuildFn build);
+
+    // When disabled, layers are rebuilt directly into the target every frame
+    void setEnabled(bool enable) { enabled = enable; }
+    bool isEnabled() const { return enabled; }
+
+    void invalidate();
+
+    int getBakeCount() const { return bakeCount; }
+    int getCachedVertexCount() const;
+
+private:
+    struct Layer {
+        std::vector<ImDrawVert> vertices;
+        std::vector<ImDrawIdx> indices;
+        float radius;
+        float fontSize;
+        ImTextureID texture;
+        bool valid;
+    };
+
+    void bake(Layer& layer, float radius, BuildFn build);
+    void replay(ImDrawList* drawList, const Layer& layer, ImVec2 center) const;
+
+    Layer layers[(int)DialLayer::COUNT];
+    std::unique_ptr<ImDrawList> scratch;
+    bool enabled;
+    int bakeCount;
+};
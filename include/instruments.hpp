@@ -1,21 +1,49 @@
 #pragma once
+#include "air_data.hpp"
 #include "aircraft.hpp"
+#include "instrument_cache.hpp"
 
 class Instruments {
 public:
     Instruments();
     
-    // Render all cockpit instruments
-    void render(const Aircraft& aircraft);
+    // Render all cockpit instruments from the state and its step's air data
+    void render(const Aircraft& aircraft, const AirData& airData);
+    
+    // Secondary panels (turn coordinator, controls, telemetry) show the last
+    // sample taken here, called from the secondary-instrument rate group
+    void sampleSecondary(const AircraftState& state, const AirData& airData);
+    
+    // Static dial geometry cache (disable to rebuild every layer each frame)
+    InstrumentGeometryCache& getGeometryCache() { return geometryCache; }
+    
+    // Frame budget controls. The primary gauges are always drawn at full
+    // rate; these only affect detail and the secondary panels (the divisor
+    // keeps every N-th secondary sample).
+    void setReducedDetail(bool reduced) { reducedDetail = reduced; }
+    void setTelemetryLines(int lines) { telemetryLines = lines; }
+    void setSecondaryUpdateDivisor(int divisor) { secondaryDivisor = divisor < 1 ? 1 : divisor; }
     
 private:
+    InstrumentGeometryCache geometryCache;
+    float gaugeRadius;
+    
+    bool reducedDetail;
+    int telemetryLines;
+    int secondaryDivisor;
+    
+    // Last sample shown by the secondary panels
+    unsigned long long sampleCounter;
+    AircraftState secondaryState;
+    AirData secondaryAirData;
+    
     // Individual instrument rendering
     void renderAltimeter(double altitude);
     void renderAirspeedIndicator(double airspeed);
     void renderAttitudeIndicator(double roll, double pitch);
     void renderHeadingIndicator(double heading);
     void renderVerticalSpeedIndicator(double verticalSpeed);
-    void renderTurnCoordinator(double rollRate, double yawRate);
+    void renderTurnCoordinator(double rollRate, double turnRate);
     void renderThrottleGauge(double throttle);
     void renderControlSurfaces(double elevator, double aileron, double rudder);
     
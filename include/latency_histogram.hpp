@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+// Log-scale histogram of durations in microseconds, four bins per octave
+// from 1 us to ~65 ms (the last bin also collects anything longer).
+// record() is wait-free and may be called from one real-time thread
+// (e.g. the audio callback) while any other thread reads.
+class LatencyHistogram {
+public:
+    static constexpr int BINS = 64;
+
+    LatencyHistogram();
+
+    // Single writer
+    void record(double us);
+
+    void reset();
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint64_t getBinCount(int bin) const { return bins[bin].load(std::memory_order_relaxed); }
+    double getLast() const { return lastUs.load(std::memory_order_relaxed); }
+    double getMax() const { return maxUs.load(std::memory_order_relaxed); }
+    double getMean() const;
+
+    // Upper edge of the bin containing the p-th fraction of samples (0..1)
+    double percentile(double p) const;
+
+    static double binUpperEdge(int bin);
+
+    // CSV rows "name,bin_upper_us,count" for non-empty bins
+    void writeCSV(FILE* file, const char* name) const;
+
+private:
+    std::atomic<uint64_t> bins[BINS];
+    std::atomic<uint64_t> count;
+    std::atomic<double> sumUs;
+    std::atomic<double> maxUs;
+    std::atomic<double> lastUs;
+};
@@ -0,0 +1,161 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+enum class LogLevel {
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR
+};
+
+// A log statement. One static instance per call site (see LOG_AT); its id
+// is what goes into the binary record instead of the format string.
+struct LogSite {
+    LogSite(LogLevel level, const char* format, uint32_t maxPerSecond);
+
+    const LogLevel level;
+    const char* const format;       // printf-style, formatted on the logger thread
+    const uint32_t maxPerSecond;    // 0 = unlimited
+    uint32_t id;
+
+    // Rate limiting window (shared by every thread using the site)
+    std::atomic<int64_t> windowStart;
+    std::atomic<uint32_t> windowCount;
+    std::atomic<uint32_t> suppressed;
+};
+
+// One fixed-size record. Numbers are stored raw; string arguments are
+// copied into `text` (truncated) so the caller's buffer can go away.
+struct LogRecord {
+    static constexpr int MAX_ARGS = 6;
+    static constexpr int TEXT_BYTES = 56;
+
+    enum ArgType : uint8_t { INT, UINT, DOUBLE, STRING };
+
+    int64_t time;          // steady_clock ticks
+    uint32_t site;
+    uint32_t suppressed;   // Records dropped by the rate limit just before this one
+    uint8_t argCount;
+    uint8_t types[MAX_ARGS];
+    union Arg {
+        int64_t i;
+        uint64_t u;
+        double d;
+        uint32_t text;     // Offset into `text`
+    } args[MAX_ARGS];
+    char text[TEXT_BYTES];
+};
+
+// Asynchronous logger. Call sites write binary records into a lock-free
+// ring owned by the calling thread; a background thread formats and
+// writes them. Logging never locks or flushes on the caller's thread
+// (except once per thread, to register its ring) and drops the record if
+// the ring is full.
+class Logger {
+public:
+    // Start the writer thread; records logged before start() wait in the rings
+    static void start(FILE* output = stderr);
+    // Drain everything and stop the writer thread
+    static void stop();
+
+    static void setLevel(LogLevel level) { minLevel().store((int)level, std::memory_order_relaxed); }
+    static bool enabled(LogLevel level) {
+        return (int)level >= minLevel().load(std::memory_order_relaxed);
+    }
+
+    template <typename... Args>
+    static void write(LogSite& site, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+        int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        uint32_t suppressed = 0;
+        if (site.maxPerSecond > 0 && !admit(site, now, suppressed)) return;
+
+        LogRecord record;
+        record.time = now;
+        record.site = site.id;
+        record.suppressed = suppressed;
+        record.argCount = 0;
+        uint32_t textUsed = 0;
+        int expand[] = {0, (pack(record, textUsed, args), 0)...};
+        (void)expand;
+        (void)textUsed;
+        submit(record);
+    }
+
+    struct Stats {
+        uint64_t written;
+        uint64_t dropped;       // Ring full
+        uint64_t suppressed;    // Rate limited
+    };
+    static Stats getStats();
+
+private:
+    static std::atomic<int>& minLevel();
+    static bool admit(LogSite& site, int64_t now, uint32_t& suppressed);
+    static void submit(const LogRecord& record);
+
+    template <typename T>
+    static void pack(LogRecord& record, uint32_t&, const T& value) {
+        static_assert(std::is_arithmetic<T>::value, "Unsupported log argument");
+        int index = record.argCount++;
+        if (std::is_floating_point<T>::value) {
+            record.types[index] = LogRecord::DOUBLE;
+            record.args[index].d = (double)value;
+        } else if (std::is_signed<T>::value) {
+            record.types[index] = LogRecord::INT;
+            record.args[index].i = (int64_t)value;
+        } else {
+            record.types[index] = LogRecord::UINT;
+            record.args[index].u = (uint64_t)value;
+        }
+    }
+
+    static void pack(LogRecord& record, uint32_t& textUsed, const char* value) {
+        int index = record.argCount++;
+        record.types[index] = LogRecord::STRING;
+        record.args[index].text = textUsed;
+        if (textUsed < (uint32_t)LogRecord::TEXT_BYTES) {
+            size_t room = LogRecord::TEXT_BYTES - textUsed - 1;
+            size_t length = value ? std::strlen(value) : 0;
+            if (length > room) length = room;
+            if (length > 0) std::memcpy(record.text + textUsed, value, length);
+            record.text[textUsed + length] = '\0';
+            textUsed += (uint32_t)length + 1;
+        } else {
+            record.args[index].text = LogRecord::TEXT_BYTES - 1;   // Out of room: empty string
+            record.text[LogRecord::TEXT_BYTES - 1] = '\0';
+        }
+    }
+
+    static void pack(LogRecord& record, uint32_t& textUsed, char* value) {
+        pack(record, textUsed, (const char*)value);
+    }
+};
+
+// Starts the logger for the lifetime of a scope (e.g. main)
+class ScopedLogger {
+public:
+    explicit ScopedLogger(FILE* output = stderr) { Logger::start(output); }
+    ~ScopedLogger() { Logger::stop(); }
+    ScopedLogger(const ScopedLogger&) = delete;
+    ScopedLogger& operator=(const ScopedLogger&) = delete;
+};
+
+// At most `perSecond` records per second from this call site (0 = unlimited)
+#define LOG_AT(level, perSecond, format, ...)                              \
+    do {                                                                  \
+        if (Logger::enabled(level)) {                                     \
+            static LogSite logSite_(level, format, perSecond);            \
+            Logger::write(logSite_, ##__VA_ARGS__);                       \
+        }                                                                 \
+    } while (0)
+
+#define LOG_DEBUG(format, ...) LOG_AT(LogLevel::DEBUG, 0, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...) LOG_AT(LogLevel::INFO, 0, format, ##__VA_ARGS__)
+#define LOG_WARN(format, ...) LOG_AT(LogLevel::WARN, 0, format, ##__VA_ARGS__)
+#define LOG_ERROR(format, ...) LOG_AT(LogLevel::ERROR, 0, format, ##__VA_ARGS__)
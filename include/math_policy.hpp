@@ -0,0 +1,47 @@
+#pragma once
+#include "fast_math.hpp"
+#include <cmath>
+#include <cstddef>
+
+// Elementary-function policies for the dynamics hot path. FlightDynamics
+// and Atmosphere are instantiated for both, so a single binary can fly
+// either (see `--bench fast-math`); SimMath is the one the simulation uses.
+
+// libm, bitwise identical to the original code
+struct StdMath {
+    static double sin(double x) { return std::sin(x); }
+    static double cos(double x) { return std::cos(x); }
+    static double tan(double x) { return std::tan(x); }
+    static double exp(double x) { return std::exp(x); }
+    static double pow(double x, double y) { return std::pow(x, y); }
+    static double atan2(double y, double x) { return std::atan2(y, x); }
+    static void sincos(double x, double& s, double& c) {
+        s = std::sin(x);
+        c = std::cos(x);
+    }
+    static void sincos(const double* x, double* s, double* c, size_t count) {
+        for (size_t i = 0; i < count; i++) sincos(x[i], s[i], c[i]);
+    }
+    // tan x given its sine and cosine (libm's own tan here)
+    static double tan(double x, double, double) { return std::tan(x); }
+};
+
+// Polynomial approximations from fast_math.hpp
+struct FastMath {
+    static double sin(double x) { return fastmath::sin(x); }
+    static double cos(double x) { return fastmath::cos(x); }
+    static double tan(double x) { return fastmath::tan(x); }
+    static double exp(double x) { return fastmath::exp(x); }
+    static double pow(double x, double y) { return fastmath::pow(x, y); }
+    static double atan2(double y, double x) { return fastmath::atan2(y, x); }
+    static void sincos(double x, double& s, double& c) { fastmath::sincos(x, s, c); }
+    static void sincos(const double* x, double* s, double* c, size_t count) { fastmath::sincos(x, s, c, count); }
+    static double tan(double, double s, double c) { return s / c; }   // As fastmath::tan
+};
+
+// Opt in to the fast policy with -DFLIGHT_FAST_MATH
+#ifdef FLIGHT_FAST_MATH
+using SimMath = FastMath;
+#else
+using SimMath = StdMath;
+#endif
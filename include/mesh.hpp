@@ -0,0 +1,52 @@
+#pragma once
+#include "vector3.hpp"
+#include <cstdint>
+#include <vector>
+
+// Packed RGBA8 color, red in the lowest byte (same layout as IM_COL32)
+inline uint32_t packColor(int r, int g, int b, int a = 255) {
+    return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | ((uint32_t)a << 24);
+}
+
+struct MeshTriangle {
+    uint32_t a, b, c;   // Vertex indices
+    uint32_t color;     // Flat RGBA8 color
+};
+
+// Indexed triangle mesh with flat per-face colors.
+// Vertices use the same axis convention as the frame they live in:
+// body frame (x forward, y right, z down) or NED for world geometry.
+struct Mesh {
+    std::vector<Vector3> vertices;
+    std::vector<MeshTriangle> triangles;
+
+    void clear() {
+        vertices.clear();
+        triangles.clear();
+    }
+
+    uint32_t addVertex(const Vector3& v) {
+        vertices.push_back(v);
+        return (uint32_t)(vertices.size() - 1);
+    }
+
+    void addTriangle(uint32_t a, uint32_t b, uint32_t c, uint32_t color) {
+        triangles.push_back({a, b, c, color});
+    }
+
+    void addQuad(const Vector3& p0, const Vector3& p1, const Vector3& p2,
+                 const Vector3& p3, uint32_t color);
+
+    // Axis-aligned box in the mesh frame
+    void addBox(const Vector3& minCorner, const Vector3& maxCorner, uint32_t color);
+
+    // Flat ground grid (z = 0, NED) of cells x cells squares centered on the
+    // given north/east position. Cell colors are derived from world cell
+    // indices, so the pattern stays fixed on the ground as the center moves.
+    // Reuses the existing allocation when called every frame.
+    static void buildTerrain(Mesh& out, double centerNorth, double centerEast,
+                             double cellSize, int cells);
+
+    // Low-poly high-wing single-engine aircraft in the body frame (meters)
+    static Mesh createAircraft();
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include "quaternion.hpp"
+#include "sensors.hpp"
+#include "small_matrix.hpp"
+#include "vector3.hpp"
+#include <cstdint>
+
+// Filter tuning: noise densities for the IMU-driven prediction and 1-sigma
+// measurement noise for the aiding sensors
+struct NavEkfNoise {
+    double accelNoiseDensity;     // m/s^2/sqrt(Hz)
+    double gyroNoiseDensity;      // rad/s/sqrt(Hz)
+    double accelBiasWalk;         // m/s^3/sqrt(Hz)
+    double gyroBiasWalk;          // rad/s^2/sqrt(Hz)
+    double gpsPosition;           // m
+    double gpsVelocity;           // m/s
+    double baroAltitude;          // m
+    double heading;               // rad
+
+    // Initial uncertainty after initialize()
+    double initialPosition;       // m
+    double initialVelocity;       // m/s
+    double initialAttitude;       // rad
+    double initialAccelBias;      // m/s^2
+    double initialGyroBias;       // rad/s
+
+    static NavEkfNoise typical();   // Matches SensorErrors::typical()
+};
+
+struct NavEstimate {
+    Vector3 position;             // m, NED
+    Vector3 velocity;             // m/s, NED
+    double roll, pitch, yaw;      // rad
+    Vector3 accelBias;            // m/s^2, body
+    Vector3 gyroBias;             // rad/s, body
+    Vector3 positionSigma;        // 1-sigma per axis
+    Vector3 velocitySigma;
+    Vector3 attitudeSigma;        // rad, about the NED axes
+};
+
+// Error-state extended Kalman filter for strapdown navigation: the IMU
+// drives the prediction (position, NED velocity, attitude quaternion,
+// accelerometer and gyro biases); GPS position/velocity, baro altitude and
+// magnetic heading correct it. The covariance is over the 15 error states
+//   0-2 position, 3-5 velocity, 6-8 attitude (small rotation about NED
+//   axes), 9-11 accelerometer bias, 12-14 gyro bias
+// on fixed-size matrices, so a filter is one flat object with no heap.
+// Measurements whose normalized innovation fails a chi-square gate are
+// rejected rather than applied.
+class NavEkf {
+public:
+    static constexpr int STATES = 15;
+    using Covariance = Matrix<STATES, STATES>;
+
+    explicit NavEkf(const NavEkfNoise& noise = NavEkfNoise::typical());
+
+    // Start from a known state (e.g. transfer alignment from the aircraft)
+    // with the initial uncertainties and zero biases
+    void initialize(const Vector3& position, const Vector3& velocity, double roll, double pitch, double yaw);
+
+    // Propagate by one IMU sample
+    void predict(const ImuReading& imu, double dt);
+
+    // Corrections; false if the measurement was gated out (or the
+    // innovation covariance was not positive definite)
+    bool updateGps(const GpsReading& gps);
+    bool updateBaroAltitude(double altitude);
+    bool updateHeading(double heading);    // rad, true (not magnetic) heading
+
+    // One physics step of sensor data: predict with the IMU, then apply
+    // the aiding sensors due at this step (GPS, baro altitude and magnetic
+    // heading, each at 10 Hz)
+    void process(const SensorReadings& readings, uint64_t step, double dt);
+
+    NavEstimate getEstimate() const;
+    const Covariance& getCovariance() const { return covariance; }
+    const NavEkfNoise& getNoise() const { return noise; }
+
+    uint64_t getPredictCount() const { return predictCount; }
+    uint64_t getUpdateCount() const { return updateCount; }
+    uint64_t getRejectedCount() const { return rejectedCount; }
+
+private:
+    template <int M>
+    bool correct(const ColumnVector<M>& innovation, const Matrix<M, STATES>& h, const Matrix<M, M>& r);
+
+    NavEkfNoise noise;
+
+    // Nominal state
+    Vector3 position;
+    Vector3 velocity;
+    Quaternion attitude;      // Body to NED
+    Vector3 accelBias;
+    Vector3 gyroBias;
+
+    Covariance covariance;
+
+    uint64_t predictCount;
+    uint64_t updateCount;
+    uint64_t rejectedCount;
+};
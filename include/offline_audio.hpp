@@ -0,0 +1,20 @@
+#pragma once
+#include "flight_log.hpp"
+#include <cstdint>
+#include <string>
+
+struct OfflineAudioStats {
+    double audioSeconds;    // Length of the rendered track
+    double renderSeconds;   // Wall time spent rendering
+    uint64_t frames;
+};
+
+// Fly a scripted flight (power changes, a low-speed glide, then a descent
+// to the ground) and record every physics step. Deterministic.
+void recordScriptedFlight(FlightLog& log, double seconds, double dt = 1.0 / 60.0);
+
+// Replay a recorded flight through an offline AudioSystem and write the
+// whole audio track to a 32-bit float WAV file. Audio is pulled in step
+// with the log's sim time, so the same log always renders the same samples.
+bool renderFlightAudio(const FlightLog& log, const std::string& wavPath,
+                       uint32_t sampleRate = 48000, OfflineAudioStats* stats = nullptr);
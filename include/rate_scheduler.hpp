@@ -0,0 +1,103 @@
+#pragma once
+#include "latency_histogram.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Cyclic executive for subsystems running at harmonic rates. The base
+// (minor) frame runs at the highest rate; every group runs every N-th minor
+// frame, where N = baseRate / rate must be a whole number. Each group gets
+// a phase offset within its period chosen so the expected load is spread
+// evenly over the minor frames, and groups due in the same minor frame run
+// in registration order. The caller drives tick() once per minor frame
+// (e.g. from a fixed-step accumulator).
+class RateScheduler {
+public:
+    using TaskFn = void (*)(void* context);
+
+    static constexpr int MAX_GROUPS = 16;
+
+    explicit RateScheduler(double baseRate);
+
+    RateScheduler(const RateScheduler&) = delete;
+    RateScheduler& operator=(const RateScheduler&) = delete;
+
+    // Register a group; returns its index, or -1 if the rate is not a whole
+    // divisor of the base rate. expectedUs weights the phase placement;
+    // budgetUs is the overrun threshold (0 = one minor frame).
+    int addGroup(const char* name, double rate, TaskFn fn, void* context,
+                 double expectedUs = 1.0, double budgetUs = 0.0);
+
+    // Same, calling fn() (which must outlive the scheduler)
+    template <typename Fn>
+    int addGroup(const char* name, double rate, Fn& fn, double expectedUs = 1.0, double budgetUs = 0.0) {
+        return addGroup(name, rate, &invoke<Fn>, (void*)&fn, expectedUs, budgetUs);
+    }
+
+    // Run one minor frame
+    void tick();
+
+    double getBaseRate() const { return baseRate; }
+    double getMinorPeriod() const { return 1.0 / baseRate; }
+    uint64_t getFrame() const { return frame; }
+
+    struct GroupStats {
+        const char* name;
+        double rate;              // Hz
+        int divisor;              // Minor frames per period
+        int phase;                // Minor frame offset within the period
+        double budgetUs;
+        uint64_t runs;
+        uint64_t overruns;        // Runs longer than budgetUs
+        double lastUs;
+        double meanUs;
+        double p99Us;
+        double maxUs;
+        double cpuShare;          // Mean execution time x rate (fraction of one core)
+    };
+    int getGroupCount() const { return groupCount; }
+    GroupStats getGroupStats(int group) const;
+    const LatencyHistogram& getHistogram(int group) const { return groups[group].histogram; }
+
+    // Minor frames whose groups together took longer than the minor period
+    uint64_t getFrameOverruns() const { return frameOverruns; }
+    double getMaxFrameUs() const { return maxFrameUs; }
+
+    void resetStats();
+
+    // Per-group summary plus histogram rows
+    bool writeCSV(const std::string& path) const;
+
+private:
+    template <typename Fn>
+    static void invoke(void* context) {
+        (*static_cast<Fn*>(context))();
+    }
+
+    struct Group {
+        std::string name;
+        double rate;
+        int divisor;
+        int phase;
+        double expectedUs;
+        double budgetUs;
+        TaskFn fn;
+        void* context;
+        uint64_t overruns;
+        LatencyHistogram histogram;
+    };
+
+    int choosePhase(int divisor, double expectedUs) const;
+
+    double baseRate;
+    uint64_t frame;
+    Group groups[MAX_GROUPS];   // Fixed: the histograms are not movable
+    int groupCount;
+
+    // Expected load per minor frame over one hyperperiod (lcm of divisors)
+    std::vector<double> slotLoad;
+
+    uint64_t frameOverruns;
+    double maxFrameUs;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+struct RealtimeConfig {
+    double rate = 1000.0;          // Steps per second
+    int priority = 80;             // SCHED_FIFO priority (1-99), 0 = keep the normal policy
+    int cpu = -1;                  // Pin the loop thread to this CPU, -1 = any
+    bool lockMemory = true;        // mlockall(MCL_CURRENT | MCL_FUTURE) while running
+};
+
+// Runs a step function on a dedicated thread at a fixed rate, released at
+// absolute deadlines (clock_nanosleep on CLOCK_MONOTONIC, so sleep error
+// never accumulates). On Linux the thread asks for SCHED_FIFO priority, CPU
+// affinity and locked memory; each one that is refused (no CAP_SYS_NICE or
+// memlock limit, e.g. in a container) is logged and skipped, and the loop
+// runs anyway with normal scheduling. A step that ends after the next
+// release is a deadline miss; releases that have already passed are dropped
+// rather than run back to back.
+class RealtimeLoop {
+public:
+    using StepFn = void (*)(void* context);
+
+    RealtimeLoop();
+    ~RealtimeLoop();
+
+    RealtimeLoop(const RealtimeLoop&) = delete;
+    RealtimeLoop& operator=(const RealtimeLoop&) = delete;
+
+    // Start the thread; returns once it has applied the config and is about
+    // to take its first release. False if already running or rate <= 0.
+    bool start(const RealtimeConfig& config, StepFn fn, void* context);
+
+    // Same, calling fn() (which must outlive the loop)
+    template <typename Fn>
+    bool start(const RealtimeConfig& config, Fn& fn) {
+        return start(config, &invoke<Fn>, (void*)&fn);
+    }
+
+    // Finish the current step and join
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    // What the thread actually got
+    struct Status {
+        bool fifo;            // SCHED_FIFO at config.priority
+        bool pinned;          // Affinity set to config.cpu
+        bool memoryLocked;    // mlockall succeeded
+    };
+    Status getStatus() const { return status; }
+    const RealtimeConfig& getConfig() const { return config; }
+
+    // Safe to read while running
+    struct Stats {
+        uint64_t steps;
+        uint64_t deadlineMisses;    // Steps that ended after the next release
+        uint64_t skippedPeriods;    // Releases dropped to get back on schedule
+        double meanLatenessUs;      // Wake-up time after the release
+        double p99LatenessUs;
+        double maxLatenessUs;
+        double meanStepUs;          // Step execution time
+        double p99StepUs;
+        double maxStepUs;
+    };
+    Stats getStats() const;
+    const LatencyHistogram& getLatenessHistogram() const { return lateness; }
+    const LatencyHistogram& getStepHistogram() const { return stepTime; }
+
+    // Summary plus histogram rows
+    bool writeCSV(const std::string& path) const;
+
+private:
+    template <typename Fn>
+    static void invoke(void* context) {
+        (*static_cast<Fn*>(context))();
+    }
+
+    void applyConfig();
+    void run();
+
+    RealtimeConfig config;
+    StepFn fn;
+    void* context;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> ready;
+    Status status;
+
+    std::atomic<uint64_t> deadlineMisses;
+    std::atomic<uint64_t> skippedPeriods;
+    LatencyHistogram lateness;
+    LatencyHistogram stepTime;
+};
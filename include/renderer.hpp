@@ -1,5 +1,9 @@
 #pragma once
+#include "air_data.hpp"
 #include "aircraft.hpp"
+#include "flight_path_predictor.hpp"
+#include "scene_renderer.hpp"
+#include "imgui.h"
 #include <GLFW/glfw3.h>
 
 class Renderer {
@@ -10,22 +14,39 @@ public:
     bool initialize(int width, int height, const char* title);
     void shutdown();
     
+    // 1 = vsync, 0 = present immediately
+    void setSwapInterval(int interval);
+    
+    // Re-rasterize the 3D view only every N frames (secondary panel)
+    void setSceneUpdateDivisor(int divisor) { sceneUpdateDivisor = divisor < 1 ? 1 : divisor; }
+    
     bool shouldClose();
+    // Dispatches window and key callbacks; call before the simulation step
+    void pollEvents();
     void beginFrame();
     void endFrame();
     
-    // Render 3D view
-    void render3DView(const Aircraft& aircraft);
+    // Render 3D view, with the predicted flight path if there is one
+    void render3DView(const Aircraft& aircraft, const AirData& airData, const PredictedPath* path = nullptr);
     
     GLFWwindow* getWindow() { return window; }
     
 private:
     GLFWwindow* window;
     
+    // Out-the-window view, rasterized on the CPU and shown as a texture
+    SceneRenderer scene;
+    CameraMode cameraMode;
+    GLuint viewTexture;
+    int viewTextureWidth, viewTextureHeight;
+    int swapInterval;
+    int sceneUpdateDivisor;
+    unsigned long long sceneFrameCounter;
+    
     void setupOpenGL();
+    void uploadViewTexture();
     void drawHorizon(double roll, double pitch);
-    void drawAircraft();
-    void drawGround(double altitude);
     void drawCompass(double heading);
+    void drawFlightPath(const AircraftState& state, const PredictedPath* path, ImVec2 origin, ImVec2 size);
 };
 
@@ -0,0 +1,91 @@
+#pragma once
+#include "aircraft.hpp"
+#include "flight_dynamics.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Rewind history for the last N seconds of flight. A record is taken every
+// `substeps` dynamics steps of length dt (i.e. whenever the inputs can
+// change). Every keyframeInterval records a full AircraftState keyframe is
+// stored; the records in between only store the control inputs that changed. Restoring loads the nearest
+// keyframe at or before the target and re-simulates forward with the
+// recorded inputs, which reproduces the recorded states exactly since the
+// dynamics are deterministic. All memory is allocated up front; the oldest
+// keyframe segment is overwritten when the buffer is full.
+class RewindBuffer {
+public:
+    RewindBuffer(double dt, double seconds = 1800.0, int keyframeInterval = 60, int substeps = 1);
+
+    // Record the state after the inputs were applied, before the next
+    // `substeps` calls to FlightDynamics::update
+    void record(double simTime, const AircraftState& state);
+
+    // The next record starts a new keyframe (call after a reset or any
+    // other jump that did not come from stepping the dynamics `substeps` times)
+    void markDiscontinuity() { discontinuity = true; }
+
+    // Restore the recorded step nearest to `time` into the aircraft and
+    // return its sim time. Later history stays available until the next
+    // record(), which continues from the restored step.
+    bool restore(double time, FlightDynamics& dynamics, Aircraft& aircraft, double& restoredTime);
+
+    void clear();
+    bool empty() const { return count == 0; }
+    double getOldestTime() const;
+    double getNewestTime() const;
+
+    struct MemoryStats {
+        size_t reservedBytes;   // Fixed, allocated at construction
+        size_t usedBytes;       // Keyframes plus encoded inputs in use
+        size_t keyframes;
+        size_t steps;
+        double spanSeconds;
+        double capacitySeconds;
+    };
+    MemoryStats getMemoryStats() const;
+
+private:
+    // Per-step input delta: a change mask, then each changed control
+    static constexpr int CONTROL_COUNT = 4;
+    static constexpr int MAX_DELTA_BYTES = 1 + CONTROL_COUNT * (int)sizeof(double);
+
+    struct Segment {
+        AircraftState keyframe;   // Step 0 of the segment, controls included
+        double keyTime;
+        int steps;                // Records, including the keyframe
+        int deltaBytes;           // Encoded inputs used in this segment's arena slice
+    };
+
+    // Truncation point left by restore(), applied by the next record()
+    struct ResumePoint {
+        bool pending;
+        size_t segment;           // Ring index
+        int steps;
+        int deltaBytes;
+        double controls[CONTROL_COUNT];
+    };
+
+    static void readControls(const AircraftState& state, double controls[CONTROL_COUNT]);
+    static void writeControls(AircraftState& state, const double controls[CONTROL_COUNT]);
+    uint8_t* arenaFor(size_t segment) { return deltas.data() + segment * segmentArenaBytes; }
+    const uint8_t* arenaFor(size_t segment) const { return deltas.data() + segment * segmentArenaBytes; }
+    size_t ringIndex(size_t ordinal) const { return (first + ordinal) % segments.size(); }
+    void startSegment(double simTime, const AircraftState& state);
+    void applyResumePoint();
+
+    double dt;                       // Dynamics step
+    int substeps;                    // Dynamics steps per record
+    double recordInterval;
+    int keyframeInterval;
+    size_t segmentArenaBytes;
+
+    std::vector<Segment> segments;   // Ring of keyframe segments
+    std::vector<uint8_t> deltas;     // One fixed arena slice per segment
+    size_t first;                    // Oldest segment
+    size_t count;                    // Segments in use
+
+    bool discontinuity;
+    double lastControls[CONTROL_COUNT];
+    ResumePoint resume;
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include "aircraft.hpp"
+#include "mesh.hpp"
+#include "software_rasterizer.hpp"
+
+enum class CameraMode {
+    COCKPIT,   // Out-the-window view from the pilot's eye point
+    CHASE      // Behind and above the aircraft, aircraft visible
+};
+
+// Builds the out-the-window scene (terrain + aircraft) for an aircraft
+// state and renders it with the software rasterizer. Has no GPU or window
+// dependency, so it also runs on headless render nodes.
+class SceneRenderer {
+public:
+    SceneRenderer(int width, int height, unsigned int threads = 0);
+
+    void resize(int width, int height) { rasterizer.resize(width, height); }
+
+    void render(const AircraftState& state, CameraMode mode);
+
+    const SoftwareRasterizer& getRasterizer() const { return rasterizer; }
+
+    // Pixel position of a world point in the last rendered frame
+    bool project(const Vector3& world, double& x, double& y) const { return rasterizer.project(world, x, y); }
+    bool writeFrame(const std::string& path) const { return rasterizer.writePPM(path); }
+
+private:
+    Camera makeCamera(const AircraftState& state, CameraMode mode) const;
+    void drawTerrain(const AircraftState& state);
+    void drawAircraft(const AircraftState& state);
+
+    SoftwareRasterizer rasterizer;
+    Mesh terrainMesh;
+    Mesh aircraftMesh;
+
+    static constexpr double TERRAIN_CELL_SIZE = 400.0;  // m
+    static constexpr int TERRAIN_CELLS = 48;            // Per side
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include "air_data.hpp"
+#include "aircraft.hpp"
+#include "atmosphere.hpp"
+#include "counter_rng.hpp"
+#include "vector3.hpp"
+#include <cstdint>
+
+// 1-sigma white noise per sample and turn-on bias per sensor
+struct SensorErrors {
+    double staticPressureNoise;   // Pa
+    double staticPressureBias;
+    double pitotPressureNoise;    // Pa, impact pressure
+    double pitotPressureBias;
+    double verticalSpeedNoise;    // m/s
+    double accelNoise;            // m/s^2
+    double accelBias;
+    double gyroNoise;             // rad/s
+    double gyroBias;
+    double magNoise;              // gauss
+    double magBias;               // Hard iron
+    double gpsPositionNoise;      // m, per axis
+    double gpsVelocityNoise;      // m/s, per axis
+
+    static SensorErrors typical();   // General aviation grade
+};
+
+struct PitotStaticReading {
+    double indicatedAirspeed;     // m/s, from impact pressure
+    double altitude;              // m, pressure altitude from static pressure
+    double verticalSpeed;         // m/s
+};
+
+struct ImuReading {
+    Vector3 specificForce;        // m/s^2, body frame
+    Vector3 angularRate;          // rad/s, body frame
+};
+
+struct MagnetometerReading {
+    Vector3 field;                // gauss, body frame
+    double heading;               // rad, tilt-compensated magnetic heading 0..2pi
+};
+
+struct GpsReading {
+    Vector3 position;             // m, NED
+    Vector3 velocity;             // m/s, NED
+};
+
+struct SensorReadings {
+    PitotStaticReading pitotStatic;
+    ImuReading imu;
+    MagnetometerReading magnetometer;
+    GpsReading gps;
+};
+
+// Noisy pitot-static, IMU, magnetometer and GPS measurements of the true state.
+// Each reading is a pure function of (seed, entity, step) and the inputs:
+// white noise comes from a CounterRng stream indexed by `step`, and the
+// turn-on biases are drawn once per (seed, entity), so runs reproduce
+// exactly regardless of sample order or threading.
+class SensorSuite {
+public:
+    SensorSuite(uint64_t seed, uint32_t entity = 0, const SensorErrors& errors = SensorErrors::typical());
+
+    SensorReadings sample(uint64_t step, const AircraftState& state, const AirData& airData) const;
+
+    const SensorErrors& getErrors() const { return errors; }
+
+    // True minus magnetic heading of the simulated Earth field (rad)
+    static double getMagneticDeclination();
+
+private:
+    SensorErrors errors;
+    CounterRng noise;
+    Atmosphere atmosphere;
+
+    // Turn-on biases
+    double staticPressureBias;
+    double pitotPressureBias;
+    Vector3 accelBias;
+    Vector3 gyroBias;
+    Vector3 magBias;
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include <cmath>
+
+// Fixed-size row-major matrix for small filters and solvers. Dimensions
+// are template parameters, so storage is inline (no heap) and every loop
+// has a compile-time trip count the optimizer can unroll. Operations are
+// constexpr and return by value.
+template <int Rows, int Cols>
+struct Matrix {
+    static constexpr int ROWS = Rows;
+    static constexpr int COLS = Cols;
+
+    double data[Rows][Cols] = {};
+
+    constexpr double& operator()(int row, int col) { return data[row][col]; }
+    constexpr double operator()(int row, int col) const { return data[row][col]; }
+
+    // Column vectors index by row only
+    constexpr double& operator[](int row) { return data[row][0]; }
+    constexpr double operator[](int row) const { return data[row][0]; }
+
+    static constexpr Matrix zero() { return Matrix(); }
+
+    static constexpr Matrix identity() {
+        Matrix m;
+        for (int i = 0; i < (Rows < Cols ? Rows : Cols); i++) m.data[i][i] = 1.0;
+        return m;
+    }
+
+    constexpr Matrix operator+(const Matrix& other) const {
+        Matrix m;
+        for (int r = 0; r < Rows; r++)
+            for (int c = 0; c < Cols; c++) m.data[r][c] = data[r][c] + other.data[r][c];
+        return m;
+    }
+
+    constexpr Matrix operator-(const Matrix& other) const {
+        Matrix m;
+        for (int r = 0; r < Rows; r++)
+            for (int c = 0; c < Cols; c++) m.data[r][c] = data[r][c] - other.data[r][c];
+        return m;
+    }
+
+    constexpr Matrix operator*(double s) const {
+        Matrix m;
+        for (int r = 0; r < Rows; r++)
+            for (int c = 0; c < Cols; c++) m.data[r][c] = data[r][c] * s;
+        return m;
+    }
+
+    template <int K>
+    constexpr Matrix<Rows, K> operator*(const Matrix<Cols, K>& other) const {
+        Matrix<Rows, K> m;
+        for (int r = 0; r < Rows; r++) {
+            for (int i = 0; i < Cols; i++) {
+                double a = data[r][i];
+                for (int c = 0; c < K; c++) m.data[r][c] += a * other.data[i][c];
+            }
+        }
+        return m;
+    }
+
+    constexpr Matrix<Cols, Rows> transpose() const {
+        Matrix<Cols, Rows> m;
+        for (int r = 0; r < Rows; r++)
+            for (int c = 0; c < Cols; c++) m.data[c][r] = data[r][c];
+        return m;
+    }
+
+    // Sub-matrix at (row, col)
+    template <int R, int C>
+    constexpr Matrix<R, C> block(int row, int col) const {
+        Matrix<R, C> m;
+        for (int r = 0; r < R; r++)
+            for (int c = 0; c < C; c++) m.data[r][c] = data[row + r][col + c];
+        return m;
+    }
+
+    template <int R, int C>
+    constexpr void setBlock(int row, int col, const Matrix<R, C>& m) {
+        for (int r = 0; r < R; r++)
+            for (int c = 0; c < C; c++) data[row + r][col + c] = m.data[r][c];
+    }
+};
+
+template <int N>
+using ColumnVector = Matrix<N, 1>;
+
+// Inverse of a symmetric positive-definite matrix by Cholesky
+// factorization; false (inverse untouched) if it is not positive definite
+template <int N>
+bool invertSymmetric(const Matrix<N, N>& a, Matrix<N, N>& inverse) {
+    // a = L L^T
+    Matrix<N, N> l;
+    for (int j = 0; j < N; j++) {
+        double diagonal = a.data[j][j];
+        for (int k = 0; k < j; k++) diagonal -= l.data[j][k] * l.data[j][k];
+        if (!(diagonal > 0.0)) return false;
+        l.data[j][j] = std::sqrt(diagonal);
+        for (int i = j + 1; i < N; i++) {
+            double sum = a.data[i][j];
+            for (int k = 0; k < j; k++) sum -= l.data[i][k] * l.data[j][k];
+            l.data[i][j] = sum / l.data[j][j];
+        }
+    }
+
+    // L^-1 by forward substitution, then a^-1 = L^-T L^-1
+    Matrix<N, N> lInv;
+    for (int j = 0; j < N; j++) {
+        lInv.data[j][j] = 1.0 / l.data[j][j];
+        for (int i = j + 1; i < N; i++) {
+            double sum = 0.0;
+            for (int k = j; k < i; k++) sum -= l.data[i][k] * lInv.data[k][j];
+            lInv.data[i][j] = sum / l.data[i][i];
+        }
+    }
+    inverse = lInv.transpose() * lInv;
+    return true;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "mesh.hpp"
+#include "thread_pool.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Pinhole camera in the NED frame. Attitude uses the aircraft Euler
+// convention, so the camera looks along its body x axis.
+struct Camera {
+    Vector3 position;      // m (NED)
+    double roll;           // rad
+    double pitch;          // rad
+    double yaw;            // rad
+    double fovY;           // rad, vertical field of view
+    double nearPlane;      // m
+    double farPlane;       // m
+};
+
+// Tiled CPU rasterizer producing an RGBA8 image with a depth buffer.
+//
+// Per frame: beginFrame() sets the camera, submit() transforms, near-clips
+// and bins triangles into 64x64 screen tiles, and endFrame() clears and
+// rasterizes all tiles in parallel. Each tile is owned by exactly one
+// thread, so the color/depth writes need no synchronization. The inner
+// loop evaluates edge functions and depth for 4 pixels at a time (SSE2,
+// scalar fallback elsewhere). Triangles are flat shaded with a fixed sun.
+class SoftwareRasterizer {
+public:
+    static constexpr int TILE_SIZE = 64;
+
+    // threads = 0 uses one per hardware thread
+    SoftwareRasterizer(int width, int height, unsigned int threads = 0);
+
+    // Width is rounded down to a multiple of 4 (SIMD row granularity)
+    void resize(int width, int height);
+
+    void beginFrame(const Camera& camera);
+
+    // Draw a mesh placed with the given world translation and attitude
+    void submit(const Mesh& mesh, const Vector3& translation,
+                double roll = 0.0, double pitch = 0.0, double yaw = 0.0);
+
+    void endFrame();
+
+    // Pixel position of a world point through the current camera; false if
+    // it is behind the near plane
+    bool project(const Vector3& world, double& x, double& y) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const uint32_t* getColorBuffer() const { return color.data(); }
+
+    // Binary PPM (P6) dump of the last finished frame
+    bool writePPM(const std::string& path) const;
+
+    struct Stats {
+        size_t trianglesSubmitted;
+        size_t trianglesRasterized;  // After culling and near-plane clipping
+        size_t tileBinEntries;
+        double binMilliseconds;
+        double rasterMilliseconds;
+    };
+    const Stats& getStats() const { return stats; }
+
+    unsigned int getThreadCount() const { return pool.getThreadCount(); }
+
+private:
+    // Screen-space triangle ready for tile rasterization
+    struct SetupTriangle {
+        float edgeA[3], edgeB[3], edgeC[3];  // E(x,y) = A*x + B*y + C, inside >= 0
+        float depthA, depthB, depthC;        // 1/w plane
+        int minX, minY, maxX, maxY;          // Inclusive pixel bounds
+        uint32_t color;                      // Shaded color
+    };
+
+    void setupTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, uint32_t color);
+    void rasterizeTile(int tileIndex);
+    void clearTile(int x0, int y0, int x1, int y1);
+
+    int width, height;
+    int tilesX, tilesY;
+
+    std::vector<uint32_t> color;
+    std::vector<float> depth;   // 1/w, larger is closer, 0 = far
+
+    std::vector<SetupTriangle> setupTriangles;
+    std::vector<std::vector<uint32_t>> tileBins;
+
+    Camera camera;
+    double worldToCamera[3][3];
+    double focalLength;
+
+    // Sky/ground background: ray down-component is linear in screen position
+    float horizonA, horizonB, horizonC;
+
+    Stats stats;
+    ThreadPool pool;
+};
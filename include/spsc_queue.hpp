@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free single-producer/single-consumer ring buffer.
+// push() may only be called from one thread and pop()/peek() from one
+// (possibly different) thread. Neither side blocks or allocates, so it is
+// safe to use from input, audio and other real-time callbacks.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer: returns false (and drops the item) when the queue is full
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: oldest item, or nullptr when empty. Valid until pop()/discard().
+    const T* peek() const {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &items[h & (Capacity - 1)];
+    }
+
+    // Consumer: drop the item returned by peek()
+    void discard() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool pop(T& item) {
+        const T* front = peek();
+        if (!front) return false;
+        item = *front;
+        discard();
+        return true;
+    }
+
+    // Approximate when called concurrently with the other side
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) T items[Capacity];
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include "aircraft.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Rolling 64-bit hash of the aircraft state, folded in once per physics
+// step. The bit patterns of every state and control value are hashed, so
+// two runs agree only while they are bitwise identical, and because each
+// step's hash includes the previous one, equal hashes at step n mean
+// (with overwhelming probability) equal states at every step up to n.
+// NaNs hash alike: IEEE leaves their sign and payload to the hardware and
+// compiler.
+struct StateHash {
+    static constexpr uint64_t SEED = 0x243F6A8885A308D3ULL;
+    static constexpr uint64_t CANONICAL_NAN = 0x7FF8000000000000ULL;
+
+    static uint64_t combine(uint64_t hash, const AircraftState& state) {
+        const double values[] = {state.position.x, state.position.y, state.position.z,
+                                 state.velocity.x, state.velocity.y, state.velocity.z,
+                                 state.angularVelocity.x, state.angularVelocity.y, state.angularVelocity.z,
+                                 state.roll, state.pitch, state.yaw,
+                                 state.elevator, state.aileron, state.rudder, state.throttle};
+        for (double value : values) {
+            uint64_t bits = CANONICAL_NAN;
+            if (value == value) std::memcpy(&bits, &value, sizeof(bits));
+            hash = (hash ^ bits) * 0x9E3779B97F4A7C15ULL;
+            hash ^= hash >> 29;
+        }
+        return hash;
+    }
+};
+
+// Per-step rolling hashes of a run: 8 bytes a step instead of the state,
+// enough to locate the first step where two runs (builds, processes,
+// machines) diverge. Saved as CSV, one step per line.
+class StateHashStream {
+public:
+    static constexpr size_t NO_DIVERGENCE = (size_t)-1;
+
+    void clear() { hashes.clear(); }
+    void reserve(size_t count) { hashes.reserve(count); }
+    void record(uint64_t hash) { hashes.push_back(hash); }
+
+    size_t size() const { return hashes.size(); }
+    uint64_t operator[](size_t step) const { return hashes[step]; }
+
+    bool saveCSV(const std::string& path) const;
+    bool loadCSV(const std::string& path);
+
+    // First step at which the two streams differ, NO_DIVERGENCE if they
+    // agree over their common length. Rolling hashes stay different once
+    // they differ, so this is a binary search.
+    static size_t firstDivergence(const StateHashStream& a, const StateHashStream& b);
+
+private:
+    std::vector<uint64_t> hashes;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops.
+// parallelFor() hands out indices through an atomic counter, so uneven
+// work items (e.g. busy screen tiles) balance themselves. The calling
+// thread takes part in the loop and the call blocks until every index is
+// done. Dispatch does not allocate, so it is safe in per-frame/per-step paths.
+// Only one thread may call parallelFor() on a given pool at a time.
+class ThreadPool {
+public:
+    // threadCount includes the calling thread; 0 = one per hardware thread
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int getThreadCount() const { return (unsigned int)workers.size() + 1; }
+
+    // Run fn(index) for every index in [0, count)
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn) {
+        run(count, &invoke<typename std::remove_reference<Fn>::type>, (void*)&fn);
+    }
+
+private:
+    using TaskFn = void (*)(void* context, size_t index);
+
+    template <typename Fn>
+    static void invoke(void* context, size_t index) {
+        (*static_cast<Fn*>(context))(index);
+    }
+
+    void run(size_t count, TaskFn fn, void* context);
+    void drain();
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    // Current job (written under mutex before workers are woken)
+    TaskFn task;
+    void* taskContext;
+    size_t taskCount;
+    std::atomic<size_t> nextIndex;
+
+    unsigned int busyWorkers;
+    uint64_t generation;
+    bool stopping;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Latest-value handoff from one writer thread to one reader thread. The
+// writer fills its back slot and swaps it with the middle one; the reader
+// swaps the middle one into its front slot when a newer value is there.
+// Neither side ever blocks or allocates, the reader always sees a complete
+// value, and values the reader did not pick up in time are overwritten
+// (only the newest matters).
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer: the slot to fill, then publish() it. Contents are whatever
+    // was last written to the slot, not the last published value.
+    T& write() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange((uint8_t)(back | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader: take the newest published value, if there is one since the
+    // last call; true if read() changed
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T& read() const { return slots[front]; }
+
+private:
+    static constexpr uint8_t INDEX = 3;
+    static constexpr uint8_t FRESH = 4;   // Middle slot holds an unread value
+
+    T slots[3];
+    alignas(64) std::atomic<uint8_t> middle;
+    alignas(64) uint8_t back;    // Writer only
+    alignas(64) uint8_t front;   // Reader only
+};
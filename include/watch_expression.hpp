@@ -0,0 +1,318 @@
+#pragma once
+#include "air_data.hpp"
+#include "aircraft.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define WATCH_USE_SSE2 1
+#endif
+
+// What a watch sees after one physics step
+struct WatchSample {
+    double time;            // Sim time, s
+    AircraftState state;
+    AirData airData;
+};
+
+// A watch expression compiled to stack bytecode. Expressions are C-like
+// over the named state and air-data values (SI units, radians):
+//
+//   alpha > 15 deg && airspeed < 45
+//   abs(roll) > 60 deg or nz > 3.5
+//   vs < -1500 fpm and altitude < 300 ft
+//
+// Operators: + - * / (unary -), < <= > >= == !=, && || ! (or and/or/not);
+// functions abs, sqrt, min, max; numbers may carry a unit (deg or °, rad,
+// kt, ft, fpm, m, s), converted to SI at compile time. Comparisons and
+// logic give 1 or 0; a watch is "true" when non-zero. The variable names
+// are in the table behind variableName() (the watch panel lists them).
+class WatchProgram {
+public:
+    enum class Op : uint8_t {
+        VARIABLE,        // Push variable `operand`
+        CONSTANT,        // Push constants[operand]
+        ADD, SUB, MUL, DIV, MIN, MAX,
+        LT, LE, GT, GE, EQ, NE,
+        AND, OR,
+        NEG, ABS, SQRT, NOT,
+        JUMP_IF_FALSE,   // && short cut: keep the top and go to `operand` if it is false
+        JUMP_IF_TRUE     // || short cut
+    };
+
+    // Binary operators with `constantOperand` set take constants[operand]
+    // as their right-hand side instead of popping it (the common
+    // `variable > constant` is then two instructions)
+    struct Instruction {
+        Op op;
+        bool constantOperand;
+        uint16_t operand;
+    };
+
+    static constexpr int MAX_DEPTH = 16;
+    static constexpr int MAX_INSTRUCTIONS = 256;
+
+    // False with a message (including the column) on a syntax error
+    bool compile(const std::string& text, std::string& error);
+
+    // Scalar evaluation, the reference for the batched evaluator
+    double evaluate(const WatchSample& sample) const;
+
+    const std::vector<Instruction>& getInstructions() const { return instructions; }
+    const std::vector<double>& getConstants() const { return constants; }
+    int getMaxDepth() const { return maxDepth; }
+    uint64_t getVariableMask() const { return variableMask; }   // Bit i: variable i is read
+
+    // Variable table
+    static int variableCount();
+    static const char* variableName(int index);
+    static const char* variableDescription(int index);
+    static double variableValue(int index, const WatchSample& sample);
+
+private:
+    std::vector<Instruction> instructions;
+    std::vector<double> constants;
+    int maxDepth = 0;
+    uint64_t variableMask = 0;
+};
+
+enum WatchAction : unsigned int {
+    WATCH_PAUSE = 1,      // Stop the sim at the step the condition became true
+    WATCH_LOG = 2,        // Log each hit
+    WATCH_SNAPSHOT = 4    // Keep the sample of the latest hit
+};
+
+// Watches evaluated after every physics step, in blocks of BLOCK steps (a
+// quarter second at 1 kHz, or less on flush()). At the end of a block each
+// watch is first run over its variables' ranges across the block, which
+// most of the time shows it false (or true) at every step; the rest run
+// one instruction at a time across the block's steps, two steps per SSE2
+// instruction, with && / || skipping their right-hand side for the whole
+// block when the left-hand side decides it.
+//
+// A watch the ranges decided is then settled: it gets a guard interval on
+// each variable the decision rests on, widened as far as the decision
+// still holds, and is neither recorded nor evaluated while its variables
+// stay inside. record() checks the guards, two variables per SSE2 compare,
+// and stores only the variables the other watches read (a column per
+// variable, and the state when one of them keeps snapshots). A value
+// outside a guard makes the watches it guarded live again from that step.
+// 50 watches cost about 3% of a dynamics step, where interpreting each
+// watch every step costs more than the step itself (see `--bench
+// watches`). All memory is allocated up front.
+//
+// Hits are rising edges of the condition and are exact to the step. A
+// pause watch that is not settled is also evaluated at every step, so the
+// break is pending (hasBreak()) right after the step that hit it; log and
+// snapshot actions run when the block is evaluated, up to one block after
+// the hit.
+class WatchEngine {
+public:
+    static constexpr int MAX_WATCHES = 64;
+    static constexpr int BLOCK = 256;   // Steps per evaluation
+    // Stride of the recorded columns: a cache line of padding staggers the
+    // cache sets of the lines record() writes together
+    static constexpr int COLUMN = BLOCK + 8;
+    static constexpr int MAX_GUARDS = 4;   // Variables a watch may be settled on
+    static constexpr int CACHED_BOXES = 8;
+
+    struct Watch {
+        int id;
+        std::string text;
+        unsigned int actions;
+        bool enabled;
+        uint64_t hits;
+        double lastHitTime;     // NAN until the first hit
+        bool hasSnapshot;
+        WatchSample snapshot;   // Latest hit, with WATCH_SNAPSHOT or WATCH_PAUSE (time,
+                                // state and the air data the watches read; NAN elsewhere)
+    };
+
+    WatchEngine();
+
+    // Returns the watch id, or -1 with a message when the expression does
+    // not compile or all MAX_WATCHES are in use
+    int add(const std::string& text, unsigned int actions, std::string& error);
+    bool remove(int id);
+    void clear();
+    void setActions(int id, unsigned int actions);
+    void setEnabled(int id, bool enabled);
+
+    size_t size() const { return watches.size(); }
+    const Watch& operator[](size_t index) const { return watches[index]; }
+
+    // At the latest evaluated step: NAN before any, or when the watch reads
+    // a variable that was not recorded at that step (the last step of a
+    // full block is recorded whole)
+    double value(size_t index) const;
+
+    // After each FlightDynamics::update
+    void record(double simTime, const AircraftState& state, const AirData& airData) {
+        if (active == 0) return;
+        // Locals, so the stores need not be assumed to change them
+        const int step = pending, split = stateSlots, count = slotCount;
+        const Slot* slot = slots;
+        columns[step] = simTime;   // Column 0, kept for the hit times
+        int k = 0;
+        for (; k < split; k++) slot[k].column[step] = readDouble(&state, slot[k].offset);
+        for (; k < count; k++) slot[k].column[step] = readDouble(&airData, slot[k].offset);
+        if (keepStates) states[step] = state;
+        pending = step + 1;
+        if (outsideGuards(simTime, state, airData) || pauseCount > 0 || pending == BLOCK) {
+            recorded(step, simTime, state, airData);
+        }
+    }
+
+    // Evaluate the steps recorded so far
+    void flush();
+
+    // After a reset, rewind or restore: drops unevaluated steps and takes
+    // the conditions at `sample` as the previous step, so a condition that
+    // is already true there is not a new hit
+    void resync(const WatchSample& sample);
+
+    // A pause watch was hit: stop stepping. takeBreak() gives the sample to
+    // stop at (the earliest hit) and clears it.
+    bool hasBreak() const { return breakPending; }
+    bool takeBreak(WatchSample& sample);
+
+    struct Stats {
+        uint64_t steps;         // Evaluated
+        double meanStepNs;      // Block evaluation per step (record() excluded)
+        double settledFraction; // Of watch blocks, settled by guards (no work)
+        double steppedFraction; // Of watch blocks, not decided by the variable ranges
+        uint64_t guardCrossings;
+    };
+    Stats getStats() const;
+
+private:
+    // Guard intervals on the variables a decision rests on, as far as it
+    // still holds
+    struct Box {
+        int count;
+        uint8_t variable[MAX_GUARDS];
+        double lo[MAX_GUARDS];
+        double hi[MAX_GUARDS];
+    };
+
+    // What record(), crossed() and updateGuards() read first, then the rest
+    struct Compiled {
+        bool enabled;           // Copies of the watch's
+        unsigned int actions;
+        bool previous;          // Condition at the last evaluated step
+        bool current;           // At the latest step, for pause watches checked each step
+        int liveFrom;           // Step of the block it is evaluated from, -1 while settled
+        Box guards;             // While settled
+        uint64_t searchFrom;    // Step it may next search for a box from, counting all steps
+        WatchProgram program;
+        Box boxes[2][CACHED_BOXES];   // Settled in before, false and true, for reuse
+        int boxCount[2];
+        int nextBox[2];
+    };
+
+    // A variable record() copies: `offset` into the AircraftState (the
+    // first stateSlots) or the AirData
+    struct Slot {
+        double* column;
+        size_t offset;
+    };
+
+    // Two guarded variables of the same struct (state pairs first), one
+    // SSE2 compare per bound
+    struct alignas(16) GuardPair {
+        double lo[2];
+        double hi[2];
+        size_t offset[2];
+    };
+
+    static double readDouble(const void* source, size_t offset) {
+        double value;
+        std::memcpy(&value, (const char*)source + offset, sizeof(value));
+        return value;
+    }
+
+    // The settled watches' guards; NaN is outside
+    bool outsideGuards(double simTime, const AircraftState& state, const AirData& airData) const {
+        bool outside = !(simTime >= timeLo && simTime <= timeHi);
+        const int split = statePairs, count = pairCount;
+        int k = 0;
+#ifdef WATCH_USE_SSE2
+        __m128d out = _mm_setzero_pd();
+        for (; k < count; k++) {
+            const GuardPair& pair = pairs[k];
+            const char* source = k < split ? (const char*)&state : (const char*)&airData;
+            __m128d x = _mm_loadh_pd(_mm_load_sd((const double*)(source + pair.offset[0])),
+                                     (const double*)(source + pair.offset[1]));
+            out = _mm_or_pd(out, _mm_or_pd(_mm_cmpnge_pd(x, _mm_load_pd(pair.lo)),
+                                           _mm_cmpnle_pd(x, _mm_load_pd(pair.hi))));
+        }
+        outside |= _mm_movemask_pd(out) != 0;
+#else
+        for (; k < count; k++) {
+            const void* source = k < split ? (const void*)&state : (const void*)&airData;
+            for (int lane = 0; lane < 2; lane++) {
+                double x = readDouble(source, pairs[k].offset[lane]);
+                outside |= !(x >= pairs[k].lo[lane] && x <= pairs[k].hi[lane]);
+            }
+        }
+#endif
+        return outside;
+    }
+
+    void recorded(int step, double simTime, const AircraftState& state, const AirData& airData);
+    void evaluateBlock();
+    void sampleAt(int step, WatchSample& sample) const;
+    bool hit(size_t index, double time, double value);
+    void snapshotTaken(size_t index);
+    void crossed(int step, double simTime, const AircraftState& state, const AirData& airData);
+    void checkPauses(int step, double simTime, const AircraftState& state, const AirData& airData);
+    void updateRecording(int from);
+    void updateGuards();
+
+    std::vector<Watch> watches;
+    std::vector<Compiled> programs;   // Parallel to watches
+    int nextId;
+    int active;                       // Enabled watches
+
+    int pending;                      // Steps recorded in the block
+    uint64_t recordMask;              // Variables read by live watches
+    int recordedFrom[64];             // Their first recorded step in the block
+    Slot slots[64];                   // Those of recordMask but time
+    int stateSlots;
+    int slotCount;
+    bool keepStates;                  // A live watch snapshots or pauses
+    int statesFrom;
+    int pauses[MAX_WATCHES];          // Live pause watches
+    int pauseCount;
+
+    // Intersection of the settled watches' guards
+    uint64_t guardMask;
+    double guardLo[64], guardHi[64];
+    GuardPair pairs[32];
+    int statePairs;
+    int pairCount;
+    double timeLo, timeHi;            // Time is not in the state or air data
+
+    // One column of BLOCK steps per variable (time always recorded), the
+    // states when kept, and the evaluation stack, one column per level
+    std::vector<double> columns;
+    std::vector<AircraftState> states;
+    std::vector<double> scratch;
+
+    WatchSample lastSample;           // Latest evaluated step, for value()
+    uint64_t lastMask;                // Its variables that were recorded
+
+    bool breakPending;
+    WatchSample breakSample;
+
+    uint64_t evaluatedSteps;
+    double evaluationNs;
+    uint64_t watchBlocks;             // One per enabled watch per block
+    uint64_t settledBlocks;
+    uint64_t steppedBlocks;
+    uint64_t guardCrossings;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "watch_expression.hpp"
+#include <string>
+
+// ImGui window for watch expressions: type an expression, pick its actions
+// (pause, log, snapshot) and add it; each watch shows its current value,
+// hit count and last hit, and a snapshot can be restored. The variables
+// an expression can use are listed with their units.
+class WatchPanel {
+public:
+    WatchPanel();
+
+    void render(WatchEngine& watches, bool* open = nullptr);
+
+    // The snapshot the user asked to restore since the last call
+    bool takeRestore(WatchSample& sample);
+
+private:
+    char text[256];
+    bool pause;
+    bool log;
+    bool snapshot;
+    std::string error;
+
+    bool restorePending;
+    WatchSample restoreSample;
+};
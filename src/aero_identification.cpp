@@ -0,0 +1,381 @@
+#include "aero_identification.hpp"
+#include "aircraft_types.hpp"
+#include "atmosphere.hpp"
+#include "logger.hpp"
+#include "small_matrix.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const double GRAVITY = 9.81;                // m/s^2, as in FlightDynamics
+const size_t BLOCK_SIZE = 16384;            // Log intervals per work item
+const double CONFIDENCE_SCALE = 1.96;       // Standard errors to the 95% bounds
+const double MIN_EXCITATION = 1e-10;        // Regressor variance below this is not excited
+const double MAX_CONDITION = 1e8;           // Of the scaled normal equations; above is not solved
+
+// Terms of each equation in regressor order, and the values the runtime
+// Aircraft (built from Cessna172) flies with
+const char* const LIFT_TERMS[] = {"LIFT0", "LIFT_ALPHA", "LIFT_ELEVATOR"};
+const double LIFT_PRIORS[] = {Cessna172::LIFT0, Cessna172::LIFT_ALPHA, Cessna172::LIFT_ELEVATOR};
+const char* const DRAG_TERMS[] = {"DRAG0", "DRAG_INDUCED"};
+const double DRAG_PRIORS[] = {Cessna172::DRAG0, Cessna172::DRAG_INDUCED};
+const char* const SIDE_TERMS[] = {"SIDE_BETA", "SIDE_RUDDER"};
+const double SIDE_PRIORS[] = {Cessna172::SIDE_BETA, Cessna172::SIDE_RUDDER};
+const char* const ROLL_TERMS[] = {"ROLL_BETA", "ROLL_AILERON", "ROLL_RUDDER", "ROLL_DAMPING"};
+const double ROLL_PRIORS[] = {Cessna172::ROLL_BETA, Cessna172::ROLL_AILERON, Cessna172::ROLL_RUDDER,
+                              Cessna172::ROLL_DAMPING};
+const char* const PITCH_TERMS[] = {"PITCH0", "PITCH_ALPHA", "PITCH_ELEVATOR", "PITCH_DAMPING"};
+const double PITCH_PRIORS[] = {Cessna172::PITCH0, Cessna172::PITCH_ALPHA, Cessna172::PITCH_ELEVATOR,
+                               Cessna172::PITCH_DAMPING};
+const char* const YAW_TERMS[] = {"YAW_BETA", "YAW_AILERON", "YAW_RUDDER", "YAW_DAMPING"};
+const double YAW_PRIORS[] = {Cessna172::YAW_BETA, Cessna172::YAW_AILERON, Cessna172::YAW_RUDDER,
+                             Cessna172::YAW_DAMPING};
+
+// Sufficient statistics of y = x . theta over a set of samples
+template <int P>
+struct NormalEquations {
+    Matrix<P, P> information;     // X^T X
+    ColumnVector<P> projection;   // X^T y
+    ColumnVector<P> regressorSums;
+    double sumSquares = 0.0;      // y^T y
+    double sum = 0.0;
+    size_t count = 0;
+
+    void add(const double (&x)[P], double y) {
+        for (int r = 0; r < P; r++) {
+            for (int c = 0; c < P; c++) information(r, c) += x[r] * x[c];
+            projection[r] += x[r] * y;
+            regressorSums[r] += x[r];
+        }
+        sumSquares += y * y;
+        sum += y;
+        count++;
+    }
+
+    void merge(const NormalEquations& other) {
+        information = information + other.information;
+        projection = projection + other.projection;
+        regressorSums = regressorSums + other.regressorSums;
+        sumSquares += other.sumSquares;
+        sum += other.sum;
+        count += other.count;
+    }
+};
+
+struct BlockSums {
+    NormalEquations<3> lift;
+    NormalEquations<2> drag;
+    NormalEquations<2> side;
+    NormalEquations<4> roll;
+    NormalEquations<4> pitch;
+    NormalEquations<4> yaw;
+    size_t skipped = 0;
+
+    void merge(const BlockSums& other) {
+        lift.merge(other.lift);
+        drag.merge(other.drag);
+        side.merge(other.side);
+        roll.merge(other.roll);
+        pitch.merge(other.pitch);
+        yaw.merge(other.yaw);
+        skipped += other.skipped;
+    }
+};
+
+struct PhysicalProperties {
+    double mass;
+    double wingArea;
+    double wingSpan;
+    double chord;
+    Vector3 inertia;
+    double maxThrust;
+};
+
+// Measured coefficients over one log interval, added to the sums; false if
+// the interval is not usable
+bool addInterval(const FlightLogSample& start, const FlightLogSample& end, const PhysicalProperties& aircraft,
+                 Atmosphere& atmosphere, BlockSums& sums) {
+    double h = end.time - start.time;
+    if (!(h > 0.0 && h <= AeroIdentification::MAX_INTERVAL)) return false;
+    const AircraftState& a = start.state;
+    const AircraftState& b = end.state;
+    if (a.position.z >= 0.0 || b.position.z >= 0.0) return false;   // On the ground
+
+    // Midpoint state, interval-mean accelerations
+    Vector3 velocity = (a.velocity + b.velocity) * 0.5;
+    Vector3 rates = (a.angularVelocity + b.angularVelocity) * 0.5;
+    double roll = 0.5 * (a.roll + b.roll);
+    double pitch = 0.5 * (a.pitch + b.pitch);
+    double altitude = -0.5 * (a.position.z + b.position.z);
+    Vector3 acceleration = (b.velocity - a.velocity) / h;
+    Vector3 angularAcceleration = (b.angularVelocity - a.angularVelocity) / h;
+
+    double speed = velocity.magnitude();
+    if (speed < AeroIdentification::MIN_AIRSPEED || velocity.x <= 0.1) return false;
+
+    double density, pressure, temperature, speedOfSound;
+    atmosphere.getProperties(altitude, density, pressure, temperature, speedOfSound);
+    double qS = 0.5 * density * speed * speed * aircraft.wingArea;
+    double alpha = std::atan2(velocity.z, velocity.x);
+    double beta = std::asin(velocity.y / speed);
+
+    // Aerodynamic force: what the accelerations need beyond thrust and gravity
+    double sr = std::sin(roll), cr = std::cos(roll);
+    double sp = std::sin(pitch), cp = std::cos(pitch);
+    Vector3 gravity(-aircraft.mass * GRAVITY * sp, aircraft.mass * GRAVITY * sr * cp,
+                    aircraft.mass * GRAVITY * cr * cp);
+    Vector3 thrust(a.throttle * aircraft.maxThrust, 0, 0);
+    Vector3 aeroForce = (acceleration + rates.cross(velocity)) * aircraft.mass - thrust - gravity;
+
+    // Wind to body as in FlightDynamics::calculateForces, inverted
+    double sa = std::sin(alpha), ca = std::cos(alpha);
+    double CL = (aeroForce.x * sa - aeroForce.z * ca) / qS;
+    double CD = -(aeroForce.x * ca + aeroForce.z * sa) / qS;
+    double CY = aeroForce.y / qS;
+
+    // Moments from Euler's equations
+    double p = rates.x, q = rates.y, r = rates.z;
+    const Vector3& I = aircraft.inertia;
+    double Cl = (I.x * angularAcceleration.x + (I.z - I.y) * q * r) / (qS * aircraft.wingSpan);
+    double Cm = (I.y * angularAcceleration.y + (I.x - I.z) * p * r) / (qS * aircraft.chord);
+    double Cn = (I.z * angularAcceleration.z + (I.y - I.x) * p * q) / (qS * aircraft.wingSpan);
+
+    double pHat = p * aircraft.wingSpan / (2.0 * speed);
+    double qHat = q * aircraft.chord / (2.0 * speed);
+    double rHat = r * aircraft.wingSpan / (2.0 * speed);
+
+    const double liftTerms[3] = {1.0, alpha, a.elevator};
+    const double dragTerms[2] = {1.0, CL * CL};
+    const double sideTerms[2] = {beta, a.rudder};
+    const double rollTerms[4] = {beta, a.aileron, a.rudder, pHat};
+    const double pitchTerms[4] = {1.0, alpha, a.elevator, qHat};
+    const double yawTerms[4] = {beta, a.aileron, a.rudder, rHat};
+    sums.lift.add(liftTerms, CL);
+    sums.drag.add(dragTerms, CD);
+    sums.side.add(sideTerms, CY);
+    sums.roll.add(rollTerms, Cl);
+    sums.pitch.add(pitchTerms, Cm);
+    sums.yaw.add(yawTerms, Cn);
+    return true;
+}
+
+// `intercept` is the index of the constant term (regressor 1), or -1
+template <int P>
+void solve(NormalEquations<P> equations, const char* name, const char* const (&names)[P],
+           const double (&priors)[P], int intercept, CoefficientFit& fit) {
+    fit.name = name;
+    fit.termCount = P;
+    fit.samples = equations.count;
+    fit.residualRms = 0.0;
+    fit.rSquared = 0.0;
+    fit.condition = 0.0;
+    fit.solved = false;
+    for (int j = 0; j < P; j++) {
+        fit.terms[j] = {names[j], priors[j], priors[j], 0.0, priors[j], priors[j], false};
+    }
+    if (equations.count == 0) return;
+
+    double n = (double)equations.count;
+    double totalSquares = equations.sumSquares - equations.sum * equations.sum / n;
+
+    // A regressor is excited if it varied; one held at a constant value is
+    // indistinguishable from the intercept. Hold unexcited terms at the
+    // prior: move their contribution to the measurement side and pin the
+    // row to identity.
+    int freeTerms = 0;
+    for (int j = 0; j < P; j++) {
+        double mean = equations.regressorSums[j] / n;
+        double variance = equations.information(j, j) / n - mean * mean;
+        fit.terms[j].excited = j == intercept || variance > MIN_EXCITATION;
+        if (fit.terms[j].excited) {
+            freeTerms++;
+            continue;
+        }
+        double c = priors[j];
+        equations.sumSquares += -2.0 * c * equations.projection[j] + c * c * equations.information(j, j);
+        for (int r = 0; r < P; r++) equations.projection[r] -= c * equations.information(r, j);
+        for (int k = 0; k < P; k++) {
+            equations.information(j, k) = 0.0;
+            equations.information(k, j) = 0.0;
+        }
+        equations.information(j, j) = 1.0;
+        equations.projection[j] = 0.0;
+    }
+    if (equations.count <= (size_t)freeTerms) return;
+
+    // Solve on the equations scaled to unit diagonal, so the condition
+    // number reflects collinearity rather than regressor units; a
+    // rank-deficient or ill-conditioned set is left unsolved
+    double scale[P];
+    for (int j = 0; j < P; j++) scale[j] = 1.0 / std::sqrt(equations.information(j, j));
+    Matrix<P, P> scaled;
+    for (int r = 0; r < P; r++) {
+        for (int c = 0; c < P; c++) scaled(r, c) = equations.information(r, c) * scale[r] * scale[c];
+    }
+    Matrix<P, P> scaledInverse;
+    if (!invertSymmetric(scaled, scaledInverse)) return;
+    double norm = 0.0, inverseNorm = 0.0;
+    for (int r = 0; r < P; r++) {
+        double rowSum = 0.0, inverseRowSum = 0.0;
+        for (int c = 0; c < P; c++) {
+            rowSum += std::fabs(scaled(r, c));
+            inverseRowSum += std::fabs(scaledInverse(r, c));
+        }
+        norm = std::max(norm, rowSum);
+        inverseNorm = std::max(inverseNorm, inverseRowSum);
+    }
+    fit.condition = norm * inverseNorm;
+    if (!(fit.condition <= MAX_CONDITION)) return;
+
+    Matrix<P, P> covariance;
+    for (int r = 0; r < P; r++) {
+        for (int c = 0; c < P; c++) covariance(r, c) = scaledInverse(r, c) * scale[r] * scale[c];
+    }
+    ColumnVector<P> theta = covariance * equations.projection;
+
+    double residualSquares = equations.sumSquares;
+    for (int j = 0; j < P; j++) residualSquares -= theta[j] * equations.projection[j];
+    residualSquares = std::max(residualSquares, 0.0);
+    double variance = residualSquares / (n - freeTerms);
+
+    for (int j = 0; j < P; j++) {
+        IdentifiedCoefficient& term = fit.terms[j];
+        if (!term.excited) continue;
+        term.value = theta[j];
+        term.standardError = std::sqrt(variance * covariance(j, j));
+        term.lower = term.value - CONFIDENCE_SCALE * term.standardError;
+        term.upper = term.value + CONFIDENCE_SCALE * term.standardError;
+    }
+    fit.residualRms = std::sqrt(residualSquares / n);
+    fit.rSquared = totalSquares > 0.0 ? 1.0 - residualSquares / totalSquares : 0.0;
+    fit.solved = true;
+}
+
+} // namespace
+
+bool AeroIdentification::identify(const FlightLog& log, const Aircraft& aircraft, unsigned int threadCount) {
+    auto start = std::chrono::steady_clock::now();
+
+    mass = aircraft.getMass();
+    wingArea = aircraft.getWingArea();
+    wingSpan = aircraft.getWingSpan();
+    chord = aircraft.getChord();
+    inertia = aircraft.getInertia();
+    maxThrust = aircraft.getMaxThrust();
+    const PhysicalProperties properties = {mass, wingArea, wingSpan, chord, inertia, maxThrust};
+
+    // Per-block sums, reduced in block order after the parallel pass
+    size_t intervals = log.size() > 1 ? log.size() - 1 : 0;
+    size_t blocks = (intervals + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::vector<BlockSums> blockSums(blocks);
+    const FlightLogSample* samples = log.getSamples().data();
+
+    ThreadPool pool(threadCount);
+    pool.parallelFor(blocks, [&](size_t block) {
+        Atmosphere atmosphere;
+        BlockSums& sums = blockSums[block];
+        size_t end = std::min(intervals, (block + 1) * BLOCK_SIZE);
+        for (size_t i = block * BLOCK_SIZE; i < end; i++) {
+            if (!addInterval(samples[i], samples[i + 1], properties, atmosphere, sums)) sums.skipped++;
+        }
+    });
+
+    BlockSums total;
+    for (const BlockSums& sums : blockSums) total.merge(sums);
+
+    solve(total.lift, "CL", LIFT_TERMS, LIFT_PRIORS, 0, fits[EQUATION_LIFT]);
+    solve(total.drag, "CD", DRAG_TERMS, DRAG_PRIORS, 0, fits[EQUATION_DRAG]);
+    solve(total.side, "CY", SIDE_TERMS, SIDE_PRIORS, -1, fits[EQUATION_SIDE_FORCE]);
+    solve(total.roll, "Cl", ROLL_TERMS, ROLL_PRIORS, -1, fits[EQUATION_ROLL]);
+    solve(total.pitch, "Cm", PITCH_TERMS, PITCH_PRIORS, 0, fits[EQUATION_PITCH]);
+    solve(total.yaw, "Cn", YAW_TERMS, YAW_PRIORS, -1, fits[EQUATION_YAW]);
+
+    usedCount = total.lift.count;
+    skippedCount = total.skipped;
+    threadsUsed = pool.getThreadCount();
+    solveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (usedCount == 0) {
+        LOG_ERROR("No usable intervals in a flight log of %zu samples", log.size());
+        return false;
+    }
+    for (const CoefficientFit& fit : fits) {
+        if (!fit.solved) {
+            LOG_WARN("%s could not be identified (collinear or ill-conditioned regressors, condition %.3g); "
+                     "priors kept", fit.name, fit.condition);
+        }
+    }
+    return true;
+}
+
+bool AeroIdentification::saveCSV(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "equation,coefficient,prior,value,standard_error,lower_95,upper_95,excited\n");
+    for (const CoefficientFit& fit : fits) {
+        for (int j = 0; j < fit.termCount; j++) {
+            const IdentifiedCoefficient& term = fit.terms[j];
+            std::fprintf(file, "%s,%s,%.9g,%.9g,%.3g,%.9g,%.9g,%d\n", fit.name, term.name, term.prior, term.value,
+                         term.standardError, term.lower, term.upper, term.excited ? 1 : 0);
+        }
+    }
+
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
+
+bool AeroIdentification::saveTypeHeader(const std::string& path, const std::string& typeName) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::string name = typeName;
+    for (char& c : name) c = (char)std::tolower((unsigned char)c);
+
+    std::fprintf(file, "// Identified from %zu flight-log intervals; comments give one standard error\n", usedCount);
+    std::fprintf(file, "struct %s {\n", typeName.c_str());
+    std::fprintf(file, "    static constexpr const char* NAME = \"%s\";\n", name.c_str());
+    std::fprintf(file, "    static constexpr const char* DESCRIPTION = \"Identified from a flight log\";\n\n");
+    std::fprintf(file, "    static constexpr double MASS = %.9g;\n", mass);
+    std::fprintf(file, "    static constexpr double WING_AREA = %.9g;\n", wingArea);
+    std::fprintf(file, "    static constexpr double WING_SPAN = %.9g;\n", wingSpan);
+    std::fprintf(file, "    static constexpr double CHORD = %.9g;\n", chord);
+    std::fprintf(file, "    static constexpr double IXX = %.9g;\n", inertia.x);
+    std::fprintf(file, "    static constexpr double IYY = %.9g;\n", inertia.y);
+    std::fprintf(file, "    static constexpr double IZZ = %.9g;\n", inertia.z);
+    std::fprintf(file, "    static constexpr double MAX_THRUST = %.9g;\n\n", maxThrust);
+    for (const CoefficientFit& fit : fits) {
+        for (int j = 0; j < fit.termCount; j++) {
+            const IdentifiedCoefficient& term = fit.terms[j];
+            if (term.excited && fit.solved) {
+                std::fprintf(file, "    static constexpr double %s = %.9g;   // +- %.2g\n", term.name, term.value,
+                             term.standardError);
+            } else {
+                std::fprintf(file, "    static constexpr double %s = %.9g;   // Prior (%s)\n", term.name, term.value,
+                             term.excited ? "not identified" : "not excited");
+            }
+        }
+    }
+    std::fprintf(file, "};\n");
+
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
@@ -0,0 +1,54 @@
+#include "air_data.hpp"
+#include "fp_determinism.hpp"
+#include <cmath>
+
+namespace {
+
+const double GRAVITY = 9.81;
+const double SEA_LEVEL_DENSITY = 1.225;   // kg/m^3
+
+} // namespace
+
+AirData computeAirData(const Aircraft& aircraft, Atmosphere& atmosphere) {
+    return computeAirData(aircraft, atmosphere, aircraft.getAltitude());
+}
+
+AirData computeAirData(const Aircraft& aircraft, Atmosphere& atmosphere, double altitude) {
+    const AircraftState& state = aircraft.getState();
+    AirData data;
+    
+    double density, pressure, temperature, speedOfSound;
+    data.altitude = altitude;
+    atmosphere.getProperties(data.altitude, density, pressure, temperature, speedOfSound);
+    
+    double cr = std::cos(state.roll);
+    double sr = std::sin(state.roll);
+    double cp = std::cos(state.pitch);
+    double sp = std::sin(state.pitch);
+    
+    // Body velocity rotated into the earth frame, positive up
+    data.verticalSpeed = sp * state.velocity.x - cp * sr * state.velocity.y - cp * cr * state.velocity.z;
+    
+    data.trueAirspeed = aircraft.getAirspeed();
+    data.indicatedAirspeed = data.trueAirspeed * std::sqrt(density / SEA_LEVEL_DENSITY);
+    data.mach = data.trueAirspeed / speedOfSound;
+    data.alpha = aircraft.getAngleOfAttack();
+    data.beta = aircraft.getSideslip();
+    data.dynamicPressure = 0.5 * density * data.trueAirspeed * data.trueAirspeed;
+    data.density = density;
+    data.staticPressure = pressure;
+    data.densityAltitude = atmosphere.getDensityAltitude(density);
+    setSpecificForce(data, Vector3(0, 0, 0));
+    
+    // Heading rate from the body rates (Euler kinematics)
+    double q = state.angularVelocity.y;
+    double r = state.angularVelocity.z;
+    data.turnRate = std::fabs(cp) > 1e-6 ? (sr * q + cr * r) / cp : 0.0;
+    
+    return data;
+}
+
+void setSpecificForce(AirData& data, const Vector3& specificForce) {
+    data.specificForce = specificForce;
+    data.loadFactor = -specificForce.z / GRAVITY;
+}
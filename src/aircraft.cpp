@@ -1,5 +1,8 @@
 #include "aircraft.hpp"
+#include "aircraft_types.hpp"
 #include "atmosphere.hpp"
+#include "fp_determinism.hpp"
+#include <algorithm>
 #include <cmath>
 
 Aircraft::Aircraft() {
@@ -16,18 +19,18 @@ Aircraft::Aircraft() {
     state.throttle = 0.5;
     
     // Cessna 172 approximate properties
-    mass = 1043.0;        // kg
-    wingArea = 16.2;      // m^2
-    wingSpan = 11.0;      // m
-    chord = 1.47;         // m
+    mass = Cessna172::MASS;
+    wingArea = Cessna172::WING_AREA;
+    wingSpan = Cessna172::WING_SPAN;
+    chord = Cessna172::CHORD;
     
     // Moments of inertia (kg·m^2)
-    Ixx = 1285.3;
-    Iyy = 1824.9;
-    Izz = 2666.9;
+    Ixx = Cessna172::IXX;
+    Iyy = Cessna172::IYY;
+    Izz = Cessna172::IZZ;
     Ixz = 0.0;
     
-    maxThrust = 2000.0;   // N
+    maxThrust = Cessna172::MAX_THRUST;
 }
 
 double Aircraft::getAirspeed() const {
@@ -70,17 +73,17 @@ double Aircraft::getMachNumber() const {
 // Aerodynamic coefficients (simplified models)
 double Aircraft::getCL(double alpha, double elevator) const {
     // Lift coefficient: CL = CL0 + CLalpha * alpha + CLde * elevator
-    double CL0 = 0.28;
-    double CLalpha = 4.58;  // per radian
-    double CLde = 0.36;
+    double CL0 = Cessna172::LIFT0;
+    double CLalpha = Cessna172::LIFT_ALPHA;  // per radian
+    double CLde = Cessna172::LIFT_ELEVATOR;
     
     return CL0 + CLalpha * alpha + CLde * elevator;
 }
 
 double Aircraft::getCD(double alpha) const {
     // Drag coefficient: CD = CD0 + CDi (induced drag)
-    double CD0 = 0.027;
-    double K = 0.045;  // Induced drag factor
+    double CD0 = Cessna172::DRAG0;
+    double K = Cessna172::DRAG_INDUCED;  // Induced drag factor
     double CL = getCL(alpha, state.elevator);
     
     return CD0 + K * CL * CL;
@@ -88,47 +91,49 @@ double Aircraft::getCD(double alpha) const {
 
 double Aircraft::getCY(double beta, double rudder) const {
     // Side force coefficient
-    double CYbeta = -0.393;
-    double CYdr = 0.187;
+    double CYbeta = Cessna172::SIDE_BETA;
+    double CYdr = Cessna172::SIDE_RUDDER;
     
     return CYbeta * beta + CYdr * rudder;
 }
 
 double Aircraft::getCl(double beta, double aileron, double rudder) const {
     // Rolling moment coefficient
-    double Clbeta = -0.074;
-    double Clda = 0.178;
-    double Cldr = 0.0147;
-    double Clp = -0.484;  // Roll damping
+    double Clbeta = Cessna172::ROLL_BETA;
+    double Clda = Cessna172::ROLL_AILERON;
+    double Cldr = Cessna172::ROLL_RUDDER;
+    double Clp = Cessna172::ROLL_DAMPING;
     
+    // Airspeed floored as in the force model, so the damping terms stay
+    // finite at rest (0/0 otherwise)
     double p = state.angularVelocity.x;
-    double pHat = p * wingSpan / (2.0 * getAirspeed());
+    double pHat = p * wingSpan / (2.0 * std::max(getAirspeed(), 0.1));
     
     return Clbeta * beta + Clda * aileron + Cldr * rudder + Clp * pHat;
 }
 
 double Aircraft::getCm(double alpha, double elevator) const {
     // Pitching moment coefficient
-    double Cm0 = 0.04;
-    double Cmalpha = -0.613;
-    double Cmde = -1.122;
-    double Cmq = -12.4;  // Pitch damping
+    double Cm0 = Cessna172::PITCH0;
+    double Cmalpha = Cessna172::PITCH_ALPHA;
+    double Cmde = Cessna172::PITCH_ELEVATOR;
+    double Cmq = Cessna172::PITCH_DAMPING;
     
     double q = state.angularVelocity.y;
-    double qHat = q * chord / (2.0 * getAirspeed());
+    double qHat = q * chord / (2.0 * std::max(getAirspeed(), 0.1));
     
     return Cm0 + Cmalpha * alpha + Cmde * elevator + Cmq * qHat;
 }
 
 double Aircraft::getCn(double beta, double aileron, double rudder) const {
     // Yawing moment coefficient
-    double Cnbeta = 0.071;
-    double Cnda = -0.0504;
-    double Cndr = -0.0805;
-    double Cnr = -0.125;  // Yaw damping
+    double Cnbeta = Cessna172::YAW_BETA;
+    double Cnda = Cessna172::YAW_AILERON;
+    double Cndr = Cessna172::YAW_RUDDER;
+    double Cnr = Cessna172::YAW_DAMPING;
     
     double r = state.angularVelocity.z;
-    double rHat = r * wingSpan / (2.0 * getAirspeed());
+    double rHat = r * wingSpan / (2.0 * std::max(getAirspeed(), 0.1));
     
     return Cnbeta * beta + Cnda * aileron + Cndr * rudder + Cnr * rHat;
 }
@@ -0,0 +1,161 @@
+#include "aircraft_types.hpp"
+#include "fp_determinism.hpp"
+#include <cmath>
+
+namespace {
+
+const double GRAVITY = 9.81;   // m/s^2, as in FlightDynamics
+
+// The FlightDynamics equations with the aircraft as a template parameter.
+// Operations are in the same order as flight_dynamics.cpp and aircraft.cpp,
+// so the Cessna instantiation reproduces the generic path bit for bit; the
+// gain comes from folded constants, inlining, and evaluating the atmosphere,
+// airspeed, alpha and beta once per derivative instead of once per use.
+template <typename Type, typename Math>
+struct TypedDynamics {
+    using StateDerivative = FlightDynamics::StateDerivative;
+
+    static StateDerivative derivative(const AircraftState& state, Atmosphere& atmosphere) {
+        StateDerivative deriv;
+
+        // Position derivative (body velocity to NED)
+        double cr, sr, cp, sp, cy, sy;
+        Math::sincos(state.roll, sr, cr);
+        Math::sincos(state.pitch, sp, cp);
+        Math::sincos(state.yaw, sy, cy);
+
+        deriv.positionDot.x = cy * cp * state.velocity.x +
+                             (cy * sp * sr - sy * cr) * state.velocity.y +
+                             (cy * sp * cr + sy * sr) * state.velocity.z;
+        deriv.positionDot.y = sy * cp * state.velocity.x +
+                             (sy * sp * sr + cy * cr) * state.velocity.y +
+                             (sy * sp * cr - cy * sr) * state.velocity.z;
+        deriv.positionDot.z = -sp * state.velocity.x +
+                              cp * sr * state.velocity.y +
+                              cp * cr * state.velocity.z;
+
+        // Air-relative quantities shared by forces and moments
+        double density, pressure, temperature, speedOfSound;
+        atmosphere.getPropertiesWith<Math>(-state.position.z, density, pressure, temperature, speedOfSound);
+        double speed = state.velocity.magnitude();
+        double airspeed = speed < 0.1 ? 0.1 : speed;
+        double dynamicPressure = 0.5 * density * airspeed * airspeed;
+        double alpha = state.velocity.x > 0.1 ? std::atan2(state.velocity.z, state.velocity.x) : 0.0;
+        double beta = speed > 0.1 ? std::asin(state.velocity.y / speed) : 0.0;
+        double qS = dynamicPressure * Type::WING_AREA;
+
+        // Forces
+        double CL = Type::LIFT0 + Type::LIFT_ALPHA * alpha + Type::LIFT_ELEVATOR * state.elevator;
+        double CD = Type::DRAG0 + Type::DRAG_INDUCED * CL * CL;
+        double CY = Type::SIDE_BETA * beta + Type::SIDE_RUDDER * state.rudder;
+        double ca, sa;
+        Math::sincos(alpha, sa, ca);
+
+        Vector3 aeroForce(qS * (-CD * ca + CL * sa), qS * CY, qS * (-CD * sa - CL * ca));
+        Vector3 thrust(state.throttle * Type::MAX_THRUST, 0, 0);
+        Vector3 gravity(-Type::MASS * GRAVITY * sp, Type::MASS * GRAVITY * sr * cp, Type::MASS * GRAVITY * cr * cp);
+        Vector3 forces = aeroForce + thrust + gravity;
+
+        deriv.velocityDot = forces / Type::MASS - state.angularVelocity.cross(state.velocity);
+
+        // Moments
+        double p = state.angularVelocity.x;
+        double q = state.angularVelocity.y;
+        double r = state.angularVelocity.z;
+
+        double Cl = Type::ROLL_BETA * beta + Type::ROLL_AILERON * state.aileron + Type::ROLL_RUDDER * state.rudder +
+                    Type::ROLL_DAMPING * (p * Type::WING_SPAN / (2.0 * airspeed));
+        double Cm = Type::PITCH0 + Type::PITCH_ALPHA * alpha + Type::PITCH_ELEVATOR * state.elevator +
+                    Type::PITCH_DAMPING * (q * Type::CHORD / (2.0 * airspeed));
+        double Cn = Type::YAW_BETA * beta + Type::YAW_AILERON * state.aileron + Type::YAW_RUDDER * state.rudder +
+                    Type::YAW_DAMPING * (r * Type::WING_SPAN / (2.0 * airspeed));
+
+        Vector3 moments(qS * Type::WING_SPAN * Cl, qS * Type::CHORD * Cm, qS * Type::WING_SPAN * Cn);
+
+        // Euler's equations
+        deriv.angularVelocityDot.x = (moments.x - (Type::IZZ - Type::IYY) * q * r) / Type::IXX;
+        deriv.angularVelocityDot.y = (moments.y - (Type::IXX - Type::IZZ) * p * r) / Type::IYY;
+        deriv.angularVelocityDot.z = (moments.z - (Type::IYY - Type::IXX) * p * q) / Type::IZZ;
+
+        // Euler angle derivatives
+        double tp = Math::tan(state.pitch);
+        deriv.eulerDot.x = p + sr * tp * q + cr * tp * r;
+        deriv.eulerDot.y = cr * q - sr * r;
+        deriv.eulerDot.z = (sr / cp) * q + (cr / cp) * r;
+
+        return deriv;
+    }
+
+    static AircraftState addScaled(const AircraftState& state, const StateDerivative& deriv, double scale) {
+        AircraftState newState = state;
+        newState.position += deriv.positionDot * scale;
+        newState.velocity += deriv.velocityDot * scale;
+        newState.angularVelocity += deriv.angularVelocityDot * scale;
+        newState.roll += deriv.eulerDot.x * scale;
+        newState.pitch += deriv.eulerDot.y * scale;
+        newState.yaw += deriv.eulerDot.z * scale;
+        return newState;
+    }
+
+    // RK4, as FlightDynamics::update without the air-data refresh
+    static void step(AircraftState& state, Atmosphere& atmosphere, double dt) {
+        StateDerivative k1 = derivative(state, atmosphere);
+        StateDerivative k2 = derivative(addScaled(state, k1, dt * 0.5), atmosphere);
+        StateDerivative k3 = derivative(addScaled(state, k2, dt * 0.5), atmosphere);
+        StateDerivative k4 = derivative(addScaled(state, k3, dt), atmosphere);
+
+        state.position += (k1.positionDot + k2.positionDot * 2.0 + k3.positionDot * 2.0 + k4.positionDot) * (dt / 6.0);
+        state.velocity += (k1.velocityDot + k2.velocityDot * 2.0 + k3.velocityDot * 2.0 + k4.velocityDot) * (dt / 6.0);
+        state.angularVelocity += (k1.angularVelocityDot + k2.angularVelocityDot * 2.0 + k3.angularVelocityDot * 2.0 + k4.angularVelocityDot) * (dt / 6.0);
+
+        Vector3 eulerDot = (k1.eulerDot + k2.eulerDot * 2.0 + k3.eulerDot * 2.0 + k4.eulerDot) * (dt / 6.0);
+        state.roll += eulerDot.x;
+        state.pitch += eulerDot.y;
+        state.yaw += eulerDot.z;
+
+        while (state.yaw > M_PI) state.yaw -= 2.0 * M_PI;
+        while (state.yaw < -M_PI) state.yaw += 2.0 * M_PI;
+
+        // Ground collision
+        if (state.position.z > 0.0) {
+            state.position.z = 0.0;
+            state.velocity = Vector3(0, 0, 0);
+            state.angularVelocity = Vector3(0, 0, 0);
+        }
+    }
+
+    static void stepMany(AircraftState* states, size_t count, Atmosphere& atmosphere, double dt) {
+#ifdef FLIGHT_DETERMINISTIC
+        ScopedFpEnvironment fpEnvironment;
+#endif
+        for (size_t i = 0; i < count; i++) {
+            step(states[i], atmosphere, dt);
+        }
+    }
+};
+
+template <typename Type>
+constexpr AircraftType describe() {
+    return {Type::NAME, Type::DESCRIPTION, Type::MASS, Type::WING_AREA, Type::WING_SPAN, Type::MAX_THRUST,
+            TypedDynamics<Type, SimMath>::derivative, TypedDynamics<Type, SimMath>::stepMany};
+}
+
+const AircraftType aircraftTypes[] = {
+    describe<Cessna172>(),
+    describe<PiperWarrior>(),
+    describe<Extra330>(),
+};
+
+} // namespace
+
+const AircraftType* findAircraftType(const std::string& name) {
+    for (const AircraftType& type : aircraftTypes) {
+        if (name == type.name) return &type;
+    }
+    return nullptr;
+}
+
+const AircraftType* getAircraftTypes(size_t& count) {
+    count = sizeof(aircraftTypes) / sizeof(aircraftTypes[0]);
+    return aircraftTypes;
+}
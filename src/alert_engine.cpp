@@ -0,0 +1,187 @@
+#include "alert_engine.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+const double FEET_PER_METER = 3.28084;
+
+// Radio-altitude style callouts, feet above terrain
+const double DEFAULT_CALLOUTS[] = {10, 20, 30, 40, 50, 100, 200, 300, 400, 500};
+
+// A callout re-arms once the aircraft climbs this far above it
+const double CALLOUT_REARM_FEET = 20.0;
+
+// Approximate GPWS envelopes: height above terrain (ft) -> rate (ft/min)
+const double SINK_RATE_MIN_FEET = 50.0;      // Mode 1 inhibited in the flare
+const double SINK_RATE_MAX_FEET = 2450.0;
+const double CLOSURE_MIN_FEET = 30.0;
+const double CLOSURE_MAX_FEET = 1650.0;
+const double CLOSURE_FILTER_SECONDS = 0.5;   // Smooths terrain steps under the aircraft
+
+// Lookahead: predicted impact within this time, above the terrain
+// clearance floor (below it an approach to land would trigger)
+const double TERRAIN_AHEAD_SECONDS = 20.0;
+const double TERRAIN_AHEAD_MIN_FEET = 500.0;
+
+// Stall warning band with hysteresis (m/s)
+const double STALL_WARNING_SPEED = 45.0;
+const double STALL_CLEAR_SPEED = 50.0;
+
+// Repeat intervals while a mode stays active (s)
+const double STALL_REPEAT = 0.5;
+const double SINK_RATE_REPEAT = 1.5;
+const double CLOSURE_REPEAT = 1.0;
+const double TERRAIN_AHEAD_REPEAT = 3.0;
+
+} // namespace
+
+AlertEngine::AlertEngine(int aircraftCount) : droppedEvents(0) {
+    callouts.assign(std::begin(DEFAULT_CALLOUTS), std::end(DEFAULT_CALLOUTS));
+    sinkRateEnvelope = {{50.0, 1560.0}, {2450.0, 5000.0}};
+    closureEnvelope = {{30.0, 2000.0}, {1000.0, 4000.0}, {1650.0, 6000.0}};
+    setAircraftCount(aircraftCount);
+}
+
+void AlertEngine::setAircraftCount(int count) {
+    tracks.resize(std::max(0, count));
+    resetAll();
+}
+
+void AlertEngine::setCallouts(const std::vector<double>& feet) {
+    callouts = feet;
+    std::sort(callouts.begin(), callouts.end());
+    resetAll();
+}
+
+void AlertEngine::reset(int aircraft) {
+    if (aircraft < 0 || aircraft >= (int)tracks.size()) return;
+    Track& track = tracks[aircraft];
+    track.hasPrevious = false;
+    track.previousFeet = 0.0;
+    track.previousTime = 0.0;
+    track.armedCount = (int)callouts.size();
+    track.closureFpm = 0.0;
+    track.stallActive = false;
+    track.sinkActive = false;
+    track.closureActive = false;
+    track.aheadActive = false;
+    track.lastStallEvent = 0.0;
+    track.lastSinkEvent = 0.0;
+    track.lastClosureEvent = 0.0;
+    track.lastAheadEvent = 0.0;
+}
+
+void AlertEngine::resetAll() {
+    for (int i = 0; i < (int)tracks.size(); i++) {
+        reset(i);
+    }
+}
+
+double AlertEngine::envelopeLimit(const std::vector<EnvelopePoint>& envelope, double heightFeet) {
+    if (envelope.empty()) return 0.0;
+    auto above = std::upper_bound(envelope.begin(), envelope.end(), heightFeet,
+                                  [](double h, const EnvelopePoint& p) { return h < p.heightFeet; });
+    if (above == envelope.begin()) return envelope.front().rateFpm;
+    if (above == envelope.end()) return envelope.back().rateFpm;
+    const EnvelopePoint& a = *(above - 1);
+    const EnvelopePoint& b = *above;
+    double t = (heightFeet - a.heightFeet) / (b.heightFeet - a.heightFeet);
+    return a.rateFpm + t * (b.rateFpm - a.rateFpm);
+}
+
+void AlertEngine::emit(AlertType type, AlertPhase phase, int aircraft, int calloutFeet, double value,
+                       double simTime) {
+    AlertEvent event;
+    event.type = type;
+    event.phase = phase;
+    event.aircraft = aircraft;
+    event.calloutFeet = calloutFeet;
+    event.value = value;
+    event.simTime = simTime;
+    event.detectTime = std::chrono::steady_clock::now();
+    if (!events.push(event)) {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AlertEngine::evaluateCallouts(Track& track, int aircraft, double heightFeet, double simTime) {
+    // Callouts crossed this tick: previous >= c > current, i.e. [low, high)
+    int low = (int)(std::upper_bound(callouts.begin(), callouts.end(), heightFeet) - callouts.begin());
+    int high = (int)(std::upper_bound(callouts.begin(), callouts.end(), track.previousFeet) - callouts.begin());
+
+    // Only the lowest one is still current; higher ones are stale
+    if (low < high && low < track.armedCount) {
+        emit(AlertType::ALTITUDE_CALLOUT, AlertPhase::ONSET, aircraft, (int)callouts[low],
+             heightFeet, simTime);
+        track.armedCount = low;
+    }
+
+    // Re-arm callouts the aircraft has climbed clear of
+    int clear = (int)(std::lower_bound(callouts.begin(), callouts.end(), heightFeet - CALLOUT_REARM_FEET) -
+                      callouts.begin());
+    track.armedCount = std::max(track.armedCount, clear);
+}
+
+void AlertEngine::evaluateMode(bool trigger, bool& active, double& lastEvent, double repeatInterval,
+                               AlertType type, int aircraft, double value, double simTime) {
+    if (trigger && !active) {
+        active = true;
+        lastEvent = simTime;
+        emit(type, AlertPhase::ONSET, aircraft, 0, value, simTime);
+    } else if (trigger && simTime - lastEvent >= repeatInterval) {
+        lastEvent = simTime;
+        emit(type, AlertPhase::REPEAT, aircraft, 0, value, simTime);
+    } else if (!trigger && active) {
+        active = false;
+        emit(type, AlertPhase::CLEARED, aircraft, 0, value, simTime);
+    }
+}
+
+void AlertEngine::evaluate(int aircraft, const AlertInputs& inputs, double simTime) {
+    if (aircraft < 0 || aircraft >= (int)tracks.size()) return;
+    Track& track = tracks[aircraft];
+
+    double heightFeet = (inputs.altitude - inputs.terrainElevation) * FEET_PER_METER;
+    if (!track.hasPrevious) {
+        track.hasPrevious = true;
+        track.previousFeet = heightFeet;
+        track.previousTime = simTime;
+    }
+
+    // Closure rate from the change in height above terrain over this tick
+    double dt = simTime - track.previousTime;
+    if (dt > 0.0) {
+        double closure = (track.previousFeet - heightFeet) / dt * 60.0;
+        track.closureFpm += dt / (CLOSURE_FILTER_SECONDS + dt) * (closure - track.closureFpm);
+    }
+
+    evaluateCallouts(track, aircraft, heightFeet, simTime);
+
+    // Mode 1: sink rate
+    double sinkFpm = -inputs.verticalSpeed * FEET_PER_METER * 60.0;
+    bool sinking = heightFeet >= SINK_RATE_MIN_FEET && heightFeet <= SINK_RATE_MAX_FEET &&
+                   sinkFpm > envelopeLimit(sinkRateEnvelope, heightFeet);
+    evaluateMode(sinking, track.sinkActive, track.lastSinkEvent, SINK_RATE_REPEAT,
+                 AlertType::SINK_RATE, aircraft, sinkFpm, simTime);
+
+    // Mode 2: terrain closure
+    bool closing = heightFeet >= CLOSURE_MIN_FEET && heightFeet <= CLOSURE_MAX_FEET &&
+                   track.closureFpm > envelopeLimit(closureEnvelope, heightFeet);
+    evaluateMode(closing, track.closureActive, track.lastClosureEvent, CLOSURE_REPEAT,
+                 AlertType::TERRAIN_CLOSURE, aircraft, track.closureFpm, simTime);
+
+    // Lookahead: predicted path into the terrain
+    bool ahead = heightFeet >= TERRAIN_AHEAD_MIN_FEET && inputs.timeToImpact <= TERRAIN_AHEAD_SECONDS;
+    evaluateMode(ahead, track.aheadActive, track.lastAheadEvent, TERRAIN_AHEAD_REPEAT,
+                 AlertType::TERRAIN_AHEAD, aircraft, inputs.timeToImpact, simTime);
+
+    // Stall warning band
+    double stallLimit = track.stallActive ? STALL_CLEAR_SPEED : STALL_WARNING_SPEED;
+    bool stall = inputs.airspeed < stallLimit;
+    evaluateMode(stall, track.stallActive, track.lastStallEvent, STALL_REPEAT,
+                 AlertType::STALL, aircraft, inputs.airspeed, simTime);
+
+    track.previousFeet = heightFeet;
+    track.previousTime = simTime;
+}
@@ -1,10 +1,13 @@
 #include "atmosphere.hpp"
+#include "fp_determinism.hpp"
+#include <algorithm>
 #include <cmath>
 
 Atmosphere::Atmosphere() {}
 
-void Atmosphere::getProperties(double altitude, double& density, double& pressure, 
-                              double& temperature, double& speedOfSound) {
+template <typename Math>
+void Atmosphere::getPropertiesWith(double altitude, double& density, double& pressure,
+                                   double& temperature, double& speedOfSound) {
     // Limit altitude to troposphere (0-11000m)
     if (altitude < 0.0) altitude = 0.0;
     
@@ -15,7 +18,7 @@ void Atmosphere::getProperties(double altitude, double& density, double& pressur
         double tempRatio = temperature / SEA_LEVEL_TEMPERATURE;
         double exponent = GRAVITY / (TEMPERATURE_LAPSE_RATE * GAS_CONSTANT);
         
-        pressure = SEA_LEVEL_PRESSURE * std::pow(tempRatio, exponent);
+        pressure = SEA_LEVEL_PRESSURE * Math::pow(tempRatio, exponent);
         density = pressure / (GAS_CONSTANT * temperature);
     } else {
         // Lower stratosphere (isothermal layer)
@@ -23,13 +26,42 @@ void Atmosphere::getProperties(double altitude, double& density, double& pressur
         
         double h11 = 11000.0;
         double T11 = SEA_LEVEL_TEMPERATURE - TEMPERATURE_LAPSE_RATE * h11;
-        double P11 = SEA_LEVEL_PRESSURE * std::pow(T11 / SEA_LEVEL_TEMPERATURE, 
-                                                     GRAVITY / (TEMPERATURE_LAPSE_RATE * GAS_CONSTANT));
+        double P11 = SEA_LEVEL_PRESSURE * Math::pow(T11 / SEA_LEVEL_TEMPERATURE, 
+                                                    GRAVITY / (TEMPERATURE_LAPSE_RATE * GAS_CONSTANT));
         
-        pressure = P11 * std::exp(-GRAVITY * (altitude - h11) / (GAS_CONSTANT * temperature));
+        pressure = P11 * Math::exp(-GRAVITY * (altitude - h11) / (GAS_CONSTANT * temperature));
         density = pressure / (GAS_CONSTANT * temperature);
     }
     
     speedOfSound = std::sqrt(GAMMA * GAS_CONSTANT * temperature);
 }
 
+template void Atmosphere::getPropertiesWith<StdMath>(double, double&, double&, double&, double&);
+template void Atmosphere::getPropertiesWith<FastMath>(double, double&, double&, double&, double&);
+
+double Atmosphere::getDensityAltitude(double density) const {
+    // Troposphere: density ratio = temperature ratio ^ (exponent - 1)
+    double exponent = GRAVITY / (TEMPERATURE_LAPSE_RATE * GAS_CONSTANT);
+    double ratio = std::max(density, 1e-6) / SEA_LEVEL_DENSITY;
+    double densityAltitude = SEA_LEVEL_TEMPERATURE / TEMPERATURE_LAPSE_RATE *
+                             (1.0 - std::pow(ratio, 1.0 / (exponent - 1.0)));
+    if (densityAltitude <= 11000.0) return densityAltitude;
+    
+    // Above the tropopause the isothermal layer's density falls exponentially
+    double T11 = SEA_LEVEL_TEMPERATURE - TEMPERATURE_LAPSE_RATE * 11000.0;
+    double rho11 = SEA_LEVEL_DENSITY * std::pow(T11 / SEA_LEVEL_TEMPERATURE, exponent - 1.0);
+    return 11000.0 - GAS_CONSTANT * T11 / GRAVITY * std::log(ratio * SEA_LEVEL_DENSITY / rho11);
+}
+
+double Atmosphere::getPressureAltitude(double pressure) const {
+    double exponent = GRAVITY / (TEMPERATURE_LAPSE_RATE * GAS_CONSTANT);
+    double ratio = std::max(pressure, 1.0) / SEA_LEVEL_PRESSURE;
+    double pressureAltitude = SEA_LEVEL_TEMPERATURE / TEMPERATURE_LAPSE_RATE *
+                              (1.0 - std::pow(ratio, 1.0 / exponent));
+    if (pressureAltitude <= 11000.0) return pressureAltitude;
+    
+    // Isothermal layer above the tropopause
+    double T11 = SEA_LEVEL_TEMPERATURE - TEMPERATURE_LAPSE_RATE * 11000.0;
+    double P11 = SEA_LEVEL_PRESSURE * std::pow(T11 / SEA_LEVEL_TEMPERATURE, exponent);
+    return 11000.0 - GAS_CONSTANT * T11 / GRAVITY * std::log(ratio * SEA_LEVEL_PRESSURE / P11);
+}
@@ -0,0 +1,101 @@
+#include "audio_debug_panel.hpp"
+#include "imgui.h"
+
+namespace {
+
+void latencyRow(const char* name, const LatencyHistogram& histogram, double offsetMs) {
+    if (histogram.getCount() == 0) {
+        ImGui::Text("%-8s  -", name);
+        return;
+    }
+    // Mix latency plus the device buffering still ahead of the first sample
+    ImGui::Text("%-8s  n=%-5llu last %6.2f  mean %6.2f  p99 %6.2f  max %6.2f ms (+%.1f out)",
+                name, (unsigned long long)histogram.getCount(), histogram.getLast() / 1000.0,
+                histogram.getMean() / 1000.0, histogram.percentile(0.99) / 1000.0,
+                histogram.getMax() / 1000.0, offsetMs);
+}
+
+} // namespace
+
+AudioDebugPanel::AudioDebugPanel() : exportPath("audio_stats.csv") {}
+
+void AudioDebugPanel::render(AudioSystem& audio, bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(520.0f, 0.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Audio Debug", open)) {
+        ImGui::End();
+        return;
+    }
+
+    AudioSystem::PipelineStats pipeline = audio.getPipelineStats();
+    const LatencyHistogram& callback = audio.getCallbackHistogram();
+
+    // Callback timing
+    ImGui::Text("Callbacks: %llu   buffer %.2f ms   output latency ~%.1f ms",
+                (unsigned long long)pipeline.callbacks, pipeline.bufferMs, pipeline.outputLatencyMs);
+    ImGui::Text("Callback: last %.1f  mean %.1f  p99 %.1f  max %.1f us",
+                callback.getLast(), callback.getMean(), callback.percentile(0.99), callback.getMax());
+
+    ImVec4 bad(1.0f, 0.4f, 0.3f, 1.0f);
+    ImVec4 good(0.6f, 1.0f, 0.6f, 1.0f);
+    ImGui::TextColored(pipeline.underruns ? bad : good, "Underruns: %llu",
+                       (unsigned long long)pipeline.underruns);
+    ImGui::SameLine();
+    ImGui::TextColored(pipeline.overruns ? bad : good, "  Overruns: %llu",
+                       (unsigned long long)pipeline.overruns);
+
+    // Histogram over the populated range of bins
+    int first = LatencyHistogram::BINS, last = -1;
+    for (int i = 0; i < LatencyHistogram::BINS; i++) {
+        if (callback.getBinCount(i) > 0) {
+            if (i < first) first = i;
+            last = i;
+        }
+    }
+    if (last >= first) {
+        float counts[LatencyHistogram::BINS];
+        int bins = last - first + 1;
+        for (int i = 0; i < bins; i++) {
+            counts[i] = (float)callback.getBinCount(first + i);
+        }
+        char label[64];
+        snprintf(label, sizeof(label), "%.0f - %.0f us",
+                 first > 0 ? LatencyHistogram::binUpperEdge(first - 1) : 0.0,
+                 LatencyHistogram::binUpperEdge(last));
+        ImGui::PlotHistogram("##callback", counts, bins, 0, label, 0.0f, 3.4e38f, ImVec2(480.0f, 80.0f));
+    }
+
+    // Voices
+    ImGui::Separator();
+    AudioMixer::Stats voices = audio.getMixerStats();
+    ImGui::Text("Voices: %u active, %u peak of %d", voices.activeVoices, voices.peakVoices,
+                AudioMixer::MAX_VOICES);
+    ImGui::Text("Started %llu  stolen %llu  rejected %llu  dropped commands %llu",
+                (unsigned long long)voices.voicesStarted, (unsigned long long)voices.voicesStolen,
+                (unsigned long long)voices.voicesRejected, (unsigned long long)voices.commandsDropped);
+
+    EngineSynth::Stats synth = audio.getSynthStats();
+    ImGui::Text("Engine synth: mean %.1f  max %.1f us  (budget %.0f us, over %llu)",
+                synth.meanUs, synth.maxUs, synth.budgetUs, (unsigned long long)synth.overBudget);
+
+    // Detection to first sample
+    ImGui::Separator();
+    ImGui::Text("Alert latency (sim detection to first mixed sample):");
+    latencyRow("Warning", audio.getAlertLatency(AudioPriority::WARNING), pipeline.outputLatencyMs);
+    latencyRow("Callout", audio.getAlertLatency(AudioPriority::CALLOUT), pipeline.outputLatencyMs);
+
+    ImGui::Separator();
+    if (ImGui::Button("Reset")) {
+        audio.resetStats();
+        exportStatus.clear();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export CSV")) {
+        exportStatus = audio.exportStats(exportPath) ? "Saved " + exportPath : "Export failed";
+    }
+    if (!exportStatus.empty()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(exportStatus.c_str());
+    }
+
+    ImGui::End();
+}
@@ -0,0 +1,255 @@
+#include "audio_mixer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+AudioMixer::AudioMixer()
+    : sampleRate(48000), channels(2), nextHandle(1), startCounter(0), envelopeStep(1.0f),
+      activeVoices(0), peakVoices(0), voicesStarted(0), voicesStolen(0), voicesRejected(0), commandsDropped(0) {
+    for (Voice& voice : voices) {
+        voice = Voice();
+    }
+    for (int i = 0; i < MAX_GROUPS; i++) {
+        groupVolume[i] = 1.0f;
+        groupPitch[i] = 1.0f;
+    }
+    configure(sampleRate, channels);
+}
+
+void AudioMixer::configure(uint32_t rate, uint32_t channelCount) {
+    sampleRate = rate > 0 ? rate : 48000;
+    channels = channelCount > 0 ? channelCount : 2;
+    envelopeStep = 1.0f / (ENVELOPE_SECONDS * sampleRate);
+}
+
+bool AudioMixer::post(const Command& command) {
+    if (!commands.push(command)) {
+        commandsDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+VoiceHandle AudioMixer::play(int group, AudioPriority priority, Waveform waveform, float frequency,
+                             float duration, float volume, Clock::time_point detectTime) {
+    Command command = {};
+    command.type = CommandType::PLAY;
+    command.handle = nextHandle++;
+    if (nextHandle == 0) nextHandle = 1;
+    command.group = group;
+    command.priority = priority;
+    command.waveform = waveform;
+    command.frequency = frequency;
+    command.duration = duration;
+    command.value = volume;
+    command.detectTime = detectTime;
+    return post(command) ? command.handle : 0;
+}
+
+void AudioMixer::stop(VoiceHandle handle) {
+    if (handle == 0) return;
+    Command command = {};
+    command.type = CommandType::STOP;
+    command.handle = handle;
+    post(command);
+}
+
+void AudioMixer::stopGroup(int group) {
+    Command command = {};
+    command.type = CommandType::STOP_GROUP;
+    command.group = group;
+    post(command);
+}
+
+void AudioMixer::stopAll() {
+    Command command = {};
+    command.type = CommandType::STOP_ALL;
+    post(command);
+}
+
+void AudioMixer::setGroupVolume(int group, float volume) {
+    Command command = {};
+    command.type = CommandType::GROUP_VOLUME;
+    command.group = group;
+    command.value = volume;
+    post(command);
+}
+
+void AudioMixer::setGroupPitch(int group, float pitch) {
+    Command command = {};
+    command.type = CommandType::GROUP_PITCH;
+    command.group = group;
+    command.value = pitch;
+    post(command);
+}
+
+AudioMixer::Stats AudioMixer::getStats() const {
+    Stats stats;
+    stats.activeVoices = activeVoices.load(std::memory_order_relaxed);
+    stats.peakVoices = peakVoices.load(std::memory_order_relaxed);
+    stats.voicesStarted = voicesStarted.load(std::memory_order_relaxed);
+    stats.voicesStolen = voicesStolen.load(std::memory_order_relaxed);
+    stats.voicesRejected = voicesRejected.load(std::memory_order_relaxed);
+    stats.commandsDropped = commandsDropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AudioMixer::resetStats() {
+    peakVoices.store(0, std::memory_order_relaxed);
+    voicesStarted.store(0, std::memory_order_relaxed);
+    voicesStolen.store(0, std::memory_order_relaxed);
+    voicesRejected.store(0, std::memory_order_relaxed);
+    commandsDropped.store(0, std::memory_order_relaxed);
+    for (LatencyHistogram& histogram : alertLatency) {
+        histogram.reset();
+    }
+}
+
+void AudioMixer::applyCommand(const Command& command) {
+    bool validGroup = command.group >= 0 && command.group < MAX_GROUPS;
+
+    switch (command.type) {
+        case CommandType::PLAY:
+            startVoice(command);
+            break;
+        case CommandType::STOP:
+            for (Voice& voice : voices) {
+                if (voice.active && voice.handle == command.handle) voice.releasing = true;
+            }
+            break;
+        case CommandType::STOP_GROUP:
+            for (Voice& voice : voices) {
+                if (voice.active && voice.group == command.group) voice.releasing = true;
+            }
+            break;
+        case CommandType::STOP_ALL:
+            for (Voice& voice : voices) {
+                if (voice.active) voice.releasing = true;
+            }
+            break;
+        case CommandType::GROUP_VOLUME:
+            if (validGroup) groupVolume[command.group] = std::max(0.0f, std::min(1.0f, command.value));
+            break;
+        case CommandType::GROUP_PITCH:
+            if (validGroup) groupPitch[command.group] = std::max(0.1f, std::min(4.0f, command.value));
+            break;
+    }
+}
+
+AudioMixer::Voice* AudioMixer::findVoiceToSteal(AudioPriority priority) {
+    // Lowest priority first, then the oldest; never steal from a higher priority
+    Voice* victim = nullptr;
+    for (Voice& voice : voices) {
+        if (voice.priority > priority) continue;
+        if (!victim || voice.priority < victim->priority ||
+            (voice.priority == victim->priority && voice.startOrder < victim->startOrder)) {
+            victim = &voice;
+        }
+    }
+    return victim;
+}
+
+void AudioMixer::startVoice(const Command& command) {
+    Voice* voice = nullptr;
+    for (Voice& candidate : voices) {
+        if (!candidate.active) {
+            voice = &candidate;
+            break;
+        }
+    }
+    if (!voice) {
+        voice = findVoiceToSteal(command.priority);
+        if (!voice) {
+            voicesRejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        voicesStolen.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    voice->active = true;
+    voice->releasing = false;
+    voice->handle = command.handle;
+    voice->group = command.group >= 0 && command.group < MAX_GROUPS ? command.group : 0;
+    voice->priority = command.priority;
+    voice->waveform = command.waveform;
+    voice->frequency = command.frequency;
+    voice->volume = std::max(0.0f, std::min(1.0f, command.value));
+    voice->phase = 0.0;
+    voice->remaining = command.duration > 0.0f
+                           ? std::max<int64_t>(1, (int64_t)(command.duration * sampleRate))
+                           : -1;
+    voice->envelope = 0.0f;
+    voice->startOrder = startCounter++;
+    voice->detectTime = command.detectTime;
+
+    voicesStarted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::mixVoice(Voice& voice, float* output, uint32_t frameCount) {
+    const double twoPi = 2.0 * M_PI;
+    double increment = voice.frequency * groupPitch[voice.group] / sampleRate;
+    float gain = voice.volume * groupVolume[voice.group];
+
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+        if (voice.releasing) {
+            voice.envelope -= envelopeStep;
+            if (voice.envelope <= 0.0f) {
+                voice.active = false;
+                return;
+            }
+        } else if (voice.envelope < 1.0f) {
+            voice.envelope = std::min(1.0f, voice.envelope + envelopeStep);
+        }
+
+        if (voice.remaining > 0 && --voice.remaining == 0) {
+            voice.releasing = true;
+        }
+
+        float wave = voice.waveform == Waveform::SQUARE
+                         ? (voice.phase < 0.5 ? 1.0f : -1.0f)
+                         : (float)std::sin(twoPi * voice.phase);
+        float sample = wave * gain * voice.envelope;
+
+        float* out = output + (size_t)frame * channels;
+        for (uint32_t c = 0; c < channels; c++) {
+            out[c] += sample;
+        }
+
+        voice.phase += increment;
+        if (voice.phase >= 1.0) voice.phase -= 1.0;
+    }
+}
+
+void AudioMixer::render(float* output, uint32_t frameCount) {
+    Command command;
+    while (commands.pop(command)) {
+        applyCommand(command);
+    }
+
+    std::memset(output, 0, sizeof(float) * frameCount * channels);
+
+    uint32_t active = 0;
+    Clock::time_point now;
+    bool haveNow = false;
+    for (Voice& voice : voices) {
+        if (!voice.active) continue;
+        
+        // First sample of an alert voice is mixed at the start of this buffer
+        if (voice.detectTime != Clock::time_point()) {
+            if (!haveNow) {
+                now = Clock::now();
+                haveNow = true;
+            }
+            std::chrono::duration<double, std::micro> latency = now - voice.detectTime;
+            alertLatency[(int)voice.priority].record(latency.count());
+            voice.detectTime = Clock::time_point();
+        }
+        
+        mixVoice(voice, output, frameCount);
+        if (voice.active) active++;
+    }
+    activeVoices.store(active, std::memory_order_relaxed);
+    if (active > peakVoices.load(std::memory_order_relaxed)) {
+        peakVoices.store(active, std::memory_order_relaxed);
+    }
+}
@@ -1,17 +1,134 @@
 #include "audio_system.hpp"
+#include "logger.hpp"
+#include <algorithm>
 #include <cmath>
-#include <iostream>
 #include <cstring>
+#include <cstdio>
 #include <cstdlib>
 
 // Only define implementation once in this file
 #define MINIAUDIO_IMPLEMENTATION
 #include "../external/miniaudio.h"
 
+namespace {
+
+// Custom data source that pulls a render callback (the voice mixer or the
+// engine synthesizer) into the engine graph as an endless stream.
+// ma_data_source_base must be the first member.
+struct StreamDataSource {
+    ma_data_source_base base;
+    void (*render)(void* context, float* output, uint32_t frameCount);
+    void* context;
+    ma_uint32 channels;
+    ma_uint32 sampleRate;
+};
+
+ma_result streamRead(ma_data_source* dataSource, void* framesOut, ma_uint64 frameCount,
+                     ma_uint64* framesRead) {
+    StreamDataSource* source = (StreamDataSource*)dataSource;
+    source->render(source->context, (float*)framesOut, (uint32_t)frameCount);
+    if (framesRead) *framesRead = frameCount;
+    return MA_SUCCESS;
+}
+
+ma_result streamSeek(ma_data_source*, ma_uint64) {
+    return MA_SUCCESS;
+}
+
+ma_result streamGetDataFormat(ma_data_source* dataSource, ma_format* format, ma_uint32* channels,
+                              ma_uint32* sampleRate, ma_channel*, size_t) {
+    StreamDataSource* source = (StreamDataSource*)dataSource;
+    if (format) *format = ma_format_f32;
+    if (channels) *channels = source->channels;
+    if (sampleRate) *sampleRate = source->sampleRate;
+    return MA_SUCCESS;
+}
+
+ma_result streamGetCursor(ma_data_source*, ma_uint64* cursor) {
+    if (cursor) *cursor = 0;
+    return MA_SUCCESS;
+}
+
+ma_result streamGetLength(ma_data_source*, ma_uint64* length) {
+    // Endless stream
+    if (length) *length = 0;
+    return MA_NOT_IMPLEMENTED;
+}
+
+const ma_data_source_vtable streamVtable = {
+    streamRead, streamSeek, streamGetDataFormat, streamGetCursor, streamGetLength, NULL, 0
+};
+
+void renderMixer(void* context, float* output, uint32_t frameCount) {
+    ((AudioMixer*)context)->render(output, frameCount);
+}
+
+void renderSynth(void* context, float* output, uint32_t frameCount) {
+    ((EngineSynth*)context)->render(output, frameCount);
+}
+
+// Create a started, endless sound fed by `render`. Allocates only here.
+bool createStream(ma_engine* engine, void (*render)(void*, float*, uint32_t), void* context,
+                  void*& sourcePtr, void*& soundPtr) {
+    StreamDataSource* source = (StreamDataSource*)malloc(sizeof(StreamDataSource));
+    ma_sound* sound = (ma_sound*)malloc(sizeof(ma_sound));
+    ma_data_source_config config = ma_data_source_config_init();
+    config.vtable = &streamVtable;
+    
+    ma_result result = ma_data_source_init(&config, &source->base);
+    if (result == MA_SUCCESS) {
+        source->render = render;
+        source->context = context;
+        source->channels = ma_engine_get_channels(engine);
+        source->sampleRate = ma_engine_get_sample_rate(engine);
+        result = ma_sound_init_from_data_source(engine, source,
+                                                MA_SOUND_FLAG_NO_SPATIALIZATION | MA_SOUND_FLAG_NO_PITCH,
+                                                NULL, sound);
+        if (result != MA_SUCCESS) {
+            ma_data_source_uninit(&source->base);
+        }
+    }
+    if (result != MA_SUCCESS) {
+        LOG_ERROR("Failed to create audio stream: %d", (int)result);
+        free(sound);
+        free(source);
+        return false;
+    }
+    
+    ma_sound_start(sound);
+    sourcePtr = source;
+    soundPtr = sound;
+    return true;
+}
+
+void destroyStream(void*& sourcePtr, void*& soundPtr) {
+    if (soundPtr) {
+        ma_sound_uninit((ma_sound*)soundPtr);
+        free(soundPtr);
+        soundPtr = nullptr;
+    }
+    if (sourcePtr) {
+        ma_data_source_uninit(&((StreamDataSource*)sourcePtr)->base);
+        free(sourcePtr);
+        sourcePtr = nullptr;
+    }
+}
+
+} // namespace
+
 AudioSystem::AudioSystem() 
-    : enginePtr(nullptr), devicePtr(nullptr), initialized(false), 
-      stallWarningActive(false), lastTerrainCallout(-10.0), 
-      terrainCalloutCooldown(3.0) {
+    : enginePtr(nullptr), devicePtr(nullptr), mixerSourcePtr(nullptr), mixerSoundPtr(nullptr),
+      synthSourcePtr(nullptr), synthSoundPtr(nullptr),
+      initialized(false), offline(false),
+      callbacks(0), underruns(0), overruns(0), bufferMs(0.0), outputLatencyMs(0.0) {
+    for (Sound& snd : sounds) {
+        snd.soundPtr = nullptr;
+        snd.loaded = false;
+        snd.playing = false;
+        snd.loop = false;
+        snd.volume = 1.0f;
+        snd.pitch = 1.0f;
+    }
 }
 
 AudioSystem::~AudioSystem() {
@@ -19,22 +136,96 @@ AudioSystem::~AudioSystem() {
 }
 
 bool AudioSystem::initialize() {
+    // Own the playback device so every callback can be timed; the engine
+    // renders into it through deviceCallback()
+    ma_device* device = (ma_device*)malloc(sizeof(ma_device));
+    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+    deviceConfig.playback.format = ma_format_f32;
+    deviceConfig.playback.channels = 2;
+    deviceConfig.dataCallback = deviceCallback;
+    deviceConfig.pUserData = this;
+    
+    ma_result result = ma_device_init(NULL, &deviceConfig, device);
+    if (result != MA_SUCCESS) {
+        LOG_ERROR("Failed to open audio device: %d", (int)result);
+        free(device);
+        return false;
+    }
+    devicePtr = device;
+    
+    ma_engine_config engineConfig = ma_engine_config_init();
+    engineConfig.pDevice = device;
+    if (!initializeEngine(&engineConfig)) {
+        ma_device_uninit(device);
+        free(devicePtr);
+        devicePtr = nullptr;
+        return false;
+    }
+    
+    outputLatencyMs.store(1000.0 * device->playback.internalPeriodSizeInFrames *
+                          device->playback.internalPeriods / device->sampleRate,
+                          std::memory_order_relaxed);
+    
+    LOG_INFO("✓ Audio system initialized successfully");
+    LOG_INFO("  You should hear beeps for stall warnings and terrain alerts");
+    
+    // Test beep
+    playBeep(SoundType::GEAR_WARNING, 440.0f, 0.1f, 0.3f);
+    
+    return true;
+}
+
+bool AudioSystem::initializeOffline(uint32_t sampleRate, uint32_t channels) {
+    // No device: the graph only advances when renderOffline() pulls frames
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice = MA_TRUE;
+    config.sampleRate = sampleRate;
+    config.channels = channels;
+    
+    if (!initializeEngine(&config)) {
+        return false;
+    }
+    offline = true;
+    return true;
+}
+
+bool AudioSystem::initializeEngine(const void* engineConfig) {
+    if (initialized) return true;
+    
     // Allocate and initialize engine
     enginePtr = malloc(sizeof(ma_engine));
     ma_engine* engine = (ma_engine*)enginePtr;
+    const ma_engine_config* config = (const ma_engine_config*)engineConfig;
     
-    ma_result result = ma_engine_init(NULL, engine);
+    ma_result result = ma_engine_init(config, engine);
     if (result != MA_SUCCESS) {
-        std::cerr << "Failed to initialize audio engine: " << result << std::endl;
+        LOG_ERROR("Failed to initialize audio engine: %d", (int)result);
         free(enginePtr);
         enginePtr = nullptr;
         return false;
     }
     
-    // Start the engine
-    result = ma_engine_start(engine);
+    // Synthetic tones (pooled voice mixer) and the continuous engine/airflow
+    // synthesizer are attached as two endless sounds. Everything the audio
+    // thread touches is allocated here.
+    mixer.configure(ma_engine_get_sample_rate(engine), ma_engine_get_channels(engine));
+    synth.configure(ma_engine_get_sample_rate(engine), ma_engine_get_channels(engine));
+    
+    if (!createStream(engine, renderMixer, &mixer, mixerSourcePtr, mixerSoundPtr) ||
+        !createStream(engine, renderSynth, &synth, synthSourcePtr, synthSoundPtr)) {
+        destroyStream(mixerSourcePtr, mixerSoundPtr);
+        ma_engine_uninit(engine);
+        free(enginePtr);
+        enginePtr = nullptr;
+        return false;
+    }
+    
+    // Start the engine (offline engines have no device to start)
+    result = (config && config->noDevice) ? MA_SUCCESS : ma_engine_start(engine);
     if (result != MA_SUCCESS) {
-        std::cerr << "Failed to start audio engine" << std::endl;
+        LOG_ERROR("Failed to start audio engine");
+        destroyStream(synthSourcePtr, synthSoundPtr);
+        destroyStream(mixerSourcePtr, mixerSoundPtr);
         ma_engine_uninit(engine);
         free(enginePtr);
         enginePtr = nullptr;
@@ -42,85 +233,215 @@ bool AudioSystem::initialize() {
     }
     
     initialized = true;
-    std::cout << "✓ Audio system initialized successfully" << std::endl;
-    std::cout << "  You should hear beeps for stall warnings and terrain alerts" << std::endl;
-    
-    // Test beep
-    playBeep(440.0f, 0.1f, 0.3f);
+    return true;
+}
+
+bool AudioSystem::renderOffline(float* output, uint32_t frameCount) {
+    if (!initialized || !offline) return false;
     
+    readEngine(output, frameCount, false);
     return true;
 }
 
+void AudioSystem::deviceCallback(ma_device* device, void* output, const void* input, uint32_t frameCount) {
+    (void)input;
+    AudioSystem* audio = (AudioSystem*)device->pUserData;
+    if (audio->initialized) {
+        audio->readEngine((float*)output, frameCount, true);
+    } else {
+        std::memset(output, 0, sizeof(float) * frameCount * device->playback.channels);
+    }
+}
+
+void AudioSystem::readEngine(float* output, uint32_t frameCount, bool fromDevice) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    double periodUs = 1e6 * frameCount / mixer.getSampleRate();
+    
+    // A device callback much later than one period after the previous one
+    // means the device ran dry
+    if (fromDevice && callbacks.load(std::memory_order_relaxed) > 0) {
+        std::chrono::duration<double, std::micro> interval = start - lastCallbackStart;
+        if (interval.count() > 2.0 * periodUs) {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    lastCallbackStart = start;
+    
+    ma_engine_read_pcm_frames((ma_engine*)enginePtr, output, frameCount, NULL);
+    
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    callbackHistogram.record(elapsed.count());
+    if (elapsed.count() > periodUs) {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    bufferMs.store(periodUs / 1000.0, std::memory_order_relaxed);
+    callbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+AudioSystem::PipelineStats AudioSystem::getPipelineStats() const {
+    PipelineStats stats;
+    stats.callbacks = callbacks.load(std::memory_order_relaxed);
+    stats.underruns = underruns.load(std::memory_order_relaxed);
+    stats.overruns = overruns.load(std::memory_order_relaxed);
+    stats.bufferMs = bufferMs.load(std::memory_order_relaxed);
+    stats.outputLatencyMs = outputLatencyMs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AudioSystem::resetStats() {
+    // Counters written by the audio thread are single-writer; a reset racing
+    // with a callback can at worst keep that callback's sample
+    callbackHistogram.reset();
+    underruns.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    mixer.resetStats();
+    synth.resetStats();
+}
+
+bool AudioSystem::exportStats(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+    
+    PipelineStats pipeline = getPipelineStats();
+    AudioMixer::Stats voices = mixer.getStats();
+    EngineSynth::Stats synthStats = synth.getStats();
+    
+    std::fprintf(file, "metric,value\n");
+    std::fprintf(file, "callbacks,%llu\n", (unsigned long long)pipeline.callbacks);
+    std::fprintf(file, "underruns,%llu\n", (unsigned long long)pipeline.underruns);
+    std::fprintf(file, "overruns,%llu\n", (unsigned long long)pipeline.overruns);
+    std::fprintf(file, "buffer_ms,%.3f\n", pipeline.bufferMs);
+    std::fprintf(file, "output_latency_ms,%.3f\n", pipeline.outputLatencyMs);
+    std::fprintf(file, "callback_mean_us,%.2f\n", callbackHistogram.getMean());
+    std::fprintf(file, "callback_p99_us,%.2f\n", callbackHistogram.percentile(0.99));
+    std::fprintf(file, "callback_max_us,%.2f\n", callbackHistogram.getMax());
+    std::fprintf(file, "voices_active,%u\n", voices.activeVoices);
+    std::fprintf(file, "voices_peak,%u\n", voices.peakVoices);
+    std::fprintf(file, "voices_started,%llu\n", (unsigned long long)voices.voicesStarted);
+    std::fprintf(file, "voices_stolen,%llu\n", (unsigned long long)voices.voicesStolen);
+    std::fprintf(file, "voices_rejected,%llu\n", (unsigned long long)voices.voicesRejected);
+    std::fprintf(file, "commands_dropped,%llu\n", (unsigned long long)voices.commandsDropped);
+    std::fprintf(file, "synth_mean_us,%.2f\n", synthStats.meanUs);
+    std::fprintf(file, "synth_max_us,%.2f\n", synthStats.maxUs);
+    std::fprintf(file, "synth_over_budget,%llu\n", (unsigned long long)synthStats.overBudget);
+    
+    const char* alertNames[] = {"ambient", "callout", "warning"};
+    for (int i = 0; i < 3; i++) {
+        const LatencyHistogram& latency = mixer.getAlertLatency((AudioPriority)i);
+        if (latency.getCount() == 0) continue;
+        std::fprintf(file, "alert_%s_count,%llu\n", alertNames[i], (unsigned long long)latency.getCount());
+        std::fprintf(file, "alert_%s_mean_us,%.2f\n", alertNames[i], latency.getMean());
+        std::fprintf(file, "alert_%s_p99_us,%.2f\n", alertNames[i], latency.percentile(0.99));
+        std::fprintf(file, "alert_%s_max_us,%.2f\n", alertNames[i], latency.getMax());
+    }
+    
+    std::fprintf(file, "\nhistogram,bin_upper_us,count\n");
+    callbackHistogram.writeCSV(file, "callback");
+    for (int i = 0; i < 3; i++) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "alert_%s", alertNames[i]);
+        mixer.getAlertLatency((AudioPriority)i).writeCSV(file, name);
+    }
+    
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
+
+uint32_t AudioSystem::getSampleRate() const {
+    return initialized ? ma_engine_get_sample_rate((const ma_engine*)enginePtr) : 0;
+}
+
+uint32_t AudioSystem::getChannels() const {
+    return initialized ? ma_engine_get_channels((const ma_engine*)enginePtr) : 0;
+}
+
 void AudioSystem::shutdown() {
     if (initialized && enginePtr) {
         ma_engine* engine = (ma_engine*)enginePtr;
         
         // Stop engine
-        ma_engine_stop(engine);
+        if (!offline) {
+            ma_engine_stop(engine);
+        }
         
-        // Uninit engine
+        for (Sound& snd : sounds) {
+            if (snd.soundPtr) {
+                ma_sound_uninit((ma_sound*)snd.soundPtr);
+                free(snd.soundPtr);
+                snd.soundPtr = nullptr;
+                snd.loaded = false;
+            }
+        }
+        
+        destroyStream(synthSourcePtr, synthSoundPtr);
+        destroyStream(mixerSourcePtr, mixerSoundPtr);
+        
+        // Uninit engine, then the device it was rendering into
         ma_engine_uninit(engine);
         free(enginePtr);
         enginePtr = nullptr;
         
+        if (devicePtr) {
+            ma_device_uninit((ma_device*)devicePtr);
+            free(devicePtr);
+            devicePtr = nullptr;
+        }
+        
         initialized = false;
-        std::cout << "Audio system shut down" << std::endl;
+        if (!offline) {
+            LOG_INFO("Audio system shut down");
+        }
+        offline = false;
     }
 }
 
-void AudioSystem::playBeep(float frequency, float duration, float volume) {
-    if (!initialized || !enginePtr) return;
-    
-    ma_engine* engine = (ma_engine*)enginePtr;
-    
-    // Create a waveform configuration
-    ma_waveform_config waveformConfig = ma_waveform_config_init(
-        ma_format_f32,
-        2,  // stereo
-        ma_engine_get_sample_rate(engine),
-        ma_waveform_type_sine,
-        0.5,  // amplitude
-        frequency
-    );
-    
-    // Allocate waveform
-    ma_waveform* waveform = (ma_waveform*)malloc(sizeof(ma_waveform));
-    ma_result result = ma_waveform_init(&waveformConfig, waveform);
-    
-    if (result != MA_SUCCESS) {
-        free(waveform);
-        return;
-    }
-    
-    // Create a sound from the waveform
-    ma_sound* sound = (ma_sound*)malloc(sizeof(ma_sound));
-    result = ma_sound_init_from_data_source(engine, waveform, 0, NULL, sound);
-    
-    if (result != MA_SUCCESS) {
-        ma_waveform_uninit(waveform);
-        free(waveform);
-        free(sound);
-        return;
+AudioPriority AudioSystem::priorityFor(SoundType type) {
+    switch (type) {
+        case SoundType::STALL_WARNING:
+        case SoundType::GEAR_WARNING:
+        case SoundType::SINK_RATE:
+        case SoundType::PULL_UP:
+        case SoundType::TERRAIN_AHEAD:
+            return AudioPriority::WARNING;
+        case SoundType::ENGINE:
+        case SoundType::WIND_AMBIENT:
+            return AudioPriority::AMBIENT;
+        default:
+            return AudioPriority::CALLOUT;
     }
+}
+
+void AudioSystem::playBeep(SoundType type, float frequency, float duration, float volume,
+                           AudioMixer::Clock::time_point detectTime) {
+    if (!initialized) return;
     
-    // Set volume and start
-    ma_sound_set_volume(sound, volume);
-    ma_sound_start(sound);
-    
-    // Note: In a real implementation, you'd need to track these and clean them up
-    // For now, this creates a fire-and-forget beep
+    // Posts a command; the audio thread picks (or steals) a preallocated voice
+    mixer.play((int)type, priorityFor(type), Waveform::SINE, frequency, duration, volume, detectTime);
 }
 
 void AudioSystem::generateSyntheticSounds() {
-    std::cout << "Using real-time audio beeps for warnings" << std::endl;
+    LOG_INFO("Using real-time audio beeps for warnings");
 }
 
 bool AudioSystem::loadSound(SoundType type, const std::string& filepath) {
     if (!initialized || !enginePtr) return false;
     
-    Sound& snd = sounds[type];
+    Sound& snd = sounds[(int)type];
+    if (snd.soundPtr) {
+        ma_sound_uninit((ma_sound*)snd.soundPtr);
+        free(snd.soundPtr);
+        snd.soundPtr = nullptr;
+        snd.loaded = false;
+    }
     
-    // Allocate sound
+    // Allocate sound (load time only, never on the play path)
     snd.soundPtr = malloc(sizeof(ma_sound));
     ma_sound* sound = (ma_sound*)snd.soundPtr;
     
@@ -129,7 +450,7 @@ bool AudioSystem::loadSound(SoundType type, const std::string& filepath) {
                                                sound);
     
     if (result != MA_SUCCESS) {
-        std::cerr << "Failed to load sound: " << filepath << std::endl;
+        LOG_ERROR("Failed to load sound: %s", filepath.c_str());
         free(snd.soundPtr);
         snd.soundPtr = nullptr;
         return false;
@@ -146,12 +467,11 @@ bool AudioSystem::loadSound(SoundType type, const std::string& filepath) {
 void AudioSystem::playSound(SoundType type, bool loop) {
     if (!initialized) return;
     
-    auto it = sounds.find(type);
-    if (it == sounds.end() || !it->second.loaded || !it->second.soundPtr) {
+    Sound& snd = sounds[(int)type];
+    if (!snd.loaded || !snd.soundPtr) {
         return;
     }
     
-    Sound& snd = it->second;
     ma_sound* sound = (ma_sound*)snd.soundPtr;
     
     if (!snd.playing) {
@@ -166,10 +486,11 @@ void AudioSystem::playSound(SoundType type, bool loop) {
 void AudioSystem::stopSound(SoundType type) {
     if (!initialized) return;
     
-    auto it = sounds.find(type);
-    if (it == sounds.end() || !it->second.loaded || !it->second.soundPtr) return;
+    // Synthetic voices playing for this sound
+    mixer.stopGroup((int)type);
     
-    Sound& snd = it->second;
+    Sound& snd = sounds[(int)type];
+    if (!snd.loaded || !snd.soundPtr) return;
     
     if (snd.playing) {
         ma_sound_stop((ma_sound*)snd.soundPtr);
@@ -178,19 +499,20 @@ void AudioSystem::stopSound(SoundType type) {
 }
 
 void AudioSystem::stopAllSounds() {
-    for (auto& pair : sounds) {
-        stopSound(pair.first);
+    for (int i = 0; i < (int)SoundType::COUNT; i++) {
+        stopSound((SoundType)i);
     }
 }
 
 void AudioSystem::setVolume(SoundType type, float volume) {
     if (!initialized) return;
     
-    auto it = sounds.find(type);
-    if (it == sounds.end()) return;
-    
-    Sound& snd = it->second;
+    Sound& snd = sounds[(int)type];
     snd.volume = std::max(0.0f, std::min(1.0f, volume));
+    mixer.setGroupVolume((int)type, snd.volume);
+    if (type == SoundType::ENGINE) {
+        synth.setVolume(snd.volume);
+    }
     
     if (snd.loaded && snd.playing && snd.soundPtr) {
         ma_sound_set_volume((ma_sound*)snd.soundPtr, snd.volume);
@@ -200,11 +522,9 @@ void AudioSystem::setVolume(SoundType type, float volume) {
 void AudioSystem::setPitch(SoundType type, float pitch) {
     if (!initialized) return;
     
-    auto it = sounds.find(type);
-    if (it == sounds.end()) return;
-    
-    Sound& snd = it->second;
+    Sound& snd = sounds[(int)type];
     snd.pitch = std::max(0.1f, std::min(4.0f, pitch));
+    mixer.setGroupPitch((int)type, snd.pitch);
     
     if (snd.loaded && snd.playing && snd.soundPtr) {
         ma_sound_set_pitch((ma_sound*)snd.soundPtr, snd.pitch);
@@ -212,134 +532,80 @@ void AudioSystem::setPitch(SoundType type, float pitch) {
 }
 
 bool AudioSystem::isPlaying(SoundType type) {
-    auto it = sounds.find(type);
-    if (it == sounds.end() || !it->second.soundPtr) return false;
+    const Sound& snd = sounds[(int)type];
+    if (!snd.soundPtr) return false;
     
-    return it->second.playing && ma_sound_is_playing((ma_sound*)it->second.soundPtr);
+    return snd.playing && ma_sound_is_playing((ma_sound*)snd.soundPtr);
 }
 
-void AudioSystem::update(double throttle, double airspeed, double altitude, bool isStalling) {
+void AudioSystem::update(double throttle, double airspeed) {
     if (!initialized) return;
     
-    static double time = 0.0;
-    time += 0.016; // Assume ~60 FPS
-    
-    // ============================================
-    // ENGINE SOUND - Varies with throttle
-    // ============================================
-    static double lastEngineUpdate = 0.0;
-    if (time - lastEngineUpdate > 2.0 && throttle > 0.1) {
-        // Play a low rumble for engine (varies with throttle)
-        float engineFreq = 80.0f + (throttle * 120.0f); // 80-200 Hz
-        float engineVol = 0.15f + (throttle * 0.15f);   // 0.15-0.3 volume
-        playBeep(engineFreq, 0.2f, engineVol);
-        
-        lastEngineUpdate = time;
-        std::cout << "🔊 Engine: " << (int)(throttle * 100) << "% power" << std::endl;
+    // Fixed-pitch prop: idle ~800 rpm to ~2700 rpm at full power,
+    // windmilling adds a little with airspeed
+    float rpm = (float)(800.0 + 1900.0 * throttle + 4.0 * airspeed);
+    synth.setParameters(std::min(rpm, 2800.0f), (float)throttle, (float)airspeed);
+}
+
+void AudioSystem::processAlerts(AlertEngine& alerts) {
+    AlertEvent event;
+    while (alerts.poll(event)) {
+        if (initialized) playAlert(event);
     }
-    
-    // ============================================
-    // STALL WARNING - Activated at low airspeed
-    // ============================================
-    double stallSpeed = 40.0; // m/s (~78 knots)
-    double stallBuffer = 5.0;  // m/s buffer zone
-    
-    if (airspeed < stallSpeed + stallBuffer && !isStalling) {
-        if (!stallWarningActive) {
-            std::cout << "⚠️  STALL WARNING - Low airspeed!" << std::endl;
-            std::cout << "    Airspeed: " << (airspeed * 1.94384) << " kts" << std::endl;
-            stallWarningActive = true;
+}
+
+void AudioSystem::playAlert(const AlertEvent& event) {
+    switch (event.type) {
+        case AlertType::STALL:
+            if (event.phase == AlertPhase::ONSET) {
+                LOG_WARN("⚠️  STALL WARNING - Low airspeed! (%.0f kts)", event.value * 1.94384);
+                playBeep(SoundType::STALL_WARNING, 800.0f, 0.3f, 0.5f, event.detectTime);
+            } else if (event.phase == AlertPhase::REPEAT) {
+                LOG_AT(LogLevel::DEBUG, 1, "🔴 BEEP BEEP BEEP");
+                playBeep(SoundType::STALL_WARNING, 800.0f, 0.2f, 0.4f, event.detectTime);
+            } else {
+                LOG_INFO("✓ Airspeed recovered");
+            }
+            break;
             
-            // Play initial stall warning beep
-            playBeep(800.0f, 0.3f, 0.5f);
-        }
-        
-        // Continuous beeping
-        static double lastStallBeep = 0.0;
-        if (time - lastStallBeep > 0.5) {
-            playBeep(800.0f, 0.2f, 0.4f);
-            std::cout << "🔴 BEEP BEEP BEEP" << std::endl;
-            lastStallBeep = time;
-        }
-    } else if (airspeed > stallSpeed + stallBuffer + 5.0) {
-        if (stallWarningActive) {
-            stallWarningActive = false;
-            std::cout << "✓ Airspeed recovered" << std::endl;
-        }
-    }
-    
-    // ============================================
-    // TERRAIN WARNINGS - Altitude callouts
-    // ============================================
-    double altitudeFeet = altitude * 3.28084;
-    
-    // Only give warnings if descending
-    static double lastAltitude = altitudeFeet;
-    bool descending = (altitudeFeet < lastAltitude - 10.0);
-    lastAltitude = altitudeFeet;
-    
-    if (descending && (time - lastTerrainCallout) > terrainCalloutCooldown) {
-        const char* calloutText = nullptr;
-        float frequency = 600.0f;
-        bool shouldCallout = false;
-        
-        if (altitudeFeet < 510 && altitudeFeet > 490) {
-            calloutText = "500";
-            shouldCallout = true;
-        } else if (altitudeFeet < 410 && altitudeFeet > 390) {
-            calloutText = "400";
-            shouldCallout = true;
-        } else if (altitudeFeet < 310 && altitudeFeet > 290) {
-            calloutText = "300";
-            shouldCallout = true;
-        } else if (altitudeFeet < 210 && altitudeFeet > 190) {
-            calloutText = "200";
-            frequency = 700.0f;
-            shouldCallout = true;
-        } else if (altitudeFeet < 110 && altitudeFeet > 90) {
-            calloutText = "100";
-            frequency = 800.0f;
-            shouldCallout = true;
-            terrainCalloutCooldown = 1.0;
-        } else if (altitudeFeet < 55 && altitudeFeet > 45) {
-            calloutText = "50";
-            frequency = 900.0f;
-            shouldCallout = true;
-            terrainCalloutCooldown = 0.5;
-        } else if (altitudeFeet < 45 && altitudeFeet > 35) {
-            calloutText = "40";
-            frequency = 950.0f;
-            shouldCallout = true;
-            terrainCalloutCooldown = 0.5;
-        } else if (altitudeFeet < 35 && altitudeFeet > 25) {
-            calloutText = "30";
-            frequency = 1000.0f;
-            shouldCallout = true;
-            terrainCalloutCooldown = 0.4;
-        } else if (altitudeFeet < 25 && altitudeFeet > 15) {
-            calloutText = "20";
-            frequency = 1100.0f;
-            shouldCallout = true;
-            terrainCalloutCooldown = 0.3;
-        } else if (altitudeFeet < 15 && altitudeFeet > 5) {
-            calloutText = "10";
-            frequency = 1200.0f;
-            shouldCallout = true;
-            terrainCalloutCooldown = 0.2;
-        }
-        
-        if (shouldCallout) {
-            std::cout << "📢 TERRAIN: " << calloutText << " feet" << std::endl;
+        case AlertType::SINK_RATE:
+            if (event.phase != AlertPhase::CLEARED) {
+                LOG_AT(LogLevel::WARN, 1, "⚠️  SINK RATE: %.0f ft/min", event.value);
+                playBeep(SoundType::SINK_RATE, 500.0f, 0.4f, 0.6f, event.detectTime);
+            }
+            break;
+            
+        case AlertType::TERRAIN_CLOSURE:
+            if (event.phase != AlertPhase::CLEARED) {
+                LOG_AT(LogLevel::WARN, 1, "🔴 TERRAIN, PULL UP");
+                playBeep(SoundType::PULL_UP, 1400.0f, 0.5f, 0.7f, event.detectTime);
+            }
+            break;
             
-            // Play warning beep with increasing frequency as we get lower
-            playBeep(frequency, 0.3f, 0.6f);
+        case AlertType::TERRAIN_AHEAD:
+            if (event.phase != AlertPhase::CLEARED) {
+                LOG_AT(LogLevel::WARN, 1, "🟠 TERRAIN AHEAD: impact in %.0f s", event.value);
+                playBeep(SoundType::TERRAIN_AHEAD, 1000.0f, 0.4f, 0.6f, event.detectTime);
+            }
+            break;
             
-            lastTerrainCallout = time;
+        case AlertType::ALTITUDE_CALLOUT: {
+            // Tone rises as the aircraft gets lower
+            static const struct { int feet; SoundType type; float frequency; } callouts[] = {
+                {500, SoundType::TERRAIN_500, 600.0f},  {400, SoundType::TERRAIN_400, 600.0f},
+                {300, SoundType::TERRAIN_300, 600.0f},  {200, SoundType::TERRAIN_200, 700.0f},
+                {100, SoundType::TERRAIN_100, 800.0f},  {50, SoundType::TERRAIN_50, 900.0f},
+                {40, SoundType::TERRAIN_40, 950.0f},    {30, SoundType::TERRAIN_30, 1000.0f},
+                {20, SoundType::TERRAIN_20, 1100.0f},   {10, SoundType::TERRAIN_10, 1200.0f},
+            };
+            for (const auto& callout : callouts) {
+                if (callout.feet == event.calloutFeet) {
+                    LOG_INFO("📢 TERRAIN: %d feet", callout.feet);
+                    playBeep(callout.type, callout.frequency, 0.3f, 0.6f, event.detectTime);
+                    break;
+                }
+            }
+            break;
         }
     }
-    
-    // Reset cooldown if climbing
-    if (!descending && altitudeFeet > 200) {
-        terrainCalloutCooldown = 3.0;
-    }
 }
@@ -0,0 +1,1895 @@
+#include "benchmarks.hpp"
+#include "aircraft.hpp"
+#include "aero_identification.hpp"
+#include "aircraft_types.hpp"
+#include "alert_engine.hpp"
+#include "flight_dynamics.hpp"
+#include "instruments.hpp"
+#include "audio_mixer.hpp"
+#include "engine_synth.hpp"
+#include "logger.hpp"
+#include "rewind_buffer.hpp"
+#include "flight_envelope.hpp"
+#include "counter_rng.hpp"
+#include "fast_math.hpp"
+#include "flight_log.hpp"
+#include "flight_env.hpp"
+#include "flight_path_predictor.hpp"
+#include "geodesy.hpp"
+#include "nav_ekf.hpp"
+#include "sensors.hpp"
+#include "state_hash.hpp"
+#include "thread_pool.hpp"
+#include "watch_expression.hpp"
+#include "imgui.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Instrument panel CPU time and vertex count, geometry cache off vs on.
+// Runs a real ImGui frame loop without a renderer backend.
+int benchInstruments() {
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+    io.DeltaTime = 1.0f / 60.0f;
+    
+    unsigned char* pixels;
+    int texWidth, texHeight;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &texWidth, &texHeight);
+    io.Fonts->SetTexID((ImTextureID)(intptr_t)1);
+    
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    Instruments instruments;
+    const int frames = 2000;
+    
+    std::printf("%-10s %12s %12s\n", "cache", "us/panel", "vertices");
+    for (int pass = 0; pass < 2; pass++) {
+        bool cached = (pass == 1);
+        instruments.getGeometryCache().setEnabled(cached);
+        
+        double totalMs = 0.0;
+        long long vertices = 0;
+        for (int i = 0; i < frames; i++) {
+            // Keep every needle and the attitude ball moving
+            AircraftState& state = aircraft.getState();
+            state.roll = 0.6 * std::sin(i * 0.031);
+            state.pitch = 0.3 * std::sin(i * 0.017);
+            state.yaw = std::fmod(i * 0.01, 2.0 * M_PI) - M_PI;
+            state.position.z = -1000.0 - 500.0 * std::sin(i * 0.005);
+            dynamics.updateAirData();
+            
+            ImGui::NewFrame();
+            ImGui::SetNextWindowSize(ImVec2(800.0f, 900.0f), ImGuiCond_Always);
+            
+            auto start = Clock::now();
+            instruments.sampleSecondary(aircraft.getState(), dynamics.getAirData());
+            instruments.render(aircraft, dynamics.getAirData());
+            totalMs += elapsedMs(start);
+            
+            ImGui::Render();
+            vertices += ImGui::GetDrawData()->TotalVtxCount;
+        }
+        
+        std::printf("%-10s %12.1f %12lld\n", cached ? "on" : "off",
+                    1000.0 * totalMs / frames, vertices / frames);
+    }
+    std::printf("static layers baked %d times, %d cached vertices\n",
+                instruments.getGeometryCache().getBakeCount(),
+                instruments.getGeometryCache().getCachedVertexCount());
+    
+    ImGui::DestroyContext();
+    return 0;
+}
+
+// Voice pool mixing cost at 48 kHz stereo with the game thread posting a
+// burst of tones every 60 Hz frame (enough to force voice stealing)
+int benchAudioMixer() {
+    AudioMixer mixer;
+    mixer.configure(48000, 2);
+    
+    const uint32_t bufferFrames = 512;
+    const int seconds = 60;
+    float buffer[bufferFrames * 2];
+    
+    double totalMs = 0.0, worstMs = 0.0;
+    int buffers = 0;
+    uint32_t peakVoices = 0;
+    uint32_t rng = 12345;
+    double nextPostTime = 0.0;
+    
+    for (uint64_t frame = 0; frame < 48000ull * seconds; frame += bufferFrames) {
+        double time = frame / 48000.0;
+        while (nextPostTime <= time) {
+            for (int i = 0; i < 3; i++) {
+                rng = rng * 1664525u + 1013904223u;
+                AudioPriority priority = (AudioPriority)((rng >> 8) % 3);
+                float frequency = 200.0f + (float)((rng >> 12) % 1000);
+                mixer.play((int)((rng >> 4) % 14), priority, (rng & 1) ? Waveform::SINE : Waveform::SQUARE,
+                           frequency, 0.3f, 0.2f);
+            }
+            nextPostTime += 1.0 / 60.0;
+        }
+        
+        auto start = Clock::now();
+        mixer.render(buffer, bufferFrames);
+        double ms = elapsedMs(start);
+        totalMs += ms;
+        if (ms > worstMs) worstMs = ms;
+        buffers++;
+        if (mixer.getStats().activeVoices > peakVoices) peakVoices = mixer.getStats().activeVoices;
+    }
+    
+    AudioMixer::Stats stats = mixer.getStats();
+    double bufferMs = 1000.0 * bufferFrames / 48000.0;
+    std::printf("%d buffers of %u frames: avg %.1f us (%.2f%% of %.1f ms), worst %.1f us\n",
+                buffers, bufferFrames, 1000.0 * totalMs / buffers, 100.0 * totalMs / buffers / bufferMs,
+                bufferMs, 1000.0 * worstMs);
+    std::printf("voices: pool %d, peak %u, started %llu, stolen %llu, rejected %llu, dropped commands %llu\n",
+                AudioMixer::MAX_VOICES, peakVoices, (unsigned long long)stats.voicesStarted,
+                (unsigned long long)stats.voicesStolen, (unsigned long long)stats.voicesRejected,
+                (unsigned long long)stats.commandsDropped);
+    return 0;
+}
+
+// Engine/airflow synthesizer cost per 10 ms buffer at 48 kHz stereo while
+// sweeping throttle and airspeed, against its per-buffer CPU budget
+int benchEngineSynth() {
+    EngineSynth synth;
+    synth.configure(48000, 2);
+    
+    const uint32_t bufferFrames = 480;
+    const int buffers = 6000;   // 60 s of audio
+    float buffer[bufferFrames * 2];
+    
+    auto start = Clock::now();
+    for (int i = 0; i < buffers; i++) {
+        float sweep = 0.5f - 0.5f * (float)std::cos(i * 0.002);
+        synth.setParameters(800.0f + 1900.0f * sweep, sweep, 20.0f + 60.0f * sweep);
+        synth.render(buffer, bufferFrames);
+    }
+    double totalMs = elapsedMs(start);
+    
+    EngineSynth::Stats stats = synth.getStats();
+    std::printf("%d buffers of %u frames: %.1f us/buffer (%.0fx real time)\n", buffers, bufferFrames,
+                1000.0 * totalMs / buffers, 60000.0 / totalMs);
+    std::printf("budget %.0f us (%.0f%% of buffer time), worst %.1f us, over budget %llu\n",
+                stats.budgetUs, 100.0 * EngineSynth::CPU_BUDGET_FRACTION, stats.maxUs,
+                (unsigned long long)stats.overBudget);
+    return stats.overBudget * 100 > stats.buffers ? 1 : 0;
+}
+
+// Call-site cost of the asynchronous logger: enabled records with numeric
+// and string arguments, rate-limited records and records below the level.
+// Bursts stay under the per-thread ring size so nothing is dropped.
+int benchLogger() {
+    FILE* sink = std::tmpfile();
+    if (!sink) {
+        std::fprintf(stderr, "Failed to create a temporary file\n");
+        return 1;
+    }
+    Logger::stop();
+    Logger::start(sink);
+    
+    const int bursts = 200;
+    const int burstSize = 512;
+    double enabledMs = 0.0, limitedMs = 0.0, filteredMs = 0.0;
+    for (int burst = 0; burst < bursts; burst++) {
+        auto start = Clock::now();
+        for (int i = 0; i < burstSize; i++) {
+            LOG_INFO("bench %d alt %.1f ft %s", i, 1000.0 - i, "callout");
+        }
+        enabledMs += elapsedMs(start);
+        
+        start = Clock::now();
+        for (int i = 0; i < burstSize; i++) {
+            LOG_AT(LogLevel::WARN, 10, "limited %d", i);
+        }
+        limitedMs += elapsedMs(start);
+        
+        start = Clock::now();
+        for (int i = 0; i < burstSize; i++) {
+            LOG_DEBUG("filtered %d", i);
+        }
+        filteredMs += elapsedMs(start);
+        
+        // Let the writer catch up
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    
+    Logger::stop();
+    Logger::Stats stats = Logger::getStats();
+    std::fclose(sink);
+    Logger::start(stderr);
+    
+    double calls = (double)bursts * burstSize;
+    std::printf("%-12s %10s\n", "record", "ns/call");
+    std::printf("%-12s %10.1f\n", "enabled", 1e6 * enabledMs / calls);
+    std::printf("%-12s %10.1f\n", "rate-limited", 1e6 * limitedMs / calls);
+    std::printf("%-12s %10.1f\n", "below level", 1e6 * filteredMs / calls);
+    std::printf("written %llu, dropped %llu, suppressed %llu\n", (unsigned long long)stats.written,
+                (unsigned long long)stats.dropped, (unsigned long long)stats.suppressed);
+    return 0;
+}
+
+// One aircraft's alert events for the checks below
+struct AlertLog {
+    std::vector<AlertEvent> events;
+    
+    void drain(AlertEngine& engine) {
+        AlertEvent event;
+        while (engine.poll(event)) events.push_back(event);
+    }
+    
+    int count(AlertType type, AlertPhase phase) const {
+        int n = 0;
+        for (const AlertEvent& event : events) n += event.type == type && event.phase == phase;
+        return n;
+    }
+};
+
+// Straight-line height change at a tick rate; false when a tick's callout
+// is not the lowest one crossed (or one is missing or repeated)
+bool alertPass(AlertEngine& engine, AlertLog& log, double fromFeet, double toFeet, double fpm, double rateHz,
+               double& simTime, int& announced) {
+    const double feetPerTick = fpm / 60.0 / rateHz;
+    const std::vector<double>& callouts = engine.getCallouts();
+    bool ok = true;
+    double previous = fromFeet;
+    for (double feet = fromFeet; fromFeet > toFeet ? feet > toFeet : feet < toFeet;) {
+        feet = fromFeet > toFeet ? std::max(toFeet, feet - feetPerTick) : std::min(toFeet, feet + feetPerTick);
+        simTime += 1.0 / rateHz;
+        AlertInputs inputs;
+        inputs.altitude = feet / 3.28084;
+        inputs.terrainElevation = 0.0;
+        inputs.verticalSpeed = (fromFeet > toFeet ? -fpm : fpm) / 60.0 / 3.28084;
+        inputs.airspeed = 70.0;
+        inputs.timeToImpact = INFINITY;
+        size_t before = log.events.size();
+        engine.evaluate(0, inputs, simTime);
+        log.drain(engine);
+        
+        // Descending: the lowest callout in (feet, previous] and nothing else
+        double expected = -1.0;
+        for (double c : callouts) {
+            if (c > feet && c <= previous) {
+                expected = c;
+                break;
+            }
+        }
+        int got = -1, count = 0;
+        for (size_t i = before; i < log.events.size(); i++) {
+            if (log.events[i].type != AlertType::ALTITUDE_CALLOUT) continue;
+            got = log.events[i].calloutFeet;
+            count++;
+        }
+        if (fromFeet < toFeet) expected = -1.0;   // Climbing re-arms without callouts
+        if (count > 1 || got != (int)expected) ok = false;
+        announced += count;
+        previous = feet;
+    }
+    return ok;
+}
+
+// Alerting on sim ticks: high-sink-rate passes through the callouts at a
+// fine and a coarse tick rate with a climb in between to re-arm them, the
+// stall band's hysteresis and repeats, and the cost per aircraft per tick
+int benchAlerts() {
+    AlertEngine engine;
+    AlertLog log;
+    double simTime = 0.0;
+    int fine = 0, coarse = 0, climb = 0;
+    
+    // 9000 ft/min from 600 ft: every callout once, lowest first per tick
+    bool finePass = alertPass(engine, log, 600.0, 5.0, 9000.0, 100.0, simTime, fine);
+    int sinkOnsets = log.count(AlertType::SINK_RATE, AlertPhase::ONSET);
+    int sinkCleared = log.count(AlertType::SINK_RATE, AlertPhase::CLEARED);
+    bool climbPass = alertPass(engine, log, 5.0, 600.0, 3000.0, 100.0, simTime, climb);
+    // 4 Hz: 37.5 ft per tick, several callouts crossed in one tick
+    bool coarsePass = alertPass(engine, log, 600.0, 2.0, 9000.0, 4.0, simTime, coarse);
+    
+    // Stall band: 60 -> 40 -> 60 m/s at 1 m/s per second, 100 Hz
+    AlertEngine stallEngine;
+    AlertLog stallLog;
+    double onsetAt = NAN, clearedAt = NAN;
+    for (int i = 1; i <= 4000; i++) {
+        double t = i * 0.01;
+        AlertInputs inputs;
+        inputs.altitude = 1000.0;
+        inputs.terrainElevation = 0.0;
+        inputs.verticalSpeed = 0.0;
+        inputs.airspeed = t < 20.0 ? 60.0 - t : 20.0 + t;
+        inputs.timeToImpact = INFINITY;
+        stallEngine.evaluate(0, inputs, t);
+        size_t before = stallLog.events.size();
+        stallLog.drain(stallEngine);
+        for (size_t k = before; k < stallLog.events.size(); k++) {
+            if (stallLog.events[k].phase == AlertPhase::ONSET) onsetAt = t;
+            if (stallLog.events[k].phase == AlertPhase::CLEARED) clearedAt = t;
+        }
+    }
+    int stallRepeats = stallLog.count(AlertType::STALL, AlertPhase::REPEAT);
+    // Below 45 m/s from t = 15 s, clear at 50 m/s (t = 30 s), repeats every 0.5 s
+    bool stallPass = std::fabs(onsetAt - 15.01) < 1e-9 && std::fabs(clearedAt - 30.0) < 1e-9 &&
+                     stallRepeats == 29 && stallLog.count(AlertType::STALL, AlertPhase::ONSET) == 1;
+    
+    std::printf("9000 ft/min at 100 Hz: %d callouts (expected 10), sink rate onset %d cleared %d: %s\n", fine,
+                sinkOnsets, sinkCleared, finePass && fine == 10 && sinkOnsets == 1 && sinkCleared == 1 ? "ok" : "FAIL");
+    std::printf("climb to 600 ft: %d callouts: %s\n", climb, climbPass && climb == 0 ? "ok" : "FAIL");
+    std::printf("9000 ft/min at 4 Hz (37.5 ft per tick): %d callouts, the lowest crossed each tick: %s\n", coarse,
+                coarsePass ? "ok" : "FAIL");
+    std::printf("stall band: onset %.2f s (45 m/s), cleared %.2f s (50 m/s), %d repeats: %s\n", onsetAt, clearedAt,
+                stallRepeats, stallPass ? "ok" : "FAIL");
+    
+    // Cost: 1000 aircraft in a descent, one tick at 100 Hz each
+    const int aircraft = 1000, ticks = 1000;
+    AlertEngine fleet(aircraft);
+    std::vector<AlertInputs> inputs(aircraft);
+    AlertEvent event;
+    double evaluateMs = 0.0;
+    for (int tick = 0; tick < ticks; tick++) {
+        for (int a = 0; a < aircraft; a++) {
+            inputs[a].altitude = 800.0 - (tick + a % 100) * 0.25;
+            inputs[a].terrainElevation = 0.0;
+            inputs[a].verticalSpeed = -25.0;
+            inputs[a].airspeed = 60.0;
+            inputs[a].timeToImpact = INFINITY;
+        }
+        auto start = Clock::now();
+        for (int a = 0; a < aircraft; a++) fleet.evaluate(a, inputs[a], tick * 0.01);
+        evaluateMs += elapsedMs(start);
+        while (fleet.poll(event)) {
+        }
+    }
+    std::printf("%d aircraft x %d ticks: %.0f ns per aircraft per tick, %llu events dropped\n", aircraft, ticks,
+                1e6 * evaluateMs / ((double)aircraft * ticks), (unsigned long long)fleet.getDroppedEvents());
+    
+    bool pass = finePass && fine == 10 && sinkOnsets == 1 && sinkCleared == 1 && climbPass && climb == 0 &&
+                coarsePass && coarse > 0 && stallPass && engine.getDroppedEvents() == 0;
+    std::printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+// Rewind buffer in the simulator's configuration (1 kHz dynamics, inputs
+// recorded at the 100 Hz control rate, one-second keyframes): record 35
+// minutes of scripted flight into a 30 minute buffer, then restore to points
+// across the whole history and check each against the state seen live. A
+// restore re-simulates up to 990 steps, so its worst case must fit a frame.
+int benchRewind() {
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    const double baseRate = 1000.0;
+    const double controlRate = 100.0;
+    const double dt = 1.0 / baseRate;
+    const int substeps = (int)(baseRate / controlRate);
+    const double frameUs = 1e6 / 60.0;
+    RewindBuffer buffer(dt, 30.0 * 60.0, (int)controlRate, substeps);
+    
+    const int records = 35 * 60 * (int)controlRate;
+    const int checkEvery = 997;
+    std::vector<AircraftState> expected;
+    expected.reserve(records / checkEvery + 1);
+    
+    auto start = Clock::now();
+    double simTime = 0.0;
+    for (int i = 0; i < records; i++) {
+        AircraftState& state = aircraft.getState();
+        if (i % 37 == 0) state.elevator = -0.01 + 0.04 * std::sin(i * 0.013);
+        state.aileron = (i % 600) < 120 ? 0.1 * std::sin(i * 0.01) : 0.0;
+        state.throttle = 0.6;
+        if (aircraft.getAltitude() < 200.0) {
+            // Climb back up; not a dynamics step, so force a keyframe
+            dynamics.reset();
+            buffer.markDiscontinuity();
+        }
+        buffer.record(simTime, state);
+        if (i % checkEvery == 0) expected.push_back(state);
+        for (int s = 0; s < substeps; s++) {
+            dynamics.update(dt);
+            simTime += dt;
+        }
+    }
+    double recordMs = elapsedMs(start);
+    
+    int exact = 0, mismatched = 0, restores = 0;
+    double totalUs = 0.0, worstUs = 0.0;
+    for (size_t k = 0; k < expected.size(); k++) {
+        double time = (double)k * checkEvery * substeps * dt;
+        if (time < buffer.getOldestTime()) continue;
+        double restoredTime;
+        auto restoreStart = Clock::now();
+        buffer.restore(time, dynamics, aircraft, restoredTime);
+        double us = 1000.0 * elapsedMs(restoreStart);
+        totalUs += us;
+        if (us > worstUs) worstUs = us;
+        restores++;
+        if (std::memcmp(&aircraft.getState(), &expected[k], sizeof(AircraftState)) == 0) {
+            exact++;
+        } else {
+            mismatched++;
+        }
+    }
+    
+    RewindBuffer::MemoryStats stats = buffer.getMemoryStats();
+    bool withinFrame = worstUs < frameUs;
+    std::printf("recorded %d control steps (%d dynamics steps) in %.1f ms (%.2f us/record)\n", records,
+                records * substeps, recordMs, 1000.0 * recordMs / records);
+    std::printf("history %.0f s of %.0f s: %zu keyframes, %.2f MB used of %.2f MB reserved\n",
+                stats.spanSeconds, stats.capacitySeconds, stats.keyframes, stats.usedBytes / 1e6,
+                stats.reservedBytes / 1e6);
+    std::printf("%d restores: avg %.1f us, worst %.1f us (%.0f%% of a 60 Hz frame): %s; %d exact, %d mismatched\n",
+                restores, totalUs / std::max(1, restores), worstUs, 100.0 * worstUs / frameUs,
+                withinFrame ? "ok" : "over", exact, mismatched);
+    return mismatched == 0 && withinFrame ? 0 : 1;
+}
+
+// Envelope map over the standard grid on one thread and on every hardware
+// thread; both runs must produce identical tables
+int benchEnvelope() {
+    EnvelopeGrid grid = EnvelopeGrid::standard();
+    FlightEnvelope serial, parallel;
+    serial.generate(grid, 1);
+    parallel.generate(grid, 0);
+    
+    size_t trimmed = 0, differing = 0;
+    for (int w = 0; w < grid.weight.count; w++) {
+        for (int a = 0; a < grid.altitude.count; a++) {
+            for (int v = 0; v < grid.airspeed.count; v++) {
+                const EnvelopeCell& one = serial.at(w, a, v);
+                const EnvelopeCell& all = parallel.at(w, a, v);
+                trimmed += one.trimmed;
+                for (int m = 0; m < FlightEnvelope::METRIC_COUNT; m++) {
+                    float x = FlightEnvelope::metricValue(one, (FlightEnvelope::Metric)m);
+                    float y = FlightEnvelope::metricValue(all, (FlightEnvelope::Metric)m);
+                    if (std::memcmp(&x, &y, sizeof(float)) != 0) {
+                        differing++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    
+    size_t cells = grid.cellCount();
+    std::printf("%zu cells (%d weights x %d altitudes x %d airspeeds), %zu trimmable\n", cells,
+                grid.weight.count, grid.altitude.count, grid.airspeed.count, trimmed);
+    std::printf("%-10s %8s %10s %12s\n", "threads", "seconds", "us/cell", "speedup");
+    std::printf("%-10u %8.3f %10.1f %12.2f\n", serial.getThreadCount(), serial.getGenerateSeconds(),
+                1e6 * serial.getGenerateSeconds() / cells, 1.0);
+    std::printf("%-10u %8.3f %10.1f %12.2f\n", parallel.getThreadCount(), parallel.getGenerateSeconds(),
+                1e6 * parallel.getGenerateSeconds() / cells,
+                serial.getGenerateSeconds() / std::max(parallel.getGenerateSeconds(), 1e-9));
+    std::printf("%zu cells differ between runs\n", differing);
+    return differing == 0 ? 0 : 1;
+}
+
+// Counter-based generator against std::mt19937 with the standard
+// distributions, plus a check that the samples do not depend on thread count
+int benchRng() {
+    const size_t chunk = 4096;
+    const size_t chunks = 4096;
+    const double samples = (double)chunk * chunks;
+    std::vector<float> buffer(chunk);
+    float sink = 0.0f;
+    
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<float> uniformDist(0.0f, 1.0f);
+    std::normal_distribution<float> normalDist(0.0f, 1.0f);
+    CounterRng rng(1, 0, 0);
+    
+    auto start = Clock::now();
+    for (size_t c = 0; c < chunks; c++) {
+        for (size_t i = 0; i < chunk; i++) buffer[i] = uniformDist(engine);
+        sink += buffer[c % chunk];
+    }
+    double mtUniformMs = elapsedMs(start);
+    
+    start = Clock::now();
+    for (size_t c = 0; c < chunks; c++) {
+        rng.uniformBatch(c, buffer.data(), chunk);
+        sink += buffer[c % chunk];
+    }
+    double batchUniformMs = elapsedMs(start);
+    
+    start = Clock::now();
+    for (size_t c = 0; c < chunks; c++) {
+        for (size_t i = 0; i < chunk; i++) buffer[i] = normalDist(engine);
+        sink += buffer[c % chunk];
+    }
+    double mtNormalMs = elapsedMs(start);
+    
+    start = Clock::now();
+    for (size_t c = 0; c < chunks; c++) {
+        for (size_t i = 0; i < chunk; i++) buffer[i] = rng.normal(c, (uint32_t)i);
+        sink += buffer[c % chunk];
+    }
+    double scalarNormalMs = elapsedMs(start);
+    
+    start = Clock::now();
+    for (size_t c = 0; c < chunks; c++) {
+        rng.normalBatch(c, buffer.data(), chunk);
+        sink += buffer[c % chunk];
+    }
+    double batchNormalMs = elapsedMs(start);
+    
+    // Same samples from a thread pool as from one thread
+    const size_t checkChunks = 256;
+    std::vector<float> serial(checkChunks * chunk), parallel(checkChunks * chunk);
+    for (size_t c = 0; c < checkChunks; c++) {
+        rng.normalBatch(c, serial.data() + c * chunk, chunk);
+    }
+    ThreadPool pool;
+    pool.parallelFor(checkChunks, [&](size_t c) {
+        rng.normalBatch(c, parallel.data() + c * chunk, chunk);
+    });
+    bool identical = std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(float)) == 0;
+    
+    auto rate = [samples](double ms) { return samples / (ms * 1e3); };
+    std::printf("%.0fM samples (checksum %.3f)\n", samples / 1e6, sink);
+    std::printf("%-28s %12s %10s\n", "generator", "Msamples/s", "vs mt19937");
+    std::printf("%-28s %12.1f %10s\n", "mt19937 uniform", rate(mtUniformMs), "1.00");
+    std::printf("%-28s %12.1f %10.2f\n", "philox uniform batch", rate(batchUniformMs), mtUniformMs / batchUniformMs);
+    std::printf("%-28s %12.1f %10s\n", "mt19937 normal", rate(mtNormalMs), "1.00");
+    std::printf("%-28s %12.1f %10.2f\n", "philox normal scalar", rate(scalarNormalMs), mtNormalMs / scalarNormalMs);
+    std::printf("%-28s %12.1f %10.2f\n", "philox normal batch", rate(batchNormalMs), mtNormalMs / batchNormalMs);
+    std::printf("%u threads vs 1 thread: %s\n", pool.getThreadCount(), identical ? "identical" : "DIFFERENT");
+    return identical ? 0 : 1;
+}
+
+// Accuracy of one fast-math function over a range against libm
+struct MathCheck {
+    const char* name;
+    double min, max;
+    bool relative;          // Bound on relative rather than absolute error
+    double bound;           // As documented in fast_math.hpp: bound +
+    double boundPerLog;     // boundPerLog * |log x| at each x
+    double (*reference)(double);
+    double (*fast)(double);
+};
+
+double powReference(double x) { return std::pow(x, 5.2559); }
+double powFast(double x) { return fastmath::pow(x, 5.2559); }
+
+const MathCheck mathChecks[] = {
+    {"sin", -1e5, 1e5, false, 2e-14, 0.0, [](double x) { return std::sin(x); }, fastmath::sin},
+    {"sin", -M_PI, M_PI, false, 2e-14, 0.0, [](double x) { return std::sin(x); }, fastmath::sin},
+    {"cos", -M_PI, M_PI, false, 2e-14, 0.0, [](double x) { return std::cos(x); }, fastmath::cos},
+    {"tan", -1.5, 1.5, true, 3e-14, 0.0, [](double x) { return std::tan(x); }, fastmath::tan},
+    {"exp", -708.0, 709.0, true, 1.5e-14, 0.0, [](double x) { return std::exp(x); }, fastmath::exp},
+    {"exp", -1.0, 1.0, true, 1.5e-14, 0.0, [](double x) { return std::exp(x); }, fastmath::exp},
+    {"log", 1e-300, 1e300, false, 5e-15, 2.3e-16, [](double x) { return std::log(x); }, fastmath::log},
+    {"log", 1e-230, 1e-215, false, 5e-15, 2.3e-16, [](double x) { return std::log(x); }, fastmath::log},
+    {"log", 0.5, 2.0, false, 5e-15, 2.3e-16, [](double x) { return std::log(x); }, fastmath::log},
+    {"pow ^5.2559", 0.7, 1.0, true, 1e-14 + 4e-15 * 5.2559, 2e-16 * 5.2559, powReference, powFast},
+};
+
+// A scripted flight from the default initial state
+struct FastMathScenario {
+    const char* name;
+    void (*controls)(AircraftState& state, double time);
+};
+
+const FastMathScenario fastMathScenarios[] = {
+    {"cruise", [](AircraftState& state, double) {
+        state.throttle = 0.6;
+    }},
+    {"climbing turn", [](AircraftState& state, double time) {
+        state.throttle = 0.9;
+        state.elevator = -0.03;
+        state.aileron = time < 3.0 ? 0.05 : 0.0;
+    }},
+    {"glide", [](AircraftState& state, double) {
+        state.throttle = 0.0;
+        state.elevator = 0.01;
+    }},
+    {"pitch doublet", [](AircraftState& state, double time) {
+        state.throttle = 0.6;
+        state.elevator = time < 1.0 ? 0.0 : (time < 2.0 ? 0.05 : (time < 3.0 ? -0.05 : 0.0));
+        state.rudder = time > 10.0 && time < 11.0 ? 0.05 : 0.0;
+    }},
+};
+
+// Flies a scenario with one math policy, keeping every `sampleEvery`th state
+template <typename Math>
+double flyScenario(const FastMathScenario& scenario, double dt, int steps, int sampleEvery,
+                   std::vector<AircraftState>& samples) {
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    dynamics.reset();
+    samples.clear();
+    
+    auto start = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        scenario.controls(aircraft.getState(), i * dt);
+        if (i % sampleEvery == 0) samples.push_back(aircraft.getState());
+        dynamics.updateWith<Math>(dt);
+    }
+    return elapsedMs(start);
+}
+
+double angleDifference(double a, double b) {
+    return std::fabs(std::remainder(a - b, 2.0 * M_PI));
+}
+
+// Fast-math policy: per-function error against the documented bounds and
+// speed against libm, then standard scenarios flown with both policies
+// reporting trajectory divergence and the speedup of the dynamics step
+int benchFastMath() {
+    bool passed = true;
+    const int points = 1 << 20;
+    std::vector<double> x(points), out(points), out2(points);
+    
+    std::printf("%-12s %-22s %11s %9s %9s %9s %8s\n", "function", "range", "error", "bound",
+                "libm ns", "fast ns", "speedup");
+    for (const MathCheck& check : mathChecks) {
+        for (int i = 0; i < points; i++) {
+            double t = (i + 0.5) / points;
+            // Log-spaced for ranges spanning many decades
+            x[i] = check.min > 0.0 && check.max / check.min > 1e6
+                 ? std::exp(std::log(check.min) + t * (std::log(check.max) - std::log(check.min)))
+                 : check.min + (check.max - check.min) * t;
+        }
+        
+        auto start = Clock::now();
+        for (int i = 0; i < points; i++) out[i] = check.reference(x[i]);
+        double referenceMs = elapsedMs(start);
+        start = Clock::now();
+        for (int i = 0; i < points; i++) out2[i] = check.fast(x[i]);
+        double fastMs = elapsedMs(start);
+        
+        // The bound grows with |log x| for log and pow, so each point is
+        // held to its own; the point nearest its bound is reported
+        double worstError = 0.0, worstBound = check.bound, worstRatio = 0.0;
+        for (int i = 0; i < points; i++) {
+            double error = std::fabs(out2[i] - out[i]);
+            if (check.relative) error /= std::fabs(out[i]);
+            double bound = check.bound + check.boundPerLog * std::fabs(std::log(std::fabs(x[i])));
+            if (error / bound > worstRatio) {
+                worstRatio = error / bound;
+                worstError = error;
+                worstBound = bound;
+            }
+        }
+        bool ok = worstRatio <= 1.0;
+        passed = passed && ok;
+        
+        char range[32];
+        std::snprintf(range, sizeof(range), "[%g, %g]", check.min, check.max);
+        std::printf("%-12s %-22s %8.2e %s %9.2e %9.2f %9.2f %8.2f%s\n", check.name, range, worstError,
+                    check.relative ? "rel" : "abs", worstBound, 1e6 * referenceMs / points,
+                    1e6 * fastMs / points, referenceMs / fastMs, ok ? "" : "  EXCEEDS BOUND");
+    }
+    
+    // log(1) is exact
+    bool logOneExact = fastmath::log(1.0) == 0.0;
+    passed = passed && logOneExact;
+    std::printf("log(1) = %g: %s\n", fastmath::log(1.0), logOneExact ? "exact" : "NOT EXACT");
+    
+    // Batched sincos and exp: throughput and bitwise agreement with scalar
+    std::vector<double> s(points), c(points);
+    for (int i = 0; i < points; i++) x[i] = -M_PI + 2.0 * M_PI * (i + 0.5) / points;
+    auto start = Clock::now();
+    for (int i = 0; i < points; i++) {
+        s[i] = std::sin(x[i]);
+        c[i] = std::cos(x[i]);
+    }
+    double libmSincosMs = elapsedMs(start);
+    start = Clock::now();
+    fastmath::sincos(x.data(), s.data(), c.data(), points);
+    double batchSincosMs = elapsedMs(start);
+    size_t mismatches = 0;
+    for (int i = 0; i < points; i++) {
+        double ss, cc;
+        fastmath::sincos(x[i], ss, cc);
+        if (std::memcmp(&ss, &s[i], sizeof(double)) != 0 || std::memcmp(&cc, &c[i], sizeof(double)) != 0) {
+            mismatches++;
+        }
+    }
+    
+    for (int i = 0; i < points; i++) x[i] = -20.0 + 40.0 * (i + 0.5) / points;
+    start = Clock::now();
+    for (int i = 0; i < points; i++) out[i] = std::exp(x[i]);
+    double libmExpMs = elapsedMs(start);
+    start = Clock::now();
+    fastmath::exp(x.data(), out2.data(), points);
+    double batchExpMs = elapsedMs(start);
+    for (int i = 0; i < points; i++) {
+        double scalar = fastmath::exp(x[i]);
+        if (std::memcmp(&scalar, &out2[i], sizeof(double)) != 0) mismatches++;
+    }
+    
+    // atan2 over the whole circle, magnitudes from 1e-3 to 1e3
+    std::vector<double> y(points);
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    for (int i = 0; i < points; i++) {
+        y[i] = uniform(rng) * std::pow(10.0, 3.0 * uniform(rng));
+        x[i] = uniform(rng) * std::pow(10.0, 3.0 * uniform(rng));
+    }
+    start = Clock::now();
+    for (int i = 0; i < points; i++) out[i] = std::atan2(y[i], x[i]);
+    double libmAtan2Ms = elapsedMs(start);
+    start = Clock::now();
+    fastmath::atan2(y.data(), x.data(), out2.data(), points);
+    double batchAtan2Ms = elapsedMs(start);
+    double atan2Error = 0.0;
+    for (int i = 0; i < points; i++) {
+        double scalar = fastmath::atan2(y[i], x[i]);
+        if (std::memcmp(&scalar, &out2[i], sizeof(double)) != 0) mismatches++;
+        atan2Error = std::max(atan2Error, std::fabs(out2[i] - out[i]));
+    }
+    passed = passed && mismatches == 0 && atan2Error <= 1e-15;
+    
+    std::printf("%-35s %9.2f ns vs libm %6.2f ns %8.2fx\n", "batched sincos", 1e6 * batchSincosMs / points,
+                1e6 * libmSincosMs / points, libmSincosMs / batchSincosMs);
+    std::printf("%-35s %9.2f ns vs libm %6.2f ns %8.2fx\n", "batched exp", 1e6 * batchExpMs / points,
+                1e6 * libmExpMs / points, libmExpMs / batchExpMs);
+    std::printf("%-35s %9.2f ns vs libm %6.2f ns %8.2fx, max error %.2e abs (bound 1.0e-15)\n", "batched atan2",
+                1e6 * batchAtan2Ms / points, 1e6 * libmAtan2Ms / points, libmAtan2Ms / batchAtan2Ms, atan2Error);
+    std::printf("batched vs scalar: %zu values differ\n\n", mismatches);
+    
+    // Scenarios: 1 kHz for 120 s, states compared every 10 ms. Timings are
+    // the best of a few alternating runs; the trajectories are identical.
+    const double dt = 0.001;
+    const int steps = 120000;
+    const int sampleEvery = 10;
+    const int runs = 5;
+    std::printf("%-14s %12s %12s %12s %12s %9s %9s %8s\n", "scenario", "max pos m", "final pos m",
+                "max att deg", "max TAS m/s", "libm us", "fast us", "speedup");
+    std::vector<AircraftState> reference, fast;
+    double totalReferenceMs = 0.0, totalFastMs = 0.0;
+    for (const FastMathScenario& scenario : fastMathScenarios) {
+        double referenceMs = 1e30, fastMs = 1e30;
+        for (int run = 0; run < runs; run++) {
+            referenceMs = std::min(referenceMs, flyScenario<StdMath>(scenario, dt, steps, sampleEvery, reference));
+            fastMs = std::min(fastMs, flyScenario<FastMath>(scenario, dt, steps, sampleEvery, fast));
+        }
+        totalReferenceMs += referenceMs;
+        totalFastMs += fastMs;
+        
+        double maxPosition = 0.0, maxAttitude = 0.0, maxAirspeed = 0.0;
+        for (size_t k = 0; k < reference.size(); k++) {
+            const AircraftState& a = reference[k];
+            const AircraftState& b = fast[k];
+            if (!std::isfinite(b.position.x) || !std::isfinite(b.velocity.x)) {
+                passed = false;
+                break;
+            }
+            maxPosition = std::max(maxPosition, (a.position - b.position).magnitude());
+            maxAttitude = std::max({maxAttitude, angleDifference(a.roll, b.roll),
+                                    angleDifference(a.pitch, b.pitch), angleDifference(a.yaw, b.yaw)});
+            maxAirspeed = std::max(maxAirspeed, std::fabs(a.velocity.magnitude() - b.velocity.magnitude()));
+        }
+        double finalPosition = (reference.back().position - fast.back().position).magnitude();
+        std::printf("%-14s %12.3e %12.3e %12.3e %12.3e %9.3f %9.3f %8.2f\n", scenario.name, maxPosition,
+                    finalPosition, maxAttitude * 180.0 / M_PI, maxAirspeed, 1000.0 * referenceMs / steps,
+                    1000.0 * fastMs / steps, referenceMs / fastMs);
+    }
+    // Below 10% the fast policy is not worth its few ulp (nor the noise)
+    double speedup = totalReferenceMs / totalFastMs;
+    std::printf("dynamics step speedup over all scenarios: %.2fx (%s)\n", speedup,
+                speedup >= 1.1 ? "a win" : "not a win here, keep the libm default");
+    std::printf("%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
+
+// Gentle scripted inputs for the aircraft-type comparison
+void scriptedControls(AircraftState& state, double time, double variation) {
+    state.throttle = 0.6 + 0.2 * variation;
+    state.elevator = -0.02 + 0.02 * std::sin(0.5 * time + variation);
+    state.aileron = 0.03 * std::sin(0.2 * time + 2.0 * variation);
+    state.rudder = 0.01 * std::sin(0.3 * time);
+}
+
+// Compile-time aircraft types against the generic Aircraft/FlightDynamics
+// path: bitwise agreement for the Cessna, derivative cost, fleet stepping
+int benchAircraftTypes() {
+    const double dt = 0.001;
+    const AircraftType* cessna = findAircraftType("c172");
+    if (!cessna) {
+        std::fprintf(stderr, "c172 is not registered\n");
+        return 1;
+    }
+    
+    // Same flight through both paths, compared after every step
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    dynamics.reset();
+    AircraftState typed = aircraft.getState();
+    const int steps = 60000;
+    int identical = 0;
+    std::vector<AircraftState> samples;
+    for (int i = 0; i < steps; i++) {
+        scriptedControls(aircraft.getState(), i * dt, 0.0);
+        scriptedControls(typed, i * dt, 0.0);
+        if (i % 60 == 0) samples.push_back(typed);
+        dynamics.update(dt);
+        cessna->step(&typed, 1, atmosphere, dt);
+        if (std::memcmp(&typed, &aircraft.getState(), sizeof(AircraftState)) == 0) identical++;
+    }
+    
+    // Derivative evaluations over the states of that flight
+    const int repeats = 200;
+    double sink = 0.0;
+    auto start = Clock::now();
+    for (int k = 0; k < repeats; k++) {
+        for (const AircraftState& state : samples) sink += dynamics.computeDerivative(state).velocityDot.x;
+    }
+    double genericMs = elapsedMs(start);
+    start = Clock::now();
+    for (int k = 0; k < repeats; k++) {
+        for (const AircraftState& state : samples) sink += cessna->derivative(state, atmosphere).velocityDot.x;
+    }
+    double typedMs = elapsedMs(start);
+    double evaluations = (double)repeats * samples.size();
+    
+    std::printf("c172 typed vs generic: %d of %d steps bitwise identical\n", identical, steps);
+    std::printf("%-34s %10s %8s\n", "derivative", "ns/eval", "speedup");
+    std::printf("%-34s %10.1f %8s\n", "generic FlightDynamics", 1e6 * genericMs / evaluations, "1.00");
+    std::printf("%-34s %10.1f %8.2f\n", "typed c172", 1e6 * typedMs / evaluations, genericMs / typedMs);
+    
+    // Fleets of 256 aircraft, 1 s of flight
+    const size_t fleet = 256;
+    const int fleetSteps = 1000;
+    std::vector<Aircraft> aircraftFleet(fleet);
+    std::vector<FlightDynamics> dynamicsFleet;
+    dynamicsFleet.reserve(fleet);
+    for (size_t n = 0; n < fleet; n++) {
+        dynamicsFleet.emplace_back(&aircraftFleet[n], &atmosphere);
+        scriptedControls(aircraftFleet[n].getState(), 0.0, (double)n / fleet);
+    }
+    start = Clock::now();
+    for (int i = 0; i < fleetSteps; i++) {
+        for (FlightDynamics& d : dynamicsFleet) d.update(dt);
+    }
+    double genericFleetMs = elapsedMs(start);
+    for (const Aircraft& a : aircraftFleet) sink += a.getState().position.x;
+    double aircraftSteps = (double)fleet * fleetSteps;
+    
+    std::printf("%-34s %10s %8s\n", "fleet RK4 step", "ns/step", "speedup");
+    std::printf("%-34s %10.1f %8s\n", "generic c172 (incl. air data)", 1e6 * genericFleetMs / aircraftSteps, "1.00");
+    size_t typeCount;
+    const AircraftType* types = getAircraftTypes(typeCount);
+    for (size_t t = 0; t < typeCount; t++) {
+        std::vector<AircraftState> states(fleet, Aircraft().getState());
+        for (size_t n = 0; n < fleet; n++) scriptedControls(states[n], 0.0, (double)n / fleet);
+        start = Clock::now();
+        for (int i = 0; i < fleetSteps; i++) types[t].step(states.data(), fleet, atmosphere, dt);
+        double fleetMs = elapsedMs(start);
+        for (const AircraftState& state : states) sink += state.position.x;
+        char label[64];
+        std::snprintf(label, sizeof(label), "typed %s", types[t].name);
+        std::printf("%-34s %10.1f %8.2f\n", label, 1e6 * fleetMs / aircraftSteps, genericFleetMs / fleetMs);
+    }
+    std::printf("(checksum %.6g)\n", sink);
+    return identical == steps ? 0 : 1;
+}
+
+// Fixed policy for the environment benchmark: proportional hold on the
+// observed errors plus a per-instance wobble, so episodes diverge; every
+// eighth instance dives instead
+void benchPolicy(const float* observation, float* action, size_t index, int step) {
+    float wobble = 0.3f * (float)std::sin(0.05 * step + 0.7 * (double)index);
+    action[FlightEnvBatch::ACTION_ELEVATOR] = index % 8 == 7 ? 0.5f :
+                                              0.5f * observation[FlightEnvBatch::OBS_ALTITUDE_ERROR] +
+                                              2.0f * observation[FlightEnvBatch::OBS_PITCH] + 0.2f * wobble;
+    action[FlightEnvBatch::ACTION_AILERON] = -1.5f * observation[FlightEnvBatch::OBS_ROLL] + wobble;
+    action[FlightEnvBatch::ACTION_RUDDER] = 0.0f;
+    action[FlightEnvBatch::ACTION_THROTTLE] = 0.5f - 0.2f * observation[FlightEnvBatch::OBS_AIRSPEED_ERROR];
+}
+
+// Batched environment throughput over batch sizes, on one thread and on
+// every hardware thread, plus a check that both give identical episodes
+int benchFlightEnv() {
+    const size_t batches[] = {1, 16, 256, 4096};
+    const double stepsPerRun = 40000.0;
+    unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> threadCounts = {1};
+    if (hardwareThreads > 1) threadCounts.push_back(hardwareThreads);
+    
+    std::printf("%-8s %-8s %14s %12s\n", "batch", "threads", "env-steps/s", "vs 1 thread");
+    for (size_t batch : batches) {
+        double serialRate = 0.0;
+        for (unsigned int threads : threadCounts) {
+            FlightEnvConfig config;
+            config.threads = threads;
+            FlightEnvBatch env(batch, config);
+            std::vector<float> observations(batch * FlightEnvBatch::OBSERVATION_SIZE);
+            std::vector<float> actions(batch * FlightEnvBatch::ACTION_SIZE);
+            std::vector<float> rewards(batch);
+            std::vector<uint8_t> dones(batch);
+            env.reset(observations.data());
+            
+            int steps = std::max(1, (int)(stepsPerRun / batch));
+            auto start = Clock::now();
+            for (int step = 0; step < steps; step++) {
+                for (size_t i = 0; i < batch; i++) {
+                    benchPolicy(&observations[i * FlightEnvBatch::OBSERVATION_SIZE],
+                                &actions[i * FlightEnvBatch::ACTION_SIZE], i, step);
+                }
+                env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+            }
+            double rate = (double)steps * batch / (elapsedMs(start) * 1e-3);
+            if (threads == 1) serialRate = rate;
+            std::printf("%-8zu %-8u %14.0f %12.2f\n", batch, env.getThreadCount(), rate, rate / serialRate);
+        }
+    }
+    
+    // Low and short episodes so crash and time-limit resets both happen
+    const size_t checkBatch = 64;
+    const int checkSteps = 800;
+    std::vector<float> trace[2];
+    uint64_t episodes = 0, crashes = 0;
+    for (int run = 0; run < 2; run++) {
+        FlightEnvConfig config;
+        config.threads = run == 0 ? 1 : 0;
+        config.maxEpisodeSeconds = 10.0;
+        config.targetAltitude = 300.0;
+        FlightEnvBatch env(checkBatch, config);
+        std::vector<float> observations(checkBatch * FlightEnvBatch::OBSERVATION_SIZE);
+        std::vector<float> actions(checkBatch * FlightEnvBatch::ACTION_SIZE);
+        std::vector<float> rewards(checkBatch);
+        std::vector<uint8_t> dones(checkBatch);
+        env.reset(observations.data());
+        for (int step = 0; step < checkSteps; step++) {
+            for (size_t i = 0; i < checkBatch; i++) {
+                benchPolicy(&observations[i * FlightEnvBatch::OBSERVATION_SIZE],
+                            &actions[i * FlightEnvBatch::ACTION_SIZE], i, step);
+            }
+            env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+            trace[run].insert(trace[run].end(), observations.begin(), observations.end());
+            trace[run].insert(trace[run].end(), rewards.begin(), rewards.end());
+            for (uint8_t done : dones) trace[run].push_back((float)done);
+        }
+        episodes = env.getEpisodeCount();
+        crashes = env.getCrashCount();
+    }
+    bool identical = trace[0].size() == trace[1].size() &&
+                     std::memcmp(trace[0].data(), trace[1].data(), trace[0].size() * sizeof(float)) == 0;
+    std::printf("%zu envs x %d steps: %llu episodes (%llu crashes), %u threads vs 1 thread: %s\n", checkBatch,
+                checkSteps, (unsigned long long)episodes, (unsigned long long)crashes, hardwareThreads,
+                identical ? "identical" : "DIFFERENT");
+    return identical ? 0 : 1;
+}
+
+// Navigation EKF against the true state over a scripted flight (starting
+// misaligned), then the cost of its predict and update steps
+int benchNavEkf() {
+    const double dt = 0.001;
+    const int steps = 120000;
+    const int settleSteps = 20000;
+    
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    SensorSuite sensors(1);
+    NavEkf ekf;
+    
+    // Records for the timing runs below
+    std::vector<SensorReadings> readings;
+    readings.reserve(steps);
+    
+    const AircraftState& state = aircraft.getState();
+    SensorReadings first = sensors.sample(0, state, dynamics.getAirData());
+    ekf.initialize(first.gps.position + Vector3(5.0, -5.0, 2.0), first.gps.velocity, state.roll + 0.01,
+                   state.pitch - 0.01, state.yaw + 0.03);
+    
+    double positionSq = 0.0, velocitySq = 0.0, attitudeSq = 0.0, gpsSq = 0.0;
+    double maxAttitude = 0.0;
+    int samples = 0, within3Sigma = 0;
+    for (int i = 1; i <= steps; i++) {
+        scriptedControls(aircraft.getState(), i * dt, 0.0);
+        dynamics.update(dt);
+        readings.push_back(sensors.sample((uint64_t)i, state, dynamics.getAirData()));
+        ekf.process(readings.back(), (uint64_t)i, dt);
+        if (i < settleSteps) continue;
+        
+        NavEstimate estimate = ekf.getEstimate();
+        double cr = std::cos(state.roll), sr = std::sin(state.roll);
+        double cp = std::cos(state.pitch), sp = std::sin(state.pitch);
+        double cy = std::cos(state.yaw), sy = std::sin(state.yaw);
+        const Vector3& v = state.velocity;
+        Vector3 velocityNed(cy * cp * v.x + (cy * sp * sr - sy * cr) * v.y + (cy * sp * cr + sy * sr) * v.z,
+                            sy * cp * v.x + (sy * sp * sr + cy * cr) * v.y + (sy * sp * cr - cy * sr) * v.z,
+                            -sp * v.x + cp * sr * v.y + cp * cr * v.z);
+        Vector3 positionError = estimate.position - state.position;
+        double attitudeError[3] = {std::remainder(estimate.roll - state.roll, 2.0 * M_PI),
+                                   std::remainder(estimate.pitch - state.pitch, 2.0 * M_PI),
+                                   std::remainder(estimate.yaw - state.yaw, 2.0 * M_PI)};
+        positionSq += positionError.dot(positionError);
+        velocitySq += (estimate.velocity - velocityNed).dot(estimate.velocity - velocityNed);
+        gpsSq += (readings.back().gps.position - state.position).dot(readings.back().gps.position - state.position);
+        for (double e : attitudeError) {
+            attitudeSq += e * e;
+            maxAttitude = std::max(maxAttitude, std::fabs(e));
+        }
+        within3Sigma += std::fabs(positionError.x) < 3.0 * estimate.positionSigma.x &&
+                        std::fabs(positionError.y) < 3.0 * estimate.positionSigma.y &&
+                        std::fabs(positionError.z) < 3.0 * estimate.positionSigma.z;
+        samples++;
+    }
+    
+    double positionRms = std::sqrt(positionSq / samples);
+    double velocityRms = std::sqrt(velocitySq / samples);
+    double attitudeRmsDeg = std::sqrt(attitudeSq / (3.0 * samples)) * 180.0 / M_PI;
+    double consistency = (double)within3Sigma / samples;
+    bool pass = positionRms < 2.0 && velocityRms < 0.3 && attitudeRmsDeg < 1.0 && consistency > 0.95;
+    std::printf("%.0f s flight at 1 kHz, errors after %.0f s:\n", steps * dt, settleSteps * dt);
+    std::printf("  position RMS %.2f m (raw GPS %.2f m), within 3 sigma %.1f%%\n", positionRms,
+                std::sqrt(gpsSq / samples), 100.0 * consistency);
+    std::printf("  velocity RMS %.3f m/s\n", velocityRms);
+    std::printf("  attitude RMS %.3f deg, max %.3f deg\n", attitudeRmsDeg, maxAttitude * 180.0 / M_PI);
+    std::printf("  %llu updates, %llu rejected: %s\n", (unsigned long long)ekf.getUpdateCount(),
+                (unsigned long long)ekf.getRejectedCount(), pass ? "ok" : "FAIL");
+    
+    // Cost per call on the recorded sensor data
+    const int timedSteps = 20000;
+    auto start = Clock::now();
+    for (int i = 0; i < timedSteps; i++) {
+        ekf.predict(readings[i].imu, dt);
+    }
+    double predictMs = elapsedMs(start);
+    
+    start = Clock::now();
+    for (int i = 0; i < timedSteps; i++) {
+        ekf.updateGps(readings[i].gps);
+        ekf.predict(readings[i].imu, dt);
+    }
+    double gpsMs = elapsedMs(start) - predictMs;
+    
+    start = Clock::now();
+    for (int i = 0; i < timedSteps; i++) {
+        ekf.process(readings[i], (uint64_t)i, dt);
+    }
+    double processMs = elapsedMs(start);
+    
+    // A fleet of filters, one per aircraft, each stepped at 1 kHz
+    const size_t fleet = 256;
+    const int fleetSteps = 1000;
+    std::vector<NavEkf> filters(fleet);
+    for (size_t f = 0; f < fleet; f++) {
+        filters[f].initialize(readings[f].gps.position, readings[f].gps.velocity, 0.0, 0.0, 0.0);
+    }
+    start = Clock::now();
+    for (int i = 0; i < fleetSteps; i++) {
+        for (size_t f = 0; f < fleet; f++) {
+            filters[f].process(readings[(i + f * 37) % readings.size()], (uint64_t)i, dt);
+        }
+    }
+    double fleetMs = elapsedMs(start);
+    
+    std::printf("%-30s %10s %12s\n", "operation", "us/call", "calls/s");
+    auto row = [](const char* name, double ms, double calls) {
+        std::printf("%-30s %10.2f %12.0f\n", name, 1e3 * ms / calls, calls / (ms * 1e-3));
+    };
+    row("predict (15 states)", predictMs, timedSteps);
+    row("GPS update (6 measurements)", gpsMs, timedSteps);
+    row("process (1 kHz step, aided)", processMs, timedSteps);
+    row("fleet process, 256 filters", fleetMs, (double)fleet * fleetSteps);
+    std::printf("%zu bytes per filter, %.1f real-time 1 kHz filters per core\n", sizeof(NavEkf),
+                timedSteps / (processMs * 1e-3) / 1000.0);
+    return pass ? 0 : 1;
+}
+
+// Identification flight as the interactive loop records it: 1 kHz physics,
+// controls held and the state logged at 100 Hz. Multi-sine inputs on every
+// axis around a gently stabilized cruise, so each regressor is excited
+// independently. `holdElevator` keeps the elevator at a constant trim
+// offset instead, which leaves the elevator terms unidentifiable.
+void recordExcitationFlight(FlightLog& log, double seconds, bool holdElevator = false) {
+    const double dt = 0.001;
+    const int stepsPerRecord = 10;
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    dynamics.reset();
+    
+    AircraftState& state = aircraft.getState();
+    int records = (int)(seconds * 100.0);
+    log.clear();
+    log.reserve(records + 1);
+    for (int i = 0; i <= records; i++) {
+        double t = i * stepsPerRecord * dt;
+        double altitudeError = -state.position.z - 1000.0;
+        state.elevator = -0.02 + 0.5 * state.pitch + 0.0005 * altitudeError +
+                         0.04 * std::sin(1.3 * t) + 0.03 * std::sin(3.7 * t + 1.0) + 0.02 * std::sin(8.1 * t + 2.0);
+        if (holdElevator) state.elevator = -0.02;
+        state.aileron = -0.4 * state.roll + 0.05 * std::sin(1.1 * t + 0.5) + 0.04 * std::sin(4.3 * t + 2.5) +
+                        0.03 * std::sin(9.7 * t);
+        state.rudder = 0.06 * std::sin(0.9 * t + 1.5) + 0.05 * std::sin(3.1 * t + 0.2) + 0.04 * std::sin(7.3 * t + 3.0);
+        state.throttle = 0.6 + 0.2 * std::sin(0.23 * t) + 0.1 * std::sin(1.9 * t + 0.7);
+        log.record(t, state);
+        for (int k = 0; k < stepsPerRecord; k++) dynamics.update(dt);
+    }
+}
+
+// Aerodynamic coefficients identified from a recorded excitation flight
+// against the values it was flown with, then blocked least-squares
+// throughput on a million-interval log, one thread vs all threads
+int benchAeroIdentification() {
+    FlightLog log;
+    auto start = Clock::now();
+    recordExcitationFlight(log, 600.0);
+    double flyMs = elapsedMs(start);
+    
+    Aircraft aircraft;
+    AeroIdentification identification;
+    if (!identification.identify(log, aircraft)) return 1;
+    std::printf("%zu intervals (%.0f s at 100 Hz, flown in %.0f ms), %zu skipped\n", identification.getUsedCount(),
+                log.getDuration(), flyMs, identification.getSkippedCount());
+    std::printf("%-4s %-15s %10s %12s %10s %9s\n", "eq", "coefficient", "prior", "identified", "std err", "error");
+    bool pass = true;
+    for (int e = 0; e < AeroIdentification::EQUATION_COUNT; e++) {
+        const CoefficientFit& fit = identification.getFit((AeroIdentification::Equation)e);
+        for (int j = 0; j < fit.termCount; j++) {
+            const IdentifiedCoefficient& term = fit.terms[j];
+            double error = std::fabs(term.value - term.prior) / std::max(std::fabs(term.prior), 1e-3);
+            pass = pass && fit.solved && term.excited && error < 0.02;
+            std::printf("%-4s %-15s %10.4f %12.4f %10.2g %8.2f%%\n", j == 0 ? fit.name : "", term.name, term.prior,
+                        term.value, term.standardError, 100.0 * error);
+        }
+        std::printf("     residual RMS %.2g, R^2 %.6f\n", fit.residualRms, fit.rSquared);
+    }
+    std::printf("all coefficients within 2%% of the flown values: %s\n", pass ? "ok" : "FAIL");
+    
+    // Elevator held at a constant offset: it is collinear with the
+    // intercepts, so its terms must be reported as not excited (priors
+    // kept) and the rest still identified
+    FlightLog held;
+    recordExcitationFlight(held, 120.0, true);
+    AeroIdentification heldIdentification;
+    bool heldOk = heldIdentification.identify(held, aircraft);
+    for (int e = 0; heldOk && e < AeroIdentification::EQUATION_COUNT; e++) {
+        const CoefficientFit& fit = heldIdentification.getFit((AeroIdentification::Equation)e);
+        for (int j = 0; j < fit.termCount; j++) {
+            const IdentifiedCoefficient& term = fit.terms[j];
+            bool elevatorTerm = std::strstr(term.name, "ELEVATOR") != nullptr;
+            heldOk = heldOk && (elevatorTerm ? !term.excited && term.value == term.prior : fit.solved && term.excited);
+        }
+    }
+    std::printf("elevator held at -0.02: elevator terms held at priors, others identified: %s\n",
+                heldOk ? "ok" : "FAIL");
+    pass = pass && heldOk;
+    
+    // Million-interval log: the flight repeated; the time reversal at each
+    // seam is skipped like any other discontinuity
+    FlightLog large;
+    size_t copies = (1000000 + log.size() - 1) / log.size();
+    large.reserve(copies * log.size());
+    for (size_t c = 0; c < copies; c++) {
+        for (const FlightLogSample& sample : log.getSamples()) large.record(sample.time, sample.state);
+    }
+    unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> threadCounts = {1};
+    if (hardware > 1) threadCounts.push_back(hardware);
+    
+    double serialSeconds = 0.0;
+    bool identical = true;
+    AeroIdentification reference;
+    std::printf("%8s %10s %14s %9s\n", "threads", "ms", "intervals/s", "speedup");
+    for (unsigned int threads : threadCounts) {
+        AeroIdentification timed;
+        timed.identify(large, aircraft, threads);
+        if (threads == 1) {
+            serialSeconds = timed.getSolveSeconds();
+            reference = timed;
+        }
+        for (int e = 0; e < AeroIdentification::EQUATION_COUNT; e++) {
+            const CoefficientFit& a = timed.getFit((AeroIdentification::Equation)e);
+            const CoefficientFit& b = reference.getFit((AeroIdentification::Equation)e);
+            for (int j = 0; j < a.termCount; j++) {
+                identical = identical && a.terms[j].value == b.terms[j].value;
+            }
+        }
+        std::printf("%8u %10.1f %14.0f %8.2fx\n", timed.getThreadCount(), timed.getSolveSeconds() * 1e3,
+                    (timed.getUsedCount() + timed.getSkippedCount()) / timed.getSolveSeconds(),
+                    serialSeconds / timed.getSolveSeconds());
+    }
+    std::printf("%zu samples, results identical across thread counts: %s\n", large.size(), identical ? "yes" : "NO");
+    return pass && identical ? 0 : 1;
+}
+
+// Flight-path predictor: predicted time and point of ground contact against
+// the 1 kHz simulation flown on from the same state, the worker's cost per
+// prediction and CPU share at its rate, and the main-thread handoff cost
+int benchFlightPath() {
+    struct Scenario {
+        const char* name;
+        double altitude;      // m
+        double pitch;         // rad
+        double elevator;
+        double throttle;
+    };
+    static const Scenario scenarios[] = {
+        {"descent", 400.0, -0.05, 0.05, 0.3},
+        {"idle descent", 700.0, -0.08, 0.06, 0.0},
+        {"steep dive", 1200.0, -0.35, 0.08, 0.8},
+        {"pushover", 800.0, -0.1, 0.1, 0.6},
+    };
+    
+    PredictorConfig config;
+    config.horizon = 60.0;
+    config.rate = 1000.0;   // Answer each request without waiting out a period
+    FlightPathPredictor predictor;
+    if (!predictor.start(config)) return 1;
+    
+    bool pass = true;
+    std::printf("%-16s %10s %10s %9s %10s\n", "scenario", "truth s", "predicted", "error s", "miss m");
+    for (const Scenario& scenario : scenarios) {
+        Aircraft aircraft;
+        Atmosphere atmosphere;
+        FlightDynamics dynamics(&aircraft, &atmosphere);
+        dynamics.reset();
+        AircraftState& state = aircraft.getState();
+        state.position.z = -scenario.altitude;
+        state.pitch = scenario.pitch;
+        state.elevator = scenario.elevator;
+        state.throttle = scenario.throttle;
+        
+        predictor.markDiscontinuity();
+        predictor.submit(state, 0.0);
+        const PredictedPath* path = nullptr;
+        auto wait = Clock::now();
+        while (!(path = predictor.getLatest()) && elapsedMs(wait) < 5000.0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!path) {
+            std::printf("%-16s no prediction\n", scenario.name);
+            pass = false;
+            continue;
+        }
+        
+        // Truth: the simulation itself, interpolated to ground contact
+        const double dt = 0.001;
+        double impactTime = INFINITY;
+        Vector3 impactPoint;
+        for (int i = 1; i <= (int)(config.horizon / dt); i++) {
+            Vector3 previous = state.position;
+            dynamics.update(dt);
+            if (state.position.z >= 0.0) {
+                double fraction = previous.z < 0.0 ? -previous.z / (state.position.z - previous.z) : 0.0;
+                impactTime = (i - 1 + fraction) * dt;
+                impactPoint = previous + (state.position - previous) * fraction;
+                break;
+            }
+        }
+        double timeError = path->timeToImpact - impactTime;
+        double miss = (path->impactPoint - impactPoint).magnitude();
+        bool ok = std::isfinite(impactTime) && std::isfinite(path->timeToImpact) && std::fabs(timeError) < 0.1 &&
+                  miss < 10.0;
+        pass = pass && ok;
+        std::printf("%-16s %10.2f %10.2f %9.3f %10.2f %s\n", scenario.name, impactTime, path->timeToImpact,
+                    timeError, miss, ok ? "" : "FAIL");
+    }
+    
+    // Main thread: one submit and one pickup per frame while the worker runs
+    Aircraft aircraft;
+    AircraftState state = aircraft.getState();
+    state.position.z = -1000.0;
+    const int frames = 200000;
+    auto start = Clock::now();
+    for (int i = 0; i < frames; i++) {
+        predictor.submit(state, i * 0.001);
+        predictor.getLatest();
+    }
+    double handoffMs = elapsedMs(start);
+    
+    FlightPathPredictor::Stats stats = predictor.getStats();
+    predictor.stop();
+    int steps = (int)std::ceil(config.horizon / config.step);
+    PredictorConfig defaults;
+    std::printf("%llu predictions of %.0f s at %.0f ms steps (%d derivatives): mean %.0f us, max %.0f us\n",
+                (unsigned long long)stats.predictions, config.horizon, config.step * 1e3, 2 * steps,
+                stats.meanMicroseconds, stats.maxMicroseconds);
+    std::printf("CPU share at the default %.0f s horizon and %.0f Hz: %.2f%% of one core\n", defaults.horizon,
+                defaults.rate,
+                100.0 * stats.meanMicroseconds * (defaults.horizon / config.horizon) * defaults.rate * 1e-6);
+    std::printf("main thread submit + getLatest: %.0f ns per frame\n", 1e6 * handoffMs / frames);
+    std::printf("impact predictions within 0.1 s and 10 m: %s\n", pass ? "ok" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+// State hash after the 60 s scripted flight of benchDeterminism, from
+// deterministic builds at -O0, -O2 and -O3 -march=native (GCC 12, glibc,
+// x86-64). A build that contracts to FMA, also through vectorized code,
+// or reassociates lands elsewhere. So may a different libm, except with
+// FastMath, which does not call it.
+#ifdef FLIGHT_FAST_MATH
+const uint64_t GOLDEN_FLIGHT_HASH = 0x8b5197403b39e618ull;
+#else
+const uint64_t GOLDEN_FLIGHT_HASH = 0x59fdef0f5c2fc2b4ull;
+#endif
+
+// Deterministic mode: the flight reproduces the pinned hash, repeated runs
+// and thread counts give identical state hash streams, a one-ulp input
+// change is located to its step, and the cost of hashing per dynamics step
+int benchDeterminism() {
+    const double dt = 0.001;
+    const int steps = 60000;
+    auto fly = [&](StateHashStream& stream, double variation, int nudgeStep) {
+        Aircraft aircraft;
+        Atmosphere atmosphere;
+        FlightDynamics dynamics(&aircraft, &atmosphere);
+        dynamics.setStateHashing(true);
+        dynamics.reset();
+        AircraftState& state = aircraft.getState();
+        stream.clear();
+        stream.reserve(steps);
+        for (int i = 0; i < steps; i++) {
+            scriptedControls(state, i * dt, variation);
+            if (i == nudgeStep) state.throttle = std::nextafter(state.throttle, 2.0);
+            dynamics.update(dt);
+            stream.record(dynamics.getStateHash());
+        }
+    };
+    
+    StateHashStream first, second, nudged;
+    fly(first, 0.0, -1);
+    fly(second, 0.0, -1);
+    
+    // The pinned hash catches what no source-level probe can: fused or
+    // reordered operations the vectorizer generated in the dynamics
+    bool golden = first[steps - 1] == GOLDEN_FLIGHT_HASH;
+#ifdef FLIGHT_DETERMINISTIC
+    std::printf("deterministic build, final hash %s the pinned %016llx%s\n", golden ? "matches" : "DIFFERS from",
+                (unsigned long long)GOLDEN_FLIGHT_HASH, golden ? "" : " (FAIL)");
+#else
+    std::printf("default build (FLIGHT_DETERMINISTIC=1 ./compile.sh for cross-build hashes), final hash %s "
+                "the pinned %016llx\n", golden ? "matches" : "differs from", (unsigned long long)GOLDEN_FLIGHT_HASH);
+#endif
+    bool repeatable = StateHashStream::firstDivergence(first, second) == StateHashStream::NO_DIVERGENCE;
+    std::printf("two %.0f s runs: final hash %016llx / %016llx, identical: %s\n", steps * dt,
+                (unsigned long long)first[steps - 1], (unsigned long long)second[steps - 1],
+                repeatable ? "yes" : "NO");
+    
+    const int nudgeStep = steps / 2;
+    fly(nudged, 0.0, nudgeStep);
+    auto start = Clock::now();
+    size_t divergence = StateHashStream::firstDivergence(first, nudged);
+    double searchUs = elapsedMs(start) * 1e3;
+    bool located = divergence == (size_t)nudgeStep;
+    std::printf("one-ulp throttle change before step %d: first divergent step %zu (%.1f us to find): %s\n",
+                nudgeStep, divergence, searchUs, located ? "ok" : "FAIL");
+    
+    // A fleet, one aircraft per index, on one thread and on several
+    const size_t fleet = 64;
+    const int fleetSteps = 10000;
+    auto flyFleet = [&](unsigned int threads, std::vector<uint64_t>& hashes) {
+        ThreadPool pool(threads);
+        hashes.assign(fleet, 0);
+        pool.parallelFor(fleet, [&](size_t index) {
+            Aircraft aircraft;
+            Atmosphere atmosphere;
+            FlightDynamics dynamics(&aircraft, &atmosphere);
+            dynamics.setStateHashing(true);
+            dynamics.reset();
+            for (int i = 0; i < fleetSteps; i++) {
+                scriptedControls(aircraft.getState(), i * dt, (double)index / fleet);
+                dynamics.update(dt);
+            }
+            hashes[index] = dynamics.getStateHash();
+        });
+        return pool.getThreadCount();
+    };
+    std::vector<uint64_t> serialHashes, parallelHashes;
+    flyFleet(1, serialHashes);
+    unsigned int threads = flyFleet(std::max(4u, std::thread::hardware_concurrency()), parallelHashes);
+    bool threadIndependent = serialHashes == parallelHashes;
+    std::printf("%zu aircraft x %d steps on 1 and %u threads, identical: %s\n", fleet, fleetSteps, threads,
+                threadIndependent ? "yes" : "NO");
+    
+    // Cost of hashing
+    const int timedSteps = 200000;
+    double stepNs[2];
+    for (int hashing = 0; hashing < 2; hashing++) {
+        Aircraft aircraft;
+        Atmosphere atmosphere;
+        FlightDynamics dynamics(&aircraft, &atmosphere);
+        dynamics.setStateHashing(hashing != 0);
+        dynamics.reset();
+        start = Clock::now();
+        for (int i = 0; i < timedSteps; i++) {
+            scriptedControls(aircraft.getState(), (i % steps) * dt, 0.0);
+            dynamics.update(dt);
+        }
+        stepNs[hashing] = elapsedMs(start) * 1e6 / timedSteps;
+    }
+    AircraftState probe = Aircraft().getState();
+    uint64_t hash = StateHash::SEED;
+    start = Clock::now();
+    for (int i = 0; i < timedSteps; i++) {
+        probe.throttle = i;
+        hash = StateHash::combine(hash, probe);
+    }
+    double combineNs = elapsedMs(start) * 1e6 / timedSteps;
+    std::printf("dynamics step %.0f ns unhashed, %.0f ns hashed; combine %.1f ns, %.1f%% of a step (checksum %016llx)\n",
+                stepNs[0], stepNs[1], combineNs, 100.0 * combineNs / stepNs[0], (unsigned long long)hash);
+    
+    bool pass = repeatable && located && threadIndependent;
+#ifdef FLIGHT_DETERMINISTIC
+    pass = pass && golden;
+#endif
+    return pass ? 0 : 1;
+}
+
+// ECEF to geodetic by fixed-point iteration in long double, for checking
+// the closed form
+Geodetic referenceGeodetic(const Vector3& ecef) {
+    const long double a = wgs84::SEMI_MAJOR_AXIS, e2 = wgs84::ECCENTRICITY_SQ;
+    long double p = std::sqrt((long double)ecef.x * ecef.x + (long double)ecef.y * ecef.y);
+    long double latitude = std::atan2((long double)ecef.z, p * (1.0L - e2));
+    for (int i = 0; i < 30; i++) {
+        long double s = std::sin(latitude);
+        long double n = a / std::sqrt(1.0L - e2 * s * s);
+        long double height = p * std::cos(latitude) + ecef.z * s - a * a / n;
+        latitude = std::atan2((long double)ecef.z, p * (1.0L - e2 * n / (n + height)));
+    }
+    long double s = std::sin(latitude);
+    long double n = a / std::sqrt(1.0L - e2 * s * s);
+    return Geodetic{(double)latitude, std::atan2(ecef.y, ecef.x),
+                    (double)(p * std::cos(latitude) + ecef.z * s - a * a / n)};
+}
+
+// WGS-84 conversions: scalar accuracy against an iterative reference,
+// batched against scalar, throughput for a fleet-sized batch, normal
+// gravity against the published values, and a long leg flown over the flat
+// and the round earth
+int benchGeodesy() {
+    const double metresPerRadian = wgs84::SEMI_MAJOR_AXIS;
+    const size_t count = 4096;
+    const int repeats = 200;
+    std::mt19937_64 rng(49);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    
+    // From 1000 km below to 1000 km above the ellipsoid, poles included
+    std::vector<Geodetic> positions(count);
+    std::vector<double> latitude(count), longitude(count), altitude(count), x(count), y(count), z(count);
+    for (size_t i = 0; i < count; i++) {
+        positions[i] = Geodetic{uniform(rng) * 0.5 * M_PI, uniform(rng) * M_PI, uniform(rng) * 1e6};
+        if (i < 4) positions[i].latitude = (i % 2 ? 0.5 : -0.5) * M_PI;
+        latitude[i] = positions[i].latitude;
+        longitude[i] = positions[i].longitude;
+        altitude[i] = positions[i].altitude;
+        Vector3 ecef = geodesy::geodeticToEcef(positions[i]);
+        x[i] = ecef.x;
+        y[i] = ecef.y;
+        z[i] = ecef.z;
+    }
+    
+    double scalarError = 0.0, roundTripError = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        Vector3 ecef(x[i], y[i], z[i]);
+        Geodetic exact = referenceGeodetic(ecef);
+        Geodetic closed = geodesy::ecefToGeodetic(ecef);
+        scalarError = std::max({scalarError, std::fabs(closed.latitude - exact.latitude) * metresPerRadian,
+                                std::fabs(closed.altitude - exact.altitude)});
+        roundTripError = std::max(roundTripError, (geodesy::geodeticToEcef(closed) - ecef).magnitude());
+    }
+    
+    std::vector<double> latitude2(count), longitude2(count), altitude2(count), x2(count), y2(count), z2(count);
+    geodesy::ecefToGeodetic(x.data(), y.data(), z.data(), latitude2.data(), longitude2.data(), altitude2.data(),
+                            count);
+    geodesy::geodeticToEcef(latitude.data(), longitude.data(), altitude.data(), x2.data(), y2.data(), z2.data(),
+                            count);
+    double batchAngleError = 0.0, batchPositionError = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        Geodetic scalar = geodesy::ecefToGeodetic(Vector3(x[i], y[i], z[i]));
+        batchAngleError = std::max({batchAngleError, std::fabs(latitude2[i] - scalar.latitude),
+                                    angleDifference(longitude2[i], scalar.longitude)});
+        batchPositionError = std::max({batchPositionError, std::fabs(altitude2[i] - scalar.altitude),
+                                       (Vector3(x2[i], y2[i], z2[i]) - Vector3(x[i], y[i], z[i])).magnitude()});
+    }
+    bool accurate = scalarError <= 1e-8 && roundTripError <= 1e-8 && batchAngleError <= 1e-15 &&
+                    batchPositionError <= 3e-7;
+    std::printf("ECEF to geodetic vs iterative reference: %.2e m (bound 1e-8), round trip %.2e m\n", scalarError,
+                roundTripError);
+    std::printf("batched vs scalar: %.2e rad (bound 1e-15), %.2e m (bound 3e-7)\n\n", batchAngleError,
+                batchPositionError);
+    
+    // Throughput, best of a few passes over the batch
+    auto time = [&](auto&& convert) {
+        double best = 1e30;
+        for (int run = 0; run < 3; run++) {
+            auto start = Clock::now();
+            for (int r = 0; r < repeats; r++) convert();
+            best = std::min(best, elapsedMs(start));
+        }
+        return best * 1e6 / ((double)repeats * count);
+    };
+    double sink = 0.0;
+    double toGeodeticScalar = time([&] {
+        for (size_t i = 0; i < count; i++) sink += geodesy::ecefToGeodetic(Vector3(x[i], y[i], z[i])).altitude;
+    });
+    double toGeodeticBatch = time([&] {
+        geodesy::ecefToGeodetic(x.data(), y.data(), z.data(), latitude2.data(), longitude2.data(),
+                                altitude2.data(), count);
+    });
+    double toEcefScalar = time([&] {
+        for (size_t i = 0; i < count; i++) sink += geodesy::geodeticToEcef(positions[i]).z;
+    });
+    double toEcefBatch = time([&] {
+        geodesy::geodeticToEcef(latitude.data(), longitude.data(), altitude.data(), x2.data(), y2.data(),
+                                z2.data(), count);
+    });
+    NedFrame frame(Geodetic{47.0 * M_PI / 180.0, 8.0 * M_PI / 180.0, 400.0});
+    std::vector<Vector3> ned(count);
+    std::vector<Geodetic> positions2(count);
+    double toNedBatch = time([&] { frame.geodeticToNed(positions.data(), ned.data(), count); });
+    double fromNedBatch = time([&] { frame.nedToGeodetic(ned.data(), positions2.data(), count); });
+    std::printf("%-22s %10s %10s %8s\n", "ns per point", "scalar", "batched", "speedup");
+    std::printf("%-22s %10.1f %10.1f %8.2f\n", "ECEF to geodetic", toGeodeticScalar, toGeodeticBatch,
+                toGeodeticScalar / toGeodeticBatch);
+    std::printf("%-22s %10.1f %10.1f %8.2f\n", "geodetic to ECEF", toEcefScalar, toEcefBatch,
+                toEcefScalar / toEcefBatch);
+    std::printf("%-22s %10s %10.1f\n", "geodetic to NED", "", toNedBatch);
+    std::printf("%-22s %10s %10.1f\n", "NED to geodetic", "", fromNedBatch);
+    std::printf("%zu positions NED to geodetic: %.1f us (checksum %.3g)\n\n", count, fromNedBatch * count * 1e-3,
+                sink);
+    
+    // Normal gravity against the WGS-84 values on the ellipsoid
+    double equator = geodesy::normalGravity(0.0, 0.0);
+    double pole = geodesy::normalGravity(0.5 * M_PI, 0.0);
+    bool gravity = std::fabs(equator - wgs84::GRAVITY_EQUATOR) < 1e-10 &&
+                   std::fabs(pole - wgs84::GRAVITY_POLE) < 1e-10;
+    std::printf("normal gravity: equator %.10f, pole %.10f, 45 deg at 10 km %.7f m/s^2\n\n", equator, pole,
+                geodesy::normalGravity(0.25 * M_PI, 10000.0));
+    
+    // An hour's cruise climb flown flat and over the round earth from the frame
+    // origin above
+    const double dt = 0.01;
+    const int steps = 360000;
+    std::printf("%-12s %12s %12s %12s %10s %10s\n", "model", "distance km", "altitude m", "-pos.z m",
+                "pitch deg", "step ns");
+    AircraftState cruiseEnd;
+    for (int round = 0; round < 2; round++) {
+        Aircraft aircraft;
+        Atmosphere atmosphere;
+        FlightDynamics dynamics(&aircraft, &atmosphere);
+        if (round) dynamics.setEarthFrame(&frame);
+        dynamics.reset();
+        AircraftState& state = aircraft.getState();
+        state.throttle = 0.6;
+        state.elevator = -0.03;
+        auto start = Clock::now();
+        for (int i = 0; i < steps; i++) dynamics.update(dt);
+        double stepNs = elapsedMs(start) * 1e6 / steps;
+        std::printf("%-12s %12.1f %12.1f %12.1f %10.3f %10.0f\n", round ? "round earth" : "flat earth",
+                    std::hypot(state.position.x, state.position.y) * 1e-3, dynamics.getAirData().altitude,
+                    -state.position.z, state.pitch * 180.0 / M_PI, stepNs);
+        if (round) cruiseEnd = state;
+    }
+    
+    // Round earth end to end: at the end of the leg, where the ellipsoid is
+    // kilometres below the tangent plane, dive from 300 m. The path
+    // predictor and the dynamics must both find the ellipsoid (the tangent
+    // plane, z = 0, is above the aircraft there), and the training
+    // environment's crash test must use the same ground.
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    dynamics.setEarthFrame(&frame);
+    AircraftState& state = aircraft.getState();
+    state = cruiseEnd;
+    Geodetic low = frame.nedToGeodetic(state.position);
+    low.altitude = 300.0;
+    state.position = frame.geodeticToNed(low);
+    state.pitch -= 0.3;
+    state.elevator = -0.3;
+    state.throttle = 0.0;
+    dynamics.updateAirData();
+    bool consistent = std::fabs(dynamics.altitudeOf(state) - dynamics.getAirData().altitude) < 1e-6;
+    
+    PredictorConfig predictorConfig;
+    predictorConfig.horizon = 120.0;
+    predictorConfig.earthFrame = &frame;
+    FlightPathPredictor predictor;
+    double predictedImpact = NAN;
+    if (predictor.start(predictorConfig)) {
+        predictor.submit(state, 0.0);
+        const PredictedPath* path = nullptr;
+        for (int wait = 0; wait < 2000 && !path; wait++) {
+            path = predictor.getLatest();
+            if (!path) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (path) predictedImpact = path->timeToImpact;
+        predictor.stop();
+    }
+    
+    const double diveDt = 0.001;
+    int diveSteps = 0;
+    while (diveSteps < 120000 && !dynamics.isOnGround(state)) {
+        dynamics.update(diveDt);
+        diveSteps++;
+    }
+    double impact = diveSteps * diveDt;
+    double zAtImpact = state.position.z;
+    bool grounded = dynamics.isOnGround(state) && std::fabs(dynamics.altitudeOf(state)) < 1e-6 &&
+                    state.velocity.magnitude() == 0.0;
+    
+    FlightEnvConfig envConfig;
+    envConfig.targetAltitude = 300.0;
+    envConfig.earthFrame = &frame;
+    envConfig.threads = 1;
+    FlightEnvBatch env(1, envConfig);
+    std::vector<float> observation(FlightEnvBatch::OBSERVATION_SIZE);
+    float action[FlightEnvBatch::ACTION_SIZE] = {};
+    float reward;
+    uint8_t done = FlightEnvBatch::DONE_NONE;
+    env.reset(observation.data());
+    // Held 0.3 rad nose down, wings level, idle: the dive ends on the ground
+    int envSteps = 0;
+    while (envSteps < 6000 && done == FlightEnvBatch::DONE_NONE) {
+        action[FlightEnvBatch::ACTION_ELEVATOR] = 2.0f * (observation[FlightEnvBatch::OBS_PITCH] + 0.3f);
+        action[FlightEnvBatch::ACTION_AILERON] = -1.5f * observation[FlightEnvBatch::OBS_ROLL];
+        env.step(action, observation.data(), &reward, &done);
+        envSteps++;
+    }
+    bool envCrash = done == FlightEnvBatch::DONE_CRASHED;
+    
+    bool predicted = std::fabs(predictedImpact - impact) < 0.1;
+    std::printf("\ndive from %.1f km out: ground at %.3f s (z %+.1f m, altitude %.1g m), predicted %.3f s: %s\n",
+                std::hypot(cruiseEnd.position.x, cruiseEnd.position.y) * 1e-3, impact, zAtImpact,
+                dynamics.altitudeOf(state), predictedImpact,
+                consistent && grounded && predicted ? "ok" : "FAIL");
+    std::printf("training environment on the round earth: %s after %d steps: %s\n",
+                envCrash ? "crashed" : "no crash", envSteps, envCrash ? "ok" : "FAIL");
+    
+    bool pass = accurate && gravity && consistent && grounded && predicted && envCrash;
+    std::printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+// Watch expressions of the kinds used when debugging the model; each is
+// instantiated with several thresholds
+const char* const watchTemplates[] = {
+    "alpha > %g deg && airspeed < 45",
+    "abs(roll) > %g deg",
+    "nz > 1 + %g / 10 or nz < 0.5",
+    "vs < -%g fpm and altitude < 1000",
+    "sqrt(p * p + q * q + r * r) > %g / 100",
+    "abs(beta) > %g / 10 deg || abs(turn_rate) > 10 deg",
+    "max(abs(p), abs(r)) > %g / 200 && time > 5",
+    "ias < 40 + %g and throttle > 0.5",
+    "-down > 1000 + %g * 2",
+    "density_altitude > altitude + %g * 100 && pitch > 0",
+};
+
+// 50 watches after every dynamics step: hits and values against per-step
+// scalar evaluation, and the cost per step against the step itself
+int benchWatches() {
+    const double dt = 0.001;
+    const int steps = 60000;
+    const int watchCount = 50;
+    
+    std::vector<std::string> texts;
+    for (int i = 0; texts.size() < (size_t)watchCount; i++) {
+        const size_t templates = sizeof(watchTemplates) / sizeof(watchTemplates[0]);
+        char text[128];
+        std::snprintf(text, sizeof(text), watchTemplates[i % templates], 2.0 + 3.0 * (i / templates));
+        texts.push_back(text);
+    }
+    
+    // The flight, recorded once
+    std::vector<WatchSample> flight(steps);
+    double stepNs;
+    {
+        Aircraft aircraft;
+        Atmosphere atmosphere;
+        FlightDynamics dynamics(&aircraft, &atmosphere);
+        dynamics.reset();
+        auto start = Clock::now();
+        for (int i = 0; i < steps; i++) {
+            scriptedControls(aircraft.getState(), i * dt, 0.7);
+            aircraft.getState().elevator -= 0.05 * std::sin(0.7 * i * dt);
+            dynamics.update(dt);
+            flight[i].time = (i + 1) * dt;
+            flight[i].state = aircraft.getState();
+            flight[i].airData = dynamics.getAirData();
+        }
+        stepNs = elapsedMs(start) * 1e6 / steps;
+    }
+    
+    WatchEngine engine;
+    std::vector<WatchProgram> programs(watchCount);
+    std::string error;
+    for (int i = 0; i < watchCount; i++) {
+        if (engine.add(texts[i], WATCH_SNAPSHOT, error) < 0 || !programs[i].compile(texts[i], error)) {
+            std::printf("'%s': %s\nFAIL\n", texts[i].c_str(), error.c_str());
+            return 1;
+        }
+    }
+    
+    // Reference: every watch evaluated on its own at every step
+    std::vector<uint64_t> hits(watchCount, 0);
+    std::vector<double> lastHit(watchCount, NAN);
+    std::vector<int> firstHitStep(watchCount, -1);
+    std::vector<bool> previous(watchCount, false);
+    for (int i = 0; i < steps; i++) {
+        for (int k = 0; k < watchCount; k++) {
+            bool current = programs[k].evaluate(flight[i]) != 0.0;
+            if (current && !previous[k]) {
+                hits[k]++;
+                lastHit[k] = flight[i].time;
+                if (firstHitStep[k] < 0) firstHitStep[k] = i;
+            }
+            previous[k] = current;
+        }
+    }
+    
+    // Engine as the simulation drives it: all of record() (guards, stores
+    // and the block evaluations), from samples in cache as they are right
+    // after a step; the best of a few passes
+    double totalNs = 1e30;
+    std::vector<WatchSample> hot(WatchEngine::BLOCK);
+    for (int run = 0; run < 5; run++) {
+        engine.clear();
+        for (int k = 0; k < watchCount; k++) engine.add(texts[k], WATCH_SNAPSHOT, error);
+        double ns = 0.0;
+        for (int first = 0; first < steps; first += WatchEngine::BLOCK) {
+            const int count = std::min(WatchEngine::BLOCK, steps - first);
+            std::copy(flight.begin() + first, flight.begin() + first + count, hot.begin());
+            auto start = Clock::now();
+            for (int i = 0; i < count; i++) engine.record(hot[i].time, hot[i].state, hot[i].airData);
+            ns += elapsedMs(start) * 1e6;
+        }
+        engine.flush();
+        totalNs = std::min(totalNs, ns / steps);
+    }
+    
+    int mismatches = 0, firing = 0;
+    for (int k = 0; k < watchCount; k++) {
+        const WatchEngine::Watch& watch = engine[k];
+        bool sameTime = watch.lastHitTime == lastHit[k] || (std::isnan(watch.lastHitTime) && std::isnan(lastHit[k]));
+        // The snapshot holds the state of the hit step
+        int hitStep = watch.hasSnapshot ? (int)std::lround(watch.snapshot.time / dt) - 1 : -1;
+        bool sameSnapshot = !watch.hasSnapshot ||
+                            (watch.snapshot.time == watch.lastHitTime && hitStep >= 0 && hitStep < steps &&
+                             std::memcmp(&watch.snapshot.state, &flight[hitStep].state, sizeof(AircraftState)) == 0);
+        if (watch.hits != hits[k] || !sameTime || !sameSnapshot) {
+            mismatches++;
+            std::printf("mismatch: '%s' %llu hits (expected %llu)\n", watch.text.c_str(),
+                        (unsigned long long)watch.hits, (unsigned long long)hits[k]);
+        }
+        if (watch.hits > 0) firing++;
+    }
+    WatchEngine::Stats stats = engine.getStats();
+    
+    // A watch added mid-block, and one re-enabled mid-block, first hit at
+    // the step after: not over the block's earlier steps
+    {
+        WatchEngine late;
+        late.add("time < 0", 0, error);
+        int toggled = late.add("time > 0", 0, error);
+        late.setEnabled(toggled, false);
+        for (int i = 0; i < 300; i++) {
+            if (i == 100) late.add("time > 0", 0, error);
+            if (i == 200) late.setEnabled(toggled, true);
+            late.record(flight[i].time, flight[i].state, flight[i].airData);
+        }
+        late.flush();
+        if (late[2].lastHitTime != flight[100].time || late[1].lastHitTime != flight[200].time) {
+            mismatches++;
+            std::printf("mismatch: watches added or enabled mid-block hit at %.3f s and %.3f s\n",
+                        late[2].lastHitTime, late[1].lastHitTime);
+        }
+    }
+    
+    // A pause watch breaks right after the step that hit it, before the
+    // next step is taken
+    {
+        int pauseWatch = 0;
+        while (pauseWatch < watchCount && firstHitStep[pauseWatch] < 0) pauseWatch++;
+        WatchEngine pausing;
+        for (int k = 0; k < watchCount; k++) {
+            pausing.add(texts[k], k == pauseWatch ? WATCH_PAUSE : WATCH_SNAPSHOT, error);
+        }
+        int breakStep = -1;
+        for (int i = 0; i < steps && breakStep < 0; i++) {
+            pausing.record(flight[i].time, flight[i].state, flight[i].airData);
+            if (pausing.hasBreak()) breakStep = i;
+        }
+        WatchSample stop;
+        bool taken = pausing.takeBreak(stop);
+        if (pauseWatch == watchCount || breakStep != firstHitStep[pauseWatch] || !taken ||
+            stop.time != flight[breakStep].time) {
+            mismatches++;
+            std::printf("mismatch: pause watch first hit at step %d, break pending after step %d\n",
+                        pauseWatch < watchCount ? firstHitStep[pauseWatch] : -1, breakStep);
+        } else {
+            std::printf("pause watch '%s' hit at %.3f s, break pending after that step: ok\n",
+                        texts[pauseWatch].c_str(), stop.time);
+        }
+    }
+    
+    size_t instructions = 0;
+    for (const WatchProgram& program : programs) instructions += program.getInstructions().size();
+    std::printf("%d watches, %.1f instructions each on average, %d of them hit during the %.0f s flight\n",
+                watchCount, (double)instructions / watchCount, firing, steps * dt);
+    std::printf("hits and hit times vs per-step scalar evaluation: %d watches differ\n", mismatches);
+    std::printf("watch blocks: %.1f%% settled by guards, %.1f%% evaluated step by step, the rest decided by "
+                "variable ranges; %llu guard crossings\n",
+                100.0 * stats.settledFraction, 100.0 * stats.steppedFraction,
+                (unsigned long long)stats.guardCrossings);
+    std::printf("dynamics step %.0f ns; block evaluation %.1f ns per step of that\n", stepNs, stats.meanStepNs);
+    std::printf("watches in all %.1f ns per step, %.2f%% of a step (target < 1%%): %s\n", totalNs,
+                100.0 * totalNs / stepNs, totalNs < 0.01 * stepNs ? "ok" : "over");
+    
+    // The same watches with a scalar interpreter call per watch per step
+    auto start = Clock::now();
+    double sink = 0.0;
+    for (int i = 0; i < steps; i++) {
+        for (int k = 0; k < watchCount; k++) sink += programs[k].evaluate(flight[i]);
+    }
+    double scalarNs = elapsedMs(start) * 1e6 / steps;
+    std::printf("per-step scalar evaluation for comparison: %.1f ns per step, %.2f%% (checksum %g)\n", scalarNs,
+                100.0 * scalarNs / stepNs, sink);
+    
+    bool pass = mismatches == 0 && firing > 0 && totalNs < 0.01 * stepNs;
+    std::printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+struct Benchmark {
+    const char* name;
+    const char* description;
+    int (*run)();
+};
+
+const Benchmark benchmarks[] = {
+    {"instruments", "Instrument panel CPU time and vertices, geometry cache off/on", benchInstruments},
+    {"audio-mixer", "Voice pool mixing cost and voice stealing at 48 kHz stereo", benchAudioMixer},
+    {"engine-synth", "Procedural engine/airflow synthesis cost vs budget at 48 kHz stereo", benchEngineSynth},
+    {"logger", "Asynchronous logger call-site cost (enabled, rate-limited, filtered)", benchLogger},
+    {"alerts", "Callouts on high-sink-rate passes, re-arming, stall hysteresis and cost per tick", benchAlerts},
+    {"rewind", "Rewind buffer memory, restore time and replay exactness over 30 minutes", benchRewind},
+    {"envelope", "Flight-envelope map generation, one thread vs all threads", benchEnvelope},
+    {"rng", "Counter-based RNG throughput vs std::mt19937, thread-count independence", benchRng},
+    {"fast-math", "Fast-math accuracy vs documented bounds, trajectory divergence and speedup", benchFastMath},
+    {"aircraft-types", "Compile-time aircraft type kernels vs the generic Aircraft path", benchAircraftTypes},
+    {"flight-env", "Batched gym-style environment throughput vs batch size and threads", benchFlightEnv},
+    {"nav-ekf", "Navigation EKF accuracy against the true state and updates per second", benchNavEkf},
+    {"aero-id", "Aerodynamic coefficient identification accuracy and least-squares throughput", benchAeroIdentification},
+    {"flight-path", "Flight-path predictor impact accuracy, worker cost and main-thread handoff", benchFlightPath},
+    {"determinism", "State hash repeatability across runs and threads, divergence search, hashing cost", benchDeterminism},
+    {"geodesy", "WGS-84 conversion accuracy and batched throughput, flat vs round-earth cruise", benchGeodesy},
+    {"watches", "Watch expression cost per physics step with 50 watches, hits vs scalar evaluation", benchWatches},
+};
+
+} // namespace
+
+int runBenchmark(const std::string& name) {
+    for (const Benchmark& bench : benchmarks) {
+        if (name == bench.name) {
+            std::printf("=== %s: %s ===\n", bench.name, bench.description);
+            return bench.run();
+        }
+    }
+    
+    if (name != "list") {
+        std::fprintf(stderr, "Unknown benchmark '%s'\n", name.c_str());
+    }
+    std::printf("Available benchmarks:\n");
+    for (const Benchmark& bench : benchmarks) {
+        std::printf("  %-14s %s\n", bench.name, bench.description);
+    }
+    return name == "list" ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include "counter_rng.hpp"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RNG_USE_SSE2 1
+#endif
+
+namespace {
+
+// Philox4x32 multipliers and Weyl key increments
+const uint32_t PHILOX_M0 = 0xD2511F53u;
+const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+const uint32_t PHILOX_W0 = 0x9E3779B9u;
+const uint32_t PHILOX_W1 = 0xBB67AE85u;
+const int PHILOX_ROUNDS = 10;
+
+const float TWO_PI = 6.28318530717958647692f;
+const float UNIFORM_SCALE = 1.0f / 16777216.0f;   // 2^-24
+
+inline void philox(uint32_t c[4], uint32_t k0, uint32_t k1) {
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c[0];
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c[2];
+        uint32_t next0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k0;
+        uint32_t next2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k1;
+        c[1] = (uint32_t)p1;
+        c[3] = (uint32_t)p0;
+        c[0] = next0;
+        c[2] = next2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+// Odd multiples of 2^-24: exactly representable, never 0 or 1
+inline float toUniform(uint32_t word) {
+    return (float)(int32_t)(((word >> 9) << 1) | 1u) * UNIFORM_SCALE;
+}
+
+inline uint32_t stepHighWord(uint64_t step, uint32_t channel) {
+    return (uint32_t)((step >> 32) & 0xFFFFu) | (channel << 16);
+}
+
+#ifdef RNG_USE_SSE2
+// Per-lane 32x32 -> 64 bit products split into high and low words
+inline void mulhilo(__m128i a, __m128i m, __m128i& hi, __m128i& lo) {
+    __m128i even = _mm_mul_epu32(a, m);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+    lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+}
+
+inline __m128 toUniform(__m128i words) {
+    __m128i odd = _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(words, 9), 1), _mm_set1_epi32(1));
+    return _mm_mul_ps(_mm_cvtepi32_ps(odd), _mm_set1_ps(UNIFORM_SCALE));
+}
+#endif
+
+} // namespace
+
+CounterRng::CounterRng(uint64_t seed, uint32_t entity, uint16_t channel)
+    : entity(entity), channel(channel) {
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+}
+
+void CounterRng::block(uint64_t step, uint32_t blockIndex, uint32_t out[4]) const {
+    out[0] = blockIndex;
+    out[1] = (uint32_t)step;
+    out[2] = stepHighWord(step, channel);
+    out[3] = entity;
+    philox(out, key[0], key[1]);
+}
+
+float CounterRng::uniform(uint64_t step, uint32_t index) const {
+    uint32_t words[4];
+    block(step, index / 4, words);
+    return toUniform(words[index % 4]);
+}
+
+float CounterRng::normal(uint64_t step, uint32_t index) const {
+    // Box-Muller over the uniform pair (2k, 2k+1), which share a block
+    uint32_t words[4];
+    block(step, index / 4, words);
+    uint32_t pair = index % 4 & ~1u;
+    float radius = std::sqrt(-2.0f * std::log(toUniform(words[pair])));
+    float angle = TWO_PI * toUniform(words[pair + 1]);
+    return (index & 1) ? radius * std::sin(angle) : radius * std::cos(angle);
+}
+
+void CounterRng::uniformBatch(uint64_t step, float* out, size_t count) const {
+    size_t i = 0;
+#ifdef RNG_USE_SSE2
+    // Four blocks (16 samples) per pass, one block per lane
+    const __m128i m0 = _mm_set1_epi32((int)PHILOX_M0);
+    const __m128i m1 = _mm_set1_epi32((int)PHILOX_M1);
+    const __m128i c1 = _mm_set1_epi32((int)(uint32_t)step);
+    const __m128i c2 = _mm_set1_epi32((int)stepHighWord(step, channel));
+    const __m128i c3 = _mm_set1_epi32((int)entity);
+    for (; i + 16 <= count; i += 16) {
+        uint32_t firstBlock = (uint32_t)(i / 4);
+        __m128i x0 = _mm_add_epi32(_mm_set1_epi32((int)firstBlock), _mm_setr_epi32(0, 1, 2, 3));
+        __m128i x1 = c1, x2 = c2, x3 = c3;
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < PHILOX_ROUNDS; round++) {
+            __m128i hi0, lo0, hi1, lo1;
+            mulhilo(x0, m0, hi0, lo0);
+            mulhilo(x2, m1, hi1, lo1);
+            x0 = _mm_xor_si128(_mm_xor_si128(hi1, x1), _mm_set1_epi32((int)k0));
+            x2 = _mm_xor_si128(_mm_xor_si128(hi0, x3), _mm_set1_epi32((int)k1));
+            x1 = lo1;
+            x3 = lo0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        // Lanes are blocks; transpose so each block's words are contiguous
+        __m128 w0 = toUniform(x0), w1 = toUniform(x1), w2 = toUniform(x2), w3 = toUniform(x3);
+        _MM_TRANSPOSE4_PS(w0, w1, w2, w3);
+        _mm_storeu_ps(out + i, w0);
+        _mm_storeu_ps(out + i + 4, w1);
+        _mm_storeu_ps(out + i + 8, w2);
+        _mm_storeu_ps(out + i + 12, w3);
+    }
+#endif
+    for (; i < count; i += 4) {
+        uint32_t words[4];
+        block(step, (uint32_t)(i / 4), words);
+        for (size_t k = 0; k < 4 && i + k < count; k++) {
+            out[i + k] = toUniform(words[k]);
+        }
+    }
+}
+
+void CounterRng::normalBatch(uint64_t step, float* out, size_t count) const {
+    size_t pairs = count / 2;
+    uniformBatch(step, out, pairs * 2);
+    for (size_t k = 0; k < pairs; k++) {
+        float radius = std::sqrt(-2.0f * std::log(out[2 * k]));
+        float angle = TWO_PI * out[2 * k + 1];
+        out[2 * k] = radius * std::cos(angle);
+        out[2 * k + 1] = radius * std::sin(angle);
+    }
+    if (count % 2) {
+        out[count - 1] = normal(step, (uint32_t)(count - 1));
+    }
+}
@@ -0,0 +1,317 @@
+#include "engine_synth.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SYNTH_USE_SSE2 1
+#endif
+
+namespace {
+
+const double TWO_PI = 2.0 * M_PI;
+
+// out[i] += amplitude * sin(phase + i * increment)
+// Four consecutive samples are kept as a rotating phasor, so the inner
+// loop is a 4-wide complex multiply with no trig calls.
+void addSine(float* out, int frames, double phase, double increment, float amplitude) {
+    int i = 0;
+#ifdef SYNTH_USE_SSE2
+    if (frames >= 4) {
+        alignas(16) float c[4], s[4];
+        for (int k = 0; k < 4; k++) {
+            c[k] = amplitude * (float)std::cos(phase + k * increment);
+            s[k] = amplitude * (float)std::sin(phase + k * increment);
+        }
+        __m128 vc = _mm_load_ps(c);
+        __m128 vs = _mm_load_ps(s);
+        __m128 rc = _mm_set1_ps((float)std::cos(4.0 * increment));
+        __m128 rs = _mm_set1_ps((float)std::sin(4.0 * increment));
+
+        for (; i + 4 <= frames; i += 4) {
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), vs));
+            __m128 nc = _mm_sub_ps(_mm_mul_ps(vc, rc), _mm_mul_ps(vs, rs));
+            vs = _mm_add_ps(_mm_mul_ps(vs, rc), _mm_mul_ps(vc, rs));
+            vc = nc;
+        }
+    }
+#else
+    float c = amplitude * (float)std::cos(phase);
+    float s = amplitude * (float)std::sin(phase);
+    float rc = (float)std::cos(increment);
+    float rs = (float)std::sin(increment);
+    for (; i < frames; i++) {
+        out[i] += s;
+        float nc = c * rc - s * rs;
+        s = s * rc + c * rs;
+        c = nc;
+    }
+#endif
+    for (; i < frames; i++) {
+        out[i] += amplitude * (float)std::sin(phase + i * increment);
+    }
+}
+
+// Zero-mean firing pulse train: out[i] = bump(frac(phase + i * increment) / width)^2
+// where bump(w) = 4w(1-w) on [0, 1] and 0 after
+void pulseTrain(float* out, int frames, double phase, double increment, float width) {
+    const float invWidth = 1.0f / width;
+    const float mean = width * (16.0f / 30.0f);   // Integral of the squared bump
+    int i = 0;
+#ifdef SYNTH_USE_SSE2
+    __m128 p = _mm_setr_ps((float)phase, (float)(phase + increment),
+                           (float)(phase + 2.0 * increment), (float)(phase + 3.0 * increment));
+    __m128 step = _mm_set1_ps((float)(4.0 * increment));
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 four = _mm_set1_ps(4.0f);
+    __m128 vInvWidth = _mm_set1_ps(invWidth);
+    __m128 vMean = _mm_set1_ps(mean);
+
+    for (; i + 4 <= frames; i += 4) {
+        // Phases are positive, so truncation is floor
+        __m128 frac = _mm_sub_ps(p, _mm_cvtepi32_ps(_mm_cvttps_epi32(p)));
+        __m128 w = _mm_min_ps(_mm_mul_ps(frac, vInvWidth), one);
+        __m128 bump = _mm_mul_ps(_mm_mul_ps(four, w), _mm_sub_ps(one, w));
+        _mm_storeu_ps(out + i, _mm_sub_ps(_mm_mul_ps(bump, bump), vMean));
+        p = _mm_add_ps(p, step);
+    }
+#endif
+    for (; i < frames; i++) {
+        double t = phase + i * increment;
+        float frac = (float)(t - std::floor(t));
+        float w = std::min(frac * invWidth, 1.0f);
+        float bump = 4.0f * w * (1.0f - w);
+        out[i] = bump * bump - mean;
+    }
+}
+
+// Chamberlin state-variable filter coefficient for a cutoff in Hz
+float svfCoefficient(float cutoff, float sampleRate) {
+    cutoff = std::min(cutoff, 0.12f * sampleRate);   // Stable region
+    return 2.0f * (float)std::sin(M_PI * cutoff / sampleRate);
+}
+
+} // namespace
+
+EngineSynth::EngineSynth()
+    : sampleRate(48000), channels(2),
+      targetRpm(0.0f), targetThrottle(0.0f), targetAirspeed(0.0f), targetVolume(0.6f),
+      rpm(0.0f), throttle(0.0f), airspeed(0.0f), volume(0.6f), smoothing(1.0f),
+      camPhase(0.0), firingPhase(0.0),
+      lastUs(0.0), meanUs(0.0), maxUs(0.0), budgetUs(0.0), buffers(0), overBudget(0) {
+    for (int k = 0; k < HARMONICS; k++) {
+        harmonicPhase[k] = 0.0;
+    }
+    // Decorrelated noise per lane
+    const uint32_t seeds[4] = {0x12345678u, 0x9e3779b9u, 0x2545f491u, 0x6c8e9cf5u};
+    for (int lane = 0; lane < 4; lane++) {
+        noiseState[lane] = seeds[lane];
+        filterLow[lane] = 0.0f;
+        filterBand[lane] = 0.0f;
+    }
+    configure(sampleRate, channels);
+}
+
+void EngineSynth::configure(uint32_t rate, uint32_t channelCount) {
+    sampleRate = rate > 0 ? rate : 48000;
+    channels = channelCount > 0 ? channelCount : 2;
+    // ~50 ms time constant for parameter changes
+    smoothing = 1.0f - (float)std::exp(-(double)CHUNK / (0.05 * sampleRate));
+}
+
+void EngineSynth::setParameters(float newRpm, float newThrottle, float newAirspeed) {
+    targetRpm.store(std::max(0.0f, newRpm), std::memory_order_relaxed);
+    targetThrottle.store(std::max(0.0f, std::min(1.0f, newThrottle)), std::memory_order_relaxed);
+    targetAirspeed.store(std::max(0.0f, newAirspeed), std::memory_order_relaxed);
+}
+
+void EngineSynth::setVolume(float newVolume) {
+    targetVolume.store(std::max(0.0f, std::min(1.0f, newVolume)), std::memory_order_relaxed);
+}
+
+EngineSynth::Stats EngineSynth::getStats() const {
+    Stats stats;
+    stats.lastUs = lastUs.load(std::memory_order_relaxed);
+    stats.meanUs = meanUs.load(std::memory_order_relaxed);
+    stats.maxUs = maxUs.load(std::memory_order_relaxed);
+    stats.budgetUs = budgetUs.load(std::memory_order_relaxed);
+    stats.buffers = buffers.load(std::memory_order_relaxed);
+    stats.overBudget = overBudget.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EngineSynth::resetStats() {
+    meanUs.store(0.0, std::memory_order_relaxed);
+    maxUs.store(0.0, std::memory_order_relaxed);
+    buffers.store(0, std::memory_order_relaxed);
+    overBudget.store(0, std::memory_order_relaxed);
+}
+
+void EngineSynth::render(float* output, uint32_t frameCount) {
+    auto start = std::chrono::steady_clock::now();
+
+    uint32_t done = 0;
+    while (done < frameCount) {
+        int frames = (int)std::min<uint32_t>(CHUNK, frameCount - done);
+        renderChunk(output + (size_t)done * channels, frames);
+        done += frames;
+    }
+
+    // CPU cost of this buffer against its share of the playback time
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    double budget = 1e6 * frameCount / sampleRate * CPU_BUDGET_FRACTION;
+    double mean = meanUs.load(std::memory_order_relaxed);
+
+    lastUs.store(us, std::memory_order_relaxed);
+    meanUs.store(mean == 0.0 ? us : mean + (us - mean) * 0.05, std::memory_order_relaxed);
+    if (us > maxUs.load(std::memory_order_relaxed)) maxUs.store(us, std::memory_order_relaxed);
+    budgetUs.store(budget, std::memory_order_relaxed);
+    buffers.fetch_add(1, std::memory_order_relaxed);
+    if (us > budget) overBudget.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EngineSynth::renderChunk(float* output, int frames) {
+    // Glide toward the latest targets once per chunk
+    rpm += (targetRpm.load(std::memory_order_relaxed) - rpm) * smoothing;
+    throttle += (targetThrottle.load(std::memory_order_relaxed) - throttle) * smoothing;
+    airspeed += (targetAirspeed.load(std::memory_order_relaxed) - airspeed) * smoothing;
+    volume += (targetVolume.load(std::memory_order_relaxed) - volume) * smoothing;
+
+    const float rate = (float)sampleRate;
+    const float running = std::min(1.0f, rpm / 600.0f);
+    const double shaftHz = rpm / 60.0;
+
+    alignas(16) float prop[CHUNK];
+    alignas(16) float modulation[CHUNK];
+    alignas(16) float pulses[CHUNK];
+
+    // Propeller: shaft orders, the 2-blade passing orders (even) strongest
+    std::fill(prop, prop + frames, 0.0f);
+    float propLevel = 0.12f * running * (0.35f + 0.65f * throttle);
+    for (int k = 0; k < HARMONICS; k++) {
+        int order = k + 1;
+        double hz = shaftHz * order;
+        double increment = TWO_PI * hz / rate;
+        if (hz > 0.0 && hz < 0.45 * rate) {
+            float amplitude = propLevel * ((order % 2 == 0) ? 1.0f : 0.4f) / order;
+            addSine(prop, frames, harmonicPhase[k], increment, amplitude);
+        }
+        harmonicPhase[k] = std::fmod(harmonicPhase[k] + frames * increment, TWO_PI);
+    }
+
+    // Firing pulses: 4-cylinder four-stroke fires twice per revolution;
+    // a cam-rate modulation gives the uneven cylinder-to-cylinder beat
+    double firingIncrement = 2.0 * shaftHz / rate;
+    pulseTrain(pulses, frames, firingPhase, firingIncrement, 0.35f);
+    firingPhase = std::fmod(firingPhase + frames * firingIncrement, 1.0);
+
+    std::fill(modulation, modulation + frames, 1.0f);
+    double camIncrement = TWO_PI * 0.5 * shaftHz / rate;
+    addSine(modulation, frames, camPhase, camIncrement, 0.25f);
+    camPhase = std::fmod(camPhase + frames * camIncrement, TWO_PI);
+
+    float engineLevel = 0.25f * running * (0.3f + 0.7f * throttle);
+    for (int i = 0; i < frames; i++) {
+        pulses[i] *= modulation[i] * engineLevel;
+    }
+
+    // Filter lanes: [wind L band, wind R band, engine low, rumble low]
+    float speedFactor = std::min(1.0f, airspeed / 80.0f);
+    float windLevel = 0.3f * speedFactor * speedFactor;
+    float rumbleLevel = 0.2f * speedFactor;
+    float windCoeff = svfCoefficient(300.0f + airspeed * 25.0f, rate);
+    float engineCoeff = svfCoefficient(1200.0f, rate);
+    float rumbleCoeff = svfCoefficient(80.0f + airspeed * 2.0f, rate);
+
+    const float laneGain[4] = {windLevel, windLevel, 0.0f, rumbleLevel};
+    const float laneCoeff[4] = {windCoeff, windCoeff, engineCoeff, rumbleCoeff};
+    const float laneDamping[4] = {1.0f, 1.0f, 0.9f, 1.2f};
+    const float lowMix[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+    const float bandMix[4] = {1.0f, 1.0f, 0.0f, 0.0f};
+    const float gain = volume;
+    const uint32_t stride = channels;
+
+#ifdef SYNTH_USE_SSE2
+    __m128i state = _mm_load_si128((const __m128i*)noiseState);
+    __m128 low = _mm_load_ps(filterLow);
+    __m128 band = _mm_load_ps(filterBand);
+    __m128 vGain = _mm_loadu_ps(laneGain);
+    __m128 vCoeff = _mm_loadu_ps(laneCoeff);
+    __m128 vDamping = _mm_loadu_ps(laneDamping);
+    __m128 vLowMix = _mm_loadu_ps(lowMix);
+    __m128 vBandMix = _mm_loadu_ps(bandMix);
+    __m128 engineLane = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+    const __m128i exponent = _mm_set1_epi32(0x40000000);
+    const __m128 three = _mm_set1_ps(3.0f);
+    alignas(16) float lanes[4];
+
+    for (int i = 0; i < frames; i++) {
+        // xorshift32 per lane -> uniform float in [-1, 1)
+        state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+        state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+        state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+        __m128 noise = _mm_sub_ps(
+            _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(state, 9), exponent)), three);
+        __m128 in = _mm_add_ps(_mm_mul_ps(noise, vGain),
+                               _mm_mul_ps(_mm_set1_ps(pulses[i]), engineLane));
+
+        low = _mm_add_ps(low, _mm_mul_ps(vCoeff, band));
+        __m128 high = _mm_sub_ps(_mm_sub_ps(in, low), _mm_mul_ps(vDamping, band));
+        band = _mm_add_ps(band, _mm_mul_ps(vCoeff, high));
+
+        _mm_store_ps(lanes, _mm_add_ps(_mm_mul_ps(low, vLowMix), _mm_mul_ps(band, vBandMix)));
+        float shared = prop[i] + lanes[2] + lanes[3];
+        float left = (shared + lanes[0]) * gain;
+        float right = (shared + lanes[1]) * gain;
+
+        float* out = output + (size_t)i * stride;
+        if (stride == 1) {
+            out[0] = 0.5f * (left + right);
+        } else {
+            out[0] = left;
+            out[1] = right;
+            for (uint32_t c = 2; c < stride; c++) out[c] = 0.0f;
+        }
+    }
+
+    _mm_store_si128((__m128i*)noiseState, state);
+    _mm_store_ps(filterLow, low);
+    _mm_store_ps(filterBand, band);
+#else
+    for (int i = 0; i < frames; i++) {
+        float lanes[4];
+        for (int lane = 0; lane < 4; lane++) {
+            uint32_t x = noiseState[lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            noiseState[lane] = x;
+
+            uint32_t bits = (x >> 9) | 0x40000000u;
+            float noise;
+            std::memcpy(&noise, &bits, sizeof(noise));
+            noise -= 3.0f;
+
+            float in = noise * laneGain[lane] + (lane == 2 ? pulses[i] : 0.0f);
+            filterLow[lane] += laneCoeff[lane] * filterBand[lane];
+            float high = in - filterLow[lane] - laneDamping[lane] * filterBand[lane];
+            filterBand[lane] += laneCoeff[lane] * high;
+            lanes[lane] = filterLow[lane] * lowMix[lane] + filterBand[lane] * bandMix[lane];
+        }
+        float shared = prop[i] + lanes[2] + lanes[3];
+        float left = (shared + lanes[0]) * gain;
+        float right = (shared + lanes[1]) * gain;
+
+        float* out = output + (size_t)i * stride;
+        if (stride == 1) {
+            out[0] = 0.5f * (left + right);
+        } else {
+            out[0] = left;
+            out[1] = right;
+            for (uint32_t c = 2; c < stride; c++) out[c] = 0.0f;
+        }
+    }
+#endif
+}
@@ -0,0 +1,164 @@
+#include "envelope_panel.hpp"
+#include "imgui.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const float MAP_HEIGHT = 320.0f;
+
+// Blue (low) through green and yellow to red (high)
+ImU32 heatColor(float t) {
+    t = std::max(0.0f, std::min(1.0f, t));
+    float r = std::min(1.0f, std::max(0.0f, 2.0f * t - 0.5f) * 1.5f);
+    float g = t < 0.75f ? std::min(1.0f, t * 2.0f) : 1.0f - (t - 0.75f) * 4.0f;
+    float b = std::max(0.0f, 1.0f - t * 2.5f);
+    return IM_COL32((int)(r * 255.0f), (int)(g * 255.0f), (int)(b * 255.0f), 255);
+}
+
+} // namespace
+
+EnvelopePanel::EnvelopePanel()
+    : ready(false), generating(false), metric(FlightEnvelope::METRIC_RATE_OF_CLIMB), weightIndex(0) {}
+
+EnvelopePanel::~EnvelopePanel() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void EnvelopePanel::startGeneration() {
+    generating = true;
+    ready.store(false, std::memory_order_relaxed);
+    worker = std::thread([this]() {
+        pending.generate(EnvelopeGrid::standard());
+        ready.store(true, std::memory_order_release);
+    });
+    status = "Generating...";
+}
+
+void EnvelopePanel::render(bool* open) {
+    // Pick up a finished generation
+    if (generating && ready.load(std::memory_order_acquire)) {
+        worker.join();
+        std::swap(envelope, pending);
+        generating = false;
+        weightIndex = std::min(weightIndex, envelope.getGrid().weight.count - 1);
+        char text[128];
+        std::snprintf(text, sizeof(text), "%zu cells in %.2f s on %u threads",
+                      envelope.getGrid().cellCount(), envelope.getGenerateSeconds(),
+                      envelope.getThreadCount());
+        status = text;
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(640.0f, 0.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Flight Envelope", open)) {
+        ImGui::End();
+        return;
+    }
+
+    if (generating) {
+        ImGui::TextDisabled("Generate");
+    } else if (ImGui::Button("Generate")) {
+        startGeneration();
+    }
+    if (!envelope.empty()) {
+        ImGui::SameLine();
+        if (ImGui::Button("Save binary")) {
+            status = envelope.saveBinary("envelope.bin") ? "Saved envelope.bin" : "Save failed";
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Save CSV")) {
+            status = envelope.saveCSV("envelope.csv") ? "Saved envelope.csv" : "Save failed";
+        }
+    }
+    if (!status.empty()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(status.c_str());
+    }
+
+    if (envelope.empty()) {
+        ImGui::TextDisabled("No map yet");
+        ImGui::End();
+        return;
+    }
+
+    static const char* metricNames[FlightEnvelope::METRIC_COUNT];
+    for (int i = 0; i < FlightEnvelope::METRIC_COUNT; i++) {
+        metricNames[i] = FlightEnvelope::metricName((FlightEnvelope::Metric)i);
+    }
+    ImGui::Combo("Metric", &metric, metricNames, FlightEnvelope::METRIC_COUNT);
+
+    const EnvelopeGrid& grid = envelope.getGrid();
+    char weightLabel[32];
+    std::snprintf(weightLabel, sizeof(weightLabel), "%.0f kg", grid.weight.value(weightIndex));
+    ImGui::SliderInt("Weight", &weightIndex, 0, grid.weight.count - 1, weightLabel);
+
+    drawHeatMap();
+    ImGui::End();
+}
+
+void EnvelopePanel::drawHeatMap() {
+    const EnvelopeGrid& grid = envelope.getGrid();
+    FlightEnvelope::Metric shown = (FlightEnvelope::Metric)metric;
+
+    // Color range over this weight's slice
+    float low = 0.0f, high = 0.0f;
+    bool any = false;
+    for (int a = 0; a < grid.altitude.count; a++) {
+        for (int v = 0; v < grid.airspeed.count; v++) {
+            float value = FlightEnvelope::metricValue(envelope.at(weightIndex, a, v), shown);
+            if (!std::isfinite(value)) continue;
+            low = any ? std::min(low, value) : value;
+            high = any ? std::max(high, value) : value;
+            any = true;
+        }
+    }
+    float range = high > low ? high - low : 1.0f;
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    float cellWidth = width / grid.airspeed.count;
+    float cellHeight = MAP_HEIGHT / grid.altitude.count;
+
+    // Altitude increases upwards, airspeed to the right
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    for (int a = 0; a < grid.altitude.count; a++) {
+        float y1 = origin.y + MAP_HEIGHT - a * cellHeight;
+        for (int v = 0; v < grid.airspeed.count; v++) {
+            float value = FlightEnvelope::metricValue(envelope.at(weightIndex, a, v), shown);
+            ImU32 color = std::isfinite(value) ? heatColor((value - low) / range) : IM_COL32(40, 40, 40, 255);
+            float x0 = origin.x + v * cellWidth;
+            drawList->AddRectFilled(ImVec2(x0, y1 - cellHeight), ImVec2(x0 + cellWidth + 0.5f, y1), color);
+        }
+    }
+
+    ImGui::InvisibleButton("##envelope", ImVec2(width, MAP_HEIGHT));
+    if (ImGui::IsItemHovered()) {
+        ImVec2 mouse = ImGui::GetMousePos();
+        int v = (int)((mouse.x - origin.x) / cellWidth);
+        int a = (int)((origin.y + MAP_HEIGHT - mouse.y) / cellHeight);
+        if (v >= 0 && v < grid.airspeed.count && a >= 0 && a < grid.altitude.count) {
+            const EnvelopeCell& cell = envelope.at(weightIndex, a, v);
+            const double radToDeg = 180.0 / M_PI;
+            ImGui::SetTooltip("%.0f m, %.1f m/s (%.0f kt)\n"
+                              "%s\n"
+                              "Trim: alpha %.1f deg, elevator %.3f, throttle %.2f\n"
+                              "Stall margin: %.2f\n"
+                              "Max climb: %.2f m/s\n"
+                              "Sustained turn: %.2f g, %.1f deg/s, radius %.0f m",
+                              grid.altitude.value(a), grid.airspeed.value(v), grid.airspeed.value(v) * 1.94384,
+                              cell.trimmed ? "Trimmable" : "Cannot trim level flight",
+                              cell.trimAlpha * radToDeg, cell.trimElevator, cell.trimThrottle,
+                              cell.stallMargin, cell.maxRateOfClimb, cell.maxLoadFactor,
+                              cell.turnRate * radToDeg, cell.turnRadius);
+        }
+    }
+
+    ImGui::Text("Altitude %.0f - %.0f m (up), airspeed %.0f - %.0f m/s (right)", grid.altitude.min,
+                grid.altitude.max, grid.airspeed.min, grid.airspeed.max);
+    if (any) {
+        ImGui::Text("Color: %.3g (blue) to %.3g (red); gray = not defined", low, high);
+    }
+}
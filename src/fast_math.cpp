@@ -0,0 +1,245 @@
+#include "fast_math.hpp"
+#include "fp_determinism.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FAST_MATH_USE_SSE2 1
+#endif
+
+namespace fastmath {
+
+namespace detail {
+
+const double EXP_TABLE[1 << EXP_TABLE_BITS] = {
+    1.00000000000000000e+00, 1.01088928605170048e+00, 1.02189714865411663e+00, 1.03302487902122841e+00,
+    1.04427378242741375e+00, 1.05564517836055716e+00, 1.06714040067682370e+00, 1.07876079775711986e+00,
+    1.09050773266525769e+00, 1.10238258330784089e+00, 1.11438674259589243e+00, 1.12652161860824185e+00,
+    1.13878863475669156e+00, 1.15118922995298267e+00, 1.16372485877757748e+00, 1.17639699165028122e+00,
+    1.18920711500272103e+00, 1.20215673145270308e+00, 1.21524735998046896e+00, 1.22848053610687002e+00,
+    1.24185781207348400e+00, 1.25538075702469110e+00, 1.26905095719173322e+00, 1.28287001607877826e+00,
+    1.29683955465100964e+00, 1.31096121152476441e+00, 1.32523664315974132e+00, 1.33966752405330292e+00,
+    1.35425554693689265e+00, 1.36900242297459052e+00, 1.38390988196383202e+00, 1.39897967253831124e+00,
+    1.41421356237309515e+00, 1.42961333839197002e+00, 1.44518080697704665e+00, 1.46091779418064704e+00,
+    1.47682614593949935e+00, 1.49290772829126484e+00, 1.50916442759342284e+00, 1.52559815074453842e+00,
+    1.54221082540794074e+00, 1.55900440023783693e+00, 1.57598084510788650e+00, 1.59314215134226700e+00,
+    1.61049033194925428e+00, 1.62802742185734783e+00, 1.64575547815396495e+00, 1.66367658032673638e+00,
+    1.68179283050742900e+00, 1.70010635371852348e+00, 1.71861929812247793e+00, 1.73733383527370622e+00,
+    1.75625216037329945e+00, 1.77537649252652119e+00, 1.79470907500310717e+00, 1.81425217550039886e+00,
+    1.83400808640934243e+00, 1.85397912508338547e+00, 1.87416763411029996e+00, 1.89457598158696561e+00,
+    1.91520656139714740e+00, 1.93606179349229435e+00, 1.95714412417540018e+00, 1.97845602638795093e+00
+};
+
+const LogTableEntry LOG_TABLE[1 << LOG_TABLE_BITS] = {
+    {1.00000000000000000e+00, 0.00000000000000000e+00},
+    {9.84615384615384670e-01, 1.55041865359651990e-02},
+    {9.69696969696969724e-01, 3.07716586667536596e-02},
+    {9.55223880597014907e-01, 4.58095360312942221e-02},
+    {9.41176470588235281e-01, 6.06246218164348538e-02},
+    {9.27536231884057982e-01, 7.52234212375875178e-02},
+    {9.14285714285714257e-01, 8.96121586896871658e-02},
+    {9.01408450704225372e-01, 1.03796793681643545e-01},
+    {8.88888888888888840e-01, 1.17783035656383511e-01},
+    {8.76712328767123239e-01, 1.31576357788719317e-01},
+    {8.64864864864864913e-01, 1.45182009844497834e-01},
+    {8.53333333333333388e-01, 1.58605030176638517e-01},
+    {8.42105263157894690e-01, 1.71850256926659284e-01},
+    {8.31168831168831224e-01, 1.84922338494011934e-01},
+    {8.20512820512820484e-01, 1.97825743329919923e-01},
+    {8.10126582278481000e-01, 2.10564769107349642e-01},
+    {8.00000000000000044e-01, 2.23143551314209709e-01},
+    {7.90123456790123413e-01, 2.35566071312766967e-01},
+    {7.80487804878048808e-01, 2.47836163904581214e-01},
+    {7.71084337349397630e-01, 2.59957524436925991e-01},
+    {7.61904761904761862e-01, 2.71933715483641814e-01},
+    {7.52941176470588225e-01, 2.83768173130644619e-01},
+    {7.44186046511627897e-01, 2.95464212893835898e-01},
+    {7.35632183908045967e-01, 3.07025035294911874e-01},
+    {7.27272727272727293e-01, 3.18453731118534589e-01},
+    {7.19101123595505598e-01, 3.29753286372468035e-01},
+    {7.11111111111111138e-01, 3.40926586970593193e-01},
+    {7.03296703296703352e-01, 3.51976423157178087e-01},
+    {6.95652173913043459e-01, 3.62905493689368475e-01},
+    {6.88172043010752743e-01, 3.73716409793584003e-01},
+    {6.80851063829787218e-01, 3.84411698910332056e-01},
+    {6.73684210526315774e-01, 3.94993808240868993e-01},
+    {6.66666666666666630e-01, 4.05465108108164440e-01},
+    {6.59793814432989678e-01, 4.15827895143710990e-01},
+    {6.53061224489795866e-01, 4.26084395310900144e-01},
+    {6.46464646464646520e-01, 4.36236766774917961e-01},
+    {6.40000000000000013e-01, 4.46287102628419474e-01},
+    {6.33663366336633671e-01, 4.56237433481587573e-01},
+    {6.27450980392156854e-01, 4.66089729924599239e-01},
+    {6.21359223300970820e-01, 4.75845904869963976e-01},
+    {6.15384615384615419e-01, 4.85507815781700769e-01},
+    {6.09523809523809579e-01, 4.95077266797851412e-01},
+    {6.03773584905660354e-01, 5.04556010752395312e-01},
+    {5.98130841121495282e-01, 5.13945751102234394e-01},
+    {5.92592592592592560e-01, 5.23248143764547868e-01},
+    {5.87155963302752326e-01, 5.32464798869471734e-01},
+    {5.81818181818181790e-01, 5.41597282432744409e-01},
+    {5.76576576576576572e-01, 5.50647117952662302e-01},
+    {5.71428571428571397e-01, 5.59615787935422770e-01},
+    {5.66371681415929196e-01, 5.68504735352668766e-01},
+    {5.61403508771929793e-01, 5.77315365034823613e-01},
+    {5.56521739130434789e-01, 5.86049045003578239e-01},
+    {5.51724137931034475e-01, 5.94707107746692776e-01},
+    {5.47008547008547064e-01, 6.03290851438084141e-01},
+    {5.42372881355932202e-01, 6.11801541105992941e-01},
+    {5.37815126050420145e-01, 6.20240409751857569e-01},
+    {5.33333333333333326e-01, 6.28608659422374205e-01},
+    {5.28925619834710758e-01, 6.36907462237069177e-01},
+    {5.24590163934426257e-01, 6.45137961373584701e-01},
+    {5.20325203252032575e-01, 6.53301272012745571e-01},
+    {5.16129032258064502e-01, 6.61398482245365016e-01},
+    {5.12000000000000011e-01, 6.69430653942629239e-01},
+    {5.07936507936507908e-01, 6.77398823591806143e-01},
+    {5.03937007874015741e-01, 6.85304003098919479e-01}
+};
+
+const double ATAN_TABLE[(1 << ATAN_TABLE_BITS) + 1] = {
+    0.00000000000000000e+00, 6.24188099959573500e-02, 1.24354994546761438e-01, 1.85347949995694761e-01,
+    2.44978663126864143e-01, 3.02884868374971417e-01, 3.58770670270572245e-01, 4.12410441597387323e-01,
+    4.63647609000806094e-01, 5.12389460310737732e-01, 5.58599315343562441e-01, 6.02287346134964152e-01,
+    6.43501108793284371e-01, 6.82316554874748071e-01, 7.18829999621624527e-01, 7.53151280962194414e-01,
+    7.85398163397448279e-01
+};
+
+} // namespace detail
+
+#ifdef FAST_MATH_USE_SSE2
+namespace {
+
+using namespace detail;
+
+// Two lanes with the operators the detail:: polynomials need
+struct Lanes {
+    __m128d v;
+    Lanes(__m128d v) : v(v) {}
+    explicit Lanes(double x) : v(_mm_set1_pd(x)) {}
+};
+
+inline Lanes operator+(Lanes a, Lanes b) { return _mm_add_pd(a.v, b.v); }
+inline Lanes operator*(Lanes a, Lanes b) { return _mm_mul_pd(a.v, b.v); }
+
+inline __m128d select(__m128d mask, __m128d a, __m128d b) {
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+inline void sincosLanes(__m128d x, __m128d& s, __m128d& c) {
+    const __m128d magic = _mm_set1_pd(ROUND_MAGIC);
+    __m128d t = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(TWO_OVER_PI)), magic);
+    __m128d k = _mm_sub_pd(t, magic);
+    __m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(PI_OVER_2_HI))),
+                           _mm_mul_pd(k, _mm_set1_pd(PI_OVER_2_LO)));
+    __m128d r2 = _mm_mul_pd(r, r);
+    __m128d sr = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, r2), sinPoly(Lanes(r2)).v));
+    __m128d cr = _mm_add_pd(_mm_set1_pd(1.0), _mm_mul_pd(r2, cosPoly(Lanes(r2)).v));
+
+    // Quadrant bits moved to the sign position; the swap mask needs the
+    // sign spread over each 64-bit lane (no 64-bit arithmetic shift in SSE2)
+    __m128i quadrant = _mm_castpd_si128(t);
+    __m128i odd = _mm_slli_epi64(quadrant, 63);
+    __m128d swap = _mm_castsi128_pd(_mm_srai_epi32(_mm_shuffle_epi32(odd, _MM_SHUFFLE(3, 3, 1, 1)), 31));
+    __m128d signBit = _mm_set1_pd(-0.0);
+    __m128d sinSign = _mm_and_pd(_mm_castsi128_pd(_mm_slli_epi64(quadrant, 62)), signBit);
+    __m128d cosSign = _mm_and_pd(_mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(quadrant, _mm_set1_epi64x(1)), 62)),
+                                 signBit);
+    s = _mm_xor_pd(select(swap, cr, sr), sinSign);
+    c = _mm_xor_pd(select(swap, sr, cr), cosSign);
+}
+
+inline __m128d expLanes(__m128d x) {
+    const double steps = 1 << EXP_TABLE_BITS;
+    x = _mm_min_pd(_mm_max_pd(x, _mm_set1_pd(EXP_MIN)), _mm_set1_pd(EXP_MAX));
+    const __m128d magic = _mm_set1_pd(ROUND_MAGIC);
+    __m128d t = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(LOG2E * steps)), magic);
+    __m128d k = _mm_sub_pd(t, magic);
+    __m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(LN2_HI / steps))),
+                           _mm_mul_pd(k, _mm_set1_pd(LN2_LO / steps)));
+    __m128i n = _mm_sub_epi64(_mm_castpd_si128(t), _mm_castpd_si128(magic));
+    
+    // No gather in SSE2: two table loads, then the exponent added to both
+    const int mask = (1 << EXP_TABLE_BITS) - 1;
+    int j0 = _mm_cvtsi128_si32(n) & mask;
+    int j1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(n, _MM_SHUFFLE(3, 2, 3, 2))) & mask;
+    __m128i table = _mm_castpd_si128(_mm_setr_pd(EXP_TABLE[j0], EXP_TABLE[j1]));
+    __m128i exponent = _mm_slli_epi64(_mm_andnot_si128(_mm_set1_epi64x(mask), n), 52 - EXP_TABLE_BITS);
+    __m128d scale = _mm_castsi128_pd(_mm_add_epi64(table, exponent));
+    
+    __m128d p = _mm_add_pd(_mm_add_pd(_mm_set1_pd(1.0), r),
+                           _mm_mul_pd(_mm_mul_pd(r, r), expPoly(Lanes(r)).v));
+    return _mm_mul_pd(scale, p);
+}
+
+inline __m128d atan2Lanes(__m128d y, __m128d x) {
+    const __m128d signBit = _mm_set1_pd(-0.0);
+    const __m128d zero = _mm_setzero_pd();
+    __m128d ay = _mm_andnot_pd(signBit, y);
+    __m128d ax = _mm_andnot_pd(signBit, x);
+    __m128d swap = _mm_cmpgt_pd(ay, ax);
+    __m128d num = select(swap, ax, ay);
+    __m128d den = select(swap, ay, ax);
+    __m128d nonzero = _mm_cmpgt_pd(den, zero);   // 0/0 lanes are masked to 0
+    __m128d t = _mm_and_pd(nonzero, _mm_div_pd(num, den));
+    
+    const double steps = 1 << ATAN_TABLE_BITS;
+    const __m128d magic = _mm_set1_pd(ROUND_MAGIC);
+    __m128d k = _mm_add_pd(_mm_mul_pd(t, _mm_set1_pd(steps)), magic);
+    __m128d c = _mm_mul_pd(_mm_sub_pd(k, magic), _mm_set1_pd(1.0 / steps));
+    __m128d r = _mm_and_pd(nonzero, _mm_div_pd(_mm_sub_pd(num, _mm_mul_pd(c, den)),
+                                               _mm_add_pd(den, _mm_mul_pd(c, num))));
+    __m128d z = _mm_mul_pd(r, r);
+    
+    __m128i j = _mm_sub_epi64(_mm_castpd_si128(k), _mm_castpd_si128(magic));
+    int j0 = _mm_cvtsi128_si32(j);
+    int j1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(j, _MM_SHUFFLE(3, 2, 3, 2)));
+    __m128d a = _mm_add_pd(_mm_setr_pd(ATAN_TABLE[j0], ATAN_TABLE[j1]),
+                           _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, z), atanPoly(Lanes(z)).v)));
+    a = select(swap, _mm_sub_pd(_mm_set1_pd(PI_OVER_2), a), a);
+    a = select(_mm_cmplt_pd(x, zero), _mm_sub_pd(_mm_set1_pd(PI), a), a);
+    return _mm_or_pd(a, _mm_and_pd(y, signBit));
+}
+
+} // namespace
+#endif
+
+void sincos(const double* x, double* s, double* c, size_t count) {
+    size_t i = 0;
+#ifdef FAST_MATH_USE_SSE2
+    for (; i + 2 <= count; i += 2) {
+        __m128d sv, cv;
+        sincosLanes(_mm_loadu_pd(x + i), sv, cv);
+        _mm_storeu_pd(s + i, sv);
+        _mm_storeu_pd(c + i, cv);
+    }
+#endif
+    for (; i < count; i++) {
+        sincos(x[i], s[i], c[i]);
+    }
+}
+
+void exp(const double* x, double* out, size_t count) {
+    size_t i = 0;
+#ifdef FAST_MATH_USE_SSE2
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(out + i, expLanes(_mm_loadu_pd(x + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = exp(x[i]);
+    }
+}
+
+void atan2(const double* y, const double* x, double* out, size_t count) {
+    size_t i = 0;
+#ifdef FAST_MATH_USE_SSE2
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(out + i, atan2Lanes(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = atan2(y[i], x[i]);
+    }
+}
+
+} // namespace fastmath
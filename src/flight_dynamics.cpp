@@ -1,23 +1,59 @@
 #include "flight_dynamics.hpp"
+#include "fp_determinism.hpp"
+#include "logger.hpp"
+#include "state_hash.hpp"
+#include <algorithm>
 #include <cmath>
 
+namespace {
+
+#ifdef FLIGHT_DETERMINISTIC
+const bool DEFAULT_STATE_HASHING = true;
+#else
+const bool DEFAULT_STATE_HASHING = false;
+#endif
+
+const double FLAT_EARTH_GRAVITY = 9.81;   // m/s^2
+
+// Round earth: north, and with it heading, is undefined at the poles,
+// where the transport rate about the vertical (east tan(latitude) /
+// radius) is infinite. Frames are refused near a pole, and cos(latitude)
+// is limited to this (about 6 mm from the pole) so a flight that still
+// gets there keeps finite rates.
+const double MAX_FRAME_LATITUDE = 89.0 * M_PI / 180.0;
+const double MIN_COS_LATITUDE = 1e-9;
+
+// Putting a state back on the ellipsoid goes through geodetic coordinates
+// and back, good to about 1e-8 m
+const double GROUND_ROUND_OFF = 1e-6;   // m
+
+} // namespace
+
 FlightDynamics::FlightDynamics(Aircraft* aircraft, Atmosphere* atmosphere)
-    : aircraft(aircraft), atmosphere(atmosphere) {}
+    : aircraft(aircraft), atmosphere(atmosphere), earthFrame(nullptr), stateHashing(DEFAULT_STATE_HASHING) {
+    resetStateHash();
+    updateAirData();
+}
 
-void FlightDynamics::update(double dt) {
+template <typename Math>
+void FlightDynamics::updateWith(double dt) {
+#ifdef FLIGHT_DETERMINISTIC
+    ScopedFpEnvironment fpEnvironment;
+#endif
+    
     // RK4 integration
     AircraftState& state = aircraft->getState();
     
-    StateDerivative k1 = computeDerivative(state);
+    StateDerivative k1 = computeDerivativeWith<Math>(state);
     AircraftState state2 = addScaledDerivative(state, k1, dt * 0.5);
     
-    StateDerivative k2 = computeDerivative(state2);
+    StateDerivative k2 = computeDerivativeWith<Math>(state2);
     AircraftState state3 = addScaledDerivative(state, k2, dt * 0.5);
     
-    StateDerivative k3 = computeDerivative(state3);
+    StateDerivative k3 = computeDerivativeWith<Math>(state3);
     AircraftState state4 = addScaledDerivative(state, k3, dt);
     
-    StateDerivative k4 = computeDerivative(state4);
+    StateDerivative k4 = computeDerivativeWith<Math>(state4);
     
     // Combine derivatives
     state.position += (k1.positionDot + k2.positionDot * 2.0 + k3.positionDot * 2.0 + k4.positionDot) * (dt / 6.0);
@@ -34,11 +70,50 @@ void FlightDynamics::update(double dt) {
     while (state.yaw < -M_PI) state.yaw += 2.0 * M_PI;
     
     // Ground collision
-    if (state.position.z > 0.0) {
+    if (earthFrame) {
+        if (altitudeOf(state) < 0.0) {
+            Geodetic position = earthFrame->nedToGeodetic(state.position);
+            position.altitude = 0.0;
+            state.position = earthFrame->geodeticToNed(position);
+            state.velocity = Vector3(0, 0, 0);
+            state.angularVelocity = Vector3(0, 0, 0);
+        }
+    } else if (state.position.z > 0.0) {
         state.position.z = 0.0;
         state.velocity = Vector3(0, 0, 0);
         state.angularVelocity = Vector3(0, 0, 0);
     }
+    
+    if (stateHashing) {
+        stateHash = StateHash::combine(stateHash, state);
+        hashedSteps++;
+    }
+    
+    updateAirData();
+}
+
+double FlightDynamics::altitudeOf(const AircraftState& state) const {
+    return earthFrame ? earthFrame->nedToLocalLevel(state.position).altitude : -state.position.z;
+}
+
+bool FlightDynamics::isOnGround(const AircraftState& state) const {
+    return altitudeOf(state) <= (earthFrame ? GROUND_ROUND_OFF : 0.0);
+}
+
+bool FlightDynamics::setEarthFrame(const NedFrame* frame) {
+    if (frame && std::fabs(frame->getOrigin().latitude) > MAX_FRAME_LATITUDE) {
+        LOG_ERROR("Round-earth frame at latitude %.3f deg refused: within %.0f deg of a pole",
+                  frame->getOrigin().latitude * 180.0 / M_PI, 90.0 - MAX_FRAME_LATITUDE * 180.0 / M_PI);
+        return false;
+    }
+    earthFrame = frame;
+    updateAirData();
+    return true;
+}
+
+void FlightDynamics::resetStateHash() {
+    stateHash = StateHash::SEED;
+    hashedSteps = 0;
 }
 
 void FlightDynamics::reset() {
@@ -49,30 +124,68 @@ void FlightDynamics::reset() {
     state.roll = 0.0;
     state.pitch = 0.0;
     state.yaw = 0.0;
+    resetStateHash();
+    updateAirData();
 }
 
-Vector3 FlightDynamics::calculateForces(const AircraftState& state) {
-    double altitude = -state.position.z;
-    double density, pressure, temperature, speedOfSound;
-    atmosphere->getProperties(altitude, density, pressure, temperature, speedOfSound);
-    
-    double airspeed = state.velocity.magnitude();
-    if (airspeed < 0.1) airspeed = 0.1;
-    
-    double q = 0.5 * density * airspeed * airspeed;  // Dynamic pressure
-    
-    // Aerodynamic angles
-    double alpha = aircraft->getAngleOfAttack();
-    double beta = aircraft->getSideslip();
+void FlightDynamics::updateAirData() {
+    const AircraftState& state = aircraft->getState();
+    updateLocalEarth(state);
+    airData = computeAirData(*aircraft, *atmosphere, local.altitude);
+    
+    // The force model reuses the record's density and angles, so the
+    // atmosphere, the angles and gravity are not evaluated a second time
+    double airspeed = std::max(airData.trueAirspeed, 0.1);
+    double q = 0.5 * airData.density * airspeed * airspeed;
+    double sinAlpha, cosAlpha;
+    SimMath::sincos(airData.alpha, sinAlpha, cosAlpha);
+    Vector3 force = calculateAeroForces<SimMath>(state, q, airData.alpha, airData.beta, sinAlpha, cosAlpha);
+    setSpecificForce(airData, force / aircraft->getMass());
+}
+
+void FlightDynamics::updateLocalEarth(const AircraftState& state) {
+    if (!earthFrame) {
+        local.altitude = -state.position.z;
+        local.gravity = FLAT_EARTH_GRAVITY;
+        return;
+    }
     
+    LocalLevel level = earthFrame->nedToLocalLevel(state.position);
+    local.altitude = level.altitude;
+    local.gravity = level.gravity;
+    local.sinLatitude = level.sinLatitude;
+    local.cosLatitude = level.cosLatitude;
+    double sinLon = level.sinLongitude, cosLon = level.cosLongitude;
+    
+    // ECEF to local NED at the aircraft, composed with the frame's ECEF to NED
+    Matrix<3, 3> ecefToLevel;
+    ecefToLevel(0, 0) = -local.sinLatitude * cosLon;
+    ecefToLevel(0, 1) = -local.sinLatitude * sinLon;
+    ecefToLevel(0, 2) = local.cosLatitude;
+    ecefToLevel(1, 0) = -sinLon;
+    ecefToLevel(1, 1) = cosLon;
+    ecefToLevel(2, 0) = -local.cosLatitude * cosLon;
+    ecefToLevel(2, 1) = -local.cosLatitude * sinLon;
+    ecefToLevel(2, 2) = -local.sinLatitude;
+    local.levelToFrame = earthFrame->getRotation() * ecefToLevel.transpose();
+}
+
+template <typename Math>
+Vector3 FlightDynamics::calculateForces(const AircraftState& state, const Stage& stage) {
+    return calculateAeroForces<Math>(state, stage.q, stage.alpha, stage.beta, stage.sines[Stage::ALPHA],
+                                     stage.cosines[Stage::ALPHA]) + calculateGravity(stage);
+}
+
+template <typename Math>
+Vector3 FlightDynamics::calculateAeroForces(const AircraftState& state, double q, double alpha, double beta,
+                                            double sinAlpha, double cosAlpha) {
     // Aerodynamic forces in body frame
     double CL = aircraft->getCL(alpha, state.elevator);
     double CD = aircraft->getCD(alpha);
     double CY = aircraft->getCY(beta, state.rudder);
     
     // Transform from wind to body frame
-    double ca = std::cos(alpha);
-    double sa = std::sin(alpha);
+    double ca = cosAlpha, sa = sinAlpha;
     
     Vector3 aeroForce;
     aeroForce.x = q * aircraft->getWingArea() * (-CD * ca + CL * sa);
@@ -82,32 +195,26 @@ Vector3 FlightDynamics::calculateForces(const AircraftState& state) {
     // Thrust
     Vector3 thrust(state.throttle * aircraft->maxThrust, 0, 0);
     
+    return aeroForce + thrust;
+}
+
+Vector3 FlightDynamics::calculateGravity(const Stage& stage) {
     // Gravity in body frame
-    double cr = std::cos(state.roll);
-    double sr = std::sin(state.roll);
-    double cp = std::cos(state.pitch);
-    double sp = std::sin(state.pitch);
+    double sr = stage.sines[Stage::ROLL], cr = stage.cosines[Stage::ROLL];
+    double sp = stage.sines[Stage::PITCH], cp = stage.cosines[Stage::PITCH];
     
     Vector3 gravity;
-    gravity.x = -aircraft->getMass() * 9.81 * sp;
-    gravity.y = aircraft->getMass() * 9.81 * sr * cp;
-    gravity.z = aircraft->getMass() * 9.81 * cr * cp;
-    
-    return aeroForce + thrust + gravity;
+    gravity.x = -aircraft->getMass() * local.gravity * sp;
+    gravity.y = aircraft->getMass() * local.gravity * sr * cp;
+    gravity.z = aircraft->getMass() * local.gravity * cr * cp;
+    return gravity;
 }
 
-Vector3 FlightDynamics::calculateMoments(const AircraftState& state) {
-    double altitude = -state.position.z;
-    double density, pressure, temperature, speedOfSound;
-    atmosphere->getProperties(altitude, density, pressure, temperature, speedOfSound);
-    
-    double airspeed = state.velocity.magnitude();
-    if (airspeed < 0.1) airspeed = 0.1;
-    
-    double q = 0.5 * density * airspeed * airspeed;
-    
-    double alpha = aircraft->getAngleOfAttack();
-    double beta = aircraft->getSideslip();
+template <typename Math>
+Vector3 FlightDynamics::calculateMoments(const AircraftState& state, const Stage& stage) {
+    double q = stage.q;
+    double alpha = stage.alpha;
+    double beta = stage.beta;
     
     // Moment coefficients
     double Cl = aircraft->getCl(beta, state.aileron, state.rudder);
@@ -122,20 +229,30 @@ Vector3 FlightDynamics::calculateMoments(const AircraftState& state) {
     return moments;
 }
 
-FlightDynamics::StateDerivative FlightDynamics::computeDerivative(const AircraftState& state) {
+template <typename Math>
+FlightDynamics::StateDerivative FlightDynamics::computeDerivativeWith(const AircraftState& state) {
     StateDerivative deriv;
     
     // Store current state temporarily
     AircraftState originalState = aircraft->getState();
     aircraft->getState() = state;
+    updateLocalEarth(state);
+    
+    Stage stage;
+    double density, pressure, temperature, speedOfSound;
+    atmosphere->getPropertiesWith<Math>(local.altitude, density, pressure, temperature, speedOfSound);
+    double airspeed = state.velocity.magnitude();
+    if (airspeed < 0.1) airspeed = 0.1;
+    stage.q = 0.5 * density * airspeed * airspeed;  // Dynamic pressure
+    stage.alpha = state.velocity.x > 0.1 ? Math::atan2(state.velocity.z, state.velocity.x) : 0.0;   // As Aircraft::getAngleOfAttack
+    stage.beta = aircraft->getSideslip();
+    const double angles[4] = {state.roll, state.pitch, state.yaw, stage.alpha};
+    Math::sincos(angles, stage.sines, stage.cosines, 4);
     
     // Position derivative (transform velocity from body to NED frame)
-    double cr = std::cos(state.roll);
-    double sr = std::sin(state.roll);
-    double cp = std::cos(state.pitch);
-    double sp = std::sin(state.pitch);
-    double cy = std::cos(state.yaw);
-    double sy = std::sin(state.yaw);
+    double sr = stage.sines[Stage::ROLL], cr = stage.cosines[Stage::ROLL];
+    double sp = stage.sines[Stage::PITCH], cp = stage.cosines[Stage::PITCH];
+    double sy = stage.sines[Stage::YAW], cy = stage.cosines[Stage::YAW];
     
     deriv.positionDot.x = cy * cp * state.velocity.x + 
                          (cy * sp * sr - sy * cr) * state.velocity.y +
@@ -147,8 +264,31 @@ FlightDynamics::StateDerivative FlightDynamics::computeDerivative(const Aircraft
                           cp * sr * state.velocity.y +
                           cp * cr * state.velocity.z;
     
+    // Attitude is relative to the local level, which turns as the aircraft
+    // moves over the curved earth (transport rate)
+    Vector3 rates = state.angularVelocity;
+    if (earthFrame) {
+        const Vector3 v = deriv.positionDot;
+        const Matrix<3, 3>& m = local.levelToFrame;
+        deriv.positionDot.x = m(0, 0) * v.x + m(0, 1) * v.y + m(0, 2) * v.z;
+        deriv.positionDot.y = m(1, 0) * v.x + m(1, 1) * v.y + m(1, 2) * v.z;
+        deriv.positionDot.z = m(2, 0) * v.x + m(2, 1) * v.y + m(2, 2) * v.z;
+        
+        double w2 = 1.0 - wgs84::ECCENTRICITY_SQ * local.sinLatitude * local.sinLatitude;
+        double primeVertical = wgs84::SEMI_MAJOR_AXIS / std::sqrt(w2);
+        double meridian = primeVertical * (1.0 - wgs84::ECCENTRICITY_SQ) / w2;
+        double east = v.y / (primeVertical + local.altitude);
+        double cosLatitude = std::max(local.cosLatitude, MIN_COS_LATITUDE);
+        Vector3 transport(east, -v.x / (meridian + local.altitude), -east * local.sinLatitude / cosLatitude);
+        
+        // Into the body frame (transpose of the body-to-NED rotation above)
+        rates.x -= cy * cp * transport.x + sy * cp * transport.y - sp * transport.z;
+        rates.y -= (cy * sp * sr - sy * cr) * transport.x + (sy * sp * sr + cy * cr) * transport.y + cp * sr * transport.z;
+        rates.z -= (cy * sp * cr + sy * sr) * transport.x + (sy * sp * cr - cy * sr) * transport.y + cp * cr * transport.z;
+    }
+    
     // Forces
-    Vector3 forces = calculateForces(state);
+    Vector3 forces = calculateForces<Math>(state, stage);
     
     // Velocity derivative
     double p = state.angularVelocity.x;
@@ -158,7 +298,7 @@ FlightDynamics::StateDerivative FlightDynamics::computeDerivative(const Aircraft
     deriv.velocityDot = forces / aircraft->getMass() - state.angularVelocity.cross(state.velocity);
     
     // Moments
-    Vector3 moments = calculateMoments(state);
+    Vector3 moments = calculateMoments<Math>(state, stage);
     
     // Angular velocity derivative (Euler's equations)
     double Ixx = aircraft->Ixx;
@@ -170,9 +310,10 @@ FlightDynamics::StateDerivative FlightDynamics::computeDerivative(const Aircraft
     deriv.angularVelocityDot.z = (moments.z - (Iyy - Ixx) * p * q) / Izz;
     
     // Euler angle derivatives
-    deriv.eulerDot.x = p + sr * std::tan(state.pitch) * q + cr * std::tan(state.pitch) * r;
-    deriv.eulerDot.y = cr * q - sr * r;
-    deriv.eulerDot.z = (sr / cp) * q + (cr / cp) * r;
+    double tp = Math::tan(state.pitch, sp, cp);
+    deriv.eulerDot.x = rates.x + sr * tp * rates.y + cr * tp * rates.z;
+    deriv.eulerDot.y = cr * rates.y - sr * rates.z;
+    deriv.eulerDot.z = (sr / cp) * rates.y + (cr / cp) * rates.z;
     
     // Restore original state
     aircraft->getState() = originalState;
@@ -180,6 +321,11 @@ FlightDynamics::StateDerivative FlightDynamics::computeDerivative(const Aircraft
     return deriv;
 }
 
+template void FlightDynamics::updateWith<StdMath>(double);
+template void FlightDynamics::updateWith<FastMath>(double);
+template FlightDynamics::StateDerivative FlightDynamics::computeDerivativeWith<StdMath>(const AircraftState&);
+template FlightDynamics::StateDerivative FlightDynamics::computeDerivativeWith<FastMath>(const AircraftState&);
+
 AircraftState FlightDynamics::addScaledDerivative(const AircraftState& state, 
                                                  const StateDerivative& deriv, double scale) {
     AircraftState newState = state;
@@ -0,0 +1,163 @@
+#include "flight_env.hpp"
+#include "counter_rng.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Instances per thread-pool work item: big enough to amortize the atomic
+// index handout, small enough to balance when episodes reset unevenly
+const size_t BLOCK_SIZE = 32;
+
+const uint16_t INITIAL_CONDITIONS_CHANNEL = 1;
+
+// NaN goes to the lower bound
+float clampAction(float value, float low, float high) {
+    return value > high ? high : (value >= low ? value : low);
+}
+
+double wrapAngle(double angle) {
+    return std::remainder(angle, 2.0 * M_PI);
+}
+
+} // namespace
+
+FlightEnvBatch::FlightEnvBatch(size_t count, const FlightEnvConfig& newConfig)
+    : config(newConfig), count(count), instances(new Instance[count]), pool(newConfig.threads) {
+    config.substeps = std::max(1, config.substeps);
+    maxEpisodeSteps = (uint64_t)std::max(1.0, std::round(config.maxEpisodeSeconds / config.dt));
+    for (size_t i = 0; i < count; i++) {
+        instances[i].dynamics.setEarthFrame(config.earthFrame);
+        resetInstance(i);
+    }
+}
+
+// Uniformly random around the task targets; level-ish flight, any heading
+void FlightEnvBatch::resetInstance(size_t index) {
+    Instance& instance = instances[index];
+    float u[8];
+    CounterRng(config.seed, (uint32_t)index, INITIAL_CONDITIONS_CHANNEL).uniformBatch(instance.episode, u, 8);
+    instance.episode++;
+    instance.episodeSteps = 0;
+
+    AircraftState& state = instance.aircraft.getState();
+    state.position = Vector3(0, 0, -(config.targetAltitude + 400.0 * (u[0] - 0.5)));
+    state.velocity = Vector3(config.targetAirspeed + 20.0 * (u[1] - 0.5), 0, 0);
+    state.angularVelocity = Vector3(0, 0, 0);
+    state.roll = 0.6 * (u[2] - 0.5);
+    state.pitch = 0.2 * (u[3] - 0.5);
+    state.yaw = 2.0 * M_PI * (u[4] - 0.5);
+    state.elevator = 0.0;
+    state.aileron = 0.0;
+    state.rudder = 0.0;
+    state.throttle = 0.3 + 0.4 * u[5];
+    instance.dynamics.updateAirData();
+}
+
+void FlightEnvBatch::observe(size_t index, float* observation) const {
+    const Instance& instance = instances[index];
+    const AircraftState& state = instance.aircraft.getState();
+    const AirData& airData = instance.dynamics.getAirData();
+
+    observation[OBS_ALTITUDE_ERROR] = (float)((airData.altitude - config.targetAltitude) / 100.0);
+    observation[OBS_VERTICAL_SPEED] = (float)(airData.verticalSpeed / 10.0);
+    observation[OBS_AIRSPEED_ERROR] = (float)((airData.trueAirspeed - config.targetAirspeed) / 10.0);
+    observation[OBS_ALPHA] = (float)airData.alpha;
+    observation[OBS_BETA] = (float)airData.beta;
+    observation[OBS_ROLL] = (float)state.roll;
+    observation[OBS_PITCH] = (float)state.pitch;
+    observation[OBS_HEADING_ERROR] = (float)wrapAngle(state.yaw - config.targetHeading);
+    observation[OBS_ROLL_RATE] = (float)state.angularVelocity.x;
+    observation[OBS_PITCH_RATE] = (float)state.angularVelocity.y;
+    observation[OBS_YAW_RATE] = (float)state.angularVelocity.z;
+    observation[OBS_THROTTLE] = (float)state.throttle;
+}
+
+// Quadratic cost on the normalized tracking errors and bank angle
+float FlightEnvBatch::computeReward(size_t index) const {
+    const Instance& instance = instances[index];
+    const AircraftState& state = instance.aircraft.getState();
+    const AirData& airData = instance.dynamics.getAirData();
+
+    double altitudeError = (airData.altitude - config.targetAltitude) / 100.0;
+    double airspeedError = (airData.trueAirspeed - config.targetAirspeed) / 10.0;
+    double headingError = wrapAngle(state.yaw - config.targetHeading);
+    return (float)-(altitudeError * altitudeError + airspeedError * airspeedError +
+                    headingError * headingError + 0.1 * state.roll * state.roll);
+}
+
+void FlightEnvBatch::stepInstance(size_t index, const float* action, float* observation, float* reward,
+                                  uint8_t* done) {
+    Instance& instance = instances[index];
+    AircraftState& state = instance.aircraft.getState();
+    state.elevator = clampAction(action[ACTION_ELEVATOR], -1.0f, 1.0f);
+    state.aileron = clampAction(action[ACTION_AILERON], -1.0f, 1.0f);
+    state.rudder = clampAction(action[ACTION_RUDDER], -1.0f, 1.0f);
+    state.throttle = clampAction(action[ACTION_THROTTLE], 0.0f, 1.0f);
+
+    // FlightDynamics stops the aircraft on ground impact
+    const double physicsDt = config.dt / config.substeps;
+    bool crashed = false;
+    for (int i = 0; i < config.substeps && !crashed; i++) {
+        instance.dynamics.update(physicsDt);
+        crashed = instance.dynamics.isOnGround(state);
+    }
+    instance.steps++;
+    instance.episodeSteps++;
+
+    float stepReward = computeReward(index);
+    uint8_t stepDone = DONE_NONE;
+    if (crashed) {
+        stepReward -= (float)config.crashPenalty;
+        stepDone = DONE_CRASHED;
+        instance.crashes++;
+    } else if (instance.episodeSteps >= maxEpisodeSteps) {
+        stepDone = DONE_TIME_LIMIT;
+    }
+    if (stepDone != DONE_NONE) {
+        resetInstance(index);
+    }
+
+    observe(index, observation);
+    *reward = stepReward;
+    *done = stepDone;
+}
+
+void FlightEnvBatch::reset(float* observations) {
+    size_t blocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    pool.parallelFor(blocks, [&](size_t block) {
+        size_t end = std::min(count, (block + 1) * BLOCK_SIZE);
+        for (size_t i = block * BLOCK_SIZE; i < end; i++) {
+            resetInstance(i);
+            observe(i, observations + i * OBSERVATION_SIZE);
+        }
+    });
+}
+
+void FlightEnvBatch::step(const float* actions, float* observations, float* rewards, uint8_t* dones) {
+    size_t blocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    pool.parallelFor(blocks, [&](size_t block) {
+        size_t end = std::min(count, (block + 1) * BLOCK_SIZE);
+        for (size_t i = block * BLOCK_SIZE; i < end; i++) {
+            stepInstance(i, actions + i * ACTION_SIZE, observations + i * OBSERVATION_SIZE, rewards + i, dones + i);
+        }
+    });
+}
+
+uint64_t FlightEnvBatch::getStepCount() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++) total += instances[i].steps;
+    return total;
+}
+
+uint64_t FlightEnvBatch::getEpisodeCount() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++) total += instances[i].episode;
+    return total;
+}
+
+uint64_t FlightEnvBatch::getCrashCount() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++) total += instances[i].crashes;
+    return total;
+}
@@ -0,0 +1,429 @@
+#include "flight_envelope.hpp"
+#include "aircraft.hpp"
+#include "atmosphere.hpp"
+#include "flight_dynamics.hpp"
+#include "logger.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const double GRAVITY = 9.81;
+const int MAX_NEWTON_ITERATIONS = 25;
+const double RESIDUAL_TOLERANCE = 1e-7;     // m/s^2 and rad/s^2
+const double JACOBIAN_STEP = 1e-6;
+const int TURN_BISECTION_STEPS = 10;
+
+const char BINARY_MAGIC[4] = {'F', 'E', 'N', 'V'};
+const uint32_t BINARY_VERSION = 1;
+
+// Steady flight condition to trim for. Level trims solve for throttle;
+// climb trims hold full throttle and solve for the flight path angle.
+struct TrimRequest {
+    double airspeed;
+    double altitude;
+    double bank;          // Coordinated level turn when non-zero
+    bool climb;
+};
+
+// Unknowns (alpha, elevator, throttle or flight path angle) plus outcome
+struct TrimResult {
+    double x[3];
+    bool converged;
+
+    double alpha() const { return x[0]; }
+    double elevator() const { return x[1]; }
+};
+
+// Trims one aircraft at one weight by Newton iteration on the body-axis
+// accelerations u', w' and q' from FlightDynamics::computeDerivative.
+// Lateral accelerations are not trimmed (aileron and rudder stay centered).
+class TrimSolver {
+public:
+    explicit TrimSolver(double mass) : dynamics(&aircraft, &atmosphere) {
+        aircraft.setMass(mass);
+    }
+
+    // `result` holds the initial guess on entry
+    void solve(const TrimRequest& request, TrimResult& result) {
+        result.converged = false;
+        for (int iteration = 0; iteration < MAX_NEWTON_ITERATIONS; iteration++) {
+            double r[3];
+            residual(request, result.x, r);
+            if (!std::isfinite(r[0]) || !std::isfinite(r[1]) || !std::isfinite(r[2])) return;
+            if (std::fabs(r[0]) < RESIDUAL_TOLERANCE && std::fabs(r[1]) < RESIDUAL_TOLERANCE &&
+                std::fabs(r[2]) < RESIDUAL_TOLERANCE) {
+                result.converged = true;
+                return;
+            }
+
+            // Forward-difference Jacobian
+            double jacobian[3][3];
+            for (int j = 0; j < 3; j++) {
+                double x[3] = {result.x[0], result.x[1], result.x[2]};
+                x[j] += JACOBIAN_STEP;
+                double rj[3];
+                residual(request, x, rj);
+                for (int i = 0; i < 3; i++) {
+                    jacobian[i][j] = (rj[i] - r[i]) / JACOBIAN_STEP;
+                }
+            }
+
+            double step[3] = {-r[0], -r[1], -r[2]};
+            if (!solve3(jacobian, step)) return;
+
+            // Limit the step so a poor guess cannot jump to a far root
+            const double maxStep[3] = {0.1, 0.5, 0.5};
+            double scale = 1.0;
+            for (int i = 0; i < 3; i++) {
+                if (std::fabs(step[i]) * scale > maxStep[i]) scale = maxStep[i] / std::fabs(step[i]);
+            }
+            for (int i = 0; i < 3; i++) {
+                result.x[i] += step[i] * scale;
+            }
+        }
+    }
+
+    // Converged inside the stall, elevator and throttle limits
+    static bool feasible(const TrimRequest& request, const TrimResult& result) {
+        if (!result.converged) return false;
+        if (result.alpha() > FlightEnvelope::STALL_ALPHA) return false;
+        if (std::fabs(result.elevator()) > 1.0) return false;
+        return request.climb || (result.x[2] >= 0.0 && result.x[2] <= 1.0);
+    }
+
+    // 1 g stall speed: lift at the stall angle with the elevator that
+    // trims the pitching moment there
+    double stallSpeed(double altitude) {
+        double density, pressure, temperature, speedOfSound;
+        atmosphere.getProperties(altitude, density, pressure, temperature, speedOfSound);
+
+        double alpha = FlightEnvelope::STALL_ALPHA;
+        double cm0 = aircraft.getCm(alpha, 0.0);
+        double cm1 = aircraft.getCm(alpha, 1.0);
+        double elevator = std::max(-1.0, std::min(1.0, -cm0 / (cm1 - cm0)));
+        double clMax = aircraft.getCL(alpha, elevator);
+        return std::sqrt(2.0 * aircraft.getMass() * GRAVITY / (density * aircraft.getWingArea() * clMax));
+    }
+
+private:
+    void residual(const TrimRequest& request, const double x[3], double r[3]) {
+        double alpha = x[0];
+        double gamma = request.climb ? x[2] : 0.0;
+
+        AircraftState state = aircraft.getState();
+        state.position = Vector3(0, 0, -request.altitude);
+        state.velocity = Vector3(request.airspeed * std::cos(alpha), 0, request.airspeed * std::sin(alpha));
+        state.roll = request.bank;
+        state.yaw = 0.0;
+        state.elevator = x[1];
+        state.aileron = 0.0;
+        state.rudder = 0.0;
+        state.throttle = request.climb ? 1.0 : x[2];
+
+        // Pitch that gives flight path angle gamma at this bank and alpha
+        double a = std::cos(request.bank) * std::sin(alpha);
+        double b = std::cos(alpha);
+        double norm = std::sqrt(a * a + b * b);
+        state.pitch = std::atan2(a, b) + std::asin(std::max(-1.0, std::min(1.0, std::sin(gamma) / norm)));
+
+        // Coordinated turn rate about the vertical, in body axes
+        double omega = GRAVITY * std::tan(request.bank) / request.airspeed;
+        state.angularVelocity = Vector3(-omega * std::sin(state.pitch),
+                                        omega * std::sin(request.bank) * std::cos(state.pitch),
+                                        omega * std::cos(request.bank) * std::cos(state.pitch));
+
+        FlightDynamics::StateDerivative derivative = dynamics.computeDerivative(state);
+        r[0] = derivative.velocityDot.x;
+        r[1] = derivative.velocityDot.z;
+        r[2] = derivative.angularVelocityDot.y;
+    }
+
+    // Gaussian elimination with partial pivoting; b is replaced by the solution
+    static bool solve3(double a[3][3], double b[3]) {
+        for (int col = 0; col < 3; col++) {
+            int pivot = col;
+            for (int row = col + 1; row < 3; row++) {
+                if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) pivot = row;
+            }
+            if (std::fabs(a[pivot][col]) < 1e-12) return false;
+            if (pivot != col) {
+                for (int k = 0; k < 3; k++) std::swap(a[col][k], a[pivot][k]);
+                std::swap(b[col], b[pivot]);
+            }
+            for (int row = col + 1; row < 3; row++) {
+                double factor = a[row][col] / a[col][col];
+                for (int k = col; k < 3; k++) a[row][k] -= factor * a[col][k];
+                b[row] -= factor * b[col];
+            }
+        }
+        for (int row = 2; row >= 0; row--) {
+            for (int k = row + 1; k < 3; k++) b[row] -= a[row][k] * b[k];
+            b[row] /= a[row][row];
+        }
+        return true;
+    }
+
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics;
+};
+
+const TrimResult INITIAL_GUESS = {{0.05, 0.0, 0.5}, false};
+
+// Solve from the warm-start guess, falling back to the default guess
+void solveWithFallback(TrimSolver& solver, const TrimRequest& request, TrimResult& guess) {
+    TrimResult result = guess;
+    solver.solve(request, result);
+    if (!result.converged) {
+        result = INITIAL_GUESS;
+        solver.solve(request, result);
+    }
+    guess = result;
+}
+
+// One (weight, altitude) row across all airspeeds. Each row has its own
+// aircraft and dynamics, and warm-starts every trim from the previous speed.
+void evaluateRow(const EnvelopeGrid& grid, int weightIndex, int altitudeIndex, EnvelopeCell* out) {
+    const float nan = std::nanf("");
+    double altitude = grid.altitude.value(altitudeIndex);
+    TrimSolver solver(grid.weight.value(weightIndex));
+    double stallSpeed = solver.stallSpeed(altitude);
+
+    TrimResult level = INITIAL_GUESS;
+    TrimResult climb = INITIAL_GUESS;
+    climb.x[2] = 0.0;
+
+    for (int i = 0; i < grid.airspeed.count; i++) {
+        EnvelopeCell& cell = out[i];
+        double airspeed = grid.airspeed.value(i);
+        cell.stallMargin = (float)(airspeed / stallSpeed);
+
+        TrimRequest levelRequest = {airspeed, altitude, 0.0, false};
+        solveWithFallback(solver, levelRequest, level);
+        cell.trimmed = TrimSolver::feasible(levelRequest, level) ? 1 : 0;
+        cell.trimAlpha = level.converged ? (float)level.x[0] : nan;
+        cell.trimElevator = level.converged ? (float)level.x[1] : nan;
+        cell.trimThrottle = level.converged ? (float)level.x[2] : nan;
+
+        TrimRequest climbRequest = {airspeed, altitude, 0.0, true};
+        solveWithFallback(solver, climbRequest, climb);
+        cell.maxRateOfClimb = TrimSolver::feasible(climbRequest, climb)
+                                  ? (float)(airspeed * std::sin(climb.x[2]))
+                                  : nan;
+
+        cell.maxLoadFactor = nan;
+        cell.turnRate = nan;
+        cell.turnRadius = nan;
+        if (!cell.trimmed) continue;
+
+        // Highest load factor a level coordinated turn can hold
+        double feasibleN = 1.0, infeasibleN = FlightEnvelope::LOAD_FACTOR_LIMIT;
+        TrimResult turn = level;
+        auto turnFeasible = [&](double n) {
+            TrimRequest request = {airspeed, altitude, std::acos(1.0 / n), false};
+            TrimResult result = turn;
+            solver.solve(request, result);
+            if (!TrimSolver::feasible(request, result)) return false;
+            turn = result;
+            return true;
+        };
+        if (turnFeasible(FlightEnvelope::LOAD_FACTOR_LIMIT)) {
+            feasibleN = FlightEnvelope::LOAD_FACTOR_LIMIT;
+        } else {
+            for (int step = 0; step < TURN_BISECTION_STEPS; step++) {
+                double n = 0.5 * (feasibleN + infeasibleN);
+                if (turnFeasible(n)) {
+                    feasibleN = n;
+                } else {
+                    infeasibleN = n;
+                }
+            }
+        }
+
+        double lateral = GRAVITY * std::sqrt(feasibleN * feasibleN - 1.0);
+        cell.maxLoadFactor = (float)feasibleN;
+        cell.turnRate = (float)(lateral / airspeed);
+        cell.turnRadius = lateral > 0.0 ? (float)(airspeed * airspeed / lateral) : nan;
+    }
+}
+
+template <typename T>
+bool writeValue(FILE* file, const T& value) {
+    return std::fwrite(&value, sizeof(T), 1, file) == 1;
+}
+
+template <typename T>
+bool readValue(FILE* file, T& value) {
+    return std::fread(&value, sizeof(T), 1, file) == 1;
+}
+
+bool writeAxis(FILE* file, const EnvelopeAxis& axis) {
+    int32_t count = axis.count;
+    return writeValue(file, axis.min) && writeValue(file, axis.max) && writeValue(file, count);
+}
+
+bool readAxis(FILE* file, EnvelopeAxis& axis) {
+    int32_t count;
+    if (!readValue(file, axis.min) || !readValue(file, axis.max) || !readValue(file, count)) return false;
+    axis.count = count;
+    return count > 0 && count <= 4096;
+}
+
+} // namespace
+
+EnvelopeGrid EnvelopeGrid::standard() {
+    EnvelopeGrid grid;
+    grid.weight = {800.0, 1150.0, 8};
+    grid.altitude = {0.0, 4000.0, 33};
+    grid.airspeed = {20.0, 83.0, 64};
+    return grid;
+}
+
+void FlightEnvelope::generate(const EnvelopeGrid& newGrid, unsigned int threadCount) {
+    auto start = std::chrono::steady_clock::now();
+
+    grid = newGrid;
+    cells.assign(grid.cellCount(), EnvelopeCell());
+
+    ThreadPool pool(threadCount);
+    const EnvelopeGrid& g = grid;
+    EnvelopeCell* data = cells.data();
+    pool.parallelFor((size_t)g.weight.count * g.altitude.count, [&g, data](size_t row) {
+        evaluateRow(g, (int)(row / g.altitude.count), (int)(row % g.altitude.count),
+                    data + row * g.airspeed.count);
+    });
+
+    threadsUsed = pool.getThreadCount();
+    generateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+const char* FlightEnvelope::metricName(Metric metric) {
+    switch (metric) {
+        case METRIC_TRIMMED: return "Trim feasible";
+        case METRIC_TRIM_ALPHA: return "Trim alpha (deg)";
+        case METRIC_TRIM_ELEVATOR: return "Trim elevator";
+        case METRIC_TRIM_THROTTLE: return "Trim throttle";
+        case METRIC_STALL_MARGIN: return "Stall margin (V/Vs)";
+        case METRIC_RATE_OF_CLIMB: return "Max rate of climb (m/s)";
+        case METRIC_LOAD_FACTOR: return "Sustained load factor (g)";
+        case METRIC_TURN_RATE: return "Sustained turn rate (deg/s)";
+        case METRIC_TURN_RADIUS: return "Turn radius (m)";
+        case METRIC_COUNT: break;
+    }
+    return "?";
+}
+
+float FlightEnvelope::metricValue(const EnvelopeCell& cell, Metric metric) {
+    const float radToDeg = (float)(180.0 / M_PI);
+    switch (metric) {
+        case METRIC_TRIMMED: return cell.trimmed ? 1.0f : 0.0f;
+        case METRIC_TRIM_ALPHA: return cell.trimAlpha * radToDeg;
+        case METRIC_TRIM_ELEVATOR: return cell.trimElevator;
+        case METRIC_TRIM_THROTTLE: return cell.trimThrottle;
+        case METRIC_STALL_MARGIN: return cell.stallMargin;
+        case METRIC_RATE_OF_CLIMB: return cell.maxRateOfClimb;
+        case METRIC_LOAD_FACTOR: return cell.maxLoadFactor;
+        case METRIC_TURN_RATE: return cell.turnRate * radToDeg;
+        case METRIC_TURN_RADIUS: return cell.turnRadius;
+        case METRIC_COUNT: break;
+    }
+    return std::nanf("");
+}
+
+bool FlightEnvelope::saveBinary(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    bool ok = std::fwrite(BINARY_MAGIC, sizeof(BINARY_MAGIC), 1, file) == 1 &&
+              writeValue(file, BINARY_VERSION) && writeAxis(file, grid.weight) &&
+              writeAxis(file, grid.altitude) && writeAxis(file, grid.airspeed);
+    for (size_t i = 0; ok && i < cells.size(); i++) {
+        const EnvelopeCell& cell = cells[i];
+        ok = writeValue(file, cell.trimmed) && writeValue(file, cell.trimAlpha) &&
+             writeValue(file, cell.trimElevator) && writeValue(file, cell.trimThrottle) &&
+             writeValue(file, cell.stallMargin) && writeValue(file, cell.maxRateOfClimb) &&
+             writeValue(file, cell.maxLoadFactor) && writeValue(file, cell.turnRate) &&
+             writeValue(file, cell.turnRadius);
+    }
+
+    if (std::fclose(file) != 0) ok = false;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
+
+bool FlightEnvelope::loadBinary(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        LOG_ERROR("Failed to open %s", path.c_str());
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    EnvelopeGrid loadedGrid;
+    bool ok = std::fread(magic, sizeof(magic), 1, file) == 1 &&
+              std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0 &&
+              readValue(file, version) && version == BINARY_VERSION &&
+              readAxis(file, loadedGrid.weight) && readAxis(file, loadedGrid.altitude) &&
+              readAxis(file, loadedGrid.airspeed);
+
+    std::vector<EnvelopeCell> loadedCells(ok ? loadedGrid.cellCount() : 0);
+    for (size_t i = 0; ok && i < loadedCells.size(); i++) {
+        EnvelopeCell& cell = loadedCells[i];
+        ok = readValue(file, cell.trimmed) && readValue(file, cell.trimAlpha) &&
+             readValue(file, cell.trimElevator) && readValue(file, cell.trimThrottle) &&
+             readValue(file, cell.stallMargin) && readValue(file, cell.maxRateOfClimb) &&
+             readValue(file, cell.maxLoadFactor) && readValue(file, cell.turnRate) &&
+             readValue(file, cell.turnRadius);
+    }
+    std::fclose(file);
+
+    if (!ok) {
+        LOG_ERROR("%s is not a version %u envelope table", path.c_str(), BINARY_VERSION);
+        return false;
+    }
+    grid = loadedGrid;
+    cells.swap(loadedCells);
+    generateSeconds = 0.0;
+    threadsUsed = 0;
+    return true;
+}
+
+bool FlightEnvelope::saveCSV(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "mass,altitude,airspeed,trimmed,trim_alpha,trim_elevator,trim_throttle,"
+                       "stall_margin,max_rate_of_climb,max_load_factor,turn_rate,turn_radius\n");
+    for (int w = 0; w < grid.weight.count; w++) {
+        for (int a = 0; a < grid.altitude.count; a++) {
+            for (int v = 0; v < grid.airspeed.count; v++) {
+                const EnvelopeCell& cell = at(w, a, v);
+                std::fprintf(file, "%g,%g,%g,%d,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g\n",
+                             grid.weight.value(w), grid.altitude.value(a), grid.airspeed.value(v),
+                             (int)cell.trimmed, cell.trimAlpha, cell.trimElevator, cell.trimThrottle,
+                             cell.stallMargin, cell.maxRateOfClimb, cell.maxLoadFactor,
+                             cell.turnRate, cell.turnRadius);
+            }
+        }
+    }
+
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
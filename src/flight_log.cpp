@@ -0,0 +1,85 @@
+#include "flight_log.hpp"
+#include "logger.hpp"
+#include <cstdio>
+
+namespace {
+
+const char* CSV_HEADER =
+    "time,north,east,down,u,v,w,p,q,r,roll,pitch,yaw,elevator,aileron,rudder,throttle";
+const int CSV_COLUMNS = 17;
+
+} // namespace
+
+void FlightLog::record(double time, const AircraftState& state) {
+    FlightLogSample sample;
+    sample.time = time;
+    sample.state = state;
+    samples.push_back(sample);
+}
+
+double FlightLog::getDuration() const {
+    return samples.empty() ? 0.0 : samples.back().time - samples.front().time;
+}
+
+bool FlightLog::saveCSV(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "%s\n", CSV_HEADER);
+    for (const FlightLogSample& sample : samples) {
+        const AircraftState& s = sample.state;
+        std::fprintf(file,
+                     "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,"
+                     "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                     sample.time, s.position.x, s.position.y, s.position.z,
+                     s.velocity.x, s.velocity.y, s.velocity.z,
+                     s.angularVelocity.x, s.angularVelocity.y, s.angularVelocity.z,
+                     s.roll, s.pitch, s.yaw, s.elevator, s.aileron, s.rudder, s.throttle);
+    }
+
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
+
+bool FlightLog::loadCSV(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "r");
+    if (!file) {
+        LOG_ERROR("Failed to open %s", path.c_str());
+        return false;
+    }
+
+    samples.clear();
+    char line[1024];
+    int lineNumber = 0;
+    bool ok = true;
+
+    while (std::fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        if (lineNumber == 1 || line[0] == '\n') continue;   // Header
+
+        FlightLogSample sample;
+        AircraftState& s = sample.state;
+        int fields = std::sscanf(line,
+                                 "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf",
+                                 &sample.time, &s.position.x, &s.position.y, &s.position.z,
+                                 &s.velocity.x, &s.velocity.y, &s.velocity.z,
+                                 &s.angularVelocity.x, &s.angularVelocity.y, &s.angularVelocity.z,
+                                 &s.roll, &s.pitch, &s.yaw,
+                                 &s.elevator, &s.aileron, &s.rudder, &s.throttle);
+        if (fields != CSV_COLUMNS) {
+            LOG_ERROR("%s:%d: expected %d columns", path.c_str(), lineNumber, CSV_COLUMNS);
+            ok = false;
+            break;
+        }
+        samples.push_back(sample);
+    }
+
+    std::fclose(file);
+    return ok;
+}
@@ -0,0 +1,155 @@
+#include "flight_path_predictor.hpp"
+#include "atmosphere.hpp"
+#include "flight_dynamics.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+AircraftState addScaled(const AircraftState& state, const FlightDynamics::StateDerivative& deriv, double scale) {
+    AircraftState result = state;
+    result.position += deriv.positionDot * scale;
+    result.velocity += deriv.velocityDot * scale;
+    result.angularVelocity += deriv.angularVelocityDot * scale;
+    result.roll += deriv.eulerDot.x * scale;
+    result.pitch += deriv.eulerDot.y * scale;
+    result.yaw += deriv.eulerDot.z * scale;
+    return result;
+}
+
+} // namespace
+
+FlightPathPredictor::FlightPathPredictor()
+    : epoch(0), hasPath(false), stopping(false), predictions(0), totalMicroseconds(0.0), maxMicroseconds(0.0) {}
+
+FlightPathPredictor::~FlightPathPredictor() {
+    stop();
+}
+
+bool FlightPathPredictor::start(const PredictorConfig& newConfig) {
+    if (isRunning()) return false;
+    if (!(newConfig.horizon > 0.0 && newConfig.step > 0.0 && newConfig.rate > 0.0)) {
+        LOG_ERROR("Invalid flight-path predictor config (horizon %.3f s, step %.3f s, rate %.1f Hz)",
+                  newConfig.horizon, newConfig.step, newConfig.rate);
+        return false;
+    }
+    config = newConfig;
+    stopping = false;
+    predictions.store(0, std::memory_order_relaxed);
+    totalMicroseconds.store(0.0, std::memory_order_relaxed);
+    maxMicroseconds.store(0.0, std::memory_order_relaxed);
+    startTime = Clock::now();
+    worker = std::thread(&FlightPathPredictor::run, this);
+    return true;
+}
+
+void FlightPathPredictor::stop() {
+    if (!isRunning()) return;
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopCondition.notify_one();
+    worker.join();
+}
+
+void FlightPathPredictor::submit(const AircraftState& state, double simTime) {
+    Request& request = requests.write();
+    request.state = state;
+    request.simTime = simTime;
+    request.epoch = epoch;
+    requests.publish();
+}
+
+const PredictedPath* FlightPathPredictor::getLatest() {
+    if (paths.acquire()) hasPath = true;
+    if (!hasPath || paths.read().epoch != epoch) return nullptr;
+    return &paths.read();
+}
+
+FlightPathPredictor::Stats FlightPathPredictor::getStats() const {
+    Stats stats;
+    stats.predictions = predictions.load(std::memory_order_relaxed);
+    double total = totalMicroseconds.load(std::memory_order_relaxed);
+    stats.meanMicroseconds = stats.predictions > 0 ? total / stats.predictions : 0.0;
+    stats.maxMicroseconds = maxMicroseconds.load(std::memory_order_relaxed);
+    double wallMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - startTime).count();
+    stats.cpuShare = wallMicroseconds > 0.0 ? total / wallMicroseconds : 0.0;
+    return stats;
+}
+
+void FlightPathPredictor::run() {
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / config.rate));
+    Clock::time_point next = Clock::now();
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (!stopping) {
+        // Fixed wake-up rate; after an overrun the next run is a full period later
+        next = std::max(next + period, Clock::now());
+        if (stopCondition.wait_until(lock, next, [this] { return stopping; })) break;
+        if (!requests.acquire()) continue;   // Nothing new (e.g. paused)
+
+        lock.unlock();
+        auto begin = Clock::now();
+        PredictedPath& path = paths.write();
+        predict(requests.read(), path);
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+        path.computeMicroseconds = us;
+        paths.publish();
+
+        // Single writer: plain load/store is enough
+        predictions.store(predictions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        totalMicroseconds.store(totalMicroseconds.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+        maxMicroseconds.store(std::max(maxMicroseconds.load(std::memory_order_relaxed), us),
+                              std::memory_order_relaxed);
+        lock.lock();
+    }
+}
+
+void FlightPathPredictor::predict(const Request& request, PredictedPath& path) {
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    dynamics.setEarthFrame(config.earthFrame);
+
+    const int steps = std::max(1, (int)std::ceil(config.horizon / config.step));
+    const int stride = (steps + PredictedPath::MAX_POINTS - 2) / (PredictedPath::MAX_POINTS - 1);
+
+    path.simTime = request.simTime;
+    path.epoch = request.epoch;
+    path.pointInterval = stride * config.step;
+    path.timeToImpact = INFINITY;
+    path.impactPoint = Vector3();
+    path.points[0] = request.state.position;
+    path.count = 1;
+    // Height above the terrain, over the ellipsoid in round-earth mode
+    double height = dynamics.altitudeOf(request.state) - config.terrainElevation;
+    if (height <= 0.0) return;   // Already on the ground
+
+    AircraftState state = request.state;
+    for (int i = 1; i <= steps; i++) {
+        // Midpoint method: two derivatives per step
+        FlightDynamics::StateDerivative k1 = dynamics.computeDerivative(state);
+        FlightDynamics::StateDerivative k2 = dynamics.computeDerivative(addScaled(state, k1, 0.5 * config.step));
+        AircraftState nextState = addScaled(state, k2, config.step);
+        if (!std::isfinite(nextState.position.z)) break;
+
+        double nextHeight = dynamics.altitudeOf(nextState) - config.terrainElevation;
+        if (nextHeight <= 0.0) {
+            // Ground contact within this step, interpolated
+            double fraction = height / (height - nextHeight);
+            path.timeToImpact = (i - 1 + fraction) * config.step;
+            path.impactPoint = state.position + (nextState.position - state.position) * fraction;
+            path.count = std::min(path.count + 1, PredictedPath::MAX_POINTS);
+            path.points[path.count - 1] = path.impactPoint;
+            break;
+        }
+        state = nextState;
+        height = nextHeight;
+        if (i % stride == 0 && path.count < PredictedPath::MAX_POINTS) {
+            path.points[path.count++] = state.position;
+        }
+    }
+}
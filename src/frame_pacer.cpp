@@ -0,0 +1,141 @@
+#include "frame_pacer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+FramePacer::FramePacer()
+    : mode(PacingMode::VSYNC), targetHz(60.0), hasLastFrame(false),
+      intervals(), workTimes(), historyCount(0), historyIndex(0), stats() {
+    frameStart = Clock::now();
+    lastFrameEnd = frameStart;
+    nextDeadline = frameStart;
+}
+
+void FramePacer::setMode(PacingMode newMode) {
+    mode = newMode;
+    nextDeadline = Clock::now();
+    historyCount = 0;
+    historyIndex = 0;
+    stats = Stats();
+}
+
+void FramePacer::setTargetRate(double hz) {
+    targetHz = std::max(10.0, std::min(1000.0, hz));
+}
+
+void FramePacer::beginFrame() {
+    frameStart = Clock::now();
+}
+
+void FramePacer::endWork() {
+    std::chrono::duration<double, std::milli> work = Clock::now() - frameStart;
+    stats.lastWorkMs = work.count();
+    workTimes[historyIndex] = work.count();
+}
+
+void FramePacer::endFrame() {
+    if (mode == PacingMode::FIXED_RATE) {
+        auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / targetHz));
+        nextDeadline += period;
+
+        Clock::time_point now = Clock::now();
+        if (now > nextDeadline) {
+            // Missed the slot; re-anchor instead of trying to catch up
+            stats.lateFrames++;
+            nextDeadline = now;
+        } else {
+            waitUntil(nextDeadline);
+        }
+    }
+
+    Clock::time_point now = Clock::now();
+    if (hasLastFrame) {
+        std::chrono::duration<double, std::milli> interval = now - lastFrameEnd;
+        intervals[historyIndex] = interval.count();
+        historyIndex = (historyIndex + 1) % HISTORY;
+        historyCount = std::min(historyCount + 1, HISTORY);
+        updateStats();
+    }
+    lastFrameEnd = now;
+    hasLastFrame = true;
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) {
+    auto margin = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(SPIN_MARGIN_MS));
+
+    if (deadline - Clock::now() > margin) {
+        std::this_thread::sleep_until(deadline - margin);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::updateStats() {
+    double sum = 0.0, workSum = 0.0;
+    for (int i = 0; i < historyCount; i++) {
+        sum += intervals[i];
+        workSum += workTimes[i];
+    }
+    double mean = sum / historyCount;
+
+    double variance = 0.0, maxDeviation = 0.0;
+    for (int i = 0; i < historyCount; i++) {
+        double d = intervals[i] - mean;
+        variance += d * d;
+        maxDeviation = std::max(maxDeviation, std::abs(d));
+    }
+
+    stats.meanIntervalMs = mean;
+    stats.jitterMs = std::sqrt(variance / historyCount);
+    stats.maxDeviationMs = maxDeviation;
+    stats.meanWorkMs = workSum / historyCount;
+}
+
+FrameBudgetGovernor::FrameBudgetGovernor()
+    : enabled(true), budgetMs(14.0), smoothedMs(0.0), level(0),
+      overBudgetFrames(0), underBudgetFrames(0) {}
+
+void FrameBudgetGovernor::setEnabled(bool enable) {
+    enabled = enable;
+    if (!enabled) {
+        level = 0;
+        overBudgetFrames = 0;
+        underBudgetFrames = 0;
+    }
+}
+
+void FrameBudgetGovernor::update(double workMs) {
+    // Exponential moving average, ~0.25 s at 60 fps
+    smoothedMs = smoothedMs == 0.0 ? workMs : smoothedMs + (workMs - smoothedMs) * 0.06;
+    if (!enabled) return;
+
+    if (smoothedMs > budgetMs) {
+        underBudgetFrames = 0;
+        if (++overBudgetFrames >= DEGRADE_FRAMES && level < MAX_LEVEL) {
+            level++;
+            overBudgetFrames = 0;
+        }
+    } else if (smoothedMs < budgetMs * RECOVER_FRACTION) {
+        overBudgetFrames = 0;
+        if (++underBudgetFrames >= RECOVER_FRAMES && level > 0) {
+            level--;
+            underBudgetFrames = 0;
+        }
+    } else {
+        overBudgetFrames = 0;
+        underBudgetFrames = 0;
+    }
+}
+
+int FrameBudgetGovernor::getTelemetryLines() const {
+    static const int lines[MAX_LEVEL + 1] = {4, 4, 2, 0};
+    return lines[level];
+}
+
+int FrameBudgetGovernor::getSecondaryUpdateDivisor() const {
+    static const int divisors[MAX_LEVEL + 1] = {1, 2, 3, 6};
+    return divisors[level];
+}
@@ -0,0 +1,246 @@
+#include "geodesy.hpp"
+#include "fast_math.hpp"
+#include "fp_determinism.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+using namespace wgs84;
+
+// Points per pass of the batched conversions; the working set stays in L1
+const size_t CHUNK = 64;
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GEODESY_USE_SSE2 1
+
+// Two lanes with the arithmetic the templated formulas below need
+struct Lanes {
+    __m128d v;
+    Lanes(__m128d v) : v(v) {}
+    Lanes(double x) : v(_mm_set1_pd(x)) {}
+};
+
+inline Lanes operator+(Lanes a, Lanes b) { return _mm_add_pd(a.v, b.v); }
+inline Lanes operator-(Lanes a, Lanes b) { return _mm_sub_pd(a.v, b.v); }
+inline Lanes operator*(Lanes a, Lanes b) { return _mm_mul_pd(a.v, b.v); }
+inline Lanes operator/(Lanes a, Lanes b) { return _mm_div_pd(a.v, b.v); }
+inline Lanes squareRoot(Lanes a) { return _mm_sqrt_pd(a.v); }
+#endif
+
+inline double squareRoot(double a) { return std::sqrt(a); }
+
+// Geodetic latitude from ECEF as an unnormalised (sin, cos) pair: Bowring's
+// formula evaluated at the parametric latitude beta, starting from the
+// spherical guess tan(beta) = z / ((1 - f) p) and refined once through
+// tan(beta) = (1 - f) tan(phi). sin/cos of beta come from normalising,
+// so no trigonometric calls.
+template <typename T>
+inline void bowringLatitude(T p, T z, T& num, T& den) {
+    T sb = z, cb = T(1.0 - FLATTENING) * p;
+    for (int i = 0; i < 2; i++) {
+        T norm = T(1.0) / squareRoot(sb * sb + cb * cb);
+        sb = sb * norm;
+        cb = cb * norm;
+        num = z + T(SECOND_ECCENTRICITY_SQ * SEMI_MINOR_AXIS) * (sb * sb * sb);
+        den = p - T(ECCENTRICITY_SQ * SEMI_MAJOR_AXIS) * (cb * cb * cb);
+        sb = T(1.0 - FLATTENING) * num;
+        cb = den;
+    }
+}
+
+// Height above the ellipsoid of the point (p, z) at latitude (num, den)
+template <typename T>
+inline T ellipsoidHeight(T p, T z, T num, T den) {
+    T norm = T(1.0) / squareRoot(num * num + den * den);
+    T sinLat = num * norm, cosLat = den * norm;
+    return p * cosLat + z * sinLat - T(SEMI_MAJOR_AXIS) * squareRoot(T(1.0) - T(ECCENTRICITY_SQ) * (sinLat * sinLat));
+}
+
+inline Vector3 rotate(const Matrix<3, 3>& m, const Vector3& v) {
+    return Vector3(m(0, 0) * v.x + m(0, 1) * v.y + m(0, 2) * v.z,
+                   m(1, 0) * v.x + m(1, 1) * v.y + m(1, 2) * v.z,
+                   m(2, 0) * v.x + m(2, 1) * v.y + m(2, 2) * v.z);
+}
+
+inline Vector3 rotateTransposed(const Matrix<3, 3>& m, const Vector3& v) {
+    return Vector3(m(0, 0) * v.x + m(1, 0) * v.y + m(2, 0) * v.z,
+                   m(0, 1) * v.x + m(1, 1) * v.y + m(2, 1) * v.z,
+                   m(0, 2) * v.x + m(1, 2) * v.y + m(2, 2) * v.z);
+}
+
+} // namespace
+
+namespace geodesy {
+
+Vector3 geodeticToEcef(const Geodetic& position) {
+    double sinLat = std::sin(position.latitude), cosLat = std::cos(position.latitude);
+    double sinLon = std::sin(position.longitude), cosLon = std::cos(position.longitude);
+    double n = SEMI_MAJOR_AXIS / std::sqrt(1.0 - ECCENTRICITY_SQ * sinLat * sinLat);
+    double r = (n + position.altitude) * cosLat;
+    return Vector3(r * cosLon, r * sinLon, (n * (1.0 - ECCENTRICITY_SQ) + position.altitude) * sinLat);
+}
+
+Geodetic ecefToGeodetic(const Vector3& ecef) {
+    double p = std::sqrt(ecef.x * ecef.x + ecef.y * ecef.y);
+    double num, den;
+    bowringLatitude(p, ecef.z, num, den);
+
+    Geodetic result;
+    result.latitude = std::atan2(num, den);
+    result.longitude = std::atan2(ecef.y, ecef.x);
+    result.altitude = ellipsoidHeight(p, ecef.z, num, den);
+    return result;
+}
+
+LocalLevel ecefToLocalLevel(const Vector3& ecef) {
+    double p = std::sqrt(ecef.x * ecef.x + ecef.y * ecef.y);
+    double num, den;
+    bowringLatitude(p, ecef.z, num, den);
+    double norm = 1.0 / std::sqrt(num * num + den * den);
+
+    LocalLevel result;
+    result.sinLatitude = num * norm;
+    result.cosLatitude = den * norm;
+    result.sinLongitude = p > 0.0 ? ecef.y / p : 0.0;
+    result.cosLongitude = p > 0.0 ? ecef.x / p : 1.0;
+    result.altitude = ellipsoidHeight(p, ecef.z, num, den);
+    result.gravity = normalGravityAt(result.sinLatitude, result.altitude);
+    return result;
+}
+
+void geodeticToEcef(const double* latitude, const double* longitude, const double* altitude, double* x, double* y,
+                    double* z, size_t count) {
+    double sinLat[CHUNK], cosLat[CHUNK], sinLon[CHUNK], cosLon[CHUNK];
+    for (size_t begin = 0; begin < count; begin += CHUNK) {
+        size_t n = std::min(CHUNK, count - begin);
+        fastmath::sincos(latitude + begin, sinLat, cosLat, n);
+        fastmath::sincos(longitude + begin, sinLon, cosLon, n);
+        for (size_t i = 0; i < n; i++) {
+            double radius = SEMI_MAJOR_AXIS / std::sqrt(1.0 - ECCENTRICITY_SQ * sinLat[i] * sinLat[i]);
+            double r = (radius + altitude[begin + i]) * cosLat[i];
+            x[begin + i] = r * cosLon[i];
+            y[begin + i] = r * sinLon[i];
+            z[begin + i] = (radius * (1.0 - ECCENTRICITY_SQ) + altitude[begin + i]) * sinLat[i];
+        }
+    }
+}
+
+void ecefToGeodetic(const double* x, const double* y, const double* z, double* latitude, double* longitude,
+                    double* altitude, size_t count) {
+    double num[CHUNK], den[CHUNK];
+    for (size_t begin = 0; begin < count; begin += CHUNK) {
+        size_t n = std::min(CHUNK, count - begin);
+        size_t i = 0;
+#ifdef GEODESY_USE_SSE2
+        for (; i + 2 <= n; i += 2) {
+            Lanes xv = _mm_loadu_pd(x + begin + i), yv = _mm_loadu_pd(y + begin + i);
+            Lanes zv = _mm_loadu_pd(z + begin + i);
+            Lanes p = squareRoot(xv * xv + yv * yv);
+            Lanes numv = 0.0, denv = 0.0;
+            bowringLatitude(p, zv, numv, denv);
+            _mm_storeu_pd(num + i, numv.v);
+            _mm_storeu_pd(den + i, denv.v);
+            _mm_storeu_pd(altitude + begin + i, ellipsoidHeight(p, zv, numv, denv).v);
+        }
+#endif
+        for (; i < n; i++) {
+            double p = std::sqrt(x[begin + i] * x[begin + i] + y[begin + i] * y[begin + i]);
+            bowringLatitude(p, z[begin + i], num[i], den[i]);
+            altitude[begin + i] = ellipsoidHeight(p, z[begin + i], num[i], den[i]);
+        }
+        fastmath::atan2(num, den, latitude + begin, n);
+        fastmath::atan2(y + begin, x + begin, longitude + begin, n);
+    }
+}
+
+double normalGravity(double latitude, double altitude) {
+    return normalGravityAt(std::sin(latitude), altitude);
+}
+
+double normalGravityAt(double sinLatitude, double altitude) {
+    double s2 = sinLatitude * sinLatitude;
+    double surface = GRAVITY_EQUATOR * (1.0 + SOMIGLIANA_K * s2) / std::sqrt(1.0 - ECCENTRICITY_SQ * s2);
+    double h = altitude / SEMI_MAJOR_AXIS;
+    return surface * (1.0 - 2.0 * (1.0 + FLATTENING + GRAVITY_RATIO_M - 2.0 * FLATTENING * s2) * h + 3.0 * h * h);
+}
+
+void radiiOfCurvature(double latitude, double& meridian, double& primeVertical) {
+    double s = std::sin(latitude);
+    double w2 = 1.0 - ECCENTRICITY_SQ * s * s;
+    primeVertical = SEMI_MAJOR_AXIS / std::sqrt(w2);
+    meridian = primeVertical * (1.0 - ECCENTRICITY_SQ) / w2;
+}
+
+Matrix<3, 3> ecefToNedRotation(double latitude, double longitude) {
+    double sinLat = std::sin(latitude), cosLat = std::cos(latitude);
+    double sinLon = std::sin(longitude), cosLon = std::cos(longitude);
+    Matrix<3, 3> m;
+    m(0, 0) = -sinLat * cosLon; m(0, 1) = -sinLat * sinLon; m(0, 2) = cosLat;
+    m(1, 0) = -sinLon;          m(1, 1) = cosLon;           m(1, 2) = 0.0;
+    m(2, 0) = -cosLat * cosLon; m(2, 1) = -cosLat * sinLon; m(2, 2) = -sinLat;
+    return m;
+}
+
+} // namespace geodesy
+
+NedFrame::NedFrame(const Geodetic& origin)
+    : origin(origin), originEcef(geodesy::geodeticToEcef(origin)),
+      rotation(geodesy::ecefToNedRotation(origin.latitude, origin.longitude)) {}
+
+Vector3 NedFrame::ecefToNed(const Vector3& ecef) const {
+    return rotate(rotation, ecef - originEcef);
+}
+
+Vector3 NedFrame::nedToEcef(const Vector3& ned) const {
+    return rotateTransposed(rotation, ned) + originEcef;
+}
+
+Vector3 NedFrame::geodeticToNed(const Geodetic& position) const {
+    return ecefToNed(geodesy::geodeticToEcef(position));
+}
+
+Geodetic NedFrame::nedToGeodetic(const Vector3& ned) const {
+    return geodesy::ecefToGeodetic(nedToEcef(ned));
+}
+
+LocalLevel NedFrame::nedToLocalLevel(const Vector3& ned) const {
+    return geodesy::ecefToLocalLevel(nedToEcef(ned));
+}
+
+void NedFrame::geodeticToNed(const Geodetic* positions, Vector3* ned, size_t count) const {
+    double a[3][CHUNK], b[3][CHUNK];
+    for (size_t begin = 0; begin < count; begin += CHUNK) {
+        size_t n = std::min(CHUNK, count - begin);
+        for (size_t i = 0; i < n; i++) {
+            a[0][i] = positions[begin + i].latitude;
+            a[1][i] = positions[begin + i].longitude;
+            a[2][i] = positions[begin + i].altitude;
+        }
+        geodesy::geodeticToEcef(a[0], a[1], a[2], b[0], b[1], b[2], n);
+        for (size_t i = 0; i < n; i++) {
+            ned[begin + i] = ecefToNed(Vector3(b[0][i], b[1][i], b[2][i]));
+        }
+    }
+}
+
+void NedFrame::nedToGeodetic(const Vector3* ned, Geodetic* positions, size_t count) const {
+    double a[3][CHUNK], b[3][CHUNK];
+    for (size_t begin = 0; begin < count; begin += CHUNK) {
+        size_t n = std::min(CHUNK, count - begin);
+        for (size_t i = 0; i < n; i++) {
+            Vector3 ecef = nedToEcef(ned[begin + i]);
+            a[0][i] = ecef.x;
+            a[1][i] = ecef.y;
+            a[2][i] = ecef.z;
+        }
+        geodesy::ecefToGeodetic(a[0], a[1], a[2], b[0], b[1], b[2], n);
+        for (size_t i = 0; i < n; i++) {
+            positions[begin + i] = Geodetic{b[0][i], b[1][i], b[2][i]};
+        }
+    }
+}
@@ -1,94 +1,228 @@
 #include "input_handler.hpp"
-#include <cstring>
 #include <algorithm>
+#include <cmath>
 
-InputHandler::InputHandler() 
+InputHandler* InputHandler::instance = nullptr;
+GLFWkeyfun InputHandler::previousCallback = nullptr;
+
+InputHandler::InputHandler()
     : paused(false), resetRequested(false),
-      elevatorInput(0.0), aileronInput(0.0), rudderInput(0.0), throttleInput(0.5) {
-    std::memset(keyStates, 0, sizeof(keyStates));
+      elevatorInput(0.0), aileronInput(0.0), rudderInput(0.0), throttleInput(0.5),
+      droppedEvents(0), stepEventCount(0),
+      latencyIndex(0), latencyCount(0), latencySum(0.0), latencyMax(0.0) {
+    for (int i = 0; i < KEY_SLOT_COUNT; i++) {
+        keyDown[i] = false;
+        keyHeld[i] = 0.0;
+    }
 }
 
-void InputHandler::update(GLFWwindow* window, Aircraft& aircraft, double dt) {
-    AircraftState& state = aircraft.getState();
-    
-    // Check for pause toggle
-    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && !keyStates[GLFW_KEY_P]) {
-        togglePause();
-    }
-    keyStates[GLFW_KEY_P] = (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS);
-    
-    // Check for reset
-    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS && !keyStates[GLFW_KEY_R]) {
-        resetRequested = true;
-    }
-    keyStates[GLFW_KEY_R] = (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS);
-    
+InputHandler::~InputHandler() {
+    if (instance == this) {
+        instance = nullptr;
+    }
+}
+
+void InputHandler::attach(GLFWwindow* window) {
+    instance = this;
+    GLFWkeyfun previous = glfwSetKeyCallback(window, keyCallback);
+    if (previous != keyCallback) {
+        previousCallback = previous;
+    }
+}
+
+void InputHandler::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    // Stamp first so the chained callback is not counted as latency
+    Clock::time_point now = Clock::now();
+    if (instance && action != GLFW_REPEAT) {
+        instance->pushEvent(key, action, now);
+    }
+    if (previousCallback) {
+        previousCallback(window, key, scancode, action, mods);
+    }
+}
+
+bool InputHandler::pushEvent(int key, int action, Clock::time_point time) {
+    InputEvent event = {key, action, time};
+    if (!events.push(event)) {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+int InputHandler::keySlot(int key) {
+    switch (key) {
+        case GLFW_KEY_W:         return KEY_W;
+        case GLFW_KEY_UP:        return KEY_UP;
+        case GLFW_KEY_S:         return KEY_S;
+        case GLFW_KEY_DOWN:      return KEY_DOWN;
+        case GLFW_KEY_A:         return KEY_A;
+        case GLFW_KEY_LEFT:      return KEY_LEFT;
+        case GLFW_KEY_D:         return KEY_D;
+        case GLFW_KEY_RIGHT:     return KEY_RIGHT;
+        case GLFW_KEY_Q:         return KEY_Q;
+        case GLFW_KEY_E:         return KEY_E;
+        case GLFW_KEY_Z:         return KEY_Z;
+        case GLFW_KEY_PAGE_UP:   return KEY_PAGE_UP;
+        case GLFW_KEY_X:         return KEY_X;
+        case GLFW_KEY_PAGE_DOWN: return KEY_PAGE_DOWN;
+        case GLFW_KEY_SPACE:     return KEY_SPACE;
+        default:                 return -1;
+    }
+}
+
+void InputHandler::handleEvent(const InputEvent& event, Clock::time_point stepStart) {
+    if (event.action == GLFW_PRESS) {
+        if (event.key == GLFW_KEY_P) togglePause();
+        if (event.key == GLFW_KEY_R) resetRequested = true;
+    }
+
+    int slot = keySlot(event.key);
+    if (slot < 0) return;
+
+    // Events that arrived late (before this step's slot) count from the slot start
+    Clock::time_point t = std::max(event.time, stepStart);
+    if (event.action == GLFW_PRESS && !keyDown[slot]) {
+        keyDown[slot] = true;
+        keyDownSince[slot] = t;
+    } else if (event.action == GLFW_RELEASE && keyDown[slot]) {
+        std::chrono::duration<double> held = t - std::max(keyDownSince[slot], stepStart);
+        keyHeld[slot] += std::max(0.0, held.count());
+        keyDown[slot] = false;
+    }
+
+    if (stepEventCount < MAX_STEP_EVENTS) {
+        stepEventTimes[stepEventCount++] = event.time;
+    }
+}
+
+void InputHandler::syncControls(const AircraftState& state) {
+    elevatorInput = state.elevator;
+    aileronInput = state.aileron;
+    rudderInput = state.rudder;
+    throttleInput = state.throttle;
+}
+
+void InputHandler::applyStep(Aircraft& aircraft, Clock::time_point stepEnd, double dt) {
+    Clock::time_point stepStart = stepEnd - std::chrono::duration_cast<Clock::duration>(
+                                               std::chrono::duration<double>(dt));
+
+    for (int i = 0; i < KEY_SLOT_COUNT; i++) {
+        keyHeld[i] = 0.0;
+    }
+    stepEventCount = 0;
+
+    const InputEvent* event;
+    while ((event = events.peek()) != nullptr && event->time <= stepEnd) {
+        handleEvent(*event, stepStart);
+        events.discard();
+    }
+
+    // Keys still down were held until the end of the step
+    for (int i = 0; i < KEY_SLOT_COUNT; i++) {
+        if (keyDown[i]) {
+            std::chrono::duration<double> held = stepEnd - std::max(keyDownSince[i], stepStart);
+            keyHeld[i] += std::max(0.0, held.count());
+        }
+        keyHeld[i] = std::min(keyHeld[i], dt);
+    }
+
     if (paused) return;
-    
-    // Elevator control (pitch) - W/S or Up/Down
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS || 
-        glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-        elevatorInput += CONTROL_RATE * dt;
-    }
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS || 
-        glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-        elevatorInput -= CONTROL_RATE * dt;
-    }
-    
-    // Aileron control (roll) - A/D or Left/Right
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || 
-        glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-        aileronInput -= CONTROL_RATE * dt;
-    }
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || 
-        glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-        aileronInput += CONTROL_RATE * dt;
-    }
-    
-    // Rudder control (yaw) - Q/E
-    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) {
-        rudderInput -= CONTROL_RATE * dt;
-    }
-    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) {
-        rudderInput += CONTROL_RATE * dt;
-    }
-    
-    // Throttle control - Z/X or PageUp/PageDown
-    if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS || 
-        glfwGetKey(window, GLFW_KEY_PAGE_UP) == GLFW_PRESS) {
-        throttleInput += THROTTLE_RATE * dt;
-    }
-    if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS || 
-        glfwGetKey(window, GLFW_KEY_PAGE_DOWN) == GLFW_PRESS) {
-        throttleInput -= THROTTLE_RATE * dt;
-    }
-    
+
+    // Either key of a pair moves the control; overlapping presses count once
+    auto held = [this](int first, int second) {
+        return std::max(keyHeld[first], keyHeld[second]);
+    };
+
+    elevatorInput += CONTROL_RATE * (held(KEY_W, KEY_UP) - held(KEY_S, KEY_DOWN));
+    aileronInput += CONTROL_RATE * (held(KEY_D, KEY_RIGHT) - held(KEY_A, KEY_LEFT));
+    rudderInput += CONTROL_RATE * (keyHeld[KEY_E] - keyHeld[KEY_Q]);
+    throttleInput += THROTTLE_RATE * (held(KEY_Z, KEY_PAGE_UP) - held(KEY_X, KEY_PAGE_DOWN));
+
     // Center controls - Space
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-        elevatorInput *= 0.95;
-        aileronInput *= 0.95;
-        rudderInput *= 0.95;
-    }
-    
-    // Apply deadzone and return to center when no input
-    auto applyDeadzone = [dt](double& value) {
+    if (keyHeld[KEY_SPACE] > 0.0) {
+        double centering = std::exp(-CENTER_KEY_RATE * keyHeld[KEY_SPACE]);
+        elevatorInput *= centering;
+        aileronInput *= centering;
+        rudderInput *= centering;
+    }
+
+    // Apply deadzone and return to center at a fixed rate per second
+    double returnFactor = std::exp(-RETURN_RATE * dt);
+    auto applyDeadzone = [returnFactor](double& value) {
         if (std::abs(value) < 0.01) value = 0.0;
         value = std::max(-1.0, std::min(1.0, value));
-        // Gradual return to center
-        value *= 0.98;
+        value *= returnFactor;
     };
-    
+
     applyDeadzone(elevatorInput);
     applyDeadzone(aileronInput);
     applyDeadzone(rudderInput);
-    
+
     // Clamp throttle
     throttleInput = std::max(0.0, std::min(1.0, throttleInput));
-    
+
     // Apply to aircraft
+    AircraftState& state = aircraft.getState();
     state.elevator = elevatorInput;
     state.aileron = aileronInput;
     state.rudder = rudderInput;
     state.throttle = throttleInput;
+
+    // The controls now reflect every event consumed this step
+    if (stepEventCount > 0) {
+        Clock::time_point now = Clock::now();
+        for (int i = 0; i < stepEventCount; i++) {
+            recordLatency(stepEventTimes[i], now);
+        }
+    }
+}
+
+void InputHandler::skipTo(Clock::time_point time) {
+    const InputEvent* event;
+    while ((event = events.peek()) != nullptr && event->time <= time) {
+        handleEvent(*event, time);
+        events.discard();
+    }
+    stepEventCount = 0;
 }
 
+void InputHandler::recordLatency(Clock::time_point eventTime, Clock::time_point now) {
+    std::chrono::duration<double, std::micro> latency = now - eventTime;
+    double us = latency.count();
+
+    latencySamples[latencyIndex] = us;
+    latencyIndex = (latencyIndex + 1) % LATENCY_HISTORY;
+    latencyCount++;
+    latencySum += us;
+    latencyMax = std::max(latencyMax, us);
+}
+
+InputHandler::LatencyStats InputHandler::getLatencyStats() const {
+    LatencyStats stats = {};
+    stats.droppedEvents = droppedEvents.load(std::memory_order_relaxed);
+    stats.samples = latencyCount;
+    if (latencyCount == 0) return stats;
+
+    int count = (int)std::min<uint64_t>(latencyCount, LATENCY_HISTORY);
+    int last = (latencyIndex + LATENCY_HISTORY - 1) % LATENCY_HISTORY;
+
+    double sorted[LATENCY_HISTORY];
+    std::copy(latencySamples, latencySamples + count, sorted);
+    int p99 = std::min(count - 1, (int)(count * 0.99));
+    std::nth_element(sorted, sorted + p99, sorted + count);
+
+    stats.lastUs = latencySamples[last];
+    stats.meanUs = latencySum / (double)latencyCount;
+    stats.p99Us = sorted[p99];
+    stats.maxUs = latencyMax;
+    return stats;
+}
+
+void InputHandler::resetLatencyStats() {
+    latencyIndex = 0;
+    latencyCount = 0;
+    latencySum = 0.0;
+    latencyMax = 0.0;
+    droppedEvents.store(0, std::memory_order_relaxed);
+}
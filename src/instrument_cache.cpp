@@ -0,0 +1,94 @@
+#include "instrument_cache.hpp"
+
+InstrumentGeometryCache::InstrumentGeometryCache() : enabled(true), bakeCount(0) {
+    invalidate();
+}
+
+InstrumentGeometryCache::~InstrumentGeometryCache() {}
+
+void InstrumentGeometryCache::invalidate() {
+    for (Layer& layer : layers) {
+        layer.valid = false;
+    }
+}
+
+int InstrumentGeometryCache::getCachedVertexCount() const {
+    int count = 0;
+    for (const Layer& layer : layers) {
+        if (layer.valid) count += (int)layer.vertices.size();
+    }
+    return count;
+}
+
+void InstrumentGeometryCache::draw(ImDrawList* drawList, DialLayer id, ImVec2 center,
+                                   float radius, BuildFn build) {
+    if (!enabled) {
+        build(drawList, center, radius);
+        return;
+    }
+
+    Layer& layer = layers[(int)id];
+    ImTextureID texture = ImGui::GetIO().Fonts->TexID;
+    if (!layer.valid || layer.radius != radius || layer.fontSize != ImGui::GetFontSize() ||
+        layer.texture != texture) {
+        bake(layer, radius, build);
+    }
+
+    replay(drawList, layer, center);
+}
+
+void InstrumentGeometryCache::bake(Layer& layer, float radius, BuildFn build) {
+    if (!scratch) {
+        scratch.reset(new ImDrawList(ImGui::GetDrawListSharedData()));
+    }
+
+    // Build around the origin with an unbounded clip rect so no glyph is culled
+    ImDrawList* list = scratch.get();
+    list->_ResetForNewFrame();
+    list->PushTextureID(ImGui::GetIO().Fonts->TexID);
+    list->PushClipRect(ImVec2(-8192.0f, -8192.0f), ImVec2(8192.0f, 8192.0f));
+
+    build(list, ImVec2(0.0f, 0.0f), radius);
+
+    list->PopClipRect();
+    list->PopTextureID();
+
+    // Everything uses the font atlas (glyphs and the white pixel), so the
+    // layer is a single vertex/index range starting at vertex 0
+    layer.vertices.assign(list->VtxBuffer.Data, list->VtxBuffer.Data + list->VtxBuffer.Size);
+    layer.indices.assign(list->IdxBuffer.Data, list->IdxBuffer.Data + list->IdxBuffer.Size);
+    layer.radius = radius;
+    layer.fontSize = ImGui::GetFontSize();
+    layer.texture = ImGui::GetIO().Fonts->TexID;
+    layer.valid = true;
+
+    bakeCount++;
+}
+
+void InstrumentGeometryCache::replay(ImDrawList* drawList, const Layer& layer, ImVec2 center) const {
+    int vtxCount = (int)layer.vertices.size();
+    int idxCount = (int)layer.indices.size();
+    if (vtxCount == 0 || idxCount == 0) return;
+
+    // PrimReserve may start a new command with a fresh vertex offset, so the
+    // index base is read afterwards
+    drawList->PrimReserve(idxCount, vtxCount);
+
+    ImDrawVert* vtx = drawList->_VtxWritePtr;
+    ImDrawIdx* idx = drawList->_IdxWritePtr;
+    unsigned int base = drawList->_VtxCurrentIdx;
+
+    for (int i = 0; i < vtxCount; i++) {
+        const ImDrawVert& src = layer.vertices[i];
+        vtx[i].pos = ImVec2(src.pos.x + center.x, src.pos.y + center.y);
+        vtx[i].uv = src.uv;
+        vtx[i].col = src.col;
+    }
+    for (int i = 0; i < idxCount; i++) {
+        idx[i] = (ImDrawIdx)(base + layer.indices[i]);
+    }
+
+    drawList->_VtxWritePtr += vtxCount;
+    drawList->_IdxWritePtr += idxCount;
+    drawList->_VtxCurrentIdx += vtxCount;
+}
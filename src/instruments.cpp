@@ -1,5 +1,6 @@
 #include "instruments.hpp"
 #include "imgui.h"
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 
@@ -7,14 +8,142 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-Instruments::Instruments() {}
+namespace {
 
-void Instruments::render(const Aircraft& aircraft) {
+const ImU32 FACE_COLOR = IM_COL32(30, 30, 30, 255);
+const ImU32 SCALE_COLOR = IM_COL32(200, 200, 200, 255);
+const ImU32 SKY_COLOR = IM_COL32(100, 150, 255, 255);
+const ImU32 GROUND_COLOR = IM_COL32(139, 90, 43, 255);
+const ImU32 SYMBOL_COLOR = IM_COL32(255, 255, 0, 255);
+
+// Static dial layers. These draw around an arbitrary center so they can be
+// baked once by InstrumentGeometryCache and replayed every frame.
+
+void drawDialFace(ImDrawList* drawList, ImVec2 center, float radius) {
+    drawList->AddCircleFilled(center, radius, FACE_COLOR);
+    drawList->AddCircle(center, radius, SCALE_COLOR, 0, 2.0f);
+}
+
+void buildAirspeedDial(ImDrawList* drawList, ImVec2 center, float radius) {
+    drawDialFace(drawList, center, radius);
+    
+    // Scale markings (0-200 knots)
+    for (int i = 0; i <= 200; i += 20) {
+        float angle = -120.0f + (240.0f * i / 200.0f);
+        float rad = angle * M_PI / 180.0f;
+        float innerRadius = (i % 40 == 0) ? radius - 15.0f : radius - 10.0f;
+        
+        ImVec2 p1(center.x + std::cos(rad) * innerRadius,
+                  center.y + std::sin(rad) * innerRadius);
+        ImVec2 p2(center.x + std::cos(rad) * radius,
+                  center.y + std::sin(rad) * radius);
+        
+        drawList->AddLine(p1, p2, SCALE_COLOR, 2.0f);
+        
+        if (i % 40 == 0) {
+            char label[8];
+            snprintf(label, sizeof(label), "%d", i);
+            ImVec2 textPos(center.x + std::cos(rad) * (radius - 25.0f) - 10,
+                          center.y + std::sin(rad) * (radius - 25.0f) - 7);
+            drawList->AddText(textPos, SCALE_COLOR, label);
+        }
+    }
+}
+
+void buildAltimeterDial(ImDrawList* drawList, ImVec2 center, float radius) {
+    drawDialFace(drawList, center, radius);
+    
+    // Scale markings (0-10000 feet)
+    for (int i = 0; i <= 10; i++) {
+        float angle = -120.0f + (240.0f * i / 10.0f);
+        float rad = angle * M_PI / 180.0f;
+        float innerRadius = radius - 15.0f;
+        
+        ImVec2 p1(center.x + std::cos(rad) * innerRadius,
+                  center.y + std::sin(rad) * innerRadius);
+        ImVec2 p2(center.x + std::cos(rad) * radius,
+                  center.y + std::sin(rad) * radius);
+        
+        drawList->AddLine(p1, p2, SCALE_COLOR, 2.0f);
+        
+        char label[8];
+        snprintf(label, sizeof(label), "%d", i);
+        ImVec2 textPos(center.x + std::cos(rad) * (radius - 25.0f) - 5,
+                      center.y + std::sin(rad) * (radius - 25.0f) - 7);
+        drawList->AddText(textPos, SCALE_COLOR, label);
+    }
+}
+
+void buildVerticalSpeedDial(ImDrawList* drawList, ImVec2 center, float radius) {
+    drawDialFace(drawList, center, radius);
+    
+    // Scale markings (-2000 to +2000 fpm)
+    int marks[] = {-20, -10, 0, 10, 20};
+    for (int i = 0; i < 5; i++) {
+        float angle = -120.0f + (i * 60.0f);
+        float rad = angle * M_PI / 180.0f;
+        
+        ImVec2 p1(center.x + std::cos(rad) * (radius - 15.0f),
+                  center.y + std::sin(rad) * (radius - 15.0f));
+        ImVec2 p2(center.x + std::cos(rad) * radius,
+                  center.y + std::sin(rad) * radius);
+        
+        drawList->AddLine(p1, p2, SCALE_COLOR, 2.0f);
+        
+        char label[8];
+        snprintf(label, sizeof(label), "%d", marks[i]);
+        ImVec2 textPos(center.x + std::cos(rad) * (radius - 30.0f) - 10,
+                      center.y + std::sin(rad) * (radius - 30.0f) - 7);
+        drawList->AddText(textPos, SCALE_COLOR, label);
+    }
+}
+
+void buildAttitudeSky(ImDrawList* drawList, ImVec2 center, float radius) {
+    drawList->AddCircleFilled(center, radius, SKY_COLOR);
+}
+
+void buildAttitudeOverlay(ImDrawList* drawList, ImVec2 center, float radius) {
+    // Outer ring
+    drawList->AddCircle(center, radius, SCALE_COLOR, 0, 2.0f);
+    
+    // Aircraft symbol (fixed)
+    drawList->AddLine(ImVec2(center.x - 30, center.y), 
+                     ImVec2(center.x - 10, center.y), 
+                     SYMBOL_COLOR, 3.0f);
+    drawList->AddLine(ImVec2(center.x + 10, center.y), 
+                     ImVec2(center.x + 30, center.y), 
+                     SYMBOL_COLOR, 3.0f);
+    drawList->AddCircleFilled(center, 3.0f, SYMBOL_COLOR);
+}
+
+void buildTurnCoordinatorFace(ImDrawList* drawList, ImVec2 center, float radius) {
+    // Square face, radius is half the side
+    ImVec2 pMin(center.x - radius, center.y - radius);
+    ImVec2 pMax(center.x + radius, center.y + radius);
+    drawList->AddRectFilled(pMin, pMax, FACE_COLOR);
+    drawList->AddRect(pMin, pMax, SCALE_COLOR, 0.0f, 0, 2.0f);
+}
+
+} // namespace
+
+Instruments::Instruments()
+    : gaugeRadius(70.0f), reducedDetail(false), telemetryLines(4),
+      secondaryDivisor(1), sampleCounter(0), secondaryState(), secondaryAirData() {}
+
+void Instruments::sampleSecondary(const AircraftState& state, const AirData& airData) {
+    // The primary gauges always use the live state
+    if (sampleCounter++ % secondaryDivisor == 0) {
+        secondaryState = state;
+        secondaryAirData = airData;
+    }
+}
+
+void Instruments::render(const Aircraft& aircraft, const AirData& airData) {
     const AircraftState& state = aircraft.getState();
     
-    double altitude = aircraft.getAltitude();
-    double airspeed = aircraft.getAirspeed();
-    double verticalSpeed = aircraft.getVerticalSpeed();
+    double altitude = airData.altitude;
+    double airspeed = airData.indicatedAirspeed;
+    double verticalSpeed = airData.verticalSpeed;
     double heading = state.yaw * 180.0 / M_PI;
     if (heading < 0) heading += 360.0;
     
@@ -27,8 +156,13 @@ void Instruments::render(const Aircraft& aircraft) {
     ImVec2 windowSize = ImGui::GetContentRegionAvail();
     float instrumentSize = std::min(windowSize.x, windowSize.y) * 0.25f;
     
+    // Gauges scale with the panel; static dial layers are re-baked only when
+    // this radius changes
+    gaugeRadius = std::floor(std::max(50.0f, std::min(120.0f, instrumentSize * 0.5f)));
+    float rowHeight = gaugeRadius * 2 + 45;
+    
     // Row 1: Airspeed, Attitude, Altimeter
-    ImGui::BeginChild("Row1", ImVec2(0, instrumentSize + 40), false);
+    ImGui::BeginChild("Row1", ImVec2(0, rowHeight), false);
     
     ImGui::BeginGroup();
     renderAirspeedIndicator(airspeed);
@@ -47,7 +181,7 @@ void Instruments::render(const Aircraft& aircraft) {
     ImGui::EndChild();
     
     // Row 2: Heading, Turn Coordinator, VSI
-    ImGui::BeginChild("Row2", ImVec2(0, instrumentSize + 40), false);
+    ImGui::BeginChild("Row2", ImVec2(0, rowHeight), false);
     
     ImGui::BeginGroup();
     renderHeadingIndicator(heading);
@@ -55,7 +189,7 @@ void Instruments::render(const Aircraft& aircraft) {
     
     ImGui::SameLine();
     ImGui::BeginGroup();
-    renderTurnCoordinator(state.angularVelocity.x, state.angularVelocity.z);
+    renderTurnCoordinator(secondaryState.angularVelocity.x, secondaryAirData.turnRate);
     ImGui::EndGroup();
     
     ImGui::SameLine();
@@ -68,24 +202,37 @@ void Instruments::render(const Aircraft& aircraft) {
     // Control surfaces and throttle
     ImGui::Separator();
     ImGui::Text("Controls");
-    renderThrottleGauge(state.throttle);
-    renderControlSurfaces(state.elevator, state.aileron, state.rudder);
+    renderThrottleGauge(secondaryState.throttle);
+    renderControlSurfaces(secondaryState.elevator, secondaryState.aileron, secondaryState.rudder);
     
-    // Additional telemetry
-    ImGui::Separator();
-    ImGui::Text("Telemetry");
-    ImGui::Text("Position: N=%.1f, E=%.1f, D=%.1f m", 
-                state.position.x, state.position.y, state.position.z);
-    ImGui::Text("Velocity: u=%.1f, v=%.1f, w=%.1f m/s", 
-                state.velocity.x, state.velocity.y, state.velocity.z);
-    ImGui::Text("Angles: Roll=%.1f°, Pitch=%.1f°, Yaw=%.1f°", 
-                state.roll * 180.0 / M_PI, 
-                state.pitch * 180.0 / M_PI, 
-                state.yaw * 180.0 / M_PI);
-    ImGui::Text("Alpha=%.1f°, Beta=%.1f°, Mach=%.3f", 
-                aircraft.getAngleOfAttack() * 180.0 / M_PI,
-                aircraft.getSideslip() * 180.0 / M_PI,
-                aircraft.getMachNumber());
+    // Additional telemetry (trimmed by the frame budget governor)
+    if (telemetryLines > 0) {
+        ImGui::Separator();
+        ImGui::Text("Telemetry");
+    }
+    if (telemetryLines >= 3) {
+        ImGui::Text("Position: N=%.1f, E=%.1f, D=%.1f m", 
+                    secondaryState.position.x, secondaryState.position.y, secondaryState.position.z);
+        ImGui::Text("Velocity: u=%.1f, v=%.1f, w=%.1f m/s", 
+                    secondaryState.velocity.x, secondaryState.velocity.y, secondaryState.velocity.z);
+    }
+    if (telemetryLines >= 1) {
+        ImGui::Text("Angles: Roll=%.1f°, Pitch=%.1f°, Yaw=%.1f°", 
+                    secondaryState.roll * 180.0 / M_PI, 
+                    secondaryState.pitch * 180.0 / M_PI, 
+                    secondaryState.yaw * 180.0 / M_PI);
+    }
+    if (telemetryLines >= 2) {
+        ImGui::Text("Alpha=%.1f°, Beta=%.1f°, Mach=%.3f", 
+                    secondaryAirData.alpha * 180.0 / M_PI,
+                    secondaryAirData.beta * 180.0 / M_PI,
+                    secondaryAirData.mach);
+        ImGui::Text("TAS=%.0f kts, q=%.0f Pa, n=%.2f g, DA=%.0f ft",
+                    secondaryAirData.trueAirspeed * 1.94384,
+                    secondaryAirData.dynamicPressure,
+                    secondaryAirData.loadFactor,
+                    secondaryAirData.densityAltitude * 3.28084);
+    }
     
     ImGui::End();
 }
@@ -96,34 +243,11 @@ void Instruments::renderAirspeedIndicator(double airspeed) {
     
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 pos = ImGui::GetCursorScreenPos();
-    float radius = 70.0f;
+    float radius = gaugeRadius;
     ImVec2 center(pos.x + radius + 10, pos.y + radius + 20);
     
-    // Background
-    drawList->AddCircleFilled(center, radius, IM_COL32(30, 30, 30, 255));
-    drawList->AddCircle(center, radius, IM_COL32(200, 200, 200, 255), 0, 2.0f);
-    
-    // Scale markings (0-200 knots)
-    for (int i = 0; i <= 200; i += 20) {
-        float angle = -120.0f + (240.0f * i / 200.0f);
-        float rad = angle * M_PI / 180.0f;
-        float innerRadius = (i % 40 == 0) ? radius - 15.0f : radius - 10.0f;
-        
-        ImVec2 p1(center.x + std::cos(rad) * innerRadius,
-                  center.y + std::sin(rad) * innerRadius);
-        ImVec2 p2(center.x + std::cos(rad) * radius,
-                  center.y + std::sin(rad) * radius);
-        
-        drawList->AddLine(p1, p2, IM_COL32(200, 200, 200, 255), 2.0f);
-        
-        if (i % 40 == 0) {
-            char label[8];
-            snprintf(label, sizeof(label), "%d", i);
-            ImVec2 textPos(center.x + std::cos(rad) * (radius - 25.0f) - 10,
-                          center.y + std::sin(rad) * (radius - 25.0f) - 7);
-            drawList->AddText(textPos, IM_COL32(200, 200, 200, 255), label);
-        }
-    }
+    // Face, scale and labels
+    geometryCache.draw(drawList, DialLayer::AIRSPEED, center, radius, buildAirspeedDial);
     
     // Needle
     float needleAngle = -120.0f + (240.0f * std::min(knots, 200.0) / 200.0f);
@@ -147,32 +271,11 @@ void Instruments::renderAltimeter(double altitude) {
     
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 pos = ImGui::GetCursorScreenPos();
-    float radius = 70.0f;
+    float radius = gaugeRadius;
     ImVec2 center(pos.x + radius + 10, pos.y + radius + 20);
     
-    // Background
-    drawList->AddCircleFilled(center, radius, IM_COL32(30, 30, 30, 255));
-    drawList->AddCircle(center, radius, IM_COL32(200, 200, 200, 255), 0, 2.0f);
-    
-    // Scale markings (0-10000 feet)
-    for (int i = 0; i <= 10; i++) {
-        float angle = -120.0f + (240.0f * i / 10.0f);
-        float rad = angle * M_PI / 180.0f;
-        float innerRadius = radius - 15.0f;
-        
-        ImVec2 p1(center.x + std::cos(rad) * innerRadius,
-                  center.y + std::sin(rad) * innerRadius);
-        ImVec2 p2(center.x + std::cos(rad) * radius,
-                  center.y + std::sin(rad) * radius);
-        
-        drawList->AddLine(p1, p2, IM_COL32(200, 200, 200, 255), 2.0f);
-        
-        char label[8];
-        snprintf(label, sizeof(label), "%d", i);
-        ImVec2 textPos(center.x + std::cos(rad) * (radius - 25.0f) - 5,
-                      center.y + std::sin(rad) * (radius - 25.0f) - 7);
-        drawList->AddText(textPos, IM_COL32(200, 200, 200, 255), label);
-    }
+    // Face, scale and labels
+    geometryCache.draw(drawList, DialLayer::ALTIMETER, center, radius, buildAltimeterDial);
     
     // Needle (for 1000s of feet)
     double thousands = std::fmod(feet / 1000.0, 10.0);
@@ -194,84 +297,42 @@ void Instruments::renderAltimeter(double altitude) {
 void Instruments::renderAttitudeIndicator(double roll, double pitch) {
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 pos = ImGui::GetCursorScreenPos();
-    float radius = 70.0f;
+    float radius = gaugeRadius;
     ImVec2 center(pos.x + radius + 10, pos.y + radius + 20);
     
-    // Clip circle
-    drawList->PushClipRect(ImVec2(center.x - radius, center.y - radius),
-                          ImVec2(center.x + radius, center.y + radius), true);
-    
-    // Sky and ground
-    float pitchPixels = pitch * (180.0 / M_PI) * 2.0f;
-    float horizonY = center.y + pitchPixels;
+    // Sky disc (static)
+    geometryCache.draw(drawList, DialLayer::ATTITUDE_SKY, center, radius, buildAttitudeSky);
     
-    // Rotate sky/ground with roll
-    ImVec2 points[4];
+    // Ground: the part of the disc below the horizon line is a circular
+    // segment, drawn as one convex polygon rotated with roll
+    float horizonOffset = pitch * (180.0 / M_PI) * 2.0f;
     float cr = std::cos(-roll);
     float sr = std::sin(-roll);
     
-    // Sky (blue)
-    for (int y = -100; y <= 0; y += 10) {
-        float y1 = horizonY + y;
-        float y2 = horizonY + y + 10;
+    if (horizonOffset <= -radius) {
+        drawList->AddCircleFilled(center, radius, GROUND_COLOR);
+    } else if (horizonOffset < radius) {
+        // Arc below the chord at y = horizonOffset (screen y points down),
+        // generated clockwise as AddConvexPolyFilled expects
+        const int MAX_POINTS = 48;
+        ImVec2 points[MAX_POINTS];
+        float t0 = std::asin(horizonOffset / radius);
+        float t1 = (float)M_PI - t0;
+        float pointsPerRadian = reducedDetail ? 3.0f : 8.0f;
+        int count = std::max(3, std::min(MAX_POINTS, (int)((t1 - t0) * pointsPerRadian) + 2));
         
-        for (int x = -100; x <= 100; x += 10) {
-            ImVec2 p1(center.x + x, y1);
-            ImVec2 p2(center.x + x + 10, y1);
-            ImVec2 p3(center.x + x + 10, y2);
-            ImVec2 p4(center.x + x, y2);
-            
-            // Rotate around center
-            auto rotate = [&](ImVec2& p) {
-                float dx = p.x - center.x;
-                float dy = p.y - center.y;
-                p.x = center.x + dx * cr - dy * sr;
-                p.y = center.y + dx * sr + dy * cr;
-            };
-            
-            rotate(p1); rotate(p2); rotate(p3); rotate(p4);
-            
-            drawList->AddQuadFilled(p1, p2, p3, p4, IM_COL32(100, 150, 255, 255));
+        for (int i = 0; i < count; i++) {
+            float t = t0 + (t1 - t0) * i / (count - 1);
+            float dx = std::cos(t) * radius;
+            float dy = std::sin(t) * radius;
+            points[i] = ImVec2(center.x + dx * cr - dy * sr,
+                               center.y + dx * sr + dy * cr);
         }
+        drawList->AddConvexPolyFilled(points, count, GROUND_COLOR);
     }
     
-    // Ground (brown)
-    for (int y = 0; y <= 100; y += 10) {
-        float y1 = horizonY + y;
-        float y2 = horizonY + y + 10;
-        
-        for (int x = -100; x <= 100; x += 10) {
-            ImVec2 p1(center.x + x, y1);
-            ImVec2 p2(center.x + x + 10, y1);
-            ImVec2 p3(center.x + x + 10, y2);
-            ImVec2 p4(center.x + x, y2);
-            
-            auto rotate = [&](ImVec2& p) {
-                float dx = p.x - center.x;
-                float dy = p.y - center.y;
-                p.x = center.x + dx * cr - dy * sr;
-                p.y = center.y + dx * sr + dy * cr;
-            };
-            
-            rotate(p1); rotate(p2); rotate(p3); rotate(p4);
-            
-            drawList->AddQuadFilled(p1, p2, p3, p4, IM_COL32(139, 90, 43, 255));
-        }
-    }
-    
-    drawList->PopClipRect();
-    
-    // Outer ring
-    drawList->AddCircle(center, radius, IM_COL32(200, 200, 200, 255), 0, 2.0f);
-    
-    // Aircraft symbol (fixed)
-    drawList->AddLine(ImVec2(center.x - 30, center.y), 
-                     ImVec2(center.x - 10, center.y), 
-                     IM_COL32(255, 255, 0, 255), 3.0f);
-    drawList->AddLine(ImVec2(center.x + 10, center.y), 
-                     ImVec2(center.x + 30, center.y), 
-                     IM_COL32(255, 255, 0, 255), 3.0f);
-    drawList->AddCircleFilled(center, 3.0f, IM_COL32(255, 255, 0, 255));
+    // Ring and aircraft symbol (static)
+    geometryCache.draw(drawList, DialLayer::ATTITUDE_OVERLAY, center, radius, buildAttitudeOverlay);
     
     // Label
     ImGui::SetCursorScreenPos(ImVec2(center.x - 30, pos.y));
@@ -285,14 +346,13 @@ void Instruments::renderAttitudeIndicator(double roll, double pitch) {
 void Instruments::renderHeadingIndicator(double heading) {
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 pos = ImGui::GetCursorScreenPos();
-    float radius = 70.0f;
+    float radius = gaugeRadius;
     ImVec2 center(pos.x + radius + 10, pos.y + radius + 20);
     
-    // Background
-    drawList->AddCircleFilled(center, radius, IM_COL32(30, 30, 30, 255));
-    drawList->AddCircle(center, radius, IM_COL32(200, 200, 200, 255), 0, 2.0f);
+    // Face (static)
+    geometryCache.draw(drawList, DialLayer::HEADING_BEZEL, center, radius, drawDialFace);
     
-    // Compass markings
+    // Compass card rotates with heading, so it is rebuilt every frame
     const char* cardinals[] = {"N", "3", "6", "E", "12", "15", "S", "21", "24", "W", "30", "33"};
     for (int i = 0; i < 12; i++) {
         float angle = -90.0f + (i * 30.0f) - heading;
@@ -303,11 +363,14 @@ void Instruments::renderHeadingIndicator(double heading) {
         ImVec2 p2(center.x + std::cos(rad) * radius,
                   center.y + std::sin(rad) * radius);
         
-        drawList->AddLine(p1, p2, IM_COL32(200, 200, 200, 255), 2.0f);
+        drawList->AddLine(p1, p2, SCALE_COLOR, 2.0f);
+        
+        // Reduced detail keeps only N/E/S/W labels
+        if (reducedDetail && i % 3 != 0) continue;
         
         ImVec2 textPos(center.x + std::cos(rad) * (radius - 30.0f) - 7,
                       center.y + std::sin(rad) * (radius - 30.0f) - 7);
-        drawList->AddText(textPos, IM_COL32(200, 200, 200, 255), cardinals[i]);
+        drawList->AddText(textPos, SCALE_COLOR, cardinals[i]);
     }
     
     // Aircraft heading marker (fixed at top)
@@ -316,7 +379,7 @@ void Instruments::renderHeadingIndicator(double heading) {
         ImVec2(center.x - 8, center.y - radius + 20),
         ImVec2(center.x + 8, center.y - radius + 20)
     };
-    drawList->AddTriangleFilled(tri[0], tri[1], tri[2], IM_COL32(255, 255, 0, 255));
+    drawList->AddTriangleFilled(tri[0], tri[1], tri[2], SYMBOL_COLOR);
     
     // Label
     ImGui::SetCursorScreenPos(ImVec2(center.x - 30, pos.y));
@@ -333,32 +396,11 @@ void Instruments::renderVerticalSpeedIndicator(double verticalSpeed) {
     
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 pos = ImGui::GetCursorScreenPos();
-    float radius = 70.0f;
+    float radius = gaugeRadius;
     ImVec2 center(pos.x + radius + 10, pos.y + radius + 20);
     
-    // Background
-    drawList->AddCircleFilled(center, radius, IM_COL32(30, 30, 30, 255));
-    drawList->AddCircle(center, radius, IM_COL32(200, 200, 200, 255), 0, 2.0f);
-    
-    // Scale markings (-2000 to +2000 fpm)
-    int marks[] = {-20, -10, 0, 10, 20};
-    for (int i = 0; i < 5; i++) {
-        float angle = -120.0f + (i * 60.0f);
-        float rad = angle * M_PI / 180.0f;
-        
-        ImVec2 p1(center.x + std::cos(rad) * (radius - 15.0f),
-                  center.y + std::sin(rad) * (radius - 15.0f));
-        ImVec2 p2(center.x + std::cos(rad) * radius,
-                  center.y + std::sin(rad) * radius);
-        
-        drawList->AddLine(p1, p2, IM_COL32(200, 200, 200, 255), 2.0f);
-        
-        char label[8];
-        snprintf(label, sizeof(label), "%d", marks[i]);
-        ImVec2 textPos(center.x + std::cos(rad) * (radius - 30.0f) - 10,
-                      center.y + std::sin(rad) * (radius - 30.0f) - 7);
-        drawList->AddText(textPos, IM_COL32(200, 200, 200, 255), label);
-    }
+    // Face, scale and labels
+    geometryCache.draw(drawList, DialLayer::VERTICAL_SPEED, center, radius, buildVerticalSpeedDial);
     
     // Needle
     double clampedFpm = std::max(-2000.0, std::min(2000.0, fpm));
@@ -377,18 +419,16 @@ void Instruments::renderVerticalSpeedIndicator(double verticalSpeed) {
     ImGui::Dummy(ImVec2(radius * 2 + 20, radius * 2 + 40));
 }
 
-void Instruments::renderTurnCoordinator(double rollRate, double yawRate) {
+void Instruments::renderTurnCoordinator(double rollRate, double turnRate) {
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 pos = ImGui::GetCursorScreenPos();
-    float width = 160.0f;
-    float height = 160.0f;
+    float width = gaugeRadius * 2 + 20;
+    float height = width;
     ImVec2 center(pos.x + width * 0.5f, pos.y + height * 0.5f);
     
     // Background
-    drawList->AddRectFilled(pos, ImVec2(pos.x + width, pos.y + height), 
-                           IM_COL32(30, 30, 30, 255));
-    drawList->AddRect(pos, ImVec2(pos.x + width, pos.y + height), 
-                     IM_COL32(200, 200, 200, 255), 0.0f, 0, 2.0f);
+    geometryCache.draw(drawList, DialLayer::TURN_COORDINATOR, center, width * 0.5f,
+                       buildTurnCoordinatorFace);
     
     // Aircraft symbol (tilted based on roll rate)
     float bankAngle = rollRate * 20.0f;  // Scale for visualization
@@ -401,14 +441,14 @@ void Instruments::renderTurnCoordinator(double rollRate, double yawRate) {
     wing2 = ImVec2(center.x + wing2.x * cr - wing2.y * sr, 
                    center.y + wing2.x * sr + wing2.y * cr);
     
-    drawList->AddLine(wing1, wing2, IM_COL32(255, 255, 0, 255), 4.0f);
-    drawList->AddCircleFilled(center, 5.0f, IM_COL32(255, 255, 0, 255));
+    drawList->AddLine(wing1, wing2, SYMBOL_COLOR, 4.0f);
+    drawList->AddCircleFilled(center, 5.0f, SYMBOL_COLOR);
     
     // Label
     ImGui::SetCursorScreenPos(ImVec2(center.x - 40, pos.y + 5));
     ImGui::Text("TURN COORD");
     ImGui::SetCursorScreenPos(ImVec2(center.x - 50, pos.y + height - 20));
-    ImGui::Text("Rate: %.2f rad/s", yawRate);
+    ImGui::Text("Rate: %.1f deg/s", turnRate * 180.0 / M_PI);
     
     ImGui::Dummy(ImVec2(width, height));
 }
@@ -0,0 +1,67 @@
+#include "latency_histogram.hpp"
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (std::atomic<uint64_t>& bin : bins) {
+        bin.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sumUs.store(0.0, std::memory_order_relaxed);
+    maxUs.store(0.0, std::memory_order_relaxed);
+    lastUs.store(0.0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::record(double us) {
+    int bin = us <= 1.0 ? 0 : (int)(4.0 * std::log2(us));
+    if (bin >= BINS) bin = BINS - 1;
+
+    // Only one thread writes, so plain load/store pairs are enough
+    bins[bin].store(bins[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sumUs.store(sumUs.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+    if (us > maxUs.load(std::memory_order_relaxed)) {
+        maxUs.store(us, std::memory_order_relaxed);
+    }
+    lastUs.store(us, std::memory_order_relaxed);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+double LatencyHistogram::getMean() const {
+    uint64_t n = count.load(std::memory_order_acquire);
+    return n > 0 ? sumUs.load(std::memory_order_relaxed) / (double)n : 0.0;
+}
+
+double LatencyHistogram::binUpperEdge(int bin) {
+    return std::exp2((bin + 1) * 0.25);
+}
+
+double LatencyHistogram::percentile(double p) const {
+    uint64_t total = 0;
+    uint64_t counts[BINS];
+    for (int i = 0; i < BINS; i++) {
+        counts[i] = bins[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) return 0.0;
+
+    uint64_t target = (uint64_t)std::ceil(p * (double)total);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BINS; i++) {
+        seen += counts[i];
+        if (seen >= target) return binUpperEdge(i);
+    }
+    return binUpperEdge(BINS - 1);
+}
+
+void LatencyHistogram::writeCSV(FILE* file, const char* name) const {
+    for (int i = 0; i < BINS; i++) {
+        uint64_t n = bins[i].load(std::memory_order_relaxed);
+        if (n > 0) {
+            std::fprintf(file, "%s,%.1f,%llu\n", name, binUpperEdge(i), (unsigned long long)n);
+        }
+    }
+}
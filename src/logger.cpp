@@ -0,0 +1,277 @@
+#include "logger.hpp"
+#include "spsc_queue.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int MAX_SITES = 4096;
+const size_t RING_CAPACITY = 1024;           // Records per thread
+const size_t MAX_BATCH = 4096;               // Records formatted per writer pass
+const int WRITER_IDLE_SLEEP_MS = 2;
+
+using Ring = SpscQueue<LogRecord, RING_CAPACITY>;
+
+std::atomic<const LogSite*> sites[MAX_SITES];
+std::atomic<uint32_t> siteCount(0);
+
+// Registration and the ring list are the only things behind a lock
+std::mutex ringsMutex;
+std::vector<std::unique_ptr<Ring>> rings;
+thread_local Ring* threadRing = nullptr;
+
+std::atomic<uint64_t> recordsWritten(0);
+std::atomic<uint64_t> recordsDropped(0);
+std::atomic<uint64_t> recordsSuppressed(0);
+
+std::mutex controlMutex;   // start()/stop()
+std::thread writer;
+std::atomic<bool> running(false);
+FILE* output = nullptr;
+int64_t startTime = 0;
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARN: return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+    }
+    return "?";
+}
+
+int64_t argAsInt(const LogRecord& record, int index) {
+    switch (record.types[index]) {
+        case LogRecord::INT: return record.args[index].i;
+        case LogRecord::UINT: return (int64_t)record.args[index].u;
+        case LogRecord::DOUBLE: return (int64_t)record.args[index].d;
+        default: return 0;
+    }
+}
+
+double argAsDouble(const LogRecord& record, int index) {
+    switch (record.types[index]) {
+        case LogRecord::INT: return (double)record.args[index].i;
+        case LogRecord::UINT: return (double)record.args[index].u;
+        case LogRecord::DOUBLE: return record.args[index].d;
+        default: return 0.0;
+    }
+}
+
+// printf-style formatting of the record's arguments. Length modifiers in
+// the format are ignored: integers are always formatted as 64-bit and the
+// stored type is converted to whatever the conversion asks for.
+size_t formatMessage(const char* format, const LogRecord& record, char* out, size_t capacity) {
+    size_t length = 0;
+    int arg = 0;
+    auto advance = [&](int written) {
+        if (written > 0) length = std::min(capacity - 1, length + (size_t)written);
+    };
+
+    for (const char* p = format; *p && length < capacity - 1;) {
+        if (*p != '%') {
+            out[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        char spec[32];
+        int specLength = 0;
+        spec[specLength++] = *p++;
+        while (*p && std::strchr("-+ #0123456789.", *p) && specLength < 24) spec[specLength++] = *p++;
+        while (*p && std::strchr("hlLjzt", *p)) p++;
+        char conversion = *p;
+        if (!conversion) break;
+        p++;
+
+        char* dest = out + length;
+        size_t room = capacity - length;
+        if (arg >= record.argCount) {
+            advance(std::snprintf(dest, room, "<?>"));
+            continue;
+        }
+        int index = arg++;
+
+        switch (conversion) {
+            case 'd': case 'i':
+                std::strcpy(spec + specLength, "lld");
+                advance(std::snprintf(dest, room, spec, (long long)argAsInt(record, index)));
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                advance(std::snprintf(dest, room, spec, (unsigned long long)argAsInt(record, index)));
+                break;
+            case 'c':
+                std::strcpy(spec + specLength, "c");
+                advance(std::snprintf(dest, room, spec, (int)argAsInt(record, index)));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                advance(std::snprintf(dest, room, spec, argAsDouble(record, index)));
+                break;
+            case 's':
+                std::strcpy(spec + specLength, "s");
+                advance(std::snprintf(dest, room, spec,
+                                      record.types[index] == LogRecord::STRING
+                                          ? record.text + record.args[index].text
+                                          : "<?>"));
+                break;
+            default:
+                advance(std::snprintf(dest, room, "<?>"));
+                break;
+        }
+    }
+    out[length] = '\0';
+    return length;
+}
+
+void writeRecord(const LogRecord& record) {
+    const LogSite* site = record.site < (uint32_t)MAX_SITES
+                              ? sites[record.site].load(std::memory_order_acquire)
+                              : nullptr;
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::duration(record.time - startTime)).count();
+
+    char line[512];
+    int prefix = std::snprintf(line, sizeof(line), "[%9.3f] %-5s ", seconds,
+                               site ? levelName(site->level) : "?");
+    size_t length = (size_t)prefix;
+    length += formatMessage(site ? site->format : "(unregistered log site)", record, line + length,
+                            sizeof(line) - length - 1);
+    if (record.suppressed > 0) {
+        int written = std::snprintf(line + length, sizeof(line) - length - 1,
+                                    " (%u similar suppressed)", record.suppressed);
+        if (written > 0) length = std::min(sizeof(line) - 2, length + (size_t)written);
+    }
+    line[length++] = '\n';
+    line[length] = '\0';
+    std::fputs(line, output);
+}
+
+// Pull everything currently queued, oldest first across threads
+size_t drain(std::vector<LogRecord>& batch) {
+    std::vector<Ring*> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        snapshot.reserve(rings.size());
+        for (const auto& ring : rings) snapshot.push_back(ring.get());
+    }
+
+    batch.clear();
+    for (Ring* ring : snapshot) {
+        const LogRecord* record;
+        while (batch.size() < MAX_BATCH && (record = ring->peek())) {
+            batch.push_back(*record);
+            ring->discard();
+        }
+    }
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const LogRecord& a, const LogRecord& b) { return a.time < b.time; });
+
+    for (const LogRecord& record : batch) {
+        writeRecord(record);
+    }
+    if (!batch.empty()) {
+        std::fflush(output);
+        recordsWritten.fetch_add(batch.size(), std::memory_order_relaxed);
+    }
+    return batch.size();
+}
+
+void writerLoop() {
+    std::vector<LogRecord> batch;
+    batch.reserve(MAX_BATCH);
+    while (true) {
+        bool stopping = !running.load(std::memory_order_acquire);
+        if (drain(batch) > 0) continue;
+        if (stopping) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(WRITER_IDLE_SLEEP_MS));
+    }
+}
+
+Ring* registerThread() {
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    rings.emplace_back(new Ring());
+    return rings.back().get();
+}
+
+} // namespace
+
+LogSite::LogSite(LogLevel level, const char* format, uint32_t maxPerSecond)
+    : level(level), format(format), maxPerSecond(maxPerSecond),
+      windowStart(0), windowCount(0), suppressed(0) {
+    id = siteCount.fetch_add(1, std::memory_order_relaxed);
+    if (id < (uint32_t)MAX_SITES) {
+        sites[id].store(this, std::memory_order_release);
+    }
+}
+
+std::atomic<int>& Logger::minLevel() {
+    static std::atomic<int> level((int)LogLevel::INFO);
+    return level;
+}
+
+void Logger::start(FILE* out) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (running.load(std::memory_order_relaxed)) return;
+    output = out ? out : stderr;
+    if (startTime == 0) {
+        startTime = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+    running.store(true, std::memory_order_release);
+    writer = std::thread(writerLoop);
+}
+
+void Logger::stop() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (!running.load(std::memory_order_relaxed)) return;
+    running.store(false, std::memory_order_release);
+    writer.join();
+}
+
+bool Logger::admit(LogSite& site, int64_t now, uint32_t& suppressed) {
+    const int64_t window = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                               std::chrono::seconds(1)).count();
+    int64_t start = site.windowStart.load(std::memory_order_relaxed);
+    if (now - start >= window &&
+        site.windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        // New window: report what the previous one swallowed
+        site.windowCount.store(1, std::memory_order_relaxed);
+        suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    if (site.windowCount.fetch_add(1, std::memory_order_relaxed) < site.maxPerSecond) {
+        return true;
+    }
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    recordsSuppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Logger::submit(const LogRecord& record) {
+    if (!threadRing) {
+        threadRing = registerThread();
+    }
+    if (!threadRing->push(record)) {
+        recordsDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Logger::Stats Logger::getStats() {
+    Stats stats;
+    stats.written = recordsWritten.load(std::memory_order_relaxed);
+    stats.dropped = recordsDropped.load(std::memory_order_relaxed);
+    stats.suppressed = recordsSuppressed.load(std::memory_order_relaxed);
+    return stats;
+}
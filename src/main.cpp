@@ -5,11 +5,332 @@
 #include "renderer.hpp"
 #include "input_handler.hpp"
 #include "audio_system.hpp"
+#include "alert_engine.hpp"
+#include "scene_renderer.hpp"
+#include "benchmarks.hpp"
+#include "frame_pacer.hpp"
+#include "flight_log.hpp"
+#include "rewind_buffer.hpp"
+#include "offline_audio.hpp"
+#include "logger.hpp"
+#include "audio_debug_panel.hpp"
+#include "envelope_panel.hpp"
+#include "flight_envelope.hpp"
+#include "rate_scheduler.hpp"
+#include "sensors.hpp"
+#include "realtime_loop.hpp"
+#include "nav_ekf.hpp"
+#include "aero_identification.hpp"
+#include "flight_path_predictor.hpp"
+#include "state_hash.hpp"
+#include "watch_panel.hpp"
 #include "imgui.h"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
 
-int main() {
+// Fly the default scenario without a window and dump the out-the-window
+// view as PPM frames (for render tests on machines without a GPU)
+static int runHeadlessRender(int frameCount, const std::string& outputDir) {
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    SceneRenderer scene(1280, 720);
+    
+    // Gentle right bank so consecutive frames differ
+    aircraft.getState().aileron = 0.05;
+    
+    const double dt = 1.0 / 60.0;
+    double totalMs = 0.0, worstMs = 0.0;
+    
+    for (int frame = 0; frame < frameCount; frame++) {
+        dynamics.update(dt);
+        
+        auto start = std::chrono::steady_clock::now();
+        scene.render(aircraft.getState(), (frame / 60) % 2 ? CameraMode::CHASE : CameraMode::COCKPIT);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        totalMs += elapsed.count();
+        if (elapsed.count() > worstMs) worstMs = elapsed.count();
+        
+        if (!outputDir.empty()) {
+            char path[512];
+            std::snprintf(path, sizeof(path), "%s/frame_%04d.ppm", outputDir.c_str(), frame);
+            if (!scene.writeFrame(path)) {
+                std::cerr << "Failed to write " << path << std::endl;
+                return 1;
+            }
+        }
+    }
+    
+    const SoftwareRasterizer& raster = scene.getRasterizer();
+    std::printf("Rendered %d frames at %dx%d on %u threads: avg %.2f ms (%.1f fps), worst %.2f ms\n",
+                frameCount, raster.getWidth(), raster.getHeight(), raster.getThreadCount(),
+                totalMs / frameCount, 1000.0 * frameCount / totalMs, worstMs);
+    return 0;
+}
+
+// Render a flight's audio track to WAV without an audio device. Uses the
+// recorded flight if given, otherwise a built-in scripted flight.
+static int runAudioRender(const std::string& wavPath, const std::string& flightPath) {
+    FlightLog log;
+    if (!flightPath.empty()) {
+        if (!log.loadCSV(flightPath)) return 1;
+    } else {
+        recordScriptedFlight(log, 120.0);
+    }
+    
+    OfflineAudioStats stats;
+    if (!renderFlightAudio(log, wavPath, 48000, &stats)) {
+        return 1;
+    }
+    std::printf("Rendered %.1f s of audio (%llu frames) to %s in %.2f s (%.0fx real time)\n",
+                stats.audioSeconds, (unsigned long long)stats.frames, wavPath.c_str(),
+                stats.renderSeconds, stats.audioSeconds / std::max(stats.renderSeconds, 1e-9));
+    return 0;
+}
+
+// Generate the flight-envelope map over the standard grid and write
+// <prefix>.bin and <prefix>.csv
+static int runEnvelope(const std::string& prefix) {
+    FlightEnvelope envelope;
+    envelope.generate(EnvelopeGrid::standard());
+    std::printf("Evaluated %zu envelope cells on %u threads in %.2f s\n",
+                envelope.getGrid().cellCount(), envelope.getThreadCount(), envelope.getGenerateSeconds());
+    
+    if (!envelope.saveBinary(prefix + ".bin") || !envelope.saveCSV(prefix + ".csv")) {
+        return 1;
+    }
+    std::printf("Wrote %s.bin and %s.csv\n", prefix.c_str(), prefix.c_str());
+    return 0;
+}
+
+// Identify the aerodynamic coefficients from a recorded flight (the CSV
+// the Record button saves) and write <prefix>.csv and <prefix>.hpp
+static int runIdentify(const std::string& flightPath, const std::string& prefix) {
+    FlightLog log;
+    if (!log.loadCSV(flightPath)) return 1;
+    
+    Aircraft aircraft;
+    AeroIdentification identification;
+    if (!identification.identify(log, aircraft)) return 1;
+    std::printf("Fitted %zu intervals (%zu skipped) on %u threads in %.1f ms\n", identification.getUsedCount(),
+                identification.getSkippedCount(), identification.getThreadCount(),
+                identification.getSolveSeconds() * 1e3);
+    for (int e = 0; e < AeroIdentification::EQUATION_COUNT; e++) {
+        const CoefficientFit& fit = identification.getFit((AeroIdentification::Equation)e);
+        std::printf("%s: residual RMS %.3g, R^2 %.4f, condition %.3g%s\n", fit.name, fit.residualRms, fit.rSquared,
+                    fit.condition, fit.solved ? "" : " (not solved, priors kept)");
+        for (int j = 0; j < fit.termCount; j++) {
+            const IdentifiedCoefficient& term = fit.terms[j];
+            std::printf("  %-15s %10.4f -> %10.4f  [%.4f, %.4f]%s\n", term.name, term.prior, term.value, term.lower,
+                        term.upper, term.excited ? "" : "  not excited");
+        }
+    }
+    
+    if (!identification.saveCSV(prefix + ".csv") || !identification.saveTypeHeader(prefix + ".hpp", "Identified")) {
+        return 1;
+    }
+    std::printf("Wrote %s.csv and %s.hpp\n", prefix.c_str(), prefix.c_str());
+    return 0;
+}
+
+// Replay a flight's control inputs through the dynamics at 1 kHz and write
+// the state hash after every step to <hashPath>. With a reference stream
+// (from another build, process or machine) report the first step where the
+// two diverge. Uses the built-in scripted flight unless a recorded one is
+// given; "-" skips the reference.
+static int runStateHash(const std::string& hashPath, const std::string& referencePath,
+                        const std::string& flightPath) {
+    FlightLog log;
+    if (!flightPath.empty()) {
+        if (!log.loadCSV(flightPath)) return 1;
+    } else {
+        recordScriptedFlight(log, 120.0, 0.01);
+    }
+    if (log.size() < 2) {
+        std::cerr << "Flight has fewer than two samples" << std::endl;
+        return 1;
+    }
+    
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    dynamics.setStateHashing(true);
+    aircraft.getState() = log[0].state;
+    dynamics.updateAirData();
+    dynamics.resetStateHash();
+    
+    // Each sample's controls are held until the next sample
+    const double dt = 0.001;
+    StateHashStream stream;
+    stream.reserve((size_t)(log.getDuration() / dt) + 1);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i + 1 < log.size(); i++) {
+        AircraftState& state = aircraft.getState();
+        state.elevator = log[i].state.elevator;
+        state.aileron = log[i].state.aileron;
+        state.rudder = log[i].state.rudder;
+        state.throttle = log[i].state.throttle;
+        long steps = std::lround((log[i + 1].time - log[i].time) / dt);
+        for (long k = 0; k < steps; k++) {
+            dynamics.update(dt);
+            stream.record(dynamics.getStateHash());
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    
+#ifdef FLIGHT_DETERMINISTIC
+    const char* build = "deterministic build";
+#else
+    const char* build = "default build, FLIGHT_DETERMINISTIC=1 ./compile.sh to compare across builds";
+#endif
+    std::printf("Replayed %zu steps (%.1f s) in %.2f s, final hash %016llx (%s)\n", stream.size(),
+                stream.size() * dt, elapsed.count(), (unsigned long long)dynamics.getStateHash(), build);
+    if (!stream.saveCSV(hashPath)) return 1;
+    std::printf("Wrote %s\n", hashPath.c_str());
+    
+    if (referencePath.empty() || referencePath == "-") return 0;
+    StateHashStream reference;
+    if (!reference.loadCSV(referencePath)) return 1;
+    size_t step = StateHashStream::firstDivergence(stream, reference);
+    if (step != StateHashStream::NO_DIVERGENCE) {
+        std::printf("Diverges from %s at step %zu (t = %.3f s)\n", referencePath.c_str(), step, (step + 1) * dt);
+        return 1;
+    }
+    if (reference.size() != stream.size()) {
+        std::printf("Agrees with %s over %zu steps, but it has %zu\n", referencePath.c_str(),
+                    std::min(stream.size(), reference.size()), reference.size());
+        return 1;
+    }
+    std::printf("Bitwise identical to %s over all %zu steps\n", referencePath.c_str(), stream.size());
+    return 0;
+}
+
+// Hardware-in-the-loop style run: the physics rate groups on a real-time
+// thread (SCHED_FIFO, pinned, locked memory where permitted) for the given
+// wall-clock time, with lateness and deadline-miss statistics
+static int runRealtime(double seconds, int cpu, const std::string& csvPath) {
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    AlertEngine alertEngine;
+    SensorSuite sensors(1);
+    aircraft.getState().aileron = 0.05;
+    
+    const double baseRate = 1000.0;
+    const double dt = 1.0 / baseRate;
+    const double sensorRate = 100.0;
+    double simTime = 0.0;
+    SensorReadings sensorReadings = sensors.sample(0, aircraft.getState(), dynamics.getAirData());
+    
+    RateScheduler scheduler(baseRate);
+    auto dynamicsTask = [&]() {
+        dynamics.update(dt);
+        simTime += dt;
+    };
+    auto alertsTask = [&]() {
+        const AirData& airData = dynamics.getAirData();
+        AlertInputs alertInputs;
+        alertInputs.altitude = airData.altitude;
+        alertInputs.terrainElevation = 0.0;
+        alertInputs.verticalSpeed = airData.verticalSpeed;
+        alertInputs.airspeed = airData.indicatedAirspeed;
+        alertInputs.timeToImpact = INFINITY;
+        alertEngine.evaluate(0, alertInputs, simTime);
+    };
+    auto sensorsTask = [&]() {
+        uint64_t step = (uint64_t)std::llround(simTime * sensorRate);
+        sensorReadings = sensors.sample(step, aircraft.getState(), dynamics.getAirData());
+    };
+    scheduler.addGroup("dynamics", baseRate, dynamicsTask, 5.0);
+    scheduler.addGroup("alerts", 50.0, alertsTask, 2.0);
+    scheduler.addGroup("sensors", sensorRate, sensorsTask, 2.0);
+    
+    RealtimeConfig config;
+    config.rate = baseRate;
+    config.cpu = cpu;
+    auto tick = [&]() { scheduler.tick(); };
+    RealtimeLoop loop;
+    if (!loop.start(config, tick)) {
+        return 1;
+    }
+    RealtimeLoop::Status status = loop.getStatus();
+    std::printf("Real-time loop at %.0f Hz: SCHED_FIFO %s, %s, memory %s\n", config.rate,
+                status.fifo ? "yes" : "no (normal scheduling)", status.pinned ? "pinned" : "not pinned",
+                status.memoryLocked ? "locked" : "not locked");
+    
+    // Progress once a second; the loop's counters are safe to read while it runs
+    auto startTime = std::chrono::steady_clock::now();
+    for (int second = 1; second <= (int)std::ceil(seconds); second++) {
+        std::this_thread::sleep_until(startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                      std::chrono::duration<double>(std::min((double)second, seconds))));
+        RealtimeLoop::Stats stats = loop.getStats();
+        std::printf("%4d s  steps %8llu  lateness mean %6.1f p99 %7.1f max %8.1f us  misses %llu\n", second,
+                    (unsigned long long)stats.steps, stats.meanLatenessUs, stats.p99LatenessUs, stats.maxLatenessUs,
+                    (unsigned long long)stats.deadlineMisses);
+    }
+    loop.stop();
+    
+    RealtimeLoop::Stats stats = loop.getStats();
+    std::printf("\n%llu steps, %llu deadline misses, %llu skipped periods\n", (unsigned long long)stats.steps,
+                (unsigned long long)stats.deadlineMisses, (unsigned long long)stats.skippedPeriods);
+    std::printf("Lateness: mean %.1f  p99 %.1f  max %.1f us\n", stats.meanLatenessUs, stats.p99LatenessUs,
+                stats.maxLatenessUs);
+    std::printf("Step:     mean %.1f  p99 %.1f  max %.1f us\n", stats.meanStepUs, stats.p99StepUs, stats.maxStepUs);
+    for (int i = 0; i < scheduler.getGroupCount(); i++) {
+        RateScheduler::GroupStats group = scheduler.getGroupStats(i);
+        std::printf("  %-9s %5.0f Hz  mean %6.1f p99 %6.1f max %7.1f us\n", group.name, group.rate, group.meanUs,
+                    group.p99Us, group.maxUs);
+    }
+    std::printf("Sim time %.3f s, altitude %.1f m, IAS %.1f m/s (sensed %.1f)\n", simTime,
+                dynamics.getAirData().altitude, dynamics.getAirData().indicatedAirspeed,
+                sensorReadings.pitotStatic.indicatedAirspeed);
+    
+    if (!csvPath.empty()) {
+        if (!loop.writeCSV(csvPath)) return 1;
+        std::printf("Wrote %s\n", csvPath.c_str());
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // Log records are formatted and written by a background thread
+    ScopedLogger logger;
+    
+    // Headless modes
+    if (argc >= 2 && std::strcmp(argv[1], "--headless-render") == 0) {
+        int frames = argc >= 3 ? std::atoi(argv[2]) : 120;
+        std::string outputDir = argc >= 4 ? argv[3] : "";
+        return runHeadlessRender(frames > 0 ? frames : 1, outputDir);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--render-audio") == 0) {
+        return runAudioRender(argv[2], argc >= 4 ? argv[3] : "");
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench") == 0) {
+        return runBenchmark(argc >= 3 ? argv[2] : "list");
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--envelope") == 0) {
+        return runEnvelope(argc >= 3 ? argv[2] : "envelope");
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--identify") == 0) {
+        return runIdentify(argc >= 3 ? argv[2] : "flight.csv", argc >= 4 ? argv[3] : "identified");
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--state-hash") == 0) {
+        return runStateHash(argc >= 3 ? argv[2] : "state_hash.csv", argc >= 4 ? argv[3] : "",
+                            argc >= 5 ? argv[4] : "");
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--realtime") == 0) {
+        double seconds = argc >= 3 ? std::atof(argv[2]) : 10.0;
+        int cpu = argc >= 4 ? std::atoi(argv[3]) : -1;
+        return runRealtime(seconds > 0.0 ? seconds : 10.0, cpu, argc >= 5 ? argv[4] : "");
+    }
+    
     // Initialize renderer
     Renderer renderer;
     if (!renderer.initialize(1920, 1080, "6DOF Flight Simulator")) {
@@ -39,44 +360,193 @@ int main() {
     // Initialize audio system
     AudioSystem audioSystem;
     if (!audioSystem.initialize()) {
-        std::cerr << "Warning: Failed to initialize audio system" << std::endl;
-        std::cerr << "         Continuing without sound..." << std::endl;
+        LOG_WARN("Failed to initialize audio system, continuing without sound");
     }
     
-    // Timing
-    auto lastTime = std::chrono::high_resolution_clock::now();
-    const double dt = 1.0 / 60.0;  // 60 Hz simulation
+    // GPWS-style alerts, evaluated every physics step
+    AlertEngine alertEngine;
+    
+    // Flight path ahead, for the lookahead warning and the 3D view
+    FlightPathPredictor predictor;
+    if (!predictor.start()) {
+        LOG_WARN("Failed to start the flight-path predictor, continuing without lookahead");
+    }
+    
+    // Frame pacing and budget
+    FramePacer pacer;
+    FrameBudgetGovernor governor;
+    AudioDebugPanel audioDebugPanel;
+    bool showAudioDebug = false;
+    EnvelopePanel envelopePanel;
+    bool showEnvelope = false;
+    WatchPanel watchPanel;
+    bool showWatches = false;
+    renderer.setSwapInterval(pacer.getSwapInterval());
+    
+    // Key events are queued by the GLFW callback and consumed per physics step
+    inputHandler.attach(renderer.getWindow());
+    
+    // Timing: the minor frame is one dynamics step
+    auto lastTime = InputHandler::Clock::now();
+    const double baseRate = 1000.0;
+    const double dt = 1.0 / baseRate;
+    const double controlRate = 100.0;
     double accumulator = 0.0;
+    double simTime = 0.0;
+    
+    // Flight recording (replayable with --render-audio)
+    FlightLog flightLog;
+    bool recording = false;
+    
+    // Last 30 minutes of flight for rewind (fixed memory), recorded at the
+    // control rate with one-second keyframes
+    RewindBuffer rewindBuffer(dt, 30.0 * 60.0, (int)controlRate, (int)(baseRate / controlRate));
+    
+    // Rate groups, run in this order when due in the same minor frame
+    RateScheduler scheduler(baseRate);
+    InputHandler::Clock::time_point minorFrameEnd;
+    
+    auto controlsTask = [&]() {
+        // Pilot inputs for the control period ending with this minor frame
+        inputHandler.applyStep(aircraft, minorFrameEnd, 1.0 / controlRate);
+        if (recording) {
+            flightLog.record(simTime, aircraft.getState());
+        }
+        rewindBuffer.record(simTime, aircraft.getState());
+    };
+    // Watch expressions and data breakpoints, checked after every step
+    WatchEngine watches;
+    
+    auto dynamicsTask = [&]() {
+        dynamics.update(dt);
+        simTime += dt;
+        watches.record(simTime, aircraft.getState(), dynamics.getAirData());
+    };
+    auto alertsTask = [&]() {
+        const AirData& stepAirData = dynamics.getAirData();
+        AlertInputs alertInputs;
+        alertInputs.altitude = stepAirData.altitude;
+        alertInputs.terrainElevation = 0.0;
+        alertInputs.verticalSpeed = stepAirData.verticalSpeed;
+        alertInputs.airspeed = stepAirData.indicatedAirspeed;
+        // The path is up to one prediction period old
+        const PredictedPath* path = predictor.getLatest();
+        alertInputs.timeToImpact = path ? path->timeToImpact - (simTime - path->simTime) : INFINITY;
+        alertEngine.evaluate(0, alertInputs, simTime);
+        audioSystem.processAlerts(alertEngine);
+    };
+    auto instrumentsTask = [&]() {
+        instruments.sampleSecondary(aircraft.getState(), dynamics.getAirData());
+    };
+    // Noisy sensors feeding the navigation filter every physics step; the
+    // step follows sim time so a rewind replays the same noise
+    SensorSuite sensors(1);
+    SensorReadings sensorReadings;
+    NavEkf navigation;
+    auto sensorStep = [&]() { return (uint64_t)std::llround(std::max(simTime, 0.0) * baseRate); };
+    // Transfer alignment: GPS position/velocity and the true attitude
+    auto alignNavigation = [&]() {
+        const AircraftState& state = aircraft.getState();
+        sensorReadings = sensors.sample(sensorStep(), state, dynamics.getAirData());
+        navigation.initialize(sensorReadings.gps.position, sensorReadings.gps.velocity, state.roll, state.pitch,
+                              state.yaw);
+    };
+    alignNavigation();
+    auto navigationTask = [&]() {
+        uint64_t step = sensorStep();
+        sensorReadings = sensors.sample(step, aircraft.getState(), dynamics.getAirData());
+        navigation.process(sensorReadings, step, dt);
+    };
+    auto audioTask = [&]() {
+        audioSystem.update(aircraft.getState().throttle, dynamics.getAirData().trueAirspeed);
+    };
+    
+    // Expected costs (us) only steer the phase offsets
+    scheduler.addGroup("controls", controlRate, controlsTask, 2.0);
+    scheduler.addGroup("dynamics", baseRate, dynamicsTask, 5.0);
+    scheduler.addGroup("alerts", 50.0, alertsTask, 2.0);
+    scheduler.addGroup("navigation", baseRate, navigationTask, 2.0);
+    scheduler.addGroup("instruments", 25.0, instrumentsTask, 1.0);
+    scheduler.addGroup("audio", 20.0, audioTask, 1.0);
+    
+    // After the state was set from outside (rewind, watch stop): pause and
+    // bring everything that follows the state in line with it
+    auto afterJump = [&](double time) {
+        if (!inputHandler.isPaused()) inputHandler.togglePause();
+        inputHandler.syncControls(aircraft.getState());
+        alertEngine.reset(0);
+        rewindBuffer.markDiscontinuity();   // The control phase may differ from here on
+        simTime = time;
+        alignNavigation();
+        predictor.markDiscontinuity();
+        predictor.submit(aircraft.getState(), simTime);
+        watches.resync(WatchSample{simTime, aircraft.getState(), dynamics.getAirData()});
+    };
     
     // Main loop
     while (!renderer.shouldClose()) {
+        pacer.beginFrame();
+        
+        // Deliver pending key events, then sample the clock so every
+        // event is stamped before currentTime
+        renderer.pollEvents();
+        
         // Calculate elapsed time
-        auto currentTime = std::chrono::high_resolution_clock::now();
+        auto currentTime = InputHandler::Clock::now();
         std::chrono::duration<double> elapsed = currentTime - lastTime;
         lastTime = currentTime;
         
         accumulator += elapsed.count();
         
-        // Handle input
-        inputHandler.update(renderer.getWindow(), aircraft, dt);
+        if (inputHandler.isPaused()) {
+            // Keep handling P/R while paused; do not bank sim time
+            inputHandler.skipTo(currentTime);
+            accumulator = 0.0;
+        }
+        
+        // Fixed minor frames. Frame i covers the wall-clock slot ending at
+        // currentTime - accumulator + dt; the control group consumes the
+        // input events up to the end of its frame.
+        while (accumulator >= dt && !inputHandler.isPaused() && !watches.hasBreak()) {
+            minorFrameEnd = currentTime - std::chrono::duration_cast<InputHandler::Clock::duration>(
+                                              std::chrono::duration<double>(accumulator - dt));
+            scheduler.tick();
+            accumulator -= dt;
+        }
+        if (!inputHandler.isPaused()) {
+            predictor.submit(aircraft.getState(), simTime);
+        } else {
+            watches.flush();   // Values up to the step shown
+        }
+        
+        // Stop at a pause watch's hit (no step is taken after it) or at a
+        // snapshot picked in the watch panel
+        WatchSample watchStop;
+        if (watches.takeBreak(watchStop) || watchPanel.takeRestore(watchStop)) {
+            aircraft.getState() = watchStop.state;
+            dynamics.updateAirData();
+            afterJump(watchStop.time);
+        }
         
         // Check for reset
         if (inputHandler.shouldReset()) {
             dynamics.reset();
+            alertEngine.reset(0);
+            alignNavigation();
+            rewindBuffer.markDiscontinuity();
+            predictor.markDiscontinuity();
+            watches.resync(WatchSample{simTime, aircraft.getState(), dynamics.getAirData()});
             inputHandler.clearReset();
         }
         
-        // Fixed timestep update
-        while (accumulator >= dt && !inputHandler.isPaused()) {
-            dynamics.update(dt);
-            accumulator -= dt;
-        }
+        // One air-data record for everything drawn or heard this frame
+        const AirData airData = dynamics.getAirData();
         
-        // Update audio system
-        const AircraftState& state = aircraft.getState();
-        bool isStalling = aircraft.getAirspeed() < 40.0; // Stall speed ~40 m/s
-        audioSystem.update(state.throttle, aircraft.getAirspeed(), 
-                          aircraft.getAltitude(), isStalling);
+        // Apply the governor's detail level for this frame
+        instruments.setReducedDetail(governor.reduceInstrumentDetail());
+        instruments.setTelemetryLines(governor.getTelemetryLines());
+        instruments.setSecondaryUpdateDivisor(governor.getSecondaryUpdateDivisor());
+        renderer.setSceneUpdateDivisor(governor.getSecondaryUpdateDivisor());
         
         // Render
         renderer.beginFrame();
@@ -108,16 +578,159 @@ int main() {
         ImGui::Text("Simulation Rate: %.1f Hz", 1.0 / dt);
         ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
         
+        if (ImGui::Checkbox("Record flight", &recording)) {
+            if (recording) {
+                flightLog.clear();
+                flightLog.reserve((size_t)controlRate * 60 * 10);   // 10 minutes without reallocating
+            } else if (flightLog.saveCSV("flight.csv")) {
+                LOG_INFO("Saved %zu samples to flight.csv", flightLog.size());
+            }
+        }
+        if (recording) {
+            ImGui::SameLine();
+            ImGui::Text("%.1f s", flightLog.getDuration());
+        }
+        
+        InputHandler::LatencyStats latency = inputHandler.getLatencyStats();
+        ImGui::Text("Input latency: %.0f us (mean %.0f, p99 %.0f, max %.0f)",
+                    latency.lastUs, latency.meanUs, latency.p99Us, latency.maxUs);
+        if (latency.droppedEvents > 0) {
+            ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Dropped input events: %llu",
+                               (unsigned long long)latency.droppedEvents);
+        }
+        
+        ImGui::Separator();
+        ImGui::Text("Rewind:");
+        if (!rewindBuffer.empty()) {
+            // Scrubbing pauses; unpause to fly on from the restored point
+            float scrubTime = (float)simTime;
+            bool seek = ImGui::SliderFloat("Time", &scrubTime, (float)rewindBuffer.getOldestTime(),
+                                           (float)rewindBuffer.getNewestTime(), "%.1f s");
+            if (ImGui::Button("Back 10 s")) {
+                scrubTime = (float)(simTime - 10.0);
+                seek = true;
+            }
+            double restoredTime;
+            if (seek && rewindBuffer.restore(scrubTime, dynamics, aircraft, restoredTime)) {
+                afterJump(restoredTime);
+            }
+        }
+        RewindBuffer::MemoryStats rewindStats = rewindBuffer.getMemoryStats();
+        ImGui::Text("History: %.0f of %.0f s, %.2f of %.2f MB", rewindStats.spanSeconds,
+                    rewindStats.capacitySeconds, rewindStats.usedBytes / 1e6, rewindStats.reservedBytes / 1e6);
+        
+        ImGui::Separator();
+        const PitotStaticReading& pitot = sensorReadings.pitotStatic;
+        ImGui::Text("Sensors: IAS %.1f kt  alt %.0f ft  VS %.0f fpm  mag hdg %.0f",
+                    pitot.indicatedAirspeed * 1.94384, pitot.altitude * 3.28084,
+                    pitot.verticalSpeed * 196.85, sensorReadings.magnetometer.heading * 180.0 / M_PI);
+        const ImuReading& imu = sensorReadings.imu;
+        ImGui::Text("IMU: f %.2f %.2f %.2f m/s2  w %.3f %.3f %.3f rad/s", imu.specificForce.x,
+                    imu.specificForce.y, imu.specificForce.z, imu.angularRate.x, imu.angularRate.y,
+                    imu.angularRate.z);
+        NavEstimate estimate = navigation.getEstimate();
+        const AircraftState& trueState = aircraft.getState();
+        Vector3 positionError = estimate.position - trueState.position;
+        double headingError = std::remainder(estimate.yaw - trueState.yaw, 2.0 * M_PI);
+        ImGui::Text("EKF: pos err %.1f m (1-sigma %.1f)  hdg err %.2f deg  %llu rejected",
+                    positionError.magnitude(), estimate.positionSigma.x, headingError * 180.0 / M_PI,
+                    (unsigned long long)navigation.getRejectedCount());
+        const PredictedPath* path = predictor.getLatest();
+        FlightPathPredictor::Stats prediction = predictor.getStats();
+        if (path && std::isfinite(path->timeToImpact)) {
+            ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Path: impact in %.1f s",
+                               path->timeToImpact - (simTime - path->simTime));
+        } else {
+            ImGui::Text("Path: clear for %.0f s", predictor.getConfig().horizon);
+        }
+        ImGui::SameLine();
+        ImGui::Text("(%.0f us per prediction, %.2f%% CPU)", prediction.meanMicroseconds,
+                    100.0 * prediction.cpuShare);
+        
+        ImGui::Separator();
+        ImGui::Text("Rate groups (%.0f Hz minor frame):", scheduler.getBaseRate());
+        for (int i = 0; i < scheduler.getGroupCount(); i++) {
+            RateScheduler::GroupStats group = scheduler.getGroupStats(i);
+            ImGui::Text("%-11s %5.0f Hz +%-2d mean %6.1f p99 %6.1f max %7.1f us  %5.2f%% CPU",
+                        group.name, group.rate, group.phase, group.meanUs, group.p99Us, group.maxUs,
+                        100.0 * group.cpuShare);
+            if (group.overruns > 0) {
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "%llu overruns",
+                                   (unsigned long long)group.overruns);
+            }
+        }
+        ImGui::Text("Frame overruns: %llu (max %.1f us)", (unsigned long long)scheduler.getFrameOverruns(),
+                    scheduler.getMaxFrameUs());
+        if (ImGui::Button("Reset group stats")) {
+            scheduler.resetStats();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export group stats")) {
+            scheduler.writeCSV("rate_groups.csv");
+        }
+        
+        ImGui::Separator();
+        ImGui::Text("Frame Pacing:");
+        static const char* pacingModes[] = {"VSync", "Uncapped", "Fixed rate"};
+        int pacingMode = (int)pacer.getMode();
+        if (ImGui::Combo("Mode", &pacingMode, pacingModes, 3)) {
+            pacer.setMode((PacingMode)pacingMode);
+            renderer.setSwapInterval(pacer.getSwapInterval());
+        }
+        if (pacer.getMode() == PacingMode::FIXED_RATE) {
+            float targetHz = (float)pacer.getTargetRate();
+            if (ImGui::SliderFloat("Target Hz", &targetHz, 30.0f, 240.0f, "%.0f")) {
+                pacer.setTargetRate(targetHz);
+            }
+        }
+        const FramePacer::Stats& pacing = pacer.getStats();
+        ImGui::Text("Interval: %.2f ms  Jitter: %.3f ms", pacing.meanIntervalMs, pacing.jitterMs);
+        ImGui::Text("Max deviation: %.2f ms  Late: %llu", pacing.maxDeviationMs,
+                    (unsigned long long)pacing.lateFrames);
+        ImGui::Text("CPU work: %.2f ms", pacing.meanWorkMs);
+        
+        bool governorEnabled = governor.isEnabled();
+        if (ImGui::Checkbox("Frame budget governor", &governorEnabled)) {
+            governor.setEnabled(governorEnabled);
+        }
+        float budget = (float)governor.getBudget();
+        if (ImGui::SliderFloat("Budget ms", &budget, 2.0f, 33.0f, "%.1f")) {
+            governor.setBudget(budget);
+        }
+        ImGui::Text("Governor level: %d/%d (%.2f ms avg)", governor.getLevel(),
+                    FrameBudgetGovernor::MAX_LEVEL, governor.getSmoothedWorkMs());
+        
+        ImGui::Separator();
+        ImGui::Checkbox("Audio debug", &showAudioDebug);
+        ImGui::SameLine();
+        ImGui::Checkbox("Envelope map", &showEnvelope);
+        ImGui::SameLine();
+        ImGui::Checkbox("Watches", &showWatches);
+        
         ImGui::End();
         
         // Render instruments
-        instruments.render(aircraft);
+        instruments.render(aircraft, airData);
+        
+        if (showAudioDebug) {
+            audioDebugPanel.render(audioSystem, &showAudioDebug);
+        }
+        if (showEnvelope) {
+            envelopePanel.render(&showEnvelope);
+        }
+        if (showWatches) {
+            watchPanel.render(watches, &showWatches);
+        }
         
         // Render 3D view
-        renderer.render3DView(aircraft);
+        renderer.render3DView(aircraft, airData, predictor.getLatest());
         
         // Finish frame
+        pacer.endWork();
+        governor.update(pacer.getStats().lastWorkMs);
         renderer.endFrame();
+        pacer.endFrame();
         
         // Check for ESC key to exit
         if (glfwGetKey(renderer.getWindow(), GLFW_KEY_ESCAPE) == GLFW_PRESS) {
@@ -125,7 +738,8 @@ int main() {
         }
     }
     
-    std::cout << "Shutting down..." << std::endl;
+    LOG_INFO("Shutting down...");
+    predictor.stop();
     audioSystem.shutdown();
     renderer.shutdown();
     
@@ -0,0 +1,106 @@
+#include "mesh.hpp"
+#include <cmath>
+
+void Mesh::addQuad(const Vector3& p0, const Vector3& p1, const Vector3& p2,
+                   const Vector3& p3, uint32_t color) {
+    uint32_t i0 = addVertex(p0);
+    uint32_t i1 = addVertex(p1);
+    uint32_t i2 = addVertex(p2);
+    uint32_t i3 = addVertex(p3);
+    addTriangle(i0, i1, i2, color);
+    addTriangle(i0, i2, i3, color);
+}
+
+void Mesh::addBox(const Vector3& lo, const Vector3& hi, uint32_t color) {
+    Vector3 c[8] = {
+        Vector3(lo.x, lo.y, lo.z), Vector3(hi.x, lo.y, lo.z),
+        Vector3(hi.x, hi.y, lo.z), Vector3(lo.x, hi.y, lo.z),
+        Vector3(lo.x, lo.y, hi.z), Vector3(hi.x, lo.y, hi.z),
+        Vector3(hi.x, hi.y, hi.z), Vector3(lo.x, hi.y, hi.z)
+    };
+
+    addQuad(c[0], c[1], c[2], c[3], color);  // Top (z down)
+    addQuad(c[4], c[7], c[6], c[5], color);  // Bottom
+    addQuad(c[0], c[4], c[5], c[1], color);  // Left
+    addQuad(c[3], c[2], c[6], c[7], color);  // Right
+    addQuad(c[1], c[5], c[6], c[2], color);  // Front
+    addQuad(c[0], c[3], c[7], c[4], color);  // Back
+}
+
+void Mesh::buildTerrain(Mesh& out, double centerNorth, double centerEast,
+                        double cellSize, int cells) {
+    out.clear();
+
+    // Field colors (grass, crops, soil)
+    static const uint32_t palette[] = {
+        packColor(86, 125, 70), packColor(104, 140, 72), packColor(74, 110, 60),
+        packColor(140, 150, 85), packColor(120, 100, 70), packColor(95, 130, 90)
+    };
+    const int paletteSize = sizeof(palette) / sizeof(palette[0]);
+
+    long long baseN = (long long)std::floor(centerNorth / cellSize) - cells / 2;
+    long long baseE = (long long)std::floor(centerEast / cellSize) - cells / 2;
+
+    // Shared vertex grid
+    for (int i = 0; i <= cells; i++) {
+        for (int j = 0; j <= cells; j++) {
+            out.vertices.push_back(Vector3((baseN + i) * cellSize, (baseE + j) * cellSize, 0.0));
+        }
+    }
+
+    for (int i = 0; i < cells; i++) {
+        for (int j = 0; j < cells; j++) {
+            // Hash the world cell index so colors are stable as the grid scrolls
+            unsigned long long h = (unsigned long long)(baseN + i) * 73856093ULL ^
+                                   (unsigned long long)(baseE + j) * 19349663ULL;
+            h ^= h >> 13;
+            uint32_t color = palette[h % paletteSize];
+
+            uint32_t v00 = i * (cells + 1) + j;
+            uint32_t v01 = v00 + 1;
+            uint32_t v10 = v00 + (cells + 1);
+            uint32_t v11 = v10 + 1;
+            out.addTriangle(v00, v10, v11, color);
+            out.addTriangle(v00, v11, v01, color);
+        }
+    }
+}
+
+Mesh Mesh::createAircraft() {
+    Mesh mesh;
+
+    uint32_t white = packColor(235, 235, 235);
+    uint32_t stripe = packColor(180, 40, 40);
+    uint32_t glass = packColor(60, 80, 110);
+    uint32_t dark = packColor(40, 40, 40);
+
+    // Engine cowling and cabin
+    mesh.addBox(Vector3(1.5, -0.55, -0.45), Vector3(3.1, 0.55, 0.55), white);
+    mesh.addBox(Vector3(-1.0, -0.6, -0.8), Vector3(1.5, 0.6, 0.6), white);
+    mesh.addBox(Vector3(0.6, -0.61, -0.8), Vector3(1.4, 0.61, -0.2), glass);
+
+    // Tapered tail boom
+    Vector3 bf[4] = { Vector3(-1.0, -0.55, -0.75), Vector3(-1.0, 0.55, -0.75),
+                      Vector3(-1.0, 0.55, 0.55), Vector3(-1.0, -0.55, 0.55) };
+    Vector3 bt[4] = { Vector3(-4.8, -0.15, -0.3), Vector3(-4.8, 0.15, -0.3),
+                      Vector3(-4.8, 0.15, 0.0), Vector3(-4.8, -0.15, 0.0) };
+    for (int i = 0; i < 4; i++) {
+        int n = (i + 1) % 4;
+        mesh.addQuad(bf[i], bt[i], bt[n], bf[n], i == 2 ? stripe : white);
+    }
+    mesh.addQuad(bt[0], bt[3], bt[2], bt[1], white);
+
+    // High wing, horizontal stabilizer and fin
+    mesh.addBox(Vector3(-0.6, -5.5, -0.95), Vector3(0.9, 5.5, -0.83), white);
+    mesh.addBox(Vector3(-4.8, -1.7, -0.12), Vector3(-3.8, 1.7, -0.04), white);
+    mesh.addBox(Vector3(-4.8, -0.05, -1.9), Vector3(-3.7, 0.05, -0.3), stripe);
+
+    // Propeller hub and fixed gear
+    mesh.addBox(Vector3(3.1, -0.15, -0.1), Vector3(3.35, 0.15, 0.2), dark);
+    mesh.addBox(Vector3(3.15, -0.9, 0.0), Vector3(3.2, 0.9, 0.1), dark);
+    mesh.addBox(Vector3(-0.2, -1.3, 0.6), Vector3(0.2, -1.1, 1.2), dark);
+    mesh.addBox(Vector3(-0.2, 1.1, 0.6), Vector3(0.2, 1.3, 1.2), dark);
+    mesh.addBox(Vector3(2.3, -0.1, 0.55), Vector3(2.6, 0.1, 1.2), dark);
+
+    return mesh;
+}
@@ -0,0 +1,295 @@
+#include "nav_ekf.hpp"
+#include <cmath>
+
+namespace {
+
+const double GRAVITY = 9.81;   // m/s^2, as in FlightDynamics
+
+// Aiding rates for process()
+const double GPS_RATE = 10.0;
+const double BARO_RATE = 10.0;
+const double HEADING_RATE = 10.0;
+
+// Chi-square gate per measurement dimension (99.99%)
+const double INNOVATION_GATE[] = {0.0, 15.14, 18.42, 21.11, 23.51, 25.74, 27.86};
+
+using Matrix3 = Matrix<3, 3>;
+
+Matrix3 skew(const Vector3& v) {
+    Matrix3 m;
+    m(0, 1) = -v.z; m(0, 2) = v.y;
+    m(1, 0) = v.z;  m(1, 2) = -v.x;
+    m(2, 0) = -v.y; m(2, 1) = v.x;
+    return m;
+}
+
+Matrix3 rotationMatrix(const Quaternion& q) {
+    Matrix3 m;
+    m(0, 0) = 1.0 - 2.0 * (q.y * q.y + q.z * q.z);
+    m(0, 1) = 2.0 * (q.x * q.y - q.w * q.z);
+    m(0, 2) = 2.0 * (q.x * q.z + q.w * q.y);
+    m(1, 0) = 2.0 * (q.x * q.y + q.w * q.z);
+    m(1, 1) = 1.0 - 2.0 * (q.x * q.x + q.z * q.z);
+    m(1, 2) = 2.0 * (q.y * q.z - q.w * q.x);
+    m(2, 0) = 2.0 * (q.x * q.z - q.w * q.y);
+    m(2, 1) = 2.0 * (q.y * q.z + q.w * q.x);
+    m(2, 2) = 1.0 - 2.0 * (q.x * q.x + q.y * q.y);
+    return m;
+}
+
+Vector3 multiply(const Matrix3& m, const Vector3& v) {
+    return Vector3(m(0, 0) * v.x + m(0, 1) * v.y + m(0, 2) * v.z,
+                   m(1, 0) * v.x + m(1, 1) * v.y + m(1, 2) * v.z,
+                   m(2, 0) * v.x + m(2, 1) * v.y + m(2, 2) * v.z);
+}
+
+// Rotation by |v| radians about v
+Quaternion fromRotationVector(const Vector3& v) {
+    double angle = v.magnitude();
+    if (angle < 1e-12) {
+        return Quaternion(1.0, 0.5 * v.x, 0.5 * v.y, 0.5 * v.z);
+    }
+    double s = std::sin(0.5 * angle) / angle;
+    return Quaternion(std::cos(0.5 * angle), v.x * s, v.y * s, v.z * s);
+}
+
+Vector3 sliceVector(const ColumnVector<NavEkf::STATES>& x, int first) {
+    return Vector3(x[first], x[first + 1], x[first + 2]);
+}
+
+using Covariance = NavEkf::Covariance;
+const int STATES = NavEkf::STATES;
+
+// Rows [to, to + 3) of out += a * rows [from, from + 3) of in. The blocks
+// are partly zero (diagonal, skew), so zero coefficients are skipped.
+void addRowProduct(Covariance& out, int to, const Matrix3& a, const Covariance& in, int from) {
+    for (int r = 0; r < 3; r++) {
+        for (int k = 0; k < 3; k++) {
+            double coefficient = a(r, k);
+            if (coefficient == 0.0) continue;
+            for (int c = 0; c < STATES; c++) out(to + r, c) += coefficient * in(from + k, c);
+        }
+    }
+}
+
+// Columns [to, to + 3) of out += columns [from, from + 3) of in * a^T
+void addColumnProduct(Covariance& out, int to, const Matrix3& a, const Covariance& in, int from) {
+    for (int r = 0; r < STATES; r++) {
+        for (int c = 0; c < 3; c++) {
+            out(r, to + c) += a(c, 0) * in(r, from) + a(c, 1) * in(r, from + 1) + a(c, 2) * in(r, from + 2);
+        }
+    }
+}
+
+double wrapAngle(double angle) {
+    return std::remainder(angle, 2.0 * M_PI);
+}
+
+bool isDue(uint64_t step, double dt, double rate) {
+    uint64_t divisor = (uint64_t)std::llround(1.0 / (rate * dt));
+    return divisor <= 1 || step % divisor == 0;
+}
+
+} // namespace
+
+NavEkfNoise NavEkfNoise::typical() {
+    NavEkfNoise noise;
+    // IMU white noise is 0.02 m/s^2 and 0.002 rad/s per 1 kHz sample; the
+    // densities allow some margin for attitude integration differences
+    noise.accelNoiseDensity = 2e-3;
+    noise.gyroNoiseDensity = 2e-4;
+    noise.accelBiasWalk = 1e-4;
+    noise.gyroBiasWalk = 1e-5;
+    noise.gpsPosition = 2.0;
+    noise.gpsVelocity = 0.1;
+    noise.baroAltitude = 4.0;      // The static pressure bias is not a state
+    noise.heading = 0.2;           // Mostly hard-iron bias
+    noise.initialPosition = 5.0;
+    noise.initialVelocity = 0.5;
+    noise.initialAttitude = 0.02;
+    noise.initialAccelBias = 0.1;
+    noise.initialGyroBias = 0.01;
+    return noise;
+}
+
+NavEkf::NavEkf(const NavEkfNoise& noise)
+    : noise(noise), predictCount(0), updateCount(0), rejectedCount(0) {
+    initialize(Vector3(0, 0, 0), Vector3(0, 0, 0), 0.0, 0.0, 0.0);
+}
+
+void NavEkf::initialize(const Vector3& newPosition, const Vector3& newVelocity, double roll, double pitch,
+                        double yaw) {
+    position = newPosition;
+    velocity = newVelocity;
+    attitude = Quaternion::fromEuler(roll, pitch, yaw);
+    accelBias = Vector3(0, 0, 0);
+    gyroBias = Vector3(0, 0, 0);
+
+    const double sigmas[] = {noise.initialPosition, noise.initialVelocity, noise.initialAttitude,
+                             noise.initialAccelBias, noise.initialGyroBias};
+    covariance = Covariance::zero();
+    for (int i = 0; i < STATES; i++) {
+        covariance(i, i) = sigmas[i / 3] * sigmas[i / 3];
+    }
+}
+
+void NavEkf::predict(const ImuReading& imu, double dt) {
+    Vector3 specificForce = imu.specificForce - accelBias;
+    Vector3 angularRate = imu.angularRate - gyroBias;
+    Matrix3 rotation = rotationMatrix(attitude);
+
+    // Nominal state: a = R f + g in NED
+    Vector3 forceNed = multiply(rotation, specificForce);
+    Vector3 acceleration = forceNed + Vector3(0, 0, GRAVITY);
+    position += velocity * dt + acceleration * (0.5 * dt * dt);
+    velocity += acceleration * dt;
+    attitude = attitude * fromRotationVector(angularRate * dt);
+    attitude.normalize();
+
+    // Error-state transition F = I + these blocks (position <- velocity,
+    // velocity <- attitude and accel bias, attitude <- gyro bias), so
+    // F P F^T is done one block row and column at a time: about a sixth of
+    // the work of the dense product
+    const Matrix3 velocityBlock = Matrix3::identity() * dt;
+    const Matrix3 attitudeBlock = skew(forceNed) * -dt;
+    const Matrix3 biasBlock = rotation * -dt;
+
+    Covariance fp = covariance;
+    addRowProduct(fp, 0, velocityBlock, covariance, 3);
+    addRowProduct(fp, 3, attitudeBlock, covariance, 6);
+    addRowProduct(fp, 3, biasBlock, covariance, 9);
+    addRowProduct(fp, 6, biasBlock, covariance, 12);
+
+    covariance = fp;
+    addColumnProduct(covariance, 0, velocityBlock, fp, 3);
+    addColumnProduct(covariance, 3, attitudeBlock, fp, 6);
+    addColumnProduct(covariance, 3, biasBlock, fp, 9);
+    addColumnProduct(covariance, 6, biasBlock, fp, 12);
+
+    const double q[] = {0.0, noise.accelNoiseDensity * noise.accelNoiseDensity,
+                        noise.gyroNoiseDensity * noise.gyroNoiseDensity, noise.accelBiasWalk * noise.accelBiasWalk,
+                        noise.gyroBiasWalk * noise.gyroBiasWalk};
+    for (int i = 3; i < STATES; i++) {
+        covariance(i, i) += q[i / 3] * dt;
+    }
+    predictCount++;
+}
+
+template <int M>
+bool NavEkf::correct(const ColumnVector<M>& innovation, const Matrix<M, STATES>& h, const Matrix<M, M>& r) {
+    Matrix<STATES, M> pht = covariance * h.transpose();
+    Matrix<M, M> s = h * pht + r;
+    Matrix<M, M> sInverse;
+    if (!invertSymmetric(s, sInverse)) {
+        rejectedCount++;
+        return false;
+    }
+    double normalized = (innovation.transpose() * sInverse * innovation)(0, 0);
+    if (normalized > INNOVATION_GATE[M]) {
+        rejectedCount++;
+        return false;
+    }
+
+    // P - K H P, using H P = (P H^T)^T, then re-symmetrized against
+    // rounding (cheaper than the Joseph form, which needs two dense products)
+    Matrix<STATES, M> gain = pht * sInverse;
+    covariance = covariance - gain * pht.transpose();
+    for (int i = 0; i < STATES; i++) {
+        for (int j = i + 1; j < STATES; j++) {
+            double mean = 0.5 * (covariance(i, j) + covariance(j, i));
+            covariance(i, j) = mean;
+            covariance(j, i) = mean;
+        }
+    }
+
+    // Fold the error estimate into the nominal state
+    ColumnVector<STATES> dx = gain * innovation;
+    position += sliceVector(dx, 0);
+    velocity += sliceVector(dx, 3);
+    attitude = fromRotationVector(sliceVector(dx, 6)) * attitude;
+    attitude.normalize();
+    accelBias += sliceVector(dx, 9);
+    gyroBias += sliceVector(dx, 12);
+    updateCount++;
+    return true;
+}
+
+bool NavEkf::updateGps(const GpsReading& gps) {
+    ColumnVector<6> innovation;
+    Vector3 positionError = gps.position - position;
+    Vector3 velocityError = gps.velocity - velocity;
+    innovation[0] = positionError.x;
+    innovation[1] = positionError.y;
+    innovation[2] = positionError.z;
+    innovation[3] = velocityError.x;
+    innovation[4] = velocityError.y;
+    innovation[5] = velocityError.z;
+
+    Matrix<6, STATES> h;
+    Matrix<6, 6> r;
+    for (int i = 0; i < 6; i++) {
+        h(i, i) = 1.0;
+        double sigma = i < 3 ? noise.gpsPosition : noise.gpsVelocity;
+        r(i, i) = sigma * sigma;
+    }
+    return correct(innovation, h, r);
+}
+
+bool NavEkf::updateBaroAltitude(double altitude) {
+    ColumnVector<1> innovation;
+    innovation[0] = altitude + position.z;
+    Matrix<1, STATES> h;
+    h(0, 2) = -1.0;
+    Matrix<1, 1> r;
+    r(0, 0) = noise.baroAltitude * noise.baroAltitude;
+    return correct(innovation, h, r);
+}
+
+bool NavEkf::updateHeading(double heading) {
+    // yaw = atan2(R10, R00); its sensitivity to a small rotation about the
+    // NED axes follows from R' = (I + [dtheta]x) R
+    Matrix3 rotation = rotationMatrix(attitude);
+    double horizontal = rotation(0, 0) * rotation(0, 0) + rotation(1, 0) * rotation(1, 0);
+    if (horizontal < 1e-6) {
+        return false;   // Pointing straight up or down, heading undefined
+    }
+
+    ColumnVector<1> innovation;
+    innovation[0] = wrapAngle(heading - std::atan2(rotation(1, 0), rotation(0, 0)));
+    Matrix<1, STATES> h;
+    h(0, 6) = -rotation(0, 0) * rotation(2, 0) / horizontal;
+    h(0, 7) = -rotation(1, 0) * rotation(2, 0) / horizontal;
+    h(0, 8) = 1.0;
+    Matrix<1, 1> r;
+    r(0, 0) = noise.heading * noise.heading;
+    return correct(innovation, h, r);
+}
+
+void NavEkf::process(const SensorReadings& readings, uint64_t step, double dt) {
+    predict(readings.imu, dt);
+    if (isDue(step, dt, GPS_RATE)) {
+        updateGps(readings.gps);
+    }
+    if (isDue(step, dt, BARO_RATE)) {
+        updateBaroAltitude(readings.pitotStatic.altitude);
+    }
+    if (isDue(step, dt, HEADING_RATE)) {
+        updateHeading(readings.magnetometer.heading + SensorSuite::getMagneticDeclination());
+    }
+}
+
+NavEstimate NavEkf::getEstimate() const {
+    NavEstimate estimate;
+    estimate.position = position;
+    estimate.velocity = velocity;
+    attitude.toEuler(estimate.roll, estimate.pitch, estimate.yaw);
+    estimate.accelBias = accelBias;
+    estimate.gyroBias = gyroBias;
+    estimate.positionSigma = Vector3(std::sqrt(covariance(0, 0)), std::sqrt(covariance(1, 1)),
+                                     std::sqrt(covariance(2, 2)));
+    estimate.velocitySigma = Vector3(std::sqrt(covariance(3, 3)), std::sqrt(covariance(4, 4)),
+                                     std::sqrt(covariance(5, 5)));
+    estimate.attitudeSigma = Vector3(std::sqrt(covariance(6, 6)), std::sqrt(covariance(7, 7)),
+                                     std::sqrt(covariance(8, 8)));
+    return estimate;
+}
@@ -0,0 +1,120 @@
+#include "offline_audio.hpp"
+#include "audio_system.hpp"
+#include "flight_dynamics.hpp"
+#include "logger.hpp"
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "../external/miniaudio.h"
+
+void recordScriptedFlight(FlightLog& log, double seconds, double dt) {
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    dynamics.reset();
+
+    int steps = (int)std::ceil(seconds / dt);
+    log.clear();
+    log.reserve(steps + 1);
+
+    AircraftState& state = aircraft.getState();
+    for (int step = 0; step <= steps; step++) {
+        double time = step * dt;
+
+        // Climb power, then idle glide (airspeed decays into the stall
+        // warning band), then nose down with a little power until touchdown
+        if (time < 20.0) {
+            state.throttle = 0.8;
+            state.elevator = 0.0;
+        } else if (time < 35.0) {
+            state.throttle = 0.0;
+            state.elevator = -0.03;
+        } else {
+            state.throttle = 0.1;
+            state.elevator = 0.05;
+        }
+        state.aileron = 0.0;
+        state.rudder = 0.0;
+
+        log.record(time, state);
+        if (dynamics.isOnGround(state)) break;
+        dynamics.update(dt);
+    }
+}
+
+bool renderFlightAudio(const FlightLog& log, const std::string& wavPath,
+                       uint32_t sampleRate, OfflineAudioStats* stats) {
+    if (log.size() < 2) {
+        LOG_WARN("Flight log is empty");
+        return false;
+    }
+
+    AudioSystem audio;
+    if (!audio.initializeOffline(sampleRate, 2)) {
+        LOG_ERROR("Failed to initialize offline audio");
+        return false;
+    }
+    const uint32_t channels = audio.getChannels();
+
+    ma_encoder encoder;
+    ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32,
+                                                      channels, sampleRate);
+    if (ma_encoder_init_file(wavPath.c_str(), &config, &encoder) != MA_SUCCESS) {
+        LOG_ERROR("Failed to open %s for writing", wavPath.c_str());
+        return false;
+    }
+
+    const uint32_t maxBlock = 4096;
+    std::vector<float> buffer((size_t)maxBlock * channels);
+    Aircraft aircraft;
+    Atmosphere atmosphere;
+    FlightDynamics dynamics(&aircraft, &atmosphere);
+    AlertEngine alerts;
+    auto start = std::chrono::steady_clock::now();
+
+    // After each sim step, pull exactly the frames up to that step's sim time
+    const double startTime = log[0].time;
+    uint64_t framesWritten = 0;
+    bool ok = true;
+
+    for (size_t i = 1; i < log.size() && ok; i++) {
+        const FlightLogSample& sample = log[i];
+        aircraft.getState() = sample.state;
+        dynamics.updateAirData();
+        const AirData& airData = dynamics.getAirData();
+
+        AlertInputs inputs;
+        inputs.altitude = airData.altitude;
+        inputs.terrainElevation = 0.0;
+        inputs.verticalSpeed = airData.verticalSpeed;
+        inputs.airspeed = airData.indicatedAirspeed;
+        inputs.timeToImpact = INFINITY;
+        alerts.evaluate(0, inputs, sample.time);
+
+        audio.update(sample.state.throttle, airData.trueAirspeed);
+        audio.processAlerts(alerts);
+
+        uint64_t targetFrames = (uint64_t)std::llround((sample.time - startTime) * sampleRate);
+        while (framesWritten < targetFrames) {
+            uint32_t block = (uint32_t)std::min<uint64_t>(maxBlock, targetFrames - framesWritten);
+            if (!audio.renderOffline(buffer.data(), block) ||
+                ma_encoder_write_pcm_frames(&encoder, buffer.data(), block, NULL) != MA_SUCCESS) {
+                LOG_ERROR("Failed to render audio at t=%.3f s", sample.time);
+                ok = false;
+                break;
+            }
+            framesWritten += block;
+        }
+    }
+
+    ma_encoder_uninit(&encoder);
+    audio.shutdown();
+
+    if (stats) {
+        stats->frames = framesWritten;
+        stats->audioSeconds = (double)framesWritten / sampleRate;
+        stats->renderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return ok;
+}
@@ -0,0 +1,169 @@
+#include "rate_scheduler.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+size_t gcd(size_t a, size_t b) {
+    while (b != 0) {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+} // namespace
+
+RateScheduler::RateScheduler(double baseRate)
+    : baseRate(baseRate), frame(0), groupCount(0), slotLoad(1, 0.0),
+      frameOverruns(0), maxFrameUs(0.0) {}
+
+int RateScheduler::addGroup(const char* name, double rate, TaskFn fn, void* context,
+                            double expectedUs, double budgetUs) {
+    if (groupCount == MAX_GROUPS) {
+        LOG_ERROR("Rate group %s: no free group slots", name);
+        return -1;
+    }
+    double ratio = rate > 0.0 ? baseRate / rate : 0.0;
+    long long divisor = std::llround(ratio);
+    if (divisor < 1 || std::fabs(ratio - (double)divisor) > 1e-9 * ratio) {
+        LOG_ERROR("Rate group %s: %.3f Hz does not divide the %.1f Hz base rate", name, rate, baseRate);
+        return -1;
+    }
+
+    // Widen the load table to the new hyperperiod
+    size_t slots = slotLoad.size();
+    size_t hyperperiod = slots / gcd(slots, (size_t)divisor) * (size_t)divisor;
+    if (hyperperiod != slots) {
+        std::vector<double> widened(hyperperiod);
+        for (size_t s = 0; s < hyperperiod; s++) {
+            widened[s] = slotLoad[s % slots];
+        }
+        slotLoad.swap(widened);
+    }
+
+    int index = groupCount++;
+    Group& group = groups[index];
+    group.name = name;
+    group.rate = baseRate / (double)divisor;
+    group.divisor = (int)divisor;
+    group.phase = choosePhase(group.divisor, expectedUs);
+    group.expectedUs = expectedUs;
+    group.budgetUs = budgetUs > 0.0 ? budgetUs : 1e6 / baseRate;
+    group.fn = fn;
+    group.context = context;
+    group.overruns = 0;
+    group.histogram.reset();
+
+    for (size_t s = (size_t)group.phase; s < slotLoad.size(); s += (size_t)group.divisor) {
+        slotLoad[s] += expectedUs;
+    }
+    return index;
+}
+
+int RateScheduler::choosePhase(int divisor, double expectedUs) const {
+    // Offset whose busiest minor frame is least loaded (then least total load)
+    int best = 0;
+    double bestPeak = 0.0, bestTotal = 0.0;
+    for (int phase = 0; phase < divisor; phase++) {
+        double peak = 0.0, total = 0.0;
+        for (size_t s = (size_t)phase; s < slotLoad.size(); s += (size_t)divisor) {
+            peak = std::max(peak, slotLoad[s] + expectedUs);
+            total += slotLoad[s];
+        }
+        if (phase == 0 || peak < bestPeak || (peak == bestPeak && total < bestTotal)) {
+            best = phase;
+            bestPeak = peak;
+            bestTotal = total;
+        }
+    }
+    return best;
+}
+
+void RateScheduler::tick() {
+    const Clock::time_point frameStart = Clock::now();
+    Clock::time_point previous = frameStart;
+
+    for (int i = 0; i < groupCount; i++) {
+        Group& group = groups[i];
+        if (frame % (uint64_t)group.divisor != (uint64_t)group.phase) continue;
+
+        group.fn(group.context);
+
+        Clock::time_point now = Clock::now();
+        double us = std::chrono::duration<double, std::micro>(now - previous).count();
+        previous = now;
+        group.histogram.record(us);
+        if (us > group.budgetUs) {
+            group.overruns++;
+            LOG_AT(LogLevel::WARN, 1, "Rate group %s overran: %.0f us (budget %.0f us)",
+                   group.name.c_str(), us, group.budgetUs);
+        }
+    }
+
+    double frameUs = std::chrono::duration<double, std::micro>(previous - frameStart).count();
+    if (frameUs > 1e6 / baseRate) frameOverruns++;
+    maxFrameUs = std::max(maxFrameUs, frameUs);
+    frame++;
+}
+
+RateScheduler::GroupStats RateScheduler::getGroupStats(int index) const {
+    const Group& group = groups[index];
+    GroupStats stats;
+    stats.name = group.name.c_str();
+    stats.rate = group.rate;
+    stats.divisor = group.divisor;
+    stats.phase = group.phase;
+    stats.budgetUs = group.budgetUs;
+    stats.runs = group.histogram.getCount();
+    stats.overruns = group.overruns;
+    stats.lastUs = group.histogram.getLast();
+    stats.meanUs = group.histogram.getMean();
+    stats.p99Us = group.histogram.percentile(0.99);
+    stats.maxUs = group.histogram.getMax();
+    stats.cpuShare = stats.meanUs * 1e-6 * group.rate;
+    return stats;
+}
+
+void RateScheduler::resetStats() {
+    for (int i = 0; i < groupCount; i++) {
+        groups[i].overruns = 0;
+        groups[i].histogram.reset();
+    }
+    frameOverruns = 0;
+    maxFrameUs = 0.0;
+}
+
+bool RateScheduler::writeCSV(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "group,rate_hz,divisor,phase,budget_us,runs,overruns,mean_us,p99_us,max_us,cpu_share\n");
+    for (int i = 0; i < groupCount; i++) {
+        GroupStats stats = getGroupStats(i);
+        std::fprintf(file, "%s,%.3f,%d,%d,%.1f,%llu,%llu,%.2f,%.2f,%.2f,%.6f\n", stats.name, stats.rate,
+                     stats.divisor, stats.phase, stats.budgetUs, (unsigned long long)stats.runs,
+                     (unsigned long long)stats.overruns, stats.meanUs, stats.p99Us, stats.maxUs,
+                     stats.cpuShare);
+    }
+    std::fprintf(file, "frame_overruns,%llu\n", (unsigned long long)frameOverruns);
+
+    std::fprintf(file, "\nhistogram,bin_upper_us,count\n");
+    for (int i = 0; i < groupCount; i++) {
+        groups[i].histogram.writeCSV(file, groups[i].name.c_str());
+    }
+
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
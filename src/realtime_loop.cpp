@@ -0,0 +1,219 @@
+#include "realtime_loop.hpp"
+#include "logger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+// Stack touched after mlockall so the loop never page-faults on it
+const size_t STACK_PREFAULT_BYTES = 64 * 1024;
+
+int64_t monotonicNs() {
+#ifdef __linux__
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void sleepUntilNs(int64_t deadline) {
+#ifdef __linux__
+    timespec target;
+    target.tv_sec = (time_t)(deadline / 1000000000);
+    target.tv_nsec = (long)(deadline % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(deadline))));
+#endif
+}
+
+void prefaultStack() {
+    unsigned char buffer[STACK_PREFAULT_BYTES];
+    volatile unsigned char* page = buffer;   // Volatile so the writes are kept
+    for (size_t i = 0; i < STACK_PREFAULT_BYTES; i += 4096) {
+        page[i] = 0;
+    }
+}
+
+} // namespace
+
+RealtimeLoop::RealtimeLoop()
+    : fn(nullptr), context(nullptr), running(false), ready(false), status(),
+      deadlineMisses(0), skippedPeriods(0) {}
+
+RealtimeLoop::~RealtimeLoop() {
+    stop();
+}
+
+bool RealtimeLoop::start(const RealtimeConfig& newConfig, StepFn newFn, void* newContext) {
+    if (thread.joinable()) {
+        LOG_ERROR("Realtime loop already running");
+        return false;
+    }
+    if (!(newConfig.rate > 0.0)) {
+        LOG_ERROR("Realtime loop: invalid rate %.3f Hz", newConfig.rate);
+        return false;
+    }
+
+    config = newConfig;
+    fn = newFn;
+    context = newContext;
+    status = Status();
+    deadlineMisses.store(0, std::memory_order_relaxed);
+    skippedPeriods.store(0, std::memory_order_relaxed);
+    lateness.reset();
+    stepTime.reset();
+
+    ready.store(false, std::memory_order_relaxed);
+    running.store(true, std::memory_order_relaxed);
+    thread = std::thread(&RealtimeLoop::run, this);
+    while (!ready.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void RealtimeLoop::stop() {
+    if (!thread.joinable()) return;
+    running.store(false, std::memory_order_relaxed);
+    thread.join();
+
+#ifdef __linux__
+    if (status.memoryLocked) {
+        munlockall();
+    }
+#endif
+}
+
+// Runs on the loop thread; each refusal leaves that part at the default
+void RealtimeLoop::applyConfig() {
+#ifdef __linux__
+    if (config.lockMemory) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            status.memoryLocked = true;
+            prefaultStack();
+        } else {
+            LOG_WARN("Realtime loop: mlockall failed (%s), memory not locked", std::strerror(errno));
+        }
+    }
+
+    if (config.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        int error = EINVAL;
+        if (config.cpu < CPU_SETSIZE) {
+            CPU_SET(config.cpu, &cpus);
+            error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        }
+        if (error == 0) {
+            status.pinned = true;
+        } else {
+            LOG_WARN("Realtime loop: cannot pin to CPU %d (%s)", config.cpu, std::strerror(error));
+        }
+    }
+
+    if (config.priority > 0) {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = config.priority;
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error == 0) {
+            status.fifo = true;
+        } else {
+            LOG_WARN("Realtime loop: SCHED_FIFO priority %d refused (%s), using normal scheduling",
+                     config.priority, std::strerror(error));
+        }
+    }
+#else
+    if (config.lockMemory || config.cpu >= 0 || config.priority > 0) {
+        LOG_WARN("Realtime loop: priority, affinity and memory locking are only supported on Linux");
+    }
+#endif
+}
+
+void RealtimeLoop::run() {
+    applyConfig();
+
+    const int64_t period = (int64_t)(1e9 / config.rate + 0.5);
+    int64_t release = monotonicNs();
+    ready.store(true, std::memory_order_release);
+
+    while (running.load(std::memory_order_relaxed)) {
+        release += period;
+        sleepUntilNs(release);
+
+        int64_t wake = monotonicNs();
+        fn(context);
+        int64_t end = monotonicNs();
+
+        lateness.record((double)(wake - release) * 1e-3);
+        stepTime.record((double)(end - wake) * 1e-3);
+
+        // Deadline is the next release; skip any releases already past
+        // instead of bursting to catch up
+        int64_t late = end - (release + period);
+        if (late > 0) {
+            deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+            int64_t missed = late / period;
+            if (missed > 0) {
+                skippedPeriods.fetch_add((uint64_t)missed, std::memory_order_relaxed);
+                release += missed * period;
+            }
+        }
+    }
+}
+
+RealtimeLoop::Stats RealtimeLoop::getStats() const {
+    Stats stats;
+    stats.steps = stepTime.getCount();
+    stats.deadlineMisses = deadlineMisses.load(std::memory_order_relaxed);
+    stats.skippedPeriods = skippedPeriods.load(std::memory_order_relaxed);
+    stats.meanLatenessUs = lateness.getMean();
+    stats.p99LatenessUs = lateness.percentile(0.99);
+    stats.maxLatenessUs = lateness.getMax();
+    stats.meanStepUs = stepTime.getMean();
+    stats.p99StepUs = stepTime.percentile(0.99);
+    stats.maxStepUs = stepTime.getMax();
+    return stats;
+}
+
+bool RealtimeLoop::writeCSV(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    Stats stats = getStats();
+    std::fprintf(file, "rate_hz,fifo,pinned,memory_locked,steps,deadline_misses,skipped_periods,"
+                       "lateness_mean_us,lateness_p99_us,lateness_max_us,step_mean_us,step_p99_us,step_max_us\n");
+    std::fprintf(file, "%.3f,%d,%d,%d,%llu,%llu,%llu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", config.rate,
+                 (int)status.fifo, (int)status.pinned, (int)status.memoryLocked, (unsigned long long)stats.steps,
+                 (unsigned long long)stats.deadlineMisses, (unsigned long long)stats.skippedPeriods,
+                 stats.meanLatenessUs, stats.p99LatenessUs, stats.maxLatenessUs, stats.meanStepUs,
+                 stats.p99StepUs, stats.maxStepUs);
+
+    std::fprintf(file, "\nhistogram,bin_upper_us,count\n");
+    lateness.writeCSV(file, "lateness");
+    stepTime.writeCSV(file, "step");
+
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
@@ -1,12 +1,17 @@
 #include "renderer.hpp"
+#include "quaternion.hpp"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <iostream>
 
-Renderer::Renderer() : window(nullptr) {}
+Renderer::Renderer()
+    : window(nullptr), scene(1280, 720), cameraMode(CameraMode::COCKPIT),
+      viewTexture(0), viewTextureWidth(0), viewTextureHeight(0),
+      swapInterval(1), sceneUpdateDivisor(1), sceneFrameCounter(0) {}
 
 Renderer::~Renderer() {
     shutdown();
@@ -37,7 +42,7 @@ bool Renderer::initialize(int width, int height, const char* title) {
     }
     
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1); // Enable vsync
+    glfwSwapInterval(swapInterval);
     
     // Setup ImGui
     IMGUI_CHECKVERSION();
@@ -57,6 +62,11 @@ bool Renderer::initialize(int width, int height, const char* title) {
 
 void Renderer::shutdown() {
     if (window) {
+        if (viewTexture) {
+            glDeleteTextures(1, &viewTexture);
+            viewTexture = 0;
+        }
+        
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
@@ -67,13 +77,22 @@ void Renderer::shutdown() {
     }
 }
 
+void Renderer::setSwapInterval(int interval) {
+    swapInterval = interval;
+    if (window) {
+        glfwSwapInterval(swapInterval);
+    }
+}
+
 bool Renderer::shouldClose() {
     return window && glfwWindowShouldClose(window);
 }
 
-void Renderer::beginFrame() {
+void Renderer::pollEvents() {
     glfwPollEvents();
-    
+}
+
+void Renderer::beginFrame() {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -99,36 +118,79 @@ void Renderer::setupOpenGL() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
-void Renderer::render3DView(const Aircraft& aircraft) {
+void Renderer::uploadViewTexture() {
+    const SoftwareRasterizer& raster = scene.getRasterizer();
+    
+    if (!viewTexture) {
+        glGenTextures(1, &viewTexture);
+        glBindTexture(GL_TEXTURE_2D, viewTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, viewTexture);
+    }
+    
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (raster.getWidth() != viewTextureWidth || raster.getHeight() != viewTextureHeight) {
+        viewTextureWidth = raster.getWidth();
+        viewTextureHeight = raster.getHeight();
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, viewTextureWidth, viewTextureHeight, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, raster.getColorBuffer());
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, viewTextureWidth, viewTextureHeight,
+                        GL_RGBA, GL_UNSIGNED_BYTE, raster.getColorBuffer());
+    }
+}
+
+void Renderer::render3DView(const Aircraft& aircraft, const AirData& airData, const PredictedPath* path) {
     const AircraftState& state = aircraft.getState();
     
     ImGui::Begin("3D View", nullptr, ImGuiWindowFlags_NoCollapse);
     
     ImVec2 windowSize = ImGui::GetContentRegionAvail();
     ImVec2 windowPos = ImGui::GetCursorScreenPos();
-    ImVec2 center(windowPos.x + windowSize.x * 0.5f, 
-                  windowPos.y + windowSize.y * 0.5f);
     
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     
+    // Out-the-window scene at the panel's resolution. Under frame budget
+    // pressure the previous image is reused between updates.
+    if (windowSize.x >= 4.0f && windowSize.y >= 1.0f) {
+        bool sizeChanged = ((int)windowSize.x & ~3) != viewTextureWidth ||
+                           (int)windowSize.y != viewTextureHeight;
+        if (sizeChanged || sceneFrameCounter % sceneUpdateDivisor == 0) {
+            scene.resize((int)windowSize.x, (int)windowSize.y);
+            scene.render(state, cameraMode);
+            uploadViewTexture();
+        }
+        sceneFrameCounter++;
+        
+        drawList->AddImage((ImTextureID)(intptr_t)viewTexture, windowPos,
+                           ImVec2(windowPos.x + windowSize.x, windowPos.y + windowSize.y));
+        drawFlightPath(state, path, windowPos, windowSize);
+    }
+    
     // Draw horizon
     drawHorizon(state.roll, state.pitch);
     
-    // Draw ground reference
-    drawGround(aircraft.getAltitude());
-    
     // Draw compass
     drawCompass(state.yaw * 180.0 / M_PI);
     
     // Info overlay
     ImGui::SetCursorPos(ImVec2(10, 30));
-    ImGui::BeginChild("3DInfo", ImVec2(250, 120), true, ImGuiWindowFlags_NoScrollbar);
+    ImGui::BeginChild("3DInfo", ImVec2(250, 170), true, ImGuiWindowFlags_NoScrollbar);
     ImGui::Text("3D VISUALIZATION");
     ImGui::Separator();
-    ImGui::Text("Altitude: %.0f ft", aircraft.getAltitude() * 3.28084);
-    ImGui::Text("Airspeed: %.0f kts", aircraft.getAirspeed() * 1.94384);
+    ImGui::Text("Altitude: %.0f ft", airData.altitude * 3.28084);
+    ImGui::Text("Airspeed: %.0f kts", airData.indicatedAirspeed * 1.94384);
     ImGui::Text("Heading: %.0f°", state.yaw * 180.0 / M_PI);
-    ImGui::Text("V/S: %.0f fpm", aircraft.getVerticalSpeed() * 196.85);
+    ImGui::Text("V/S: %.0f fpm", airData.verticalSpeed * 196.85);
+    bool chase = (cameraMode == CameraMode::CHASE);
+    if (ImGui::Checkbox("Chase camera", &chase)) {
+        cameraMode = chase ? CameraMode::CHASE : CameraMode::COCKPIT;
+    }
+    ImGui::Text("Raster: %.1f ms", scene.getRasterizer().getStats().rasterMilliseconds);
     ImGui::EndChild();
     
     ImGui::End();
@@ -180,22 +242,57 @@ void Renderer::drawHorizon(double roll, double pitch) {
     drawList->AddCircleFilled(center, 5.0f, IM_COL32(0, 255, 0, 255));
 }
 
-void Renderer::drawAircraft() {
-    // Simple aircraft representation (could be expanded)
-}
-
-void Renderer::drawGround(double altitude) {
-    ImVec2 windowSize = ImGui::GetContentRegionAvail();
-    ImVec2 windowPos = ImGui::GetCursorScreenPos();
+// Predicted path as a ribbon of ground-relative points, amber with an
+// impact marker when it meets the terrain, and the flight-path vector
+// (where the aircraft is heading now). Projected through the camera of the
+// last rasterized frame, so it stays registered with the image.
+void Renderer::drawFlightPath(const AircraftState& state, const PredictedPath* path, ImVec2 origin, ImVec2 size) {
+    const SoftwareRasterizer& raster = scene.getRasterizer();
+    float scaleX = size.x / raster.getWidth();
+    float scaleY = size.y / raster.getHeight();
+    auto toScreen = [&](const Vector3& world, ImVec2& point) {
+        double x, y;
+        if (!scene.project(world, x, y)) return false;
+        point = ImVec2(origin.x + (float)x * scaleX, origin.y + (float)y * scaleY);
+        return true;
+    };
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->PushClipRect(origin, ImVec2(origin.x + size.x, origin.y + size.y), true);
+    
+    if (path && path->count > 1) {
+        bool impact = std::isfinite(path->timeToImpact);
+        ImU32 color = impact ? IM_COL32(255, 170, 0, 230) : IM_COL32(0, 255, 140, 200);
+        ImVec2 previous;
+        bool previousVisible = toScreen(path->points[0], previous);
+        for (int i = 1; i < path->count; i++) {
+            ImVec2 point;
+            bool visible = toScreen(path->points[i], point);
+            if (visible && previousVisible) drawList->AddLine(previous, point, color, 2.0f);
+            previous = point;
+            previousVisible = visible;
+        }
+        ImVec2 marker;
+        if (impact && toScreen(path->impactPoint, marker)) {
+            drawList->AddLine(ImVec2(marker.x - 8, marker.y - 8), ImVec2(marker.x + 8, marker.y + 8), color, 3.0f);
+            drawList->AddLine(ImVec2(marker.x - 8, marker.y + 8), ImVec2(marker.x + 8, marker.y - 8), color, 3.0f);
+            char label[32];
+            std::snprintf(label, sizeof(label), "%.0f s", path->timeToImpact);
+            drawList->AddText(ImVec2(marker.x + 10, marker.y - 6), color, label);
+        }
+    }
     
-    // Ground indicator at bottom
-    if (altitude < 500.0) {
-        float groundY = windowPos.y + windowSize.y - (altitude / 500.0) * (windowSize.y * 0.3f);
-        ImDrawList* drawList = ImGui::GetWindowDrawList();
-        drawList->AddRectFilled(ImVec2(windowPos.x, groundY),
-                               ImVec2(windowPos.x + windowSize.x, windowPos.y + windowSize.y),
-                               IM_COL32(139, 90, 43, 100));
+    // Flight-path vector: a point far along the current velocity
+    Vector3 velocity = Quaternion::fromEuler(state.roll, state.pitch, state.yaw).rotate(state.velocity);
+    double speed = velocity.magnitude();
+    ImVec2 fpv;
+    if (speed > 1.0 && toScreen(state.position + velocity * (2000.0 / speed), fpv)) {
+        ImU32 color = IM_COL32(0, 255, 140, 255);
+        drawList->AddCircle(fpv, 7.0f, color, 16, 2.0f);
+        drawList->AddLine(ImVec2(fpv.x - 20, fpv.y), ImVec2(fpv.x - 7, fpv.y), color, 2.0f);
+        drawList->AddLine(ImVec2(fpv.x + 7, fpv.y), ImVec2(fpv.x + 20, fpv.y), color, 2.0f);
+        drawList->AddLine(ImVec2(fpv.x, fpv.y - 7), ImVec2(fpv.x, fpv.y - 14), color, 2.0f);
     }
+    drawList->PopClipRect();
 }
 
 void Renderer::drawCompass(double heading) {
@@ -0,0 +1,175 @@
+#include "rewind_buffer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+RewindBuffer::RewindBuffer(double dt, double seconds, int keyframeInterval, int substeps)
+    : dt(dt), substeps(std::max(1, substeps)), recordInterval(dt * std::max(1, substeps)),
+      keyframeInterval(std::max(1, keyframeInterval)) {
+    size_t steps = (size_t)std::ceil(std::max(seconds, recordInterval) / recordInterval);
+    size_t segmentCount = (steps + this->keyframeInterval - 1) / this->keyframeInterval + 1;
+    segmentArenaBytes = (size_t)(this->keyframeInterval - 1) * MAX_DELTA_BYTES;
+
+    segments.resize(segmentCount);
+    deltas.resize(segmentCount * segmentArenaBytes);
+    clear();
+}
+
+void RewindBuffer::clear() {
+    first = 0;
+    count = 0;
+    discontinuity = true;
+    resume.pending = false;
+    for (double& control : lastControls) control = 0.0;
+}
+
+void RewindBuffer::readControls(const AircraftState& state, double controls[CONTROL_COUNT]) {
+    controls[0] = state.elevator;
+    controls[1] = state.aileron;
+    controls[2] = state.rudder;
+    controls[3] = state.throttle;
+}
+
+void RewindBuffer::writeControls(AircraftState& state, const double controls[CONTROL_COUNT]) {
+    state.elevator = controls[0];
+    state.aileron = controls[1];
+    state.rudder = controls[2];
+    state.throttle = controls[3];
+}
+
+void RewindBuffer::startSegment(double simTime, const AircraftState& state) {
+    // Full: overwrite the oldest segment
+    if (count == segments.size()) {
+        first = (first + 1) % segments.size();
+        count--;
+    }
+    Segment& segment = segments[ringIndex(count)];
+    count++;
+
+    segment.keyframe = state;
+    segment.keyTime = simTime;
+    segment.steps = 1;
+    segment.deltaBytes = 0;
+}
+
+void RewindBuffer::applyResumePoint() {
+    if (!resume.pending) return;
+    resume.pending = false;
+
+    // Drop everything recorded after the restored step
+    size_t ordinal = (resume.segment + segments.size() - first) % segments.size();
+    count = ordinal + 1;
+    Segment& segment = segments[resume.segment];
+    segment.steps = resume.steps;
+    segment.deltaBytes = resume.deltaBytes;
+    std::memcpy(lastControls, resume.controls, sizeof(lastControls));
+}
+
+void RewindBuffer::record(double simTime, const AircraftState& state) {
+    applyResumePoint();
+
+    double controls[CONTROL_COUNT];
+    readControls(state, controls);
+
+    size_t last = count > 0 ? ringIndex(count - 1) : 0;
+    if (count == 0 || discontinuity || segments[last].steps >= keyframeInterval) {
+        startSegment(simTime, state);
+    } else {
+        // Mask byte, then the changed controls (bitwise comparison so the
+        // replay reproduces them exactly)
+        Segment& segment = segments[last];
+        uint8_t* out = arenaFor(last) + segment.deltaBytes;
+        uint8_t* p = out + 1;
+        uint8_t mask = 0;
+        for (int c = 0; c < CONTROL_COUNT; c++) {
+            if (std::memcmp(&controls[c], &lastControls[c], sizeof(double)) != 0) {
+                mask |= (uint8_t)(1 << c);
+                std::memcpy(p, &controls[c], sizeof(double));
+                p += sizeof(double);
+            }
+        }
+        out[0] = mask;
+        segment.deltaBytes += (int)(p - out);
+        segment.steps++;
+    }
+
+    std::memcpy(lastControls, controls, sizeof(lastControls));
+    discontinuity = false;
+}
+
+bool RewindBuffer::restore(double time, FlightDynamics& dynamics, Aircraft& aircraft, double& restoredTime) {
+    if (count == 0) return false;
+
+    // Last segment whose keyframe is at or before `time`
+    size_t low = 0, high = count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (segments[ringIndex(mid)].keyTime <= time) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    size_t index = ringIndex(low > 0 ? low - 1 : 0);
+    const Segment& segment = segments[index];
+
+    long long step = std::llround((time - segment.keyTime) / recordInterval);
+    int target = (int)std::max(0LL, std::min<long long>(step, segment.steps - 1));
+
+    // Keyframe, then re-simulate with the recorded inputs
+    AircraftState& state = aircraft.getState();
+    state = segment.keyframe;
+    double controls[CONTROL_COUNT];
+    readControls(state, controls);
+
+    const uint8_t* in = arenaFor(index);
+    int offset = 0;
+    for (int i = 1; i <= target; i++) {
+        for (int s = 0; s < substeps; s++) {
+            dynamics.update(dt);
+        }
+        uint8_t mask = in[offset++];
+        for (int c = 0; c < CONTROL_COUNT; c++) {
+            if (mask & (1 << c)) {
+                std::memcpy(&controls[c], in + offset, sizeof(double));
+                offset += sizeof(double);
+            }
+        }
+        writeControls(state, controls);
+    }
+    dynamics.updateAirData();
+
+    restoredTime = segment.keyTime + target * recordInterval;
+    resume.pending = true;
+    resume.segment = index;
+    resume.steps = target + 1;
+    resume.deltaBytes = offset;
+    std::memcpy(resume.controls, controls, sizeof(resume.controls));
+    return true;
+}
+
+double RewindBuffer::getOldestTime() const {
+    return count > 0 ? segments[first].keyTime : 0.0;
+}
+
+double RewindBuffer::getNewestTime() const {
+    if (count == 0) return 0.0;
+    const Segment& segment = segments[ringIndex(count - 1)];
+    return segment.keyTime + (segment.steps - 1) * recordInterval;
+}
+
+RewindBuffer::MemoryStats RewindBuffer::getMemoryStats() const {
+    MemoryStats stats;
+    stats.reservedBytes = segments.size() * sizeof(Segment) + deltas.size();
+    stats.usedBytes = count * sizeof(Segment);
+    stats.keyframes = count;
+    stats.steps = 0;
+    for (size_t i = 0; i < count; i++) {
+        const Segment& segment = segments[ringIndex(i)];
+        stats.usedBytes += segment.deltaBytes;
+        stats.steps += segment.steps;
+    }
+    stats.spanSeconds = count > 0 ? getNewestTime() - getOldestTime() : 0.0;
+    stats.capacitySeconds = (double)(segments.size() - 1) * keyframeInterval * recordInterval;
+    return stats;
+}
@@ -0,0 +1,58 @@
+#include "scene_renderer.hpp"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+SceneRenderer::SceneRenderer(int width, int height, unsigned int threads)
+    : rasterizer(width, height, threads), aircraftMesh(Mesh::createAircraft()) {}
+
+void SceneRenderer::render(const AircraftState& state, CameraMode mode) {
+    rasterizer.beginFrame(makeCamera(state, mode));
+
+    drawTerrain(state);
+    if (mode == CameraMode::CHASE) {
+        drawAircraft(state);
+    }
+
+    rasterizer.endFrame();
+}
+
+Camera SceneRenderer::makeCamera(const AircraftState& state, CameraMode mode) const {
+    Camera camera;
+    camera.fovY = 50.0 * M_PI / 180.0;
+    camera.farPlane = 30000.0;
+
+    if (mode == CameraMode::COCKPIT) {
+        // Pilot eye point, roughly above the wing root
+        camera.position = state.position + Vector3(0.0, 0.0, -0.6);
+        camera.roll = state.roll;
+        camera.pitch = state.pitch;
+        camera.yaw = state.yaw;
+        camera.nearPlane = 0.5;
+    } else {
+        // Trail the aircraft along its heading, level horizon
+        double cy = std::cos(state.yaw), sy = std::sin(state.yaw);
+        camera.position = state.position + Vector3(-22.0 * cy, -22.0 * sy, -6.0);
+        camera.roll = 0.0;
+        camera.pitch = -10.0 * M_PI / 180.0;
+        camera.yaw = state.yaw;
+        camera.nearPlane = 1.0;
+    }
+
+    // Keep the eye above ground
+    if (camera.position.z > -0.5) camera.position.z = -0.5;
+
+    return camera;
+}
+
+void SceneRenderer::drawTerrain(const AircraftState& state) {
+    Mesh::buildTerrain(terrainMesh, state.position.x, state.position.y,
+                       TERRAIN_CELL_SIZE, TERRAIN_CELLS);
+    rasterizer.submit(terrainMesh, Vector3(0, 0, 0));
+}
+
+void SceneRenderer::drawAircraft(const AircraftState& state) {
+    rasterizer.submit(aircraftMesh, state.position, state.roll, state.pitch, state.yaw);
+}
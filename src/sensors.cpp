@@ -0,0 +1,122 @@
+#include "sensors.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double SEA_LEVEL_DENSITY = 1.225;   // kg/m^3
+
+// Random stream channels
+const uint16_t NOISE_CHANNEL = 1;
+const uint16_t BIAS_CHANNEL = 2;
+
+// Sample layout within a step
+enum NoiseIndex {
+    STATIC_PRESSURE,
+    PITOT_PRESSURE,
+    VERTICAL_SPEED,
+    ACCEL_X, ACCEL_Y, ACCEL_Z,
+    GYRO_X, GYRO_Y, GYRO_Z,
+    MAG_X, MAG_Y, MAG_Z,
+    GPS_POSITION_X, GPS_POSITION_Y, GPS_POSITION_Z,
+    GPS_VELOCITY_X, GPS_VELOCITY_Y, GPS_VELOCITY_Z,
+    NOISE_COUNT
+};
+
+// Earth field at mid-northern latitudes (NED, gauss), ~6 deg east declination
+const Vector3 EARTH_FIELD(0.20, 0.02, 0.45);
+
+Vector3 scaled(const float* samples, double sigma) {
+    return Vector3(samples[0] * sigma, samples[1] * sigma, samples[2] * sigma);
+}
+
+// NED vector into the body frame (transpose of the body-to-NED rotation)
+Vector3 nedToBody(const AircraftState& state, const Vector3& v) {
+    double cr = std::cos(state.roll), sr = std::sin(state.roll);
+    double cp = std::cos(state.pitch), sp = std::sin(state.pitch);
+    double cy = std::cos(state.yaw), sy = std::sin(state.yaw);
+    return Vector3(cy * cp * v.x + sy * cp * v.y - sp * v.z,
+                   (cy * sp * sr - sy * cr) * v.x + (sy * sp * sr + cy * cr) * v.y + cp * sr * v.z,
+                   (cy * sp * cr + sy * sr) * v.x + (sy * sp * cr - cy * sr) * v.y + cp * cr * v.z);
+}
+
+// Body vector into NED, as FlightDynamics does for the position derivative
+Vector3 bodyToNed(const AircraftState& state, const Vector3& v) {
+    double cr = std::cos(state.roll), sr = std::sin(state.roll);
+    double cp = std::cos(state.pitch), sp = std::sin(state.pitch);
+    double cy = std::cos(state.yaw), sy = std::sin(state.yaw);
+    return Vector3(cy * cp * v.x + (cy * sp * sr - sy * cr) * v.y + (cy * sp * cr + sy * sr) * v.z,
+                   sy * cp * v.x + (sy * sp * sr + cy * cr) * v.y + (sy * sp * cr - cy * sr) * v.z,
+                   -sp * v.x + cp * sr * v.y + cp * cr * v.z);
+}
+
+} // namespace
+
+SensorErrors SensorErrors::typical() {
+    SensorErrors errors;
+    errors.staticPressureNoise = 2.0;    // ~0.17 m at sea level
+    errors.staticPressureBias = 10.0;
+    errors.pitotPressureNoise = 1.5;
+    errors.pitotPressureBias = 3.0;
+    errors.verticalSpeedNoise = 0.1;
+    errors.accelNoise = 0.02;
+    errors.accelBias = 0.05;
+    errors.gyroNoise = 0.002;
+    errors.gyroBias = 0.005;
+    errors.magNoise = 0.002;
+    errors.magBias = 0.01;
+    errors.gpsPositionNoise = 2.0;
+    errors.gpsVelocityNoise = 0.1;
+    return errors;
+}
+
+SensorSuite::SensorSuite(uint64_t seed, uint32_t entity, const SensorErrors& errors)
+    : errors(errors), noise(seed, entity, NOISE_CHANNEL) {
+    float bias[NOISE_COUNT];
+    CounterRng(seed, entity, BIAS_CHANNEL).normalBatch(0, bias, NOISE_COUNT);
+    staticPressureBias = bias[STATIC_PRESSURE] * errors.staticPressureBias;
+    pitotPressureBias = bias[PITOT_PRESSURE] * errors.pitotPressureBias;
+    accelBias = scaled(bias + ACCEL_X, errors.accelBias);
+    gyroBias = scaled(bias + GYRO_X, errors.gyroBias);
+    magBias = scaled(bias + MAG_X, errors.magBias);
+}
+
+SensorReadings SensorSuite::sample(uint64_t step, const AircraftState& state, const AirData& airData) const {
+    float n[NOISE_COUNT];
+    noise.normalBatch(step, n, NOISE_COUNT);
+    SensorReadings readings;
+
+    // Pitot-static: pressures measured, air data derived from them
+    PitotStaticReading& pitot = readings.pitotStatic;
+    double staticPressure = airData.staticPressure + staticPressureBias +
+                            n[STATIC_PRESSURE] * errors.staticPressureNoise;
+    double impactPressure = airData.dynamicPressure + pitotPressureBias +
+                            n[PITOT_PRESSURE] * errors.pitotPressureNoise;
+    pitot.altitude = atmosphere.getPressureAltitude(staticPressure);
+    pitot.indicatedAirspeed = std::sqrt(2.0 * std::max(impactPressure, 0.0) / SEA_LEVEL_DENSITY);
+    pitot.verticalSpeed = airData.verticalSpeed + n[VERTICAL_SPEED] * errors.verticalSpeedNoise;
+
+    // Strapdown IMU
+    readings.imu.specificForce = airData.specificForce + accelBias + scaled(n + ACCEL_X, errors.accelNoise);
+    readings.imu.angularRate = state.angularVelocity + gyroBias + scaled(n + GYRO_X, errors.gyroNoise);
+
+    // Magnetometer, heading tilt-compensated with the (true) attitude
+    MagnetometerReading& mag = readings.magnetometer;
+    mag.field = nedToBody(state, EARTH_FIELD) + magBias + scaled(n + MAG_X, errors.magNoise);
+    double cr = std::cos(state.roll), sr = std::sin(state.roll);
+    double cp = std::cos(state.pitch), sp = std::sin(state.pitch);
+    double horizontalX = mag.field.x * cp + mag.field.y * sr * sp + mag.field.z * cr * sp;
+    double horizontalY = mag.field.y * cr - mag.field.z * sr;
+    mag.heading = std::atan2(-horizontalY, horizontalX);
+    if (mag.heading < 0.0) mag.heading += 2.0 * M_PI;
+
+    // GPS, white noise only
+    readings.gps.position = state.position + scaled(n + GPS_POSITION_X, errors.gpsPositionNoise);
+    readings.gps.velocity = bodyToNed(state, state.velocity) + scaled(n + GPS_VELOCITY_X, errors.gpsVelocityNoise);
+
+    return readings;
+}
+
+double SensorSuite::getMagneticDeclination() {
+    return std::atan2(EARTH_FIELD.y, EARTH_FIELD.x);
+}
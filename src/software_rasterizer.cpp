@@ -0,0 +1,397 @@
+#include "software_rasterizer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RASTER_USE_SSE2 1
+#endif
+
+namespace {
+
+// Body-to-NED direction cosine matrix (same convention as FlightDynamics)
+void eulerToMatrix(double roll, double pitch, double yaw, double m[3][3]) {
+    double cr = std::cos(roll), sr = std::sin(roll);
+    double cp = std::cos(pitch), sp = std::sin(pitch);
+    double cy = std::cos(yaw), sy = std::sin(yaw);
+
+    m[0][0] = cy * cp;  m[0][1] = cy * sp * sr - sy * cr;  m[0][2] = cy * sp * cr + sy * sr;
+    m[1][0] = sy * cp;  m[1][1] = sy * sp * sr + cy * cr;  m[1][2] = sy * sp * cr - cy * sr;
+    m[2][0] = -sp;      m[2][1] = cp * sr;                 m[2][2] = cp * cr;
+}
+
+inline uint32_t scaleColor(uint32_t c, double s) {
+    int r = (int)((c & 0xFF) * s);
+    int g = (int)(((c >> 8) & 0xFF) * s);
+    int b = (int)(((c >> 16) & 0xFF) * s);
+    return packColor(std::min(r, 255), std::min(g, 255), std::min(b, 255));
+}
+
+inline uint32_t lerpColor(uint32_t a, uint32_t b, double t) {
+    int r = (int)((a & 0xFF) + (((int)(b & 0xFF) - (int)(a & 0xFF)) * t));
+    int g = (int)(((a >> 8) & 0xFF) + (((int)((b >> 8) & 0xFF) - (int)((a >> 8) & 0xFF)) * t));
+    int bl = (int)(((a >> 16) & 0xFF) + (((int)((b >> 16) & 0xFF) - (int)((a >> 16) & 0xFF)) * t));
+    return packColor(r, g, bl);
+}
+
+const uint32_t SKY_ZENITH = packColor(70, 120, 200);
+const uint32_t SKY_HORIZON = packColor(175, 200, 225);
+const uint32_t GROUND_HAZE = packColor(130, 145, 120);
+
+// Sun direction (NED, pointing towards the sun)
+const Vector3 SUN_DIRECTION = Vector3(0.4, 0.3, -0.85).normalized();
+
+// Visibility for distance haze (m)
+const double HAZE_DISTANCE = 12000.0;
+
+} // namespace
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height, unsigned int threads)
+    : width(0), height(0), tilesX(0), tilesY(0), worldToCamera(), focalLength(1.0),
+      horizonA(0.0f), horizonB(0.0f), horizonC(0.0f), stats(), pool(threads) {
+    camera = Camera{Vector3(), 0.0, 0.0, 0.0, 1.0, 0.5, 30000.0};
+    resize(width, height);
+}
+
+void SoftwareRasterizer::resize(int w, int h) {
+    w = std::max(4, w & ~3);
+    h = std::max(1, h);
+    if (w == width && h == height) return;
+
+    width = w;
+    height = h;
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    color.assign((size_t)width * height, 0);
+    depth.assign((size_t)width * height, 0.0f);
+    tileBins.resize((size_t)tilesX * tilesY);
+}
+
+void SoftwareRasterizer::beginFrame(const Camera& cam) {
+    camera = cam;
+
+    double camToWorld[3][3];
+    eulerToMatrix(camera.roll, camera.pitch, camera.yaw, camToWorld);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            worldToCamera[i][j] = camToWorld[j][i];
+
+    focalLength = (height * 0.5) / std::tan(camera.fovY * 0.5);
+
+    // World "down" component of the view ray through a pixel center:
+    // ray_cam = (1, (x - cx) / f, (y - cy) / f), down = row 2 of camToWorld
+    double cx = width * 0.5, cy = height * 0.5;
+    horizonA = (float)(camToWorld[2][1] / focalLength);
+    horizonB = (float)(camToWorld[2][2] / focalLength);
+    horizonC = (float)(camToWorld[2][0] - camToWorld[2][1] * (cx - 0.5) / focalLength
+                       - camToWorld[2][2] * (cy - 0.5) / focalLength);
+
+    setupTriangles.clear();
+    for (auto& bin : tileBins) bin.clear();
+
+    stats = Stats();
+}
+
+void SoftwareRasterizer::submit(const Mesh& mesh, const Vector3& translation,
+                                double roll, double pitch, double yaw) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Combined model-to-camera transform
+    double modelToWorld[3][3];
+    eulerToMatrix(roll, pitch, yaw, modelToWorld);
+
+    double m[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            m[i][j] = worldToCamera[i][0] * modelToWorld[0][j] +
+                      worldToCamera[i][1] * modelToWorld[1][j] +
+                      worldToCamera[i][2] * modelToWorld[2][j];
+
+    Vector3 rel = translation - camera.position;
+    Vector3 offset(worldToCamera[0][0] * rel.x + worldToCamera[0][1] * rel.y + worldToCamera[0][2] * rel.z,
+                   worldToCamera[1][0] * rel.x + worldToCamera[1][1] * rel.y + worldToCamera[1][2] * rel.z,
+                   worldToCamera[2][0] * rel.x + worldToCamera[2][1] * rel.y + worldToCamera[2][2] * rel.z);
+
+    Vector3 sun(worldToCamera[0][0] * SUN_DIRECTION.x + worldToCamera[0][1] * SUN_DIRECTION.y + worldToCamera[0][2] * SUN_DIRECTION.z,
+                worldToCamera[1][0] * SUN_DIRECTION.x + worldToCamera[1][1] * SUN_DIRECTION.y + worldToCamera[1][2] * SUN_DIRECTION.z,
+                worldToCamera[2][0] * SUN_DIRECTION.x + worldToCamera[2][1] * SUN_DIRECTION.y + worldToCamera[2][2] * SUN_DIRECTION.z);
+
+    auto toView = [&](const Vector3& p) {
+        return Vector3(m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + offset.x,
+                       m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + offset.y,
+                       m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + offset.z);
+    };
+
+    const double nearPlane = camera.nearPlane;
+
+    for (const MeshTriangle& tri : mesh.triangles) {
+        stats.trianglesSubmitted++;
+
+        Vector3 v[3] = { toView(mesh.vertices[tri.a]),
+                         toView(mesh.vertices[tri.b]),
+                         toView(mesh.vertices[tri.c]) };
+
+        // Trivial rejects (camera x is depth)
+        if (v[0].x < nearPlane && v[1].x < nearPlane && v[2].x < nearPlane) continue;
+        if (v[0].x > camera.farPlane && v[1].x > camera.farPlane && v[2].x > camera.farPlane) continue;
+
+        // Flat shading, double sided
+        Vector3 normal = (v[1] - v[0]).cross(v[2] - v[0]).normalized();
+        double light = 0.45 + 0.55 * std::abs(normal.dot(sun));
+
+        // Distance haze
+        Vector3 centroid = (v[0] + v[1] + v[2]) / 3.0;
+        double haze = std::min(1.0, centroid.magnitude() / HAZE_DISTANCE);
+        uint32_t shaded = lerpColor(scaleColor(tri.color, light), GROUND_HAZE, haze * haze);
+
+        // Clip against the near plane (Sutherland-Hodgman, one plane)
+        Vector3 clipped[4];
+        int count = 0;
+        for (int i = 0; i < 3; i++) {
+            const Vector3& a = v[i];
+            const Vector3& b = v[(i + 1) % 3];
+            bool aIn = a.x >= nearPlane;
+            bool bIn = b.x >= nearPlane;
+            if (aIn) clipped[count++] = a;
+            if (aIn != bIn) {
+                double t = (nearPlane - a.x) / (b.x - a.x);
+                clipped[count++] = a + (b - a) * t;
+            }
+        }
+
+        for (int i = 1; i + 1 < count; i++) {
+            setupTriangle(clipped[0], clipped[i], clipped[i + 1], shaded);
+        }
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    stats.binMilliseconds += elapsed.count();
+}
+
+bool SoftwareRasterizer::project(const Vector3& world, double& x, double& y) const {
+    Vector3 rel = world - camera.position;
+    double depth = worldToCamera[0][0] * rel.x + worldToCamera[0][1] * rel.y + worldToCamera[0][2] * rel.z;
+    if (depth < camera.nearPlane) return false;
+    double right = worldToCamera[1][0] * rel.x + worldToCamera[1][1] * rel.y + worldToCamera[1][2] * rel.z;
+    double down = worldToCamera[2][0] * rel.x + worldToCamera[2][1] * rel.y + worldToCamera[2][2] * rel.z;
+    x = width * 0.5 + focalLength * right / depth;
+    y = height * 0.5 + focalLength * down / depth;
+    return true;
+}
+
+void SoftwareRasterizer::setupTriangle(const Vector3& v0, const Vector3& v1,
+                                       const Vector3& v2, uint32_t triColor) {
+    double cx = width * 0.5, cy = height * 0.5;
+
+    double x[3], y[3], z[3];
+    const Vector3* v[3] = { &v0, &v1, &v2 };
+    for (int i = 0; i < 3; i++) {
+        double invW = 1.0 / v[i]->x;
+        x[i] = cx + focalLength * v[i]->y * invW;
+        y[i] = cy + focalLength * v[i]->z * invW;
+        z[i] = invW;
+    }
+
+    double area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (std::abs(area) < 1e-8) return;
+
+    double minX = std::min(x[0], std::min(x[1], x[2]));
+    double maxX = std::max(x[0], std::max(x[1], x[2]));
+    double minY = std::min(y[0], std::min(y[1], y[2]));
+    double maxY = std::max(y[0], std::max(y[1], y[2]));
+
+    SetupTriangle t;
+    t.minX = (int)std::max(0.0, std::floor(minX));
+    t.minY = (int)std::max(0.0, std::floor(minY));
+    t.maxX = (int)std::min((double)width - 1, std::floor(maxX));
+    t.maxY = (int)std::min((double)height - 1, std::floor(maxY));
+    if (t.minX > t.maxX || t.minY > t.maxY) return;
+
+    // Edge functions opposite each vertex, oriented so the interior is >= 0
+    // and evaluated at pixel centers
+    double sign = area > 0.0 ? 1.0 : -1.0;
+    double A[3], B[3], C[3];
+    for (int i = 0; i < 3; i++) {
+        int a = (i + 1) % 3;
+        int b = (i + 2) % 3;
+        A[i] = sign * (y[a] - y[b]);
+        B[i] = sign * (x[b] - x[a]);
+        C[i] = -(A[i] * x[a] + B[i] * y[a]) + 0.5 * (A[i] + B[i]);
+    }
+
+    // 1/w is affine in screen space
+    double invArea = 1.0 / std::abs(area);
+    double dA = (A[0] * z[0] + A[1] * z[1] + A[2] * z[2]) * invArea;
+    double dB = (B[0] * z[0] + B[1] * z[1] + B[2] * z[2]) * invArea;
+    double dC = (C[0] * z[0] + C[1] * z[1] + C[2] * z[2]) * invArea;
+
+    // Store coefficients relative to the triangle's bounding-box origin so the
+    // float values used in the inner loop stay small
+    double ox = t.minX, oy = t.minY;
+    for (int i = 0; i < 3; i++) {
+        t.edgeA[i] = (float)A[i];
+        t.edgeB[i] = (float)B[i];
+        t.edgeC[i] = (float)(C[i] + A[i] * ox + B[i] * oy);
+    }
+    t.depthA = (float)dA;
+    t.depthB = (float)dB;
+    t.depthC = (float)(dC + dA * ox + dB * oy);
+    t.color = triColor;
+
+    uint32_t index = (uint32_t)setupTriangles.size();
+    setupTriangles.push_back(t);
+
+    int tx0 = t.minX / TILE_SIZE, tx1 = t.maxX / TILE_SIZE;
+    int ty0 = t.minY / TILE_SIZE, ty1 = t.maxY / TILE_SIZE;
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            tileBins[ty * tilesX + tx].push_back(index);
+            stats.tileBinEntries++;
+        }
+    }
+    stats.trianglesRasterized++;
+}
+
+void SoftwareRasterizer::endFrame() {
+    auto start = std::chrono::steady_clock::now();
+
+    pool.parallelFor((size_t)tilesX * tilesY, [this](size_t tile) {
+        rasterizeTile((int)tile);
+    });
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    stats.rasterMilliseconds = elapsed.count();
+}
+
+void SoftwareRasterizer::clearTile(int x0, int y0, int x1, int y1) {
+    for (int y = y0; y < y1; y++) {
+        uint32_t* row = &color[(size_t)y * width];
+        float* depthRow = &depth[(size_t)y * width];
+        float down = horizonA * x0 + horizonB * y + horizonC;
+
+        for (int x = x0; x < x1; x++) {
+            if (down > 0.0f) {
+                row[x] = GROUND_HAZE;
+            } else {
+                float t = std::min(1.0f, -down * 1.5f);
+                row[x] = lerpColor(SKY_HORIZON, SKY_ZENITH, t);
+            }
+            depthRow[x] = 0.0f;
+            down += horizonA;
+        }
+    }
+}
+
+void SoftwareRasterizer::rasterizeTile(int tileIndex) {
+    int tx = tileIndex % tilesX;
+    int ty = tileIndex / tilesX;
+    int x0 = tx * TILE_SIZE, y0 = ty * TILE_SIZE;
+    int x1 = std::min(x0 + TILE_SIZE, width);
+    int y1 = std::min(y0 + TILE_SIZE, height);
+
+    clearTile(x0, y0, x1, y1);
+
+    for (uint32_t index : tileBins[tileIndex]) {
+        const SetupTriangle& t = setupTriangles[index];
+
+        // Start on a 4-pixel boundary; the edge test rejects the extra pixels
+        int bx0 = std::max(t.minX, x0) & ~3;
+        int bx1 = std::min(t.maxX, x1 - 1);
+        int by0 = std::max(t.minY, y0);
+        int by1 = std::min(t.maxY, y1 - 1);
+        if (bx0 > bx1 || by0 > by1) continue;
+
+        float fx = (float)(bx0 - t.minX);
+
+#ifdef RASTER_USE_SSE2
+        const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 a0 = _mm_set1_ps(t.edgeA[0]);
+        const __m128 a1 = _mm_set1_ps(t.edgeA[1]);
+        const __m128 a2 = _mm_set1_ps(t.edgeA[2]);
+        const __m128 step0 = _mm_set1_ps(t.edgeA[0] * 4.0f);
+        const __m128 step1 = _mm_set1_ps(t.edgeA[1] * 4.0f);
+        const __m128 step2 = _mm_set1_ps(t.edgeA[2] * 4.0f);
+        const __m128 stepZ = _mm_set1_ps(t.depthA * 4.0f);
+        const __m128i triColor = _mm_set1_epi32((int)t.color);
+
+        for (int y = by0; y <= by1; y++) {
+            float fy = (float)(y - t.minY);
+            __m128 e0 = _mm_add_ps(_mm_set1_ps(t.edgeB[0] * fy + t.edgeC[0] + t.edgeA[0] * fx), _mm_mul_ps(a0, lane));
+            __m128 e1 = _mm_add_ps(_mm_set1_ps(t.edgeB[1] * fy + t.edgeC[1] + t.edgeA[1] * fx), _mm_mul_ps(a1, lane));
+            __m128 e2 = _mm_add_ps(_mm_set1_ps(t.edgeB[2] * fy + t.edgeC[2] + t.edgeA[2] * fx), _mm_mul_ps(a2, lane));
+            __m128 z = _mm_add_ps(_mm_set1_ps(t.depthB * fy + t.depthC + t.depthA * fx),
+                                  _mm_mul_ps(_mm_set1_ps(t.depthA), lane));
+
+            uint32_t* row = &color[(size_t)y * width];
+            float* depthRow = &depth[(size_t)y * width];
+
+            for (int x = bx0; x <= bx1; x += 4) {
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                           _mm_cmpge_ps(e2, zero));
+                if (_mm_movemask_ps(inside)) {
+                    __m128 d = _mm_loadu_ps(depthRow + x);
+                    __m128 mask = _mm_and_ps(inside, _mm_cmpgt_ps(z, d));
+                    if (_mm_movemask_ps(mask)) {
+                        _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, d)));
+
+                        __m128i maski = _mm_castps_si128(mask);
+                        __m128i c = _mm_loadu_si128((const __m128i*)(row + x));
+                        c = _mm_or_si128(_mm_and_si128(maski, triColor), _mm_andnot_si128(maski, c));
+                        _mm_storeu_si128((__m128i*)(row + x), c);
+                    }
+                }
+                e0 = _mm_add_ps(e0, step0);
+                e1 = _mm_add_ps(e1, step1);
+                e2 = _mm_add_ps(e2, step2);
+                z = _mm_add_ps(z, stepZ);
+            }
+        }
+#else
+        for (int y = by0; y <= by1; y++) {
+            float fy = (float)(y - t.minY);
+            uint32_t* row = &color[(size_t)y * width];
+            float* depthRow = &depth[(size_t)y * width];
+
+            for (int x = bx0; x <= bx1; x++) {
+                float px = (float)(x - t.minX);
+                float e0 = t.edgeA[0] * px + t.edgeB[0] * fy + t.edgeC[0];
+                float e1 = t.edgeA[1] * px + t.edgeB[1] * fy + t.edgeC[1];
+                float e2 = t.edgeA[2] * px + t.edgeB[2] * fy + t.edgeC[2];
+                if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f) continue;
+
+                float z = t.depthA * px + t.depthB * fy + t.depthC;
+                if (z > depthRow[x]) {
+                    depthRow[x] = z;
+                    row[x] = t.color;
+                }
+            }
+        }
+#endif
+    }
+}
+
+bool SoftwareRasterizer::writePPM(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+    std::vector<unsigned char> rowBytes((size_t)width * 3);
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = &color[(size_t)y * width];
+        for (int x = 0; x < width; x++) {
+            rowBytes[x * 3 + 0] = (unsigned char)(row[x] & 0xFF);
+            rowBytes[x * 3 + 1] = (unsigned char)((row[x] >> 8) & 0xFF);
+            rowBytes[x * 3 + 2] = (unsigned char)((row[x] >> 16) & 0xFF);
+        }
+        std::fwrite(rowBytes.data(), 1, rowBytes.size(), file);
+    }
+
+    bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    return ok;
+}
@@ -0,0 +1,71 @@
+#include "state_hash.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+bool StateHashStream::saveCSV(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "step,hash\n");
+    for (size_t step = 0; step < hashes.size(); step++) {
+        std::fprintf(file, "%zu,%016" PRIx64 "\n", step, hashes[step]);
+    }
+
+    bool ok = std::fclose(file) == 0;
+    if (!ok) {
+        LOG_ERROR("Failed to write %s", path.c_str());
+    }
+    return ok;
+}
+
+bool StateHashStream::loadCSV(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "r");
+    if (!file) {
+        LOG_ERROR("Failed to open %s", path.c_str());
+        return false;
+    }
+
+    hashes.clear();
+    char line[128];
+    int lineNumber = 0;
+    bool ok = true;
+
+    while (std::fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        if (lineNumber == 1 || line[0] == '\n') continue;   // Header
+
+        size_t step;
+        uint64_t hash;
+        if (std::sscanf(line, "%zu,%" SCNx64, &step, &hash) != 2 || step != hashes.size()) {
+            LOG_ERROR("%s:%d: expected step %zu,<hash>", path.c_str(), lineNumber, hashes.size());
+            ok = false;
+            break;
+        }
+        hashes.push_back(hash);
+    }
+
+    std::fclose(file);
+    return ok;
+}
+
+size_t StateHashStream::firstDivergence(const StateHashStream& a, const StateHashStream& b) {
+    size_t count = std::min(a.size(), b.size());
+    if (count == 0 || a[count - 1] == b[count - 1]) return NO_DIVERGENCE;
+
+    // Invariant: the streams agree before `low` and differ at `high`
+    size_t low = 0, high = count - 1;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (a[middle] == b[middle]) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return high;
+}
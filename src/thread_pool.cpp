@@ -0,0 +1,82 @@
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : task(nullptr), taskContext(nullptr), taskCount(0), nextIndex(0),
+      busyWorkers(0), generation(0), stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+
+    // The calling thread is the first worker
+    for (unsigned int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(size_t count, TaskFn fn, void* context) {
+    if (count == 0) return;
+
+    if (workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) fn(context, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = fn;
+        taskContext = context;
+        taskCount = count;
+        nextIndex.store(0, std::memory_order_relaxed);
+        busyWorkers = (unsigned int)workers.size();
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    drain();
+
+    // Workers may still be finishing the last indices they claimed
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return busyWorkers == 0; });
+}
+
+void ThreadPool::drain() {
+    for (;;) {
+        size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= taskCount) break;
+        task(taskContext, index);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seenGeneration = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        drain();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+            if (busyWorkers == 0) doneCondition.notify_one();
+        }
+    }
+}
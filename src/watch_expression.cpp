@@ -0,0 +1,1344 @@
+#include "watch_expression.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+using Op = WatchProgram::Op;
+using Instruction = WatchProgram::Instruction;
+using Clock = std::chrono::steady_clock;
+
+struct Variable {
+    const char* name;
+    const char* description;
+    size_t offset;   // Of the double in WatchSample
+};
+
+#define WATCH_FIELD(member) offsetof(WatchSample, member)
+
+const Variable VARIABLES[] = {
+    {"time", "sim time, s", WATCH_FIELD(time)},
+    {"north", "position north, m", WATCH_FIELD(state.position.x)},
+    {"east", "position east, m", WATCH_FIELD(state.position.y)},
+    {"down", "position down, m", WATCH_FIELD(state.position.z)},
+    {"u", "body velocity x, m/s", WATCH_FIELD(state.velocity.x)},
+    {"v", "body velocity y, m/s", WATCH_FIELD(state.velocity.y)},
+    {"w", "body velocity z, m/s", WATCH_FIELD(state.velocity.z)},
+    {"p", "roll rate, rad/s", WATCH_FIELD(state.angularVelocity.x)},
+    {"q", "pitch rate, rad/s", WATCH_FIELD(state.angularVelocity.y)},
+    {"r", "yaw rate, rad/s", WATCH_FIELD(state.angularVelocity.z)},
+    {"roll", "rad", WATCH_FIELD(state.roll)},
+    {"pitch", "rad", WATCH_FIELD(state.pitch)},
+    {"yaw", "rad", WATCH_FIELD(state.yaw)},
+    {"elevator", "-1 to 1", WATCH_FIELD(state.elevator)},
+    {"aileron", "-1 to 1", WATCH_FIELD(state.aileron)},
+    {"rudder", "-1 to 1", WATCH_FIELD(state.rudder)},
+    {"throttle", "0 to 1", WATCH_FIELD(state.throttle)},
+    {"altitude", "m above sea level", WATCH_FIELD(airData.altitude)},
+    {"vs", "vertical speed, m/s up", WATCH_FIELD(airData.verticalSpeed)},
+    {"airspeed", "true airspeed, m/s", WATCH_FIELD(airData.trueAirspeed)},
+    {"tas", "true airspeed, m/s", WATCH_FIELD(airData.trueAirspeed)},
+    {"ias", "indicated airspeed, m/s", WATCH_FIELD(airData.indicatedAirspeed)},
+    {"mach", "Mach number", WATCH_FIELD(airData.mach)},
+    {"alpha", "angle of attack, rad", WATCH_FIELD(airData.alpha)},
+    {"beta", "sideslip, rad", WATCH_FIELD(airData.beta)},
+    {"qbar", "dynamic pressure, Pa", WATCH_FIELD(airData.dynamicPressure)},
+    {"density", "kg/m^3", WATCH_FIELD(airData.density)},
+    {"pressure", "static pressure, Pa", WATCH_FIELD(airData.staticPressure)},
+    {"density_altitude", "m", WATCH_FIELD(airData.densityAltitude)},
+    {"nz", "load factor, g", WATCH_FIELD(airData.loadFactor)},
+    {"ax", "specific force x, m/s^2", WATCH_FIELD(airData.specificForce.x)},
+    {"ay", "specific force y, m/s^2", WATCH_FIELD(airData.specificForce.y)},
+    {"az", "specific force z, m/s^2", WATCH_FIELD(airData.specificForce.z)},
+    {"turn_rate", "heading rate, rad/s", WATCH_FIELD(airData.turnRate)},
+};
+
+#undef WATCH_FIELD
+
+const int VARIABLE_COUNT = (int)(sizeof(VARIABLES) / sizeof(VARIABLES[0]));
+static_assert(sizeof(VARIABLES) / sizeof(VARIABLES[0]) <= 64, "variable mask is 64 bits");
+
+const size_t STATE_START = offsetof(WatchSample, state);
+const size_t AIR_DATA_START = offsetof(WatchSample, airData);
+
+inline bool isStateVariable(int v) {
+    return VARIABLES[v].offset >= STATE_START && VARIABLES[v].offset < AIR_DATA_START;
+}
+
+struct Unit {
+    const char* name;
+    double scale;   // To SI
+};
+
+const Unit UNITS[] = {
+    {"deg", M_PI / 180.0}, {"\xC2\xB0", M_PI / 180.0}, {"rad", 1.0}, {"kt", 1852.0 / 3600.0},
+    {"ft", 0.3048}, {"fpm", 0.3048 / 60.0}, {"m", 1.0}, {"s", 1.0},
+};
+
+inline double readVariable(const WatchSample& sample, size_t offset) {
+    double value;
+    std::memcpy(&value, (const char*)&sample + offset, sizeof(value));
+    return value;
+}
+
+double applyBinary(Op op, double a, double b) {
+    switch (op) {
+        case Op::ADD: return a + b;
+        case Op::SUB: return a - b;
+        case Op::MUL: return a * b;
+        case Op::DIV: return a / b;
+        case Op::MIN: return b < a ? b : a;
+        case Op::MAX: return b > a ? b : a;
+        case Op::LT: return a < b ? 1.0 : 0.0;
+        case Op::LE: return a <= b ? 1.0 : 0.0;
+        case Op::GT: return a > b ? 1.0 : 0.0;
+        case Op::GE: return a >= b ? 1.0 : 0.0;
+        case Op::EQ: return a == b ? 1.0 : 0.0;
+        case Op::NE: return a != b ? 1.0 : 0.0;
+        case Op::AND: return a != 0.0 && b != 0.0 ? 1.0 : 0.0;
+        case Op::OR: return a != 0.0 || b != 0.0 ? 1.0 : 0.0;
+        default: return 0.0;
+    }
+}
+
+double applyUnary(Op op, double a) {
+    switch (op) {
+        case Op::NEG: return -a;
+        case Op::ABS: return std::fabs(a);
+        case Op::SQRT: return std::sqrt(a);
+        case Op::NOT: return a == 0.0 ? 1.0 : 0.0;
+        default: return 0.0;
+    }
+}
+
+// The scalar interpreter, over any source of variable values
+template <typename Read>
+double evaluateProgram(const WatchProgram& program, Read read) {
+    const std::vector<Instruction>& code = program.getInstructions();
+    const std::vector<double>& constants = program.getConstants();
+    double stack[WatchProgram::MAX_DEPTH];
+    int top = -1;
+    for (size_t pc = 0; pc < code.size(); pc++) {
+        const Instruction& instruction = code[pc];
+        switch (instruction.op) {
+            case Op::VARIABLE:
+                stack[++top] = read(instruction.operand);
+                break;
+            case Op::CONSTANT:
+                stack[++top] = constants[instruction.operand];
+                break;
+            case Op::NEG: case Op::ABS: case Op::SQRT: case Op::NOT:
+                stack[top] = applyUnary(instruction.op, stack[top]);
+                break;
+            case Op::JUMP_IF_FALSE: case Op::JUMP_IF_TRUE:
+                stack[top] = stack[top] != 0.0 ? 1.0 : 0.0;
+                if ((stack[top] != 0.0) == (instruction.op == Op::JUMP_IF_TRUE)) pc = instruction.operand - 1;
+                break;
+            default:
+                if (instruction.constantOperand) {
+                    stack[top] = applyBinary(instruction.op, stack[top], constants[instruction.operand]);
+                } else {
+                    top--;
+                    stack[top] = applyBinary(instruction.op, stack[top], stack[top + 1]);
+                }
+                break;
+        }
+    }
+    return top == 0 ? stack[0] : 0.0;
+}
+
+// A variable straight from what record() is given
+inline double stepValue(int v, double simTime, const AircraftState& state, const AirData& airData) {
+    if (v == 0) return simTime;
+    double value;
+    if (isStateVariable(v)) {
+        std::memcpy(&value, (const char*)&state + (VARIABLES[v].offset - STATE_START), sizeof(value));
+    } else {
+        std::memcpy(&value, (const char*)&airData + (VARIABLES[v].offset - AIR_DATA_START), sizeof(value));
+    }
+    return value;
+}
+
+// A watch that keeps leaving its boxes (one hovering at its threshold) is
+// cheaper left live than settled again and again: it searches for a new box
+// up to SEARCH_BURST more times in a row, then once per SEARCH_INTERVAL
+// steps; in between it settles only in boxes it found before
+const uint64_t SEARCH_INTERVAL = 1000 * WatchEngine::BLOCK;
+const uint64_t SEARCH_BURST = 3;
+
+inline int lowestBit(uint64_t bits) {
+    return __builtin_ctzll(bits);
+}
+
+// Recursive descent straight to bytecode, lowest precedence first:
+// || , && , comparison, + -, * /, unary, primary
+class Parser {
+public:
+    Parser(const std::string& text, std::vector<Instruction>& code, std::vector<double>& constants)
+        : text(text), position(0), code(code), constants(constants), depth(0), maxDepth(0), mask(0) {}
+
+    bool parse(std::string& error) {
+        bool ok = parseOr();
+        skipSpace();
+        if (ok && position < text.size()) ok = fail("unexpected '" + text.substr(position, 1) + "'");
+        if (ok && code.size() > (size_t)WatchProgram::MAX_INSTRUCTIONS) ok = fail("expression too long");
+        if (!ok) error = "column " + std::to_string(errorPosition + 1) + ": " + message;
+        return ok;
+    }
+
+    int getMaxDepth() const { return maxDepth; }
+    uint64_t getVariableMask() const { return mask; }
+
+private:
+    const std::string& text;
+    size_t position;
+    std::vector<Instruction>& code;
+    std::vector<double>& constants;
+    int depth;
+    int maxDepth;
+    uint64_t mask;
+    size_t errorPosition = 0;
+    std::string message;
+
+    bool fail(const std::string& what) {
+        errorPosition = position;
+        message = what;
+        return false;
+    }
+
+    void skipSpace() {
+        while (position < text.size() && std::isspace((unsigned char)text[position])) position++;
+    }
+
+    bool accept(const char* token) {
+        skipSpace();
+        size_t length = std::strlen(token);
+        if (text.compare(position, length, token) != 0) return false;
+        // Word operators must end at a word boundary
+        if (std::isalpha((unsigned char)token[0]) && position + length < text.size() &&
+            (std::isalnum((unsigned char)text[position + length]) || text[position + length] == '_')) {
+            return false;
+        }
+        position += length;
+        return true;
+    }
+
+    std::string peekWord() {
+        skipSpace();
+        size_t end = position;
+        while (end < text.size() && (std::isalnum((unsigned char)text[end]) || text[end] == '_')) end++;
+        return text.substr(position, end - position);
+    }
+
+    bool push(Instruction instruction) {
+        code.push_back(instruction);
+        if (++depth > WatchProgram::MAX_DEPTH) return fail("expression nested too deeply");
+        if (depth > maxDepth) maxDepth = depth;
+        return true;
+    }
+
+    bool pushConstant(double value) {
+        constants.push_back(value);
+        return push({Op::CONSTANT, false, (uint16_t)(constants.size() - 1)});
+    }
+
+    bool lastIsConstant(size_t back = 1) const {
+        return code.size() >= back && code[code.size() - back].op == Op::CONSTANT;
+    }
+
+    // Constant operands are folded or moved into the operator. The result
+    // takes the index of the first instruction it replaces, so a jump
+    // target (always right after an AND/OR) stays valid.
+    void emitBinary(Op op) {
+        depth--;
+        if (lastIsConstant(1) && lastIsConstant(2)) {
+            double b = constants[code.back().operand];
+            code.pop_back();
+            constants[code.back().operand] = applyBinary(op, constants[code.back().operand], b);
+        } else if (lastIsConstant(1)) {
+            code.back() = {op, true, code.back().operand};
+        } else {
+            code.push_back({op, false, 0});
+        }
+    }
+
+    void emitUnary(Op op) {
+        if (lastIsConstant(1)) {
+            constants[code.back().operand] = applyUnary(op, constants[code.back().operand]);
+        } else {
+            code.push_back({op, false, 0});
+        }
+    }
+
+    // a || b: a, JUMP_IF_TRUE end, b, OR, end
+    bool parseLogical(Op op, Op jump, const char* symbol, const char* word, bool (Parser::*operand)()) {
+        if (!(this->*operand)()) return false;
+        while (accept(symbol) || accept(word)) {
+            size_t jumpAt = code.size();
+            code.push_back({jump, false, 0});
+            if (!(this->*operand)()) return false;
+            emitBinary(op);
+            code[jumpAt].operand = (uint16_t)code.size();
+        }
+        return true;
+    }
+
+    bool parseOr() { return parseLogical(Op::OR, Op::JUMP_IF_TRUE, "||", "or", &Parser::parseAnd); }
+    bool parseAnd() { return parseLogical(Op::AND, Op::JUMP_IF_FALSE, "&&", "and", &Parser::parseComparison); }
+
+    bool parseComparison() {
+        if (!parseSum()) return false;
+        // Two-character operators first
+        static const struct { const char* symbol; Op op; } comparisons[] = {
+            {"<=", Op::LE}, {">=", Op::GE}, {"==", Op::EQ}, {"!=", Op::NE}, {"<", Op::LT}, {">", Op::GT},
+        };
+        for (const auto& comparison : comparisons) {
+            if (accept(comparison.symbol)) {
+                if (!parseSum()) return false;
+                emitBinary(comparison.op);
+                return true;
+            }
+        }
+        return true;
+    }
+
+    bool parseSum() {
+        if (!parseProduct()) return false;
+        for (;;) {
+            Op op;
+            if (accept("+")) op = Op::ADD;
+            else if (accept("-")) op = Op::SUB;
+            else return true;
+            if (!parseProduct()) return false;
+            emitBinary(op);
+        }
+    }
+
+    bool parseProduct() {
+        if (!parseUnary()) return false;
+        for (;;) {
+            Op op;
+            if (accept("*")) op = Op::MUL;
+            else if (accept("/")) op = Op::DIV;
+            else return true;
+            if (!parseUnary()) return false;
+            emitBinary(op);
+        }
+    }
+
+    bool parseUnary() {
+        if (accept("-")) {
+            if (!parseUnary()) return false;
+            emitUnary(Op::NEG);
+            return true;
+        }
+        if (accept("!") || accept("not")) {
+            if (!parseUnary()) return false;
+            emitUnary(Op::NOT);
+            return true;
+        }
+        return parsePrimary();
+    }
+
+    bool parsePrimary() {
+        skipSpace();
+        if (position >= text.size()) return fail("expected a value");
+
+        if (accept("(")) {
+            if (!parseOr()) return false;
+            return accept(")") || fail("expected ')'");
+        }
+
+        const char* begin = text.c_str() + position;
+        if (std::isdigit((unsigned char)*begin) || *begin == '.') {
+            char* end;
+            double value = std::strtod(begin, &end);
+            if (end == begin) return fail("bad number");
+            position += end - begin;
+            skipSpace();
+            for (const Unit& unit : UNITS) {
+                if (accept(unit.name)) {
+                    value *= unit.scale;
+                    break;
+                }
+            }
+            return pushConstant(value);
+        }
+
+        std::string word = peekWord();
+        if (word.empty()) return fail("expected a value");
+        size_t wordPosition = position;
+        position += word.size();
+
+        static const struct { const char* name; Op op; int arguments; } functions[] = {
+            {"abs", Op::ABS, 1}, {"sqrt", Op::SQRT, 1}, {"min", Op::MIN, 2}, {"max", Op::MAX, 2},
+        };
+        for (const auto& function : functions) {
+            if (word != function.name) continue;
+            if (!accept("(")) return fail("expected '(' after " + word);
+            for (int i = 0; i < function.arguments; i++) {
+                if (i > 0 && !accept(",")) return fail(word + " takes " + std::to_string(function.arguments) +
+                                                       " arguments");
+                if (!parseOr()) return false;
+            }
+            if (!accept(")")) return fail("expected ')'");
+            if (function.arguments == 2) {
+                emitBinary(function.op);
+            } else {
+                emitUnary(function.op);
+            }
+            return true;
+        }
+
+        for (int i = 0; i < VARIABLE_COUNT; i++) {
+            if (word == VARIABLES[i].name) {
+                mask |= 1ull << i;
+                return push({Op::VARIABLE, false, (uint16_t)i});
+            }
+        }
+        position = wordPosition;
+        return fail("unknown name '" + word + "'");
+    }
+};
+
+#ifdef WATCH_USE_SSE2
+// Two steps per instruction
+struct Lanes {
+    __m128d v;
+    Lanes(__m128d v) : v(v) {}
+};
+
+inline Lanes load(const double* p) { return _mm_loadu_pd(p); }
+inline void store(double* p, Lanes a) { _mm_storeu_pd(p, a.v); }
+inline Lanes broadcast(double x) { return _mm_set1_pd(x); }
+inline Lanes truth(__m128d mask) { return _mm_and_pd(mask, _mm_set1_pd(1.0)); }
+inline __m128d nonZero(Lanes a) { return _mm_cmpneq_pd(a.v, _mm_setzero_pd()); }
+const int LANES = 2;
+#else
+using Lanes = double;
+inline Lanes load(const double* p) { return *p; }
+inline void store(double* p, Lanes a) { *p = a; }
+inline Lanes broadcast(double x) { return x; }
+const int LANES = 1;
+#endif
+
+template <typename F>
+inline void binaryLanes(double* out, const double* a, const double* b, int n, F f) {
+    for (int i = 0; i < n; i += LANES) store(out + i, f(load(a + i), load(b + i)));
+}
+
+template <typename F>
+inline void binaryLanes(double* out, const double* a, double b, int n, F f) {
+    Lanes right = broadcast(b);
+    for (int i = 0; i < n; i += LANES) store(out + i, f(load(a + i), right));
+}
+
+template <typename F>
+inline void unaryLanes(double* out, const double* a, int n, F f) {
+    for (int i = 0; i < n; i += LANES) store(out + i, f(load(a + i)));
+}
+
+template <typename B>
+inline void dispatchBinary(Op op, double* out, const double* a, B b, int n) {
+#ifdef WATCH_USE_SSE2
+    switch (op) {
+        case Op::ADD: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return Lanes(_mm_add_pd(x.v, y.v)); }); break;
+        case Op::SUB: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return Lanes(_mm_sub_pd(x.v, y.v)); }); break;
+        case Op::MUL: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return Lanes(_mm_mul_pd(x.v, y.v)); }); break;
+        case Op::DIV: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return Lanes(_mm_div_pd(x.v, y.v)); }); break;
+        // minpd/maxpd return the second operand when unordered, as the scalar b < a ? b : a
+        case Op::MIN: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return Lanes(_mm_min_pd(y.v, x.v)); }); break;
+        case Op::MAX: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return Lanes(_mm_max_pd(y.v, x.v)); }); break;
+        case Op::LT: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return truth(_mm_cmplt_pd(x.v, y.v)); }); break;
+        case Op::LE: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return truth(_mm_cmple_pd(x.v, y.v)); }); break;
+        case Op::GT: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return truth(_mm_cmpgt_pd(x.v, y.v)); }); break;
+        case Op::GE: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return truth(_mm_cmpge_pd(x.v, y.v)); }); break;
+        case Op::EQ: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return truth(_mm_cmpeq_pd(x.v, y.v)); }); break;
+        case Op::NE: binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return truth(_mm_cmpneq_pd(x.v, y.v)); }); break;
+        case Op::AND:
+            binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return truth(_mm_and_pd(nonZero(x), nonZero(y))); });
+            break;
+        case Op::OR:
+            binaryLanes(out, a, b, n, [](Lanes x, Lanes y) { return truth(_mm_or_pd(nonZero(x), nonZero(y))); });
+            break;
+        default: break;
+    }
+#else
+    binaryLanes(out, a, b, n, [op](double x, double y) { return applyBinary(op, x, y); });
+#endif
+}
+
+inline void dispatchUnary(Op op, double* out, const double* a, int n) {
+#ifdef WATCH_USE_SSE2
+    switch (op) {
+        case Op::NEG:
+            unaryLanes(out, a, n, [](Lanes x) { return Lanes(_mm_xor_pd(x.v, _mm_set1_pd(-0.0))); });
+            break;
+        case Op::ABS:
+            unaryLanes(out, a, n, [](Lanes x) { return Lanes(_mm_andnot_pd(_mm_set1_pd(-0.0), x.v)); });
+            break;
+        case Op::SQRT: unaryLanes(out, a, n, [](Lanes x) { return Lanes(_mm_sqrt_pd(x.v)); }); break;
+        case Op::NOT:
+            unaryLanes(out, a, n, [](Lanes x) { return truth(_mm_cmpeq_pd(x.v, _mm_setzero_pd())); });
+            break;
+        default: break;
+    }
+#else
+    unaryLanes(out, a, n, [op](double x) { return applyUnary(op, x); });
+#endif
+}
+
+// Whether any of the first n values is non-zero (NaN counts, as in C)
+bool anyNonZero(const double* values, int n) {
+    int i = 0;
+#ifdef WATCH_USE_SSE2
+    __m128d any = _mm_setzero_pd();
+    for (; i + 2 <= n; i += 2) any = _mm_or_pd(any, nonZero(load(values + i)));
+    if (_mm_movemask_pd(any) != 0) return true;
+#endif
+    for (; i < n; i++) {
+        if (values[i] != 0.0) return true;
+    }
+    return false;
+}
+
+bool allNonZero(const double* values, int n) {
+    for (int i = 0; i < n; i++) {
+        if (values[i] == 0.0) return false;
+    }
+    return true;
+}
+
+// Value ranges for deciding a watch for a whole block from the bounds of
+// its variables over the block. Known ranges are finite; anything that
+// could be infinite or NaN is unknown, so a known result is exact: the
+// operations round monotonically, so the bounds computed from the extremes
+// contain every per-step result.
+struct Range {
+    double lo, hi;
+    bool known;
+};
+
+const Range UNKNOWN = {0.0, 0.0, false};
+const Range FALSE_RANGE = {0.0, 0.0, true};
+const Range TRUE_RANGE = {1.0, 1.0, true};
+const Range EITHER_RANGE = {0.0, 1.0, true};
+
+enum class Truth { FALSE, TRUE, EITHER };
+
+inline Range makeRange(double lo, double hi) {
+    if (!(std::isfinite(lo) && std::isfinite(hi))) return UNKNOWN;
+    return {lo, hi, true};
+}
+
+inline Truth truthOf(const Range& a) {
+    if (!a.known) return Truth::EITHER;
+    if (a.lo == 0.0 && a.hi == 0.0) return Truth::FALSE;
+    if (a.lo > 0.0 || a.hi < 0.0) return Truth::TRUE;
+    return Truth::EITHER;
+}
+
+inline Range fromTruth(Truth truth) {
+    return truth == Truth::FALSE ? FALSE_RANGE : truth == Truth::TRUE ? TRUE_RANGE : EITHER_RANGE;
+}
+
+// `always`: a op b holds for every pair; `never`: for none
+inline Range comparison(bool always, bool never) {
+    return always ? TRUE_RANGE : never ? FALSE_RANGE : EITHER_RANGE;
+}
+
+inline Range corners(double c0, double c1, double c2, double c3) {
+    return makeRange(std::min(std::min(c0, c1), std::min(c2, c3)), std::max(std::max(c0, c1), std::max(c2, c3)));
+}
+
+inline Range rangeBinary(Op op, const Range& a, const Range& b) {
+    if (op == Op::AND || op == Op::OR) {
+        Truth x = truthOf(a), y = truthOf(b);
+        if (op == Op::AND) {
+            if (x == Truth::FALSE || y == Truth::FALSE) return FALSE_RANGE;
+            return fromTruth(x == Truth::TRUE && y == Truth::TRUE ? Truth::TRUE : Truth::EITHER);
+        }
+        if (x == Truth::TRUE || y == Truth::TRUE) return TRUE_RANGE;
+        return fromTruth(x == Truth::FALSE && y == Truth::FALSE ? Truth::FALSE : Truth::EITHER);
+    }
+    if (!a.known || !b.known) {
+        // NaN compares false (and != true), so even comparisons are open
+        return op >= Op::LT && op <= Op::NE ? EITHER_RANGE : UNKNOWN;
+    }
+    switch (op) {
+        case Op::ADD: return makeRange(a.lo + b.lo, a.hi + b.hi);
+        case Op::SUB: return makeRange(a.lo - b.hi, a.hi - b.lo);
+        case Op::MUL: return corners(a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi);
+        case Op::DIV:
+            if (!(b.lo > 0.0 || b.hi < 0.0)) return UNKNOWN;
+            return corners(a.lo / b.lo, a.lo / b.hi, a.hi / b.lo, a.hi / b.hi);
+        case Op::MIN: return {std::min(a.lo, b.lo), std::min(a.hi, b.hi), true};
+        case Op::MAX: return {std::max(a.lo, b.lo), std::max(a.hi, b.hi), true};
+        case Op::LT: return comparison(a.hi < b.lo, a.lo >= b.hi);
+        case Op::LE: return comparison(a.hi <= b.lo, a.lo > b.hi);
+        case Op::GT: return comparison(a.lo > b.hi, a.hi <= b.lo);
+        case Op::GE: return comparison(a.lo >= b.hi, a.hi < b.lo);
+        case Op::EQ:
+            return comparison(a.lo == a.hi && b.lo == b.hi && a.lo == b.lo, a.hi < b.lo || b.hi < a.lo);
+        case Op::NE:
+            return comparison(a.hi < b.lo || b.hi < a.lo, a.lo == a.hi && b.lo == b.hi && a.lo == b.lo);
+        default: return UNKNOWN;
+    }
+}
+
+inline Range rangeUnary(Op op, const Range& a) {
+    if (op == Op::NOT) {
+        Truth x = truthOf(a);
+        return fromTruth(x == Truth::TRUE ? Truth::FALSE : x == Truth::FALSE ? Truth::TRUE : Truth::EITHER);
+    }
+    if (!a.known) return UNKNOWN;
+    switch (op) {
+        case Op::NEG: return {-a.hi, -a.lo, true};
+        case Op::ABS:
+            if (a.lo >= 0.0) return a;
+            if (a.hi <= 0.0) return {-a.hi, -a.lo, true};
+            return {0.0, std::max(-a.lo, a.hi), true};
+        case Op::SQRT: return a.lo >= 0.0 ? Range{std::sqrt(a.lo), std::sqrt(a.hi), true} : UNKNOWN;
+        default: return UNKNOWN;
+    }
+}
+
+// Range of a variable's column over n steps (unknown if any value is NaN
+// or infinite)
+inline Range variableRange(const double* values, int n) {
+    int i = 0;
+    double lo = INFINITY, hi = -INFINITY;
+#ifdef WATCH_USE_SSE2
+    // Two steps per register, four registers per iteration, paired first so
+    // each running min and max takes one dependent instruction per four
+    // steps (their latency bounds the loop); cmpunord flags a NaN in either
+    // operand
+    __m128d low0 = _mm_set1_pd(INFINITY), low1 = low0, high0 = _mm_set1_pd(-INFINITY), high1 = high0;
+    __m128d nan = _mm_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        __m128d a0 = _mm_loadu_pd(values + i), a1 = _mm_loadu_pd(values + i + 2);
+        __m128d b0 = _mm_loadu_pd(values + i + 4), b1 = _mm_loadu_pd(values + i + 6);
+        low0 = _mm_min_pd(low0, _mm_min_pd(a0, b0));
+        low1 = _mm_min_pd(low1, _mm_min_pd(a1, b1));
+        high0 = _mm_max_pd(high0, _mm_max_pd(a0, b0));
+        high1 = _mm_max_pd(high1, _mm_max_pd(a1, b1));
+        nan = _mm_or_pd(nan, _mm_or_pd(_mm_cmpunord_pd(a0, b0), _mm_cmpunord_pd(a1, b1)));
+    }
+    if (_mm_movemask_pd(nan) != 0) return UNKNOWN;
+    __m128d low = _mm_min_pd(low0, low1), high = _mm_max_pd(high0, high1);
+    lo = _mm_cvtsd_f64(_mm_min_pd(low, _mm_unpackhi_pd(low, low)));
+    hi = _mm_cvtsd_f64(_mm_max_pd(high, _mm_unpackhi_pd(high, high)));
+#endif
+    for (; i < n; i++) {
+        double x = values[i];
+        if (std::isnan(x)) return UNKNOWN;
+        lo = x < lo ? x : lo;
+        hi = x > hi ? x : hi;
+    }
+    return makeRange(lo, hi);
+}
+
+// Variable ranges over a block, each computed when a program first reads
+// it: a watch decided by the left-hand side of && or || never
+// scans the variables on the right
+struct RangeSource {
+    const double* columns;
+    int n;
+    uint64_t ready;
+    Range ranges[VARIABLE_COUNT];
+
+    void reset(const double* first, int count) {
+        columns = first;
+        n = count;
+        ready = 0;
+    }
+
+    const Range& get(int v) {
+        if (!(ready >> v & 1)) {
+            ranges[v] = variableRange(columns + (size_t)v * WatchEngine::COLUMN, n);
+            ready |= 1ull << v;
+        }
+        return ranges[v];
+    }
+};
+
+// A program's truth over a block from its variables' ranges: FALSE or TRUE
+// at every step, or EITHER (decided step by step)
+Truth rangeTruth(const WatchProgram& program, RangeSource& variables) {
+    const std::vector<Instruction>& code = program.getInstructions();
+    const std::vector<double>& constants = program.getConstants();
+    Range stack[WatchProgram::MAX_DEPTH];
+    int top = -1;
+
+    for (size_t pc = 0; pc < code.size(); pc++) {
+        const Instruction& instruction = code[pc];
+        switch (instruction.op) {
+            case Op::VARIABLE:
+                stack[++top] = variables.get(instruction.operand);
+                break;
+            case Op::CONSTANT: {
+                double value = constants[instruction.operand];
+                stack[++top] = makeRange(value, value);
+                break;
+            }
+            case Op::NEG: case Op::ABS: case Op::SQRT: case Op::NOT:
+                stack[top] = rangeUnary(instruction.op, stack[top]);
+                break;
+            case Op::JUMP_IF_FALSE: case Op::JUMP_IF_TRUE: {
+                Truth truth = truthOf(stack[top]);
+                stack[top] = fromTruth(truth);
+                if (truth == (instruction.op == Op::JUMP_IF_FALSE ? Truth::FALSE : Truth::TRUE)) {
+                    pc = instruction.operand - 1;
+                }
+                break;
+            }
+            default:
+                if (instruction.constantOperand) {
+                    double value = constants[instruction.operand];
+                    stack[top] = rangeBinary(instruction.op, stack[top], makeRange(value, value));
+                } else if (instruction.op == Op::MUL && pc >= 2 && code[pc - 1].op == Op::VARIABLE &&
+                           code[pc - 2].op == Op::VARIABLE && code[pc - 1].operand == code[pc - 2].operand) {
+                    // x * x is never negative, though the corners of x's range may be
+                    top--;
+                    Range product = rangeBinary(Op::MUL, stack[top], stack[top]);
+                    if (product.known && stack[top].lo < 0.0 && stack[top].hi > 0.0) product.lo = 0.0;
+                    stack[top] = product;
+                } else {
+                    top--;
+                    stack[top] = rangeBinary(instruction.op, stack[top], stack[top + 1]);
+                }
+                break;
+        }
+    }
+    return top == 0 ? truthOf(stack[0]) : Truth::FALSE;
+}
+
+// Runs a program over n steps: variables are columns of BLOCK values,
+// scratch holds one column per stack slot. Returns the result column.
+const double* runBlock(const WatchProgram& program, const double* columns, double* scratch, int n) {
+    const std::vector<Instruction>& code = program.getInstructions();
+    const std::vector<double>& constants = program.getConstants();
+    const int lanes = (n + LANES - 1) / LANES * LANES;   // Padding lanes compute garbage, never read
+    const double* stack[WatchProgram::MAX_DEPTH];
+    int top = -1;
+
+    for (size_t pc = 0; pc < code.size(); pc++) {
+        const Instruction& instruction = code[pc];
+        switch (instruction.op) {
+            case Op::VARIABLE:
+                stack[++top] = columns + instruction.operand * WatchEngine::COLUMN;
+                break;
+            case Op::CONSTANT: {
+                double* out = scratch + (top + 1) * WatchEngine::BLOCK;
+                for (int i = 0; i < lanes; i++) out[i] = constants[instruction.operand];
+                stack[++top] = out;
+                break;
+            }
+            case Op::NEG: case Op::ABS: case Op::SQRT: case Op::NOT: {
+                double* out = scratch + top * WatchEngine::BLOCK;
+                dispatchUnary(instruction.op, out, stack[top], lanes);
+                stack[top] = out;
+                break;
+            }
+            case Op::JUMP_IF_FALSE: case Op::JUMP_IF_TRUE: {
+                // Normalised to 0/1, the value && / || give when they stop here
+                double* out = scratch + top * WatchEngine::BLOCK;
+                dispatchUnary(Op::NOT, out, stack[top], lanes);
+                dispatchUnary(Op::NOT, out, out, lanes);
+                stack[top] = out;
+                bool decided = instruction.op == Op::JUMP_IF_FALSE ? !anyNonZero(out, n) : allNonZero(out, n);
+                if (decided) pc = instruction.operand - 1;
+                break;
+            }
+            default: {
+                double* out;
+                if (instruction.constantOperand) {
+                    out = scratch + top * WatchEngine::BLOCK;
+                    dispatchBinary(instruction.op, out, stack[top], constants[instruction.operand], lanes);
+                } else {
+                    top--;
+                    out = scratch + top * WatchEngine::BLOCK;
+                    dispatchBinary(instruction.op, out, stack[top], stack[top + 1], lanes);
+                }
+                stack[top] = out;
+                break;
+            }
+        }
+    }
+    return stack[0];
+}
+
+// Guards that keep a watch's decision (FALSE or TRUE at every step of the
+// block, from the block's ranges) beyond the block: the variables it still
+// needs with the others unknown, their ranges widened together and then
+// each side on its own, by multiples of the range's width (plus a
+// little of its magnitude, for values that did not move), as far as the
+// decision holds. The guard count, or -1 when it rests on more than
+// MAX_GUARDS variables.
+int settleGuards(const WatchProgram& program, RangeSource& ranges, Truth truth, uint8_t* variables, double* lo,
+                 double* hi) {
+    const uint64_t reads = program.getVariableMask();
+    RangeSource trial;
+    trial.reset(nullptr, 0);
+    trial.ready = ~0ull;
+    for (uint64_t bits = reads; bits != 0; bits &= bits - 1) trial.ranges[lowestBit(bits)] = UNKNOWN;
+
+    uint64_t keep = reads;
+    for (uint64_t bits = (reads & (reads - 1)) != 0 ? reads : 0; bits != 0; bits &= bits - 1) {
+        int v = lowestBit(bits);
+        trial.ranges[v] = UNKNOWN;
+        for (uint64_t kept = keep & ~(1ull << v); kept != 0; kept &= kept - 1) {
+            trial.ranges[lowestBit(kept)] = ranges.get(lowestBit(kept));
+        }
+        if (rangeTruth(program, trial) == truth) keep &= ~(1ull << v);
+    }
+    int count = 0;
+    double base[2 * WatchEngine::MAX_GUARDS], width[WatchEngine::MAX_GUARDS];
+    for (uint64_t bits = keep; bits != 0; bits &= bits - 1) {
+        int v = lowestBit(bits);
+        const Range& range = ranges.get(v);
+        if (!range.known) continue;   // Decided without it after all
+        if (count == WatchEngine::MAX_GUARDS) return -1;
+        variables[count] = (uint8_t)v;
+        base[2 * count] = range.lo;
+        base[2 * count + 1] = range.hi;
+        width[count] = (range.hi - range.lo) + 1e-3 * std::max(std::max(std::fabs(range.lo), std::fabs(range.hi)), 1.0);
+        count++;
+    }
+
+    // Margins as multiples of the width: together, the widest first, then
+    // bisected by powers of two; then each side on its own, as far as it
+    // goes within 1/4096 of the margin
+    const double MAX_MARGIN = 4096.0;
+    double margin[2 * WatchEngine::MAX_GUARDS];
+    auto decides = [&]() {
+        for (int k = 0; k < count; k++) {
+            trial.ranges[variables[k]] = makeRange(base[2 * k] - margin[2 * k] * width[k],
+                                                   base[2 * k + 1] + margin[2 * k + 1] * width[k]);
+        }
+        return rangeTruth(program, trial) == truth;
+    };
+    double good = 0.0, bad = 2 * MAX_MARGIN;
+    while (bad > 2 * good && bad > 1.0) {
+        double mid = bad > MAX_MARGIN ? MAX_MARGIN : good > 0.0 ? std::sqrt(good * bad) : bad / 16;
+        std::fill(margin, margin + 2 * count, mid);
+        if (decides()) {
+            good = mid;
+        } else {
+            bad = mid;
+        }
+    }
+    std::fill(margin, margin + 2 * count, good);
+    for (int side = 0; side < 2 * count && good < MAX_MARGIN; side++) {
+        margin[side] = MAX_MARGIN;
+        if (decides()) continue;
+        double sideGood = good, sideBad = MAX_MARGIN;
+        for (double next = std::max(2 * good, 1.0); next < sideBad; next *= 2) {
+            margin[side] = next;
+            if (!decides()) {
+                sideBad = next;
+                break;
+            }
+            sideGood = next;
+        }
+        while (sideBad - sideGood > sideBad / 4096) {
+            margin[side] = 0.5 * (sideGood + sideBad);
+            if (decides()) {
+                sideGood = margin[side];
+            } else {
+                sideBad = margin[side];
+            }
+        }
+        margin[side] = sideGood;
+    }
+    for (int k = 0; k < count; k++) {
+        lo[k] = base[2 * k] - margin[2 * k] * width[k];
+        hi[k] = base[2 * k + 1] + margin[2 * k + 1] * width[k];
+    }
+    return count;
+}
+
+
+// Whether a block's (or a step's) values lie inside a box
+template <typename Box>
+bool inside(const Box& box, RangeSource& ranges) {
+    for (int k = 0; k < box.count; k++) {
+        const Range& range = ranges.get(box.variable[k]);
+        if (!range.known || !(range.lo >= box.lo[k] && range.hi <= box.hi[k])) return false;
+    }
+    return true;
+}
+
+// Settles a watch whose truth over `ranges` is decided: in a box it was
+// settled in before when one holds them, else in a new one when the search
+// limit allows. False when it stays live.
+template <typename Compiled>
+bool settle(Compiled& compiled, RangeSource& ranges, Truth truth, uint64_t now) {
+    const int t = truth == Truth::TRUE;
+    const int cached = WatchEngine::CACHED_BOXES;
+    for (int b = 0; b < compiled.boxCount[t]; b++) {
+        if (inside(compiled.boxes[t][b], ranges)) {
+            compiled.guards = compiled.boxes[t][b];
+            return true;
+        }
+    }
+    if (compiled.searchFrom > now + SEARCH_BURST * SEARCH_INTERVAL) return false;
+    compiled.searchFrom = std::max(compiled.searchFrom, now) + SEARCH_INTERVAL;
+    decltype(compiled.guards) box;
+    box.count = settleGuards(compiled.program, ranges, truth, box.variable, box.lo, box.hi);
+    if (box.count < 0) return false;
+    compiled.guards = compiled.boxes[t][compiled.nextBox[t]] = box;
+    compiled.nextBox[t] = (compiled.nextBox[t] + 1) % cached;
+    compiled.boxCount[t] = std::min(compiled.boxCount[t] + 1, cached);
+    return true;
+}
+
+} // namespace
+
+bool WatchProgram::compile(const std::string& text, std::string& error) {
+    std::vector<Instruction> code;
+    std::vector<double> pool;
+    Parser parser(text, code, pool);
+    if (!parser.parse(error)) return false;
+    instructions = std::move(code);
+    constants = std::move(pool);
+    maxDepth = parser.getMaxDepth();
+    variableMask = parser.getVariableMask();
+    return true;
+}
+
+double WatchProgram::evaluate(const WatchSample& sample) const {
+    return evaluateProgram(*this, [&](int v) { return readVariable(sample, VARIABLES[v].offset); });
+}
+
+int WatchProgram::variableCount() {
+    return VARIABLE_COUNT;
+}
+
+const char* WatchProgram::variableName(int index) {
+    return VARIABLES[index].name;
+}
+
+const char* WatchProgram::variableDescription(int index) {
+    return VARIABLES[index].description;
+}
+
+double WatchProgram::variableValue(int index, const WatchSample& sample) {
+    return readVariable(sample, VARIABLES[index].offset);
+}
+
+WatchEngine::WatchEngine()
+    : nextId(1), active(0), pending(0), recordMask(0), stateSlots(0), slotCount(0), keepStates(false),
+      statesFrom(0), pauseCount(0), guardMask(0), statePairs(0), pairCount(0), timeLo(-INFINITY),
+      timeHi(INFINITY), columns((size_t)VARIABLE_COUNT * COLUMN), states(BLOCK),
+      scratch((size_t)WatchProgram::MAX_DEPTH * BLOCK), lastMask(0), breakPending(false), evaluatedSteps(0),
+      evaluationNs(0.0), watchBlocks(0), settledBlocks(0), steppedBlocks(0), guardCrossings(0) {
+    watches.reserve(MAX_WATCHES);
+    programs.reserve(MAX_WATCHES);
+}
+
+int WatchEngine::add(const std::string& text, unsigned int actions, std::string& error) {
+    flush();   // The steps so far are evaluated without it (its variables were not recorded)
+    if (watches.size() >= (size_t)MAX_WATCHES) {
+        error = "all " + std::to_string(MAX_WATCHES) + " watches in use";
+        return -1;
+    }
+    Compiled compiled;
+    if (!compiled.program.compile(text, error)) return -1;
+    compiled.enabled = true;
+    compiled.actions = actions;
+    compiled.previous = false;   // Already true counts as a hit on the next step
+    compiled.current = false;
+    compiled.liveFrom = 0;
+    compiled.guards.count = 0;
+    compiled.searchFrom = 0;
+    compiled.boxCount[0] = compiled.boxCount[1] = 0;
+    compiled.nextBox[0] = compiled.nextBox[1] = 0;
+
+    Watch watch;
+    watch.id = nextId++;
+    watch.text = text;
+    watch.actions = actions;
+    watch.enabled = true;
+    watch.hits = 0;
+    watch.lastHitTime = NAN;
+    watch.hasSnapshot = false;
+    watches.push_back(watch);
+    programs.push_back(std::move(compiled));
+    updateRecording(pending);
+    return watch.id;
+}
+
+bool WatchEngine::remove(int id) {
+    for (size_t i = 0; i < watches.size(); i++) {
+        if (watches[i].id == id) {
+            watches.erase(watches.begin() + i);
+            programs.erase(programs.begin() + i);
+            updateRecording(pending);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WatchEngine::clear() {
+    watches.clear();
+    programs.clear();
+    pending = 0;
+    breakPending = false;
+    updateRecording(0);
+}
+
+void WatchEngine::setActions(int id, unsigned int actions) {
+    flush();   // Snapshots need the states, recorded from here on
+    for (size_t i = 0; i < watches.size(); i++) {
+        if (watches[i].id == id) watches[i].actions = programs[i].actions = actions;
+    }
+    updateRecording(pending);
+}
+
+void WatchEngine::setEnabled(int id, bool enabled) {
+    flush();   // A watch enabled now is not evaluated over earlier steps
+    for (size_t i = 0; i < watches.size(); i++) {
+        if (watches[i].id == id && watches[i].enabled != enabled) {
+            Compiled& compiled = programs[i];
+            watches[i].enabled = compiled.enabled = enabled;
+            compiled.previous = compiled.current = false;
+            compiled.liveFrom = 0;
+        }
+    }
+    updateRecording(pending);
+}
+
+// What record() does from step `from` of the block on: the live watches'
+// variables and (for snapshots) states, and the pause watches it evaluates
+void WatchEngine::updateRecording(int from) {
+    if (from == 0) {
+        recordMask = 0;
+        keepStates = false;
+    }
+    active = 0;
+    pauseCount = 0;
+    uint64_t live = 0;
+    bool keep = false;
+    for (size_t i = 0; i < programs.size(); i++) {
+        const Compiled& compiled = programs[i];
+        if (!compiled.enabled) continue;
+        active++;
+        if (compiled.liveFrom < 0) continue;
+        live |= compiled.program.getVariableMask();
+        keep |= (compiled.actions & (WATCH_SNAPSHOT | WATCH_PAUSE)) != 0;
+        if (compiled.actions & WATCH_PAUSE) pauses[pauseCount++] = (int)i;
+    }
+    for (uint64_t bits = live & ~recordMask; bits != 0; bits &= bits - 1) recordedFrom[lowestBit(bits)] = from;
+    recordMask = live;
+    if (keep && !keepStates) statesFrom = from;
+    keepStates = keep;
+
+    // Time is always column 0; the state variables come before the air
+    // data in the table
+    stateSlots = slotCount = 0;
+    for (int v = 1; v < VARIABLE_COUNT; v++) {
+        if (!(recordMask >> v & 1)) continue;
+        bool state = isStateVariable(v);
+        slots[slotCount].column = &columns[(size_t)v * COLUMN];
+        slots[slotCount].offset = VARIABLES[v].offset - (state ? STATE_START : AIR_DATA_START);
+        if (state) stateSlots++;
+        slotCount++;
+    }
+    updateGuards();
+}
+
+// The intersection of the settled watches' guards, as record() checks it
+void WatchEngine::updateGuards() {
+    guardMask = 0;
+    for (const Compiled& compiled : programs) {
+        if (!compiled.enabled || compiled.liveFrom >= 0) continue;
+        const Box& box = compiled.guards;
+        for (int k = 0; k < box.count; k++) {
+            int v = box.variable[k];
+            bool first = !(guardMask >> v & 1);
+            guardLo[v] = first ? box.lo[k] : std::max(guardLo[v], box.lo[k]);
+            guardHi[v] = first ? box.hi[k] : std::min(guardHi[v], box.hi[k]);
+            guardMask |= 1ull << v;
+        }
+    }
+
+    // In pairs from the same struct, the last of an odd count twice
+    timeLo = guardMask & 1 ? guardLo[0] : -INFINITY;
+    timeHi = guardMask & 1 ? guardHi[0] : INFINITY;
+    pairCount = 0;
+    for (int part = 0; part < 2; part++) {
+        int members[VARIABLE_COUNT], count = 0;
+        for (uint64_t bits = guardMask & ~1ull; bits != 0; bits &= bits - 1) {
+            int v = lowestBit(bits);
+            if (isStateVariable(v) == (part == 0)) members[count++] = v;
+        }
+        for (int k = 0; k < count; k += 2) {
+            GuardPair& pair = pairs[pairCount++];
+            for (int lane = 0; lane < 2; lane++) {
+                int v = members[std::min(k + lane, count - 1)];
+                pair.lo[lane] = guardLo[v];
+                pair.hi[lane] = guardHi[v];
+                pair.offset[lane] = VARIABLES[v].offset - (part == 0 ? STATE_START : AIR_DATA_START);
+            }
+        }
+        if (part == 0) statePairs = pairCount;
+    }
+}
+
+// After a step that left the guards, with pause watches to evaluate, or
+// that ends the block
+void WatchEngine::recorded(int step, double simTime, const AircraftState& state, const AirData& airData) {
+    if (outsideGuards(simTime, state, airData)) crossed(step, simTime, state, airData);
+    if (pauseCount > 0) checkPauses(step, simTime, state, airData);
+    if (pending == BLOCK) {
+        evaluateBlock();
+        lastSample.time = simTime;   // All of it, for value()
+        lastSample.state = state;
+        lastSample.airData = airData;
+        lastMask = ~0ull;
+    }
+}
+
+void WatchEngine::flush() {
+    if (pending == 0) return;
+    sampleAt(pending - 1, lastSample);
+    lastMask = recordMask | 1;
+    for (int v = 1; keepStates && statesFrom < pending && v < VARIABLE_COUNT; v++) {
+        if (isStateVariable(v)) lastMask |= 1ull << v;
+    }
+    evaluateBlock();
+}
+
+// A value left the guards at `step`. The settled watches whose own guard it
+// left are evaluated there, with the whole sample at hand, and settled
+// again in a box around it; one that finds none is evaluated with the
+// block from the next step on.
+void WatchEngine::crossed(int step, double simTime, const AircraftState& state, const AirData& airData) {
+    guardCrossings++;
+    auto valueOf = [&](int v) { return stepValue(v, simTime, state, airData); };
+    RangeSource point;
+    point.reset(nullptr, 0);
+    point.ready = ~0ull;
+    uint64_t outside = 0;
+    for (uint64_t bits = guardMask; bits != 0; bits &= bits - 1) {
+        int v = lowestBit(bits);
+        double value = valueOf(v);
+        point.ranges[v] = makeRange(value, value);
+        if (!(value >= guardLo[v] && value <= guardHi[v])) outside |= 1ull << v;
+    }
+
+    const uint64_t now = evaluatedSteps + step;
+    uint64_t known = guardMask;
+    bool wentLive = false;
+    for (size_t i = 0; i < programs.size(); i++) {
+        Compiled& compiled = programs[i];
+        if (!compiled.enabled || compiled.liveFrom >= 0) continue;
+        const Box& box = compiled.guards;
+        bool left = false;
+        for (int k = 0; k < box.count && !left; k++) {
+            int v = box.variable[k];
+            left = (outside >> v & 1) && !(point.ranges[v].known && point.ranges[v].lo >= box.lo[k] &&
+                                           point.ranges[v].hi <= box.hi[k]);
+        }
+        if (!left) continue;
+
+        double value = evaluateProgram(compiled.program, valueOf);
+        bool current = value != 0.0;
+        if (current && !compiled.previous && hit(i, simTime, value)) {
+            Watch& watch = watches[i];
+            watch.snapshot.time = simTime;
+            watch.snapshot.state = state;
+            watch.snapshot.airData = airData;
+            snapshotTaken(i);
+        }
+        compiled.previous = compiled.current = current;
+
+        for (uint64_t bits = compiled.program.getVariableMask() & ~known; bits != 0; bits &= bits - 1) {
+            int v = lowestBit(bits);
+            double x = valueOf(v);
+            point.ranges[v] = makeRange(x, x);
+        }
+        known |= compiled.program.getVariableMask();
+        if (rangeTruth(compiled.program, point) == (current ? Truth::TRUE : Truth::FALSE) &&
+            settle(compiled, point, current ? Truth::TRUE : Truth::FALSE, now)) {
+            continue;
+        }
+        compiled.liveFrom = step + 1;
+        wentLive = true;
+    }
+    if (wentLive) {
+        updateRecording(step + 1);
+    } else {
+        updateGuards();
+    }
+}
+
+// Pause watches that are not settled, at every step: a hit evaluates the
+// block there, so the break is pending before the next step
+void WatchEngine::checkPauses(int step, double simTime, const AircraftState& state, const AirData& airData) {
+    for (int k = 0; k < pauseCount; k++) {
+        Compiled& compiled = programs[pauses[k]];
+        if (compiled.liveFrom > step) continue;
+        bool current = evaluateProgram(compiled.program, [&](int v) {
+            return stepValue(v, simTime, state, airData);
+        }) != 0.0;
+        bool rising = current && !compiled.current;
+        compiled.current = current;
+        if (rising) {
+            evaluateBlock();
+            lastSample.time = simTime;
+            lastSample.state = state;
+            lastSample.airData = airData;
+            lastMask = ~0ull;
+            return;
+        }
+    }
+}
+
+void WatchEngine::resync(const WatchSample& sample) {
+    pending = 0;
+    breakPending = false;
+    for (Compiled& compiled : programs) {
+        compiled.previous = compiled.current = compiled.program.evaluate(sample) != 0.0;
+        compiled.liveFrom = 0;
+    }
+    lastSample = sample;
+    lastMask = ~0ull;
+    updateRecording(0);
+}
+
+double WatchEngine::value(size_t index) const {
+    const WatchProgram& program = programs[index].program;
+    return (program.getVariableMask() & ~lastMask) == 0 && lastMask != 0 ? program.evaluate(lastSample) : NAN;
+}
+
+bool WatchEngine::takeBreak(WatchSample& sample) {
+    if (!breakPending) return false;
+    sample = breakSample;
+    breakPending = false;
+    return true;
+}
+
+WatchEngine::Stats WatchEngine::getStats() const {
+    Stats stats;
+    stats.steps = evaluatedSteps;
+    stats.meanStepNs = evaluatedSteps > 0 ? evaluationNs / evaluatedSteps : 0.0;
+    stats.settledFraction = watchBlocks > 0 ? (double)settledBlocks / watchBlocks : 0.0;
+    stats.steppedFraction = watchBlocks > 0 ? (double)steppedBlocks / watchBlocks : 0.0;
+    stats.guardCrossings = guardCrossings;
+    return stats;
+}
+
+// A step of the block as far as it was recorded, NAN elsewhere
+void WatchEngine::sampleAt(int step, WatchSample& sample) const {
+    const double nan = NAN;
+    for (int v = 1; v < VARIABLE_COUNT; v++) std::memcpy((char*)&sample + VARIABLES[v].offset, &nan, sizeof(nan));
+    if (keepStates && statesFrom <= step) sample.state = states[step];
+    for (int v = 0; v < VARIABLE_COUNT; v++) {
+        if (v == 0 || ((recordMask >> v & 1) && recordedFrom[v] <= step)) {
+            std::memcpy((char*)&sample + VARIABLES[v].offset, &columns[(size_t)v * COLUMN + step], sizeof(double));
+        }
+    }
+}
+
+// Counts and logs a hit; true when the watch keeps a snapshot of it, which
+// the caller fills in before snapshotTaken()
+bool WatchEngine::hit(size_t index, double time, double value) {
+    Watch& watch = watches[index];
+    watch.hits++;
+    watch.lastHitTime = time;
+    if (watch.actions & WATCH_LOG) {
+        LOG_AT(LogLevel::INFO, 20, "Watch %d hit at %.3f s (value %g): %s", watch.id, time, value,
+               watch.text.c_str());
+    }
+    return (watch.actions & (WATCH_SNAPSHOT | WATCH_PAUSE)) != 0;
+}
+
+void WatchEngine::snapshotTaken(size_t index) {
+    Watch& watch = watches[index];
+    watch.hasSnapshot = true;
+    if ((watch.actions & WATCH_PAUSE) && (!breakPending || watch.snapshot.time < breakSample.time)) {
+        breakSample = watch.snapshot;
+        breakPending = true;
+    }
+}
+
+void WatchEngine::evaluateBlock() {
+    auto start = Clock::now();
+    const int n = pending;
+    pending = 0;
+
+    // The variables' ranges over the block decide most watches outright;
+    // those live since the block's start share them
+    RangeSource ranges, lateRanges;
+    ranges.reset(columns.data(), n);
+    bool changed = keepStates && statesFrom > 0;
+    for (uint64_t bits = recordMask; bits != 0 && !changed; bits &= bits - 1) changed = recordedFrom[lowestBit(bits)] > 0;
+
+    for (size_t w = 0; w < programs.size(); w++) {
+        Compiled& compiled = programs[w];
+        if (!compiled.enabled) continue;
+        watchBlocks++;
+        if (compiled.liveFrom < 0) {
+            settledBlocks++;
+            continue;
+        }
+
+        // From the step it went live: the columns shifted to start there
+        const int first = compiled.liveFrom, count = n - first;
+        compiled.liveFrom = 0;
+        if (count <= 0) continue;
+        const double* block = columns.data() + first;
+        RangeSource& source = first == 0 ? ranges : lateRanges;
+        if (first > 0) lateRanges.reset(block, count);
+
+        Truth truth = rangeTruth(compiled.program, source);
+        if (truth == Truth::FALSE) {
+            compiled.previous = false;
+        } else if (truth == Truth::TRUE) {
+            if (!compiled.previous) {
+                double value = runBlock(compiled.program, block, scratch.data(), 1)[0];
+                if (hit(w, columns[first], value)) {
+                    sampleAt(first, watches[w].snapshot);
+                    snapshotTaken(w);
+                }
+            }
+            compiled.previous = true;
+        } else {
+            // Step by step, over the columns of the variables it reads
+            steppedBlocks++;
+            const double* result = runBlock(compiled.program, block, scratch.data(), count);
+            if (!anyNonZero(result, count)) {
+                compiled.previous = false;
+            } else {
+                for (int i = 0; i < count; i++) {
+                    bool current = result[i] != 0.0;
+                    if (current && !compiled.previous && hit(w, columns[first + i], result[i])) {
+                        sampleAt(first + i, watches[w].snapshot);
+                        snapshotTaken(w);
+                    }
+                    compiled.previous = current;
+                }
+            }
+        }
+        compiled.current = compiled.previous;
+
+        // Decided by the ranges: settled until a value leaves its guards
+        if (truth != Truth::EITHER && settle(compiled, source, truth, evaluatedSteps + n)) {
+            compiled.liveFrom = -1;
+            changed = true;
+        }
+    }
+
+    if (changed) updateRecording(0);
+    evaluatedSteps += n;
+    evaluationNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
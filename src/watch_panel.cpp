@@ -0,0 +1,120 @@
+#include "watch_panel.hpp"
+#include "imgui.h"
+#include <cmath>
+
+namespace {
+
+// Small checkbox for one action bit
+bool actionToggle(const char* label, unsigned int& actions, unsigned int bit) {
+    bool on = (actions & bit) != 0;
+    if (!ImGui::Checkbox(label, &on)) return false;
+    actions = on ? actions | bit : actions & ~bit;
+    return true;
+}
+
+} // namespace
+
+WatchPanel::WatchPanel() : text{}, pause(true), log(true), snapshot(false), restorePending(false) {}
+
+bool WatchPanel::takeRestore(WatchSample& sample) {
+    if (!restorePending) return false;
+    sample = restoreSample;
+    restorePending = false;
+    return true;
+}
+
+void WatchPanel::render(WatchEngine& watches, bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(560.0f, 0.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Watches", open)) {
+        ImGui::End();
+        return;
+    }
+
+    // New watch
+    bool add = ImGui::InputText("##expression", text, sizeof(text), ImGuiInputTextFlags_EnterReturnsTrue);
+    ImGui::SameLine();
+    add |= ImGui::Button("Add");
+    ImGui::Checkbox("Pause", &pause);
+    ImGui::SameLine();
+    ImGui::Checkbox("Log", &log);
+    ImGui::SameLine();
+    ImGui::Checkbox("Snapshot", &snapshot);
+    if (add && text[0] != '\0') {
+        unsigned int actions = 0;
+        if (pause) actions |= WATCH_PAUSE;
+        if (log) actions |= WATCH_LOG;
+        if (snapshot) actions |= WATCH_SNAPSHOT;
+        if (watches.add(text, actions, error) >= 0) {
+            text[0] = '\0';
+            error.clear();
+        }
+    }
+    if (!error.empty()) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "%s", error.c_str());
+    }
+
+    // Watches; removing one ends the loop for this frame
+    ImGui::Separator();
+    if (watches.size() == 0) {
+        ImGui::TextDisabled("No watches, e.g.  alpha > 15 deg && airspeed < 45");
+    }
+    for (size_t i = 0; i < watches.size(); i++) {
+        const WatchEngine::Watch& watch = watches[i];
+        ImGui::PushID(watch.id);
+
+        bool enabled = watch.enabled;
+        if (ImGui::Checkbox("##enabled", &enabled)) {
+            watches.setEnabled(watch.id, enabled);
+        }
+        ImGui::SameLine();
+        ImGui::Text("%s", watch.text.c_str());
+
+        double value = watches.value(i);
+        ImGui::Text("    = %-10.4g hits %-6llu", value, (unsigned long long)watch.hits);
+        ImGui::SameLine();
+        if (std::isnan(watch.lastHitTime)) {
+            ImGui::Text("last -        ");
+        } else {
+            ImGui::Text("last %7.3f s", watch.lastHitTime);
+        }
+
+        ImGui::SameLine();
+        unsigned int actions = watch.actions;
+        bool changed = actionToggle("P", actions, WATCH_PAUSE);
+        ImGui::SameLine();
+        changed |= actionToggle("L", actions, WATCH_LOG);
+        ImGui::SameLine();
+        changed |= actionToggle("S", actions, WATCH_SNAPSHOT);
+        if (changed) {
+            watches.setActions(watch.id, actions);
+        }
+
+        if (watch.hasSnapshot) {
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Restore")) {
+                restoreSample = watch.snapshot;
+                restorePending = true;
+            }
+        }
+        ImGui::SameLine();
+        bool removed = ImGui::SmallButton("X") && watches.remove(watch.id);
+        ImGui::PopID();
+        if (removed) break;
+    }
+
+    ImGui::Separator();
+    WatchEngine::Stats stats = watches.getStats();
+    ImGui::Text("Evaluation: %.1f ns per step; of watch blocks %.1f%% settled, %.1f%% stepped", stats.meanStepNs,
+                100.0 * stats.settledFraction, 100.0 * stats.steppedFraction);
+    ImGui::TextDisabled("Pause stops right after the step that hit; log and snapshot run up to %d steps later",
+                        WatchEngine::BLOCK);
+
+    if (ImGui::CollapsingHeader("Variables")) {
+        for (int i = 0; i < WatchProgram::variableCount(); i++) {
+            ImGui::BulletText("%-16s %s", WatchProgram::variableName(i), WatchProgram::variableDescription(i));
+        }
+        ImGui::TextDisabled("Units: deg rad kt ft fpm m s (e.g. 500 ft, 15 deg)");
+    }
+
+    ImGui::End();
+}